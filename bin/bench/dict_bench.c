@@ -0,0 +1,109 @@
+// Copyright (c) 2025 Ian Chen
+// SPDX-License-Identifier: MPL-2.0
+
+// Micro-benchmarks for ObjectDict: insert, lookup hit and lookup miss over int and string keys at several sizes.
+// Build with `make bench BUILD_MODE=release` and run `build/dict_bench`.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "../../src/gc.h"
+#include "../../src/value.h"
+
+#define LOOKUP_ROUNDS 4000000
+
+static void* benchReallocFn(void* ptr, size_t size, void* reallocData) {
+    (void)reallocData;
+    if (size == 0) {
+        free(ptr);
+        return NULL;
+    }
+    return realloc(ptr, size);
+}
+
+static double nowNs(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+// Multiplicative scrambling so that consecutive ids do not produce consecutive keys.
+static IntValue scrambledKey(uint32_t i) {
+    return (IntValue)((uint64_t)i * 0x9E3779B97F4A7C15ull >> 16);
+}
+
+static Value makeKey(GC* gc, bool stringKeys, uint32_t i) {
+    if (!stringKeys) {
+        return semiValueIntCreate(scrambledKey(i));
+    }
+    char buf[32];
+    int length = snprintf(buf, sizeof(buf), "key-%lld", (long long)scrambledKey(i));
+    return semiValueStringCreate(gc, buf, (size_t)length);
+}
+
+static void benchmark(uint32_t size, bool stringKeys) {
+    GC gc;
+    semiGCInit(&gc, benchReallocFn, NULL);
+
+    // Keys [0, size) are inserted and keys [size, 2 * size) are used for misses.
+    Value* keys = (Value*)malloc(sizeof(Value) * size * 2);
+    for (uint32_t i = 0; i < size * 2; i++) {
+        keys[i] = makeKey(&gc, stringKeys, i);
+    }
+
+    uint32_t repeat = size >= LOOKUP_ROUNDS ? 1 : LOOKUP_ROUNDS / size;
+    double insertNs = 0;
+    ObjectDict dict;
+    for (uint32_t r = 0; r < repeat; r++) {
+        if (r > 0) {
+            semiObjectStackDictCleanup(&gc, &dict);
+        }
+        semiObjectStackDictInit(&dict);
+        double start = nowNs();
+        for (uint32_t i = 0; i < size; i++) {
+            semiDictSet(&gc, &dict, keys[i], semiValueIntCreate(i));
+        }
+        insertNs += nowNs() - start;
+    }
+
+    uint64_t checksum = 0;
+    double start      = nowNs();
+    for (uint32_t r = 0; r < repeat; r++) {
+        for (uint32_t i = 0; i < size; i++) {
+            checksum += (uint64_t)semiDictGet(&dict, keys[i]).as.i;
+        }
+    }
+    double hitNs = nowNs() - start;
+
+    start = nowNs();
+    for (uint32_t r = 0; r < repeat; r++) {
+        for (uint32_t i = size; i < size * 2; i++) {
+            checksum += semiDictHas(&dict, keys[i]);
+        }
+    }
+    double missNs = nowNs() - start;
+
+    double ops = (double)size * repeat;
+    printf("%-6s %8u  insert %7.2f ns  hit %7.2f ns  miss %7.2f ns  (checksum %llu)\n",
+           stringKeys ? "string" : "int",
+           size,
+           insertNs / ops,
+           hitNs / ops,
+           missNs / ops,
+           (unsigned long long)checksum);
+
+    semiObjectStackDictCleanup(&gc, &dict);
+    free(keys);
+    semiGCCleanup(&gc);
+}
+
+int main(void) {
+    static const uint32_t sizes[] = {8, 64, 1024, 16384, 262144, 1048576};
+    for (int stringKeys = 0; stringKeys <= 1; stringKeys++) {
+        for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+            benchmark(sizes[i], stringKeys);
+        }
+    }
+    return 0;
+}
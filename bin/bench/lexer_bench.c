@@ -0,0 +1,111 @@
+// Copyright (c) 2025 Ian Chen
+// SPDX-License-Identifier: MPL-2.0
+
+// Lexer throughput in MB/s over a synthetic module with indentation, comments, identifiers, numbers and strings.
+// Build with `make bench BUILD_MODE=release` and run `build/lexer_bench [size in MB]`.
+//
+// The lexer is internal to the compiler, so the benchmark includes its translation unit directly. The library is linked
+// after it, which leaves the compiler object in the archive unused.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "../../src/compiler.c"
+
+#define DEFAULT_SOURCE_MB 16
+#define ROUNDS            5
+
+static void* benchReallocFn(void* ptr, size_t size, void* reallocData) {
+    (void)reallocData;
+    if (size == 0) {
+        free(ptr);
+        return NULL;
+    }
+    return realloc(ptr, size);
+}
+
+static double nowNs(void) {
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+    return (double)ts.tv_sec * 1e9 + (double)ts.tv_nsec;
+}
+
+// Fills `source` with generated functions until `size` bytes are used and returns the length of the source.
+static size_t generateSource(char* source, size_t size) {
+    size_t length = 0;
+    for (unsigned i = 0;; i++) {
+        char block[512];
+        int n = snprintf(block,
+                         sizeof(block),
+                         "# Computes the weighted score of the entry number %u from its accumulated samples\n"
+                         "fn compute_weighted_score_%u(sample_count, accumulated_value) {\n"
+                         "    normalized_value := accumulated_value / (sample_count + %u)\n"
+                         "    description := \"weighted score of the entry, normalized by its sample count\"\n"
+                         "    if normalized_value > 0x%X and sample_count != 0 {\n"
+                         "        return normalized_value * 3.25 + %u  # scaled\n"
+                         "    }\n"
+                         "    return description\n"
+                         "}\n\n",
+                         i,
+                         i,
+                         i % 97,
+                         i,
+                         i);
+        if (n < 0 || length + (size_t)n >= size) {
+            return length;
+        }
+        memcpy(source + length, block, (size_t)n);
+        length += (size_t)n;
+    }
+}
+
+int main(int argc, char** argv) {
+    size_t sizeMb = argc > 1 ? (size_t)strtoul(argv[1], NULL, 10) : DEFAULT_SOURCE_MB;
+    if (sizeMb == 0 || sizeMb > 1024) {
+        fprintf(stderr, "usage: %s [size in MB, 1-1024]\n", argv[0]);
+        return 1;
+    }
+
+    char* source  = (char*)malloc(sizeMb << 20);
+    size_t length = generateSource(source, sizeMb << 20);
+
+    double bestNs     = 0;
+    uint64_t checksum = 0;
+    for (int r = 0; r < ROUNDS; r++) {
+        GC gc;
+        semiGCInit(&gc, benchReallocFn, NULL);
+        Compiler compiler;
+        semiCompilerInit(&compiler);
+        compiler.gc = &gc;
+
+        Lexer lexer;
+        double start = nowNs();
+        initLexer(&lexer, &compiler, source, (uint32_t)length);
+        Token token;
+        while ((token = nextToken(&lexer)) != TK_EOF) {
+            checksum += (uint64_t)token;
+        }
+        double elapsedNs = nowNs() - start;
+
+        if (compiler.errorJmpBuf.errorId != 0) {
+            fprintf(stderr, "lexing failed with error %d\n", (int)compiler.errorJmpBuf.errorId);
+            return 1;
+        }
+        if (r == 0 || elapsedNs < bestNs) {
+            bestNs = elapsedNs;
+        }
+
+        semiCompilerCleanup(&compiler);
+        semiGCCleanup(&gc);
+    }
+
+    printf("lexed %.1f MB in %.2f ms  %8.1f MB/s  (checksum %llu)\n",
+           (double)length / (1 << 20),
+           bestNs / 1e6,
+           (double)length / (1 << 20) / (bestNs / 1e9),
+           (unsigned long long)checksum);
+
+    free(source);
+    return 0;
+}
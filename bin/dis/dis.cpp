@@ -141,6 +141,11 @@ int main(int argc, char* argv[]) {
         disassembleCode(func->chunk.data, func->chunk.size);
     }
 
+    std::cout << "Peephole: removed " << module->peepholeRemovedCount << " instruction(s)" << std::endl;
+    std::cout << "Inlining: inlined " << module->inlinedCallCount << " call(s)" << std::endl;
+    std::cout << "Hoisting: hoisted " << module->hoistedInstructionCount << " instruction(s)" << std::endl;
+    std::cout << "Incremental: reused " << module->reusedFunctionCount << " function(s)" << std::endl;
+
 cleanup:
     ErrorId errorId = vm->error;
     uint32_t line   = vm->errorDetails.compileError.line;
@@ -79,6 +79,23 @@ static void printValue(Value* value) {
             printf(" ]");
             break;
         }
+        case VALUE_TYPE_DEQUE: {
+            ObjectDeque* deque = AS_DEQUE(value);
+            if (deque->size == 0) {
+                printf("Deque[]");
+                break;
+            }
+
+            printf("Deque[ ");
+            for (uint32_t j = 0; j < deque->size; j++) {
+                if (j > 0) {
+                    printf(", ");
+                }
+                printValue(semiDequeAt(deque, j));
+            }
+            printf(" ]");
+            break;
+        }
         case VALUE_TYPE_DICT: {
             ObjectDict* dict = AS_DICT(value);
             if (dict->len == 0) {
@@ -86,19 +103,33 @@ static void printValue(Value* value) {
                 break;
             }
             printf("Dict[ ");
-            uint32_t j = 0;
-            for (;;) {
-                if (IS_VALID(&dict->keys[j].key)) {
-                    printValue(&dict->keys[j].key);
-                    printf(": ");
-                    printValue(&dict->values[j]);
+            uint32_t cursor = 0;
+            TupleId tid;
+            for (uint32_t j = 0; (tid = semiDictNextTupleId(dict, &cursor)) >= 0; j++) {
+                if (j > 0) {
+                    printf(", ");
                 }
-                j++;
-                if (j < dict->len) {
+                printValue(&dict->keys[tid].key);
+                printf(": ");
+                printValue(&dict->values[tid]);
+            }
+            printf(" ]");
+            break;
+        }
+        case VALUE_TYPE_SET: {
+            ObjectSet* set = AS_SET(value);
+            if (set->len == 0) {
+                printf("Set[]");
+                break;
+            }
+            printf("Set[ ");
+            uint32_t cursor = 0;
+            TupleId tid;
+            for (uint32_t j = 0; (tid = semiDictNextTupleId(set, &cursor)) >= 0; j++) {
+                if (j > 0) {
                     printf(", ");
-                } else {
-                    break;
                 }
+                printValue(&set->keys[tid].key);
             }
             printf(" ]");
             break;
@@ -128,17 +159,14 @@ ErrorId printFunction(SemiVM* vm, uint8_t argCount, Value* args, Value* ret) {
     return 0;
 }
 
-ErrorId minFunction(SemiVM* vm, uint8_t argCount, Value* args, Value* ret) {
-    if (argCount == 0) {
-        return SEMI_ERROR_INVALID_VALUE;
-    }
+static ErrorId minOfValues(SemiVM* vm, uint32_t count, Value* items, Value* ret) {
     ErrorId err;
-    Value* minItem             = &args[0];
+    Value* minItem             = &items[0];
     MagicMethodsTable* methods = semiVMGetMagicMethodsTable(vm, minItem);
     Value cmpResult;
 
-    for (uint8_t i = 1; i < argCount; i++) {
-        Value* item = &args[i];
+    for (uint32_t i = 1; i < count; i++) {
+        Value* item = &items[i];
         if ((err = methods->comparisonMethods->lt(&vm->gc, &cmpResult, item, minItem)) != 0) {
             return err;
         }
@@ -152,30 +180,135 @@ ErrorId minFunction(SemiVM* vm, uint8_t argCount, Value* args, Value* ret) {
     return 0;
 }
 
-ErrorId maxFunction(SemiVM* vm, uint8_t argCount, Value* args, Value* ret) {
-    if (argCount == 0) {
-        return SEMI_ERROR_INVALID_VALUE;
-    }
+static ErrorId maxOfValues(SemiVM* vm, uint32_t count, Value* items, Value* ret) {
     ErrorId err;
-    Value* minItem             = &args[0];
-    MagicMethodsTable* methods = semiVMGetMagicMethodsTable(vm, minItem);
+    Value* maxItem             = &items[0];
+    MagicMethodsTable* methods = semiVMGetMagicMethodsTable(vm, maxItem);
     Value cmpResult;
 
-    for (uint8_t i = 1; i < argCount; i++) {
-        Value* item = &args[i];
-        if ((err = methods->comparisonMethods->gt(&vm->gc, &cmpResult, item, minItem)) != 0) {
+    for (uint32_t i = 1; i < count; i++) {
+        Value* item = &items[i];
+        if ((err = methods->comparisonMethods->gt(&vm->gc, &cmpResult, item, maxItem)) != 0) {
             return err;
         }
 
         if (AS_BOOL(&cmpResult)) {
-            minItem = item;
-            methods = semiVMGetMagicMethodsTable(vm, minItem);
+            maxItem = item;
+            methods = semiVMGetMagicMethodsTable(vm, maxItem);
         }
     }
-    *ret = *minItem;
+    *ret = *maxItem;
     return 0;
 }
 
+// `min(list)` runs the numeric kernel when the list is homogeneous and falls back to comparing elements otherwise.
+// `min(a, b, ...)` compares the arguments.
+ErrorId minFunction(SemiVM* vm, uint8_t argCount, Value* args, Value* ret) {
+    if (argCount == 0) {
+        return SEMI_ERROR_INVALID_VALUE;
+    }
+    if (argCount == 1 && IS_LIST(&args[0])) {
+        ObjectList* list = AS_LIST(&args[0]);
+        if (list->size == 0) {
+            return SEMI_ERROR_INVALID_VALUE;
+        }
+        return semiListMin(list, ret) ? 0 : minOfValues(vm, list->size, list->values, ret);
+    }
+    return minOfValues(vm, argCount, args, ret);
+}
+
+ErrorId maxFunction(SemiVM* vm, uint8_t argCount, Value* args, Value* ret) {
+    if (argCount == 0) {
+        return SEMI_ERROR_INVALID_VALUE;
+    }
+    if (argCount == 1 && IS_LIST(&args[0])) {
+        ObjectList* list = AS_LIST(&args[0]);
+        if (list->size == 0) {
+            return SEMI_ERROR_INVALID_VALUE;
+        }
+        return semiListMax(list, ret) ? 0 : maxOfValues(vm, list->size, list->values, ret);
+    }
+    return maxOfValues(vm, argCount, args, ret);
+}
+
+ErrorId sumFunction(SemiVM* vm, uint8_t argCount, Value* args, Value* ret) {
+    if (argCount != 1 || !IS_LIST(&args[0])) {
+        return SEMI_ERROR_INVALID_VALUE;
+    }
+
+    ObjectList* list = AS_LIST(&args[0]);
+    if (semiListSum(list, ret)) {
+        return 0;
+    }
+
+    ErrorId err;
+    Value acc = semiValueIntCreate(0);
+    for (uint32_t i = 0; i < list->size; i++) {
+        MagicMethodsTable* methods = semiVMGetMagicMethodsTable(vm, &acc);
+        if ((err = methods->numericMethods->add(&vm->gc, &acc, &acc, &list->values[i])) != 0) {
+            return err;
+        }
+    }
+    *ret = acc;
+    return 0;
+}
+
+ErrorId dotFunction(SemiVM* vm, uint8_t argCount, Value* args, Value* ret) {
+    (void)vm;
+    if (argCount != 2 || !IS_LIST(&args[0]) || !IS_LIST(&args[1])) {
+        return SEMI_ERROR_INVALID_VALUE;
+    }
+    return semiListDot(AS_LIST(&args[0]), AS_LIST(&args[1]), ret) ? 0 : SEMI_ERROR_UNEXPECTED_TYPE;
+}
+
+static ErrorId magicLessThan(void* context, Value* a, Value* b, bool* ret) {
+    SemiVM* vm                 = (SemiVM*)context;
+    MagicMethodsTable* methods = semiVMGetMagicMethodsTable(vm, a);
+    Value cmpResult;
+
+    ErrorId err = methods->comparisonMethods->lt(&vm->gc, &cmpResult, a, b);
+    if (err == 0) {
+        *ret = AS_BOOL(&cmpResult);
+    }
+    return err;
+}
+
+// `sort(list)` sorts the list in place and returns it. `sort(list, key)` orders elements by `key(element)`, calling the
+// key function once per element. Only native key functions are supported since the VM cannot yet re-enter script code
+// from a native call.
+ErrorId sortFunction(SemiVM* vm, uint8_t argCount, Value* args, Value* ret) {
+    if (argCount < 1 || argCount > 2 || !IS_LIST(&args[0])) {
+        return SEMI_ERROR_INVALID_VALUE;
+    }
+
+    ObjectList* list = AS_LIST(&args[0]);
+    *ret             = args[0];
+    if (argCount == 1) {
+        return semiListSort(&vm->gc, list, magicLessThan, vm);
+    }
+
+    if (!IS_NATIVE_FUNCTION(&args[1])) {
+        return SEMI_ERROR_UNIMPLEMENTED_FEATURE;
+    }
+
+    NativeFunction* keyFunction = AS_NATIVE_FUNCTION(&args[1]);
+    semiListEnsureUnique(&vm->gc, list);
+    Value* keys = (Value*)semiMalloc(&vm->gc, sizeof(Value) * list->size);
+    if (keys == NULL && list->size > 0) {
+        return SEMI_ERROR_MEMORY_ALLOCATION_FAILURE;
+    }
+
+    ErrorId err = 0;
+    for (uint32_t i = 0; i < list->size && err == 0; i++) {
+        err = keyFunction(vm, 1, &list->values[i], &keys[i]);
+    }
+    if (err == 0) {
+        err = semiValuesSort(&vm->gc, keys, list->values, list->size, magicLessThan, vm);
+    }
+    semiFree(&vm->gc, keys, sizeof(Value) * list->size);
+    return err;
+}
+
 ErrorId appendFunction(SemiVM* vm, uint8_t argCount, Value* args, Value* ret) {
     (void)ret;
     if (argCount < 2) {
@@ -197,6 +330,36 @@ ErrorId appendFunction(SemiVM* vm, uint8_t argCount, Value* args, Value* ret) {
     return methods->collectionMethods->extend(&vm->gc, listValue, &temp);
 }
 
+ErrorId popFunction(SemiVM* vm, uint8_t argCount, Value* args, Value* ret) {
+    if (argCount != 1) {
+        return SEMI_ERROR_INVALID_VALUE;
+    }
+
+    MagicMethodsTable* methods = semiVMGetMagicMethodsTable(vm, &args[0]);
+    return methods->collectionMethods->pop(&vm->gc, ret, &args[0]);
+}
+
+ErrorId pushFrontFunction(SemiVM* vm, uint8_t argCount, Value* args, Value* ret) {
+    (void)ret;
+    if (argCount < 2 || !IS_DEQUE(&args[0])) {
+        return SEMI_ERROR_INVALID_VALUE;
+    }
+
+    ObjectDeque* deque = AS_DEQUE(&args[0]);
+    for (uint8_t i = 1; i < argCount; i++) {
+        semiDequePushFront(&vm->gc, deque, args[i]);
+    }
+    return 0;
+}
+
+ErrorId popFrontFunction(SemiVM* vm, uint8_t argCount, Value* args, Value* ret) {
+    (void)vm;
+    if (argCount != 1 || !IS_DEQUE(&args[0])) {
+        return SEMI_ERROR_INVALID_VALUE;
+    }
+    return semiDequePopFront(AS_DEQUE(&args[0]), ret) ? 0 : SEMI_ERROR_INDEX_OOB;
+}
+
 ErrorId lenFunction(SemiVM* vm, uint8_t argCount, Value* args, Value* ret) {
     if (argCount != 1) {
         return SEMI_ERROR_INVALID_VALUE;
@@ -208,12 +371,18 @@ ErrorId lenFunction(SemiVM* vm, uint8_t argCount, Value* args, Value* ret) {
 }
 
 static const builtInFunctions builtInFunctionList[] = {
-    { "print",  printFunction},
-    {   "now",    nowFunction},
-    {   "min",    minFunction},
-    {   "max",    maxFunction},
-    {"append", appendFunction},
-    {   "len",    lenFunction},
+    {    "print",     printFunction},
+    {      "now",       nowFunction},
+    {      "min",       minFunction},
+    {      "max",       maxFunction},
+    {      "sum",       sumFunction},
+    {      "dot",       dotFunction},
+    {     "sort",      sortFunction},
+    {   "append",    appendFunction},
+    {      "pop",       popFunction},
+    {"pushFront", pushFrontFunction},
+    { "popFront",  popFrontFunction},
+    {      "len",       lenFunction},
 };
 
 ErrorId compileAndRunInternal(SemiVM* vm, const char* source, unsigned int length) {
@@ -15,6 +15,7 @@
 #define SEMI_ERROR_UNIMPLEMENTED_FEATURE     4
 #define SEMI_ERROR_UNEXPECTED_END_OF_FILE    5
 #define SEMI_ERROR_MODULE_NOT_FOUND          6
+#define SEMI_ERROR_SOURCE_READ_FAILURE       7
 
 //
 // LEX ERROR
@@ -55,6 +56,8 @@
 #define SEMI_ERROR_RETURN_VALUE_IN_DEFER          (SEMI_COMPILER_ERROR_BASE + 23)
 #define SEMI_ERROR_UNDEFINED_TYPE                 (SEMI_COMPILER_ERROR_BASE + 24)
 #define SEMI_ERROR_MISSING_RETURN_STATEMENT       (SEMI_COMPILER_ERROR_BASE + 25)
+#define SEMI_ERROR_UNKNOWN_FIELD                  (SEMI_COMPILER_ERROR_BASE + 26)
+#define SEMI_ERROR_MISSING_FIELD                  (SEMI_COMPILER_ERROR_BASE + 27)
 
 //
 // VM ERROR
@@ -75,6 +78,7 @@
 #define SEMI_ERROR_MISSING_RETURN_VALUE   (SEMI_VM_ERROR_BASE + 14)
 #define SEMI_ERROR_TOO_MANY_DEFER_CALLS   (SEMI_VM_ERROR_BASE + 15)
 #define SEMI_ERROR_INVALID_FUNCTION_PROTO (SEMI_VM_ERROR_BASE + 16)
+#define SEMI_ERROR_UNKNOWN_ATTRIBUTE      (SEMI_VM_ERROR_BASE + 17)
 
 typedef unsigned int ErrorId;
 
@@ -120,14 +120,96 @@ typedef struct SemiRuntimeErrorDetails {
 // Compiles the source code of a module. On success, add the module to the VM's module
 // list.
 //
+// Adding a module with the name of one already added recompiles it in place, e.g. to reload it. The
+// functions whose source and dependencies are unchanged are reused, and the functions, constants and
+// variables the new source no longer has are dropped once no value of the VM can reach them. A
+// variable may turn into an export or back. A struct type may be declared again only with the same
+// fields, as its instances keep their layout, and it stays registered when the new source drops it.
+//
 // TODO: If `transitive` is `true`, modules transistively imported by this module will also be
 // compiled and added to the VM's module list using a BFS approach.
 SEMI_EXPORT ErrorId semiVMAddModule(SemiVM* vm, SemiModuleSource moduleSource, bool transitive);
 
+// Reads the next chunk of the source of a module into `buffer`, which has room for `capacity` bytes, and returns the
+// number of bytes read. Returns 0 at the end of the source, or `SEMI_SOURCE_READ_FAILURE` if the source can't be read.
+typedef size_t (*SemiSourceReadFn)(char* buffer, size_t capacity, void* readUserData);
+
+#define SEMI_SOURCE_READ_FAILURE ((size_t)-1)
+
+typedef struct SemiModuleReader {
+    // Called repeatedly until the whole source is read. A chunk can end anywhere, including inside a token or a UTF-8
+    // sequence.
+    SemiSourceReadFn readFn;
+
+    // User-defined data to pass to the read function.
+    void* readUserData;
+
+    // The name of the module, with the same requirements as `SemiModuleSource::name`.
+    const char* name;
+
+    // The length of the module name.
+    uint8_t nameLength;
+} SemiModuleReader;
+
+// Same as `semiVMAddModule()`, but the source is pulled from the reader in chunks and compiled as it is read, so the
+// host doesn't need to know its length or hold all of it. The VM only keeps the line being compiled and the chunk
+// after it. As the whole source is never available, the module is compiled without the optimizations that look
+// ahead in it (constant propagation, inlining and loop-invariant code motion), and without the compile cache.
+SEMI_EXPORT ErrorId semiVMAddModuleFromReader(SemiVM* vm, SemiModuleReader reader, bool transitive);
+
 // Runs the module with the given name. The module must have been added to the VM using
 // `semiVMAddModule()`.
 SEMI_EXPORT ErrorId semiRunModule(SemiVM* vm, const char* moduleName, uint8_t moduleNameLength);
 
+// A cache of compiled modules, keyed by the content of their source, the name of the module, the version of Semi and
+// the compiler configuration. VMs in the same process can share a cache: adding a module whose source was compiled
+// before by a VM in the same state (the same identifiers, struct types and global variables) copies the compiled module
+// instead of compiling the source again. The source and name are compared on every hit, so a key collision is a miss.
+//
+// Only the first compilation of a module name in a VM goes through the cache. Adding a module with the name of one
+// already added, e.g. a REPL compiling every input into the same module or a host reloading a module, recompiles it in
+// place as described at `semiVMAddModule()`, and neither looks up nor stores anything.
+//
+// A cache is not thread-safe, and must outlive the VMs using it.
+typedef struct SemiCompileCache SemiCompileCache;
+
+// Creates an empty compile cache, which allocates memory with the allocation function of the configuration. When
+// `NULL` is passed, the default configuration is used.
+SEMI_EXPORT SemiCompileCache* semiCreateCompileCache(SemiVMConfig* config);
+
+// Free the compile cache and all modules in it.
+SEMI_EXPORT void semiDestroyCompileCache(SemiCompileCache* cache);
+
+// Makes the VM look up the modules it adds in the cache before compiling them, and store the modules it compiles in
+// the cache. When `NULL` is passed, the VM stops using a cache.
+SEMI_EXPORT void semiVMSetCompileCache(SemiVM* vm, SemiCompileCache* cache);
+
+// Loads the bytes stored for `key` by `SemiCompileCacheStoreFn`. Points `*data` at them and returns their size, or
+// returns 0 if nothing is stored for the key. The bytes only need to stay valid until the function is called again.
+typedef size_t (*SemiCompileCacheLoadFn)(uint64_t key, const void** data, void* storageUserData);
+
+// Stores the bytes of a module the cache has just added under `key`. The bytes are only valid during the call.
+typedef void (*SemiCompileCacheStoreFn)(uint64_t key, const void* data, size_t size, void* storageUserData);
+
+// A second level behind the memory of a compile cache, e.g. files on disk, so that compiled modules outlive the
+// process. The stored bytes are opaque and only readable by the same version of Semi on the same platform. Bytes
+// that are truncated or malformed are ignored, so a storage doesn't need to validate them. The compiled code in them
+// is run as is, though, so a storage must not be writable by anyone the host doesn't trust.
+typedef struct SemiCompileCacheStorage {
+    // Called when a module isn't in the memory of the cache.
+    SemiCompileCacheLoadFn loadFn;
+
+    // Called for every module stored in the memory of the cache.
+    SemiCompileCacheStoreFn storeFn;
+
+    // User-defined data to pass to the storage functions.
+    void* storageUserData;
+} SemiCompileCacheStorage;
+
+// Makes the cache load modules it misses from the storage, and store the modules it adds there. When `NULL` is
+// passed, the cache only keeps modules in memory.
+SEMI_EXPORT void semiCompileCacheSetStorage(SemiCompileCache* cache, const SemiCompileCacheStorage* storage);
+
 /* TODO: Snapshot the VM state for quick resuming later.
 
 ErrorId semiVMSnapshot(SemiVM* vm, void** snapshot, size_t* size);
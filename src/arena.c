@@ -0,0 +1,94 @@
+// Copyright (c) 2025 Ian Chen
+// SPDX-License-Identifier: MPL-2.0
+
+#include "./arena.h"
+
+#include <string.h>
+
+#define ARENA_BLOCK_SIZE 16384
+#define ARENA_ALIGNMENT  _Alignof(max_align_t)
+
+struct ArenaBlock {
+    ArenaBlock* prev;
+    size_t size;
+    size_t used;
+};
+
+static inline size_t alignSize(size_t size) {
+    return (size + ARENA_ALIGNMENT - 1) & ~(size_t)(ARENA_ALIGNMENT - 1);
+}
+
+static inline char* blockData(ArenaBlock* block) {
+    return (char*)block + alignSize(sizeof(ArenaBlock));
+}
+
+static void freeBlock(GC* gc, ArenaBlock* block) {
+    semiFree(gc, block, alignSize(sizeof(ArenaBlock)) + block->size);
+}
+
+void semiArenaInit(Arena* arena) {
+    arena->head = NULL;
+}
+
+void semiArenaCleanup(GC* gc, Arena* arena) {
+    semiArenaRelease(gc, arena, (ArenaMark){.block = NULL, .used = 0});
+}
+
+void* semiArenaAlloc(GC* gc, Arena* arena, size_t size) {
+    size              = alignSize(size);
+    ArenaBlock* block = arena->head;
+    if (block == NULL || block->size - block->used < size) {
+        // The rest of the current block is left unused.
+        size_t blockSize = size > ARENA_BLOCK_SIZE ? size : ARENA_BLOCK_SIZE;
+        block            = semiMalloc(gc, alignSize(sizeof(ArenaBlock)) + blockSize);
+        if (block == NULL) {
+            return NULL;
+        }
+        block->prev = arena->head;
+        block->size = blockSize;
+        block->used = 0;
+        arena->head = block;
+    }
+
+    void* ptr = blockData(block) + block->used;
+    block->used += size;
+    return ptr;
+}
+
+void* semiArenaRealloc(GC* gc, Arena* arena, void* ptr, size_t oldSize, size_t newSize) {
+    ArenaBlock* block = arena->head;
+    if (ptr != NULL && block != NULL && (char*)ptr + alignSize(oldSize) == blockData(block) + block->used) {
+        size_t offset = (size_t)((char*)ptr - blockData(block));
+        if (alignSize(newSize) <= block->size - offset) {
+            block->used = offset + alignSize(newSize);
+            return ptr;
+        }
+    }
+    if (newSize <= oldSize) {
+        return ptr;
+    }
+
+    void* newPtr = semiArenaAlloc(gc, arena, newSize);
+    if (newPtr != NULL && oldSize > 0) {
+        memcpy(newPtr, ptr, oldSize);
+    }
+    return newPtr;
+}
+
+ArenaMark semiArenaMark(const Arena* arena) {
+    return (ArenaMark){
+        .block = arena->head,
+        .used  = arena->head != NULL ? arena->head->used : 0,
+    };
+}
+
+void semiArenaRelease(GC* gc, Arena* arena, ArenaMark mark) {
+    while (arena->head != mark.block) {
+        ArenaBlock* prev = arena->head->prev;
+        freeBlock(gc, arena->head);
+        arena->head = prev;
+    }
+    if (arena->head != NULL) {
+        arena->head->used = mark.used;
+    }
+}
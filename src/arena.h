@@ -0,0 +1,109 @@
+// Copyright (c) 2025 Ian Chen
+// SPDX-License-Identifier: MPL-2.0
+
+#ifndef SEMI_ARENA_H
+#define SEMI_ARENA_H
+
+#include <stddef.h>
+
+#include "./gc.h"
+#include "semi/error.h"
+
+// A bump allocator for memory that is released all at once. Its blocks are allocated from a GC, but nothing allocated
+// in an arena is freed on its own.
+typedef struct ArenaBlock ArenaBlock;
+
+typedef struct Arena {
+    ArenaBlock* head;
+} Arena;
+
+// The state of an arena at some point, to release everything allocated after it.
+typedef struct ArenaMark {
+    ArenaBlock* block;
+    size_t used;
+} ArenaMark;
+
+void semiArenaInit(Arena* arena);
+void semiArenaCleanup(GC* gc, Arena* arena);
+
+void* semiArenaAlloc(GC* gc, Arena* arena, size_t size);
+
+// Resize an allocation. The last allocation of the arena is resized in place when its block has room, and other ones
+// are copied to a new allocation when they grow.
+void* semiArenaRealloc(GC* gc, Arena* arena, void* ptr, size_t oldSize, size_t newSize);
+
+ArenaMark semiArenaMark(const Arena* arena);
+void semiArenaRelease(GC* gc, Arena* arena, ArenaMark mark);
+
+// The dynamic array operations of DECLARE_DARRAY for arrays allocated in an arena. There is no cleanup function, as the
+// memory goes away with the arena.
+#define DECLARE_ARENA_DARRAY_OPS(NAME, ITEM_TYPE, INDEX_TYPE)                                  \
+    ErrorId NAME##ArenaEnsureCapacity(GC* gc, Arena* arena, NAME* arr, INDEX_TYPE capacity); \
+                                                                                             \
+    ErrorId NAME##ArenaAppend(GC* gc, Arena* arena, NAME* arr, ITEM_TYPE value);
+
+#define DECLARE_ARENA_DARRAY(NAME, ITEM_TYPE, INDEX_TYPE) \
+    typedef struct NAME {                                 \
+        ITEM_TYPE* data;                                  \
+        INDEX_TYPE size;                                  \
+        INDEX_TYPE capacity;                              \
+    } NAME;                                               \
+                                                          \
+    void NAME##Init(NAME* arr);                           \
+                                                          \
+    DECLARE_ARENA_DARRAY_OPS(NAME, ITEM_TYPE, INDEX_TYPE)
+
+#define DEFINE_ARENA_DARRAY_OPS(NAME, ITEM_TYPE, INDEX_TYPE, MAX_CAPACITY)                                       \
+                                                                                                                 \
+    ErrorId NAME##ArenaEnsureCapacity(GC* gc, Arena* arena, NAME* arr, INDEX_TYPE capacity) {                    \
+        if (arr->capacity >= capacity) {                                                                         \
+            return 0;                                                                                            \
+        }                                                                                                        \
+                                                                                                                 \
+        if (capacity > MAX_CAPACITY) {                                                                           \
+            return SEMI_ERROR_REACH_ALLOCATION_LIMIT;                                                            \
+        }                                                                                                        \
+                                                                                                                 \
+        INDEX_TYPE new_capacity = arr->capacity == 0 ? 8 : arr->capacity;                                        \
+        while (new_capacity < capacity && new_capacity <= MAX_CAPACITY / 2) {                                    \
+            new_capacity *= 2;                                                                                   \
+        }                                                                                                        \
+        if (new_capacity < capacity || new_capacity > MAX_CAPACITY) {                                            \
+            new_capacity = MAX_CAPACITY;                                                                         \
+        }                                                                                                        \
+                                                                                                                 \
+        ITEM_TYPE* temp = semiArenaRealloc(                                                                      \
+            gc, arena, arr->data, arr->capacity * sizeof(ITEM_TYPE), new_capacity * sizeof(ITEM_TYPE));          \
+        if (temp == NULL) {                                                                                      \
+            return SEMI_ERROR_MEMORY_ALLOCATION_FAILURE;                                                         \
+        }                                                                                                        \
+        arr->data     = temp;                                                                                    \
+        arr->capacity = new_capacity;                                                                            \
+        return 0;                                                                                                \
+    }                                                                                                            \
+                                                                                                                 \
+    ErrorId NAME##ArenaAppend(GC* gc, Arena* arena, NAME* arr, ITEM_TYPE value) {                                \
+        if (arr->size >= arr->capacity) {                                                                        \
+            if (arr->capacity == MAX_CAPACITY) {                                                                 \
+                return SEMI_ERROR_REACH_ALLOCATION_LIMIT;                                                        \
+            }                                                                                                    \
+            ErrorId errId = NAME##ArenaEnsureCapacity(gc, arena, arr, (INDEX_TYPE)(arr->size + 1));              \
+            if (errId != 0) {                                                                                    \
+                return errId;                                                                                    \
+            }                                                                                                    \
+        }                                                                                                        \
+        arr->data[arr->size++] = value;                                                                          \
+        return 0;                                                                                                \
+    }
+
+#define DEFINE_ARENA_DARRAY(NAME, ITEM_TYPE, INDEX_TYPE, MAX_CAPACITY) \
+                                                                       \
+    void NAME##Init(NAME* arr) {                                       \
+        arr->data     = NULL;                                          \
+        arr->size     = 0;                                             \
+        arr->capacity = 0;                                             \
+    }                                                                  \
+                                                                       \
+    DEFINE_ARENA_DARRAY_OPS(NAME, ITEM_TYPE, INDEX_TYPE, MAX_CAPACITY)
+
+#endif /* SEMI_ARENA_H */
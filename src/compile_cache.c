@@ -0,0 +1,805 @@
+// Copyright (c) 2025 Ian Chen
+// SPDX-License-Identifier: MPL-2.0
+
+#include "./compile_cache.h"
+
+#include <string.h>
+
+#include "./const_table.h"
+#include "./primitives.h"
+#include "./types.h"
+#include "./value.h"
+
+DEFINE_DARRAY(IdentifierIdList, IdentifierId, uint32_t, UINT32_MAX)
+
+// Cached modules are copied into and out of the cache the same way. Only the objects the compiler puts into the
+// constant table are supported, and a module whose dicts had entries deleted can't be copied, since the ids of module
+// variables are the positions of their tuples.
+
+static FunctionProto* copyFunctionProto(GC* gc, const FunctionProto* source, ModuleId moduleId) {
+    FunctionProto* fn = semiFunctionProtoCreate(gc, source->upvalueCount);
+    if (fn == NULL) {
+        return NULL;
+    }
+
+    if (ChunkEnsureCapacity(gc, &fn->chunk, source->chunk.size) != 0) {
+        goto failure;
+    }
+    memcpy(fn->chunk.data, source->chunk.data, sizeof(Instruction) * source->chunk.size);
+    fn->chunk.size = source->chunk.size;
+
+    if (source->attrCacheCount > 0) {
+        fn->attrCaches = semiMalloc(gc, sizeof(AttrCache) * source->attrCacheCount);
+        if (fn->attrCaches == NULL) {
+            goto failure;
+        }
+        memcpy(fn->attrCaches, source->attrCaches, sizeof(AttrCache) * source->attrCacheCount);
+        fn->attrCacheCount = source->attrCacheCount;
+    }
+
+    fn->moduleId     = moduleId;
+    fn->arity        = source->arity;
+    fn->coarity      = source->coarity;
+    fn->maxStackSize = source->maxStackSize;
+    memcpy(fn->upvalues, source->upvalues, sizeof(UpvalueDescription) * source->upvalueCount);
+    return fn;
+
+failure:
+    semiFunctionProtoDestroy(gc, fn);
+    return NULL;
+}
+
+static bool copyConstant(GC* gc, Value value, ModuleId moduleId, Value* copy) {
+    switch (VALUE_TYPE(&value)) {
+        case VALUE_TYPE_OBJECT_STRING:
+            *copy = semiValueStringCreate(gc, AS_OBJECT_STRING(&value)->str, AS_OBJECT_STRING(&value)->length);
+            return IS_VALID(copy);
+
+        case VALUE_TYPE_OBJECT_INT_RANGE:
+        case VALUE_TYPE_OBJECT_FLOAT_RANGE: {
+            ObjectRange* range = semiObjectRangeCopy(gc, AS_OBJECT_RANGE(&value));
+            *copy              = OBJECT_VALUE(range, VALUE_TYPE(&value));
+            return range != NULL;
+        }
+
+        case VALUE_TYPE_FUNCTION_PROTO: {
+            FunctionProto* fn = copyFunctionProto(gc, AS_FUNCTION_PROTO(&value), moduleId);
+            *copy             = semiValueFunctionProtoCreate(fn);
+            return fn != NULL;
+        }
+
+        default:
+            *copy = value;
+            return (VALUE_TYPE(&value) & VALUE_HEADER_OBJECT_MASK) == 0;
+    }
+}
+
+static bool copyConstants(GC* gc, ConstantTable* target, const ConstantTable* source, ModuleId moduleId) {
+    for (ConstantIndex i = 0; i < semiConstantTableSize(source); i++) {
+        Value constant;
+        if (!copyConstant(gc, semiConstantTableGet(source, i), moduleId, &constant)) {
+            return false;
+        }
+        if (semiConstantTableInsert(target, constant) != i) {
+            if (IS_FUNCTION_PROTO(&constant)) {
+                semiFunctionProtoDestroy(gc, AS_FUNCTION_PROTO(&constant));
+            }
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool copyDict(GC* gc, ObjectDict* target, const ObjectDict* source) {
+    if (source->used != source->len) {
+        return false;
+    }
+    for (uint32_t i = 0; i < source->used; i++) {
+        if (!semiDictSetWithHash(gc, target, source->keys[i].key, source->values[i], source->keys[i].hash)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static SemiModule* copyModule(GC* gc, const SemiModule* source, ModuleId moduleId) {
+    SemiModule* module = semiVMModuleCreate(gc, moduleId);
+    if (module == NULL) {
+        return NULL;
+    }
+
+    if (!copyDict(gc, &module->exports, &source->exports) || !copyDict(gc, &module->globals, &source->globals) ||
+        !copyDict(gc, &module->types, &source->types) ||
+        !copyConstants(gc, &module->constantTable, &source->constantTable, moduleId) ||
+        (module->moduleInit = copyFunctionProto(gc, source->moduleInit, moduleId)) == NULL) {
+        semiVMModuleDestroy(gc, module);
+        return NULL;
+    }
+
+    module->peepholeRemovedCount    = source->peepholeRemovedCount;
+    module->inlinedCallCount        = source->inlinedCallCount;
+    module->hoistedInstructionCount = source->hoistedInstructionCount;
+    return module;
+}
+
+static void destroyCachedModule(GC* gc, CachedModule* cached) {
+    semiFree(gc, cached->name, cached->nameLength);
+    semiFree(gc, cached->source, cached->sourceLength);
+    semiFree(gc, cached->identifiers, cached->identifiersSize);
+    IdentifierIdListCleanup(gc, &cached->structTypes);
+    if (cached->module != NULL) {
+        semiVMModuleDestroy(gc, cached->module);
+    }
+    semiFree(gc, cached, sizeof(CachedModule));
+}
+
+static bool recordIdentifiers(GC* gc, SymbolTable* symbolTable, CachedModule* cached) {
+    size_t size = 0;
+    for (IdentifierId id = cached->environment.nextIdentifierId; id < symbolTable->nextId; id++) {
+        size += 1 + semiSymbolTableLength(semiSymbolTableGetById(symbolTable, id));
+    }
+    if (size == 0) {
+        return true;
+    }
+    if (size > UINT32_MAX || (cached->identifiers = semiMalloc(gc, size)) == NULL) {
+        return false;
+    }
+
+    char* next = cached->identifiers;
+    for (IdentifierId id = cached->environment.nextIdentifierId; id < symbolTable->nextId; id++) {
+        InternedChar* identifier = semiSymbolTableGetById(symbolTable, id);
+        IdentifierLength length  = semiSymbolTableLength(identifier);
+        *next++                  = (char)length;
+        memcpy(next, identifier, length);
+        next += length;
+    }
+    cached->identifiersSize = (uint32_t)size;
+    return true;
+}
+
+static bool replayIdentifiers(SymbolTable* symbolTable, const CachedModule* cached) {
+    IdentifierId expectedId = cached->environment.nextIdentifierId;
+    for (uint32_t offset = 0; offset < cached->identifiersSize; expectedId++) {
+        IdentifierLength length  = (IdentifierLength)cached->identifiers[offset];
+        InternedChar* identifier = semiSymbolTableInsert(symbolTable, cached->identifiers + offset + 1, length);
+        if (identifier == NULL || semiSymbolTableGetId(identifier) != expectedId) {
+            return false;
+        }
+        offset += 1 + length;
+    }
+    return true;
+}
+
+static bool recordStructTypes(GC* gc, ClassTable* classes, CachedModule* cached) {
+    IdentifierIdList* types = &cached->structTypes;
+    for (TypeId typeId = cached->environment.classCount; typeId < classes->classCount; typeId++) {
+        StructType* type = semiPrimitivesGetStructType(classes, typeId);
+        if (IdentifierIdListAppend(gc, types, semiSymbolTableGetId(type->name)) != 0 ||
+            IdentifierIdListAppend(gc, types, (IdentifierId)type->fieldCount) != 0) {
+            return false;
+        }
+        for (size_t i = 0; i < type->fieldCount; i++) {
+            if (IdentifierIdListAppend(gc, types, semiSymbolTableGetId(type->fields[i].name)) != 0) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+static bool replayStructTypes(SemiVM* vm, const CachedModule* cached) {
+    const IdentifierIdList* types = &cached->structTypes;
+    TypeId expectedTypeId         = cached->environment.classCount;
+    for (uint32_t i = 0; i < types->size; expectedTypeId++) {
+        InternedChar* name = semiSymbolTableGetById(&vm->symbolTable, types->data[i]);
+        size_t fieldCount  = types->data[i + 1];
+        StructField fields[MAX_STRUCT_FIELD_COUNT];
+        for (size_t j = 0; j < fieldCount; j++) {
+            fields[j] = (StructField){
+                .name = semiSymbolTableGetById(&vm->symbolTable, types->data[i + 2 + j]),
+                .type = NULL,
+            };
+            if (fields[j].name == NULL) {
+                return false;
+            }
+        }
+
+        TypeId typeId;
+        if (name == NULL ||
+            semiPrimitivesAddStructType(&vm->gc, &vm->classes, name, fields, fieldCount, &typeId) != 0 ||
+            typeId != expectedTypeId) {
+            return false;
+        }
+        i += 2 + (uint32_t)fieldCount;
+    }
+    return true;
+}
+
+static CachedModule* createCachedModule(GC* gc) {
+    CachedModule* cached = semiMalloc(gc, sizeof(CachedModule));
+    if (cached == NULL) {
+        return NULL;
+    }
+    *cached = (CachedModule){0};
+    IdentifierIdListInit(&cached->structTypes);
+    return cached;
+}
+
+static char* copyBytes(GC* gc, const char* bytes, size_t size) {
+    char* copy = size > 0 ? semiMalloc(gc, size) : NULL;
+    if (copy != NULL) {
+        memcpy(copy, bytes, size);
+    }
+    return copy;
+}
+
+static bool isSameSource(const CachedModule* cached, const SemiModuleSource* moduleSource, uint32_t configuration) {
+    return cached->configuration == configuration && cached->nameLength == moduleSource->nameLength &&
+           cached->sourceLength == moduleSource->length &&
+           memcmp(cached->name, moduleSource->name, cached->nameLength) == 0 &&
+           (cached->sourceLength == 0 || memcmp(cached->source, moduleSource->source, cached->sourceLength) == 0);
+}
+
+// A cached module is stored as the fields of the CachedModule, in the order of their declarations, followed by its
+// module. Values without objects are stored as their bits, which is why the bytes are only readable by the same build
+// on the same platform.
+
+#define CACHED_MODULE_MAGIC 0x434D4553u  // "SEMC"
+
+DECLARE_DARRAY(ByteList, char, uint32_t)
+DEFINE_DARRAY(ByteList, char, uint32_t, UINT32_MAX)
+
+typedef struct ByteWriter {
+    GC* gc;
+    ByteList bytes;
+    bool failed;
+} ByteWriter;
+
+typedef struct ByteReader {
+    const char* data;
+    size_t size;
+    size_t offset;
+    bool failed;
+} ByteReader;
+
+static void writeBytes(ByteWriter* writer, const void* bytes, size_t size) {
+    if (writer->failed || size == 0) {
+        return;
+    }
+    if (size > UINT32_MAX - writer->bytes.size ||
+        ByteListEnsureCapacity(writer->gc, &writer->bytes, writer->bytes.size + (uint32_t)size) != 0) {
+        writer->failed = true;
+        return;
+    }
+    memcpy(writer->bytes.data + writer->bytes.size, bytes, size);
+    writer->bytes.size += (uint32_t)size;
+}
+
+static bool readBytes(ByteReader* reader, void* bytes, size_t size) {
+    if (reader->failed || size > reader->size - reader->offset) {
+        reader->failed = true;
+        return false;
+    }
+    memcpy(bytes, reader->data + reader->offset, size);
+    reader->offset += size;
+    return true;
+}
+
+#define WRITE_FIELD(writer, field) writeBytes((writer), &(field), sizeof(field))
+#define READ_FIELD(reader, field)  readBytes((reader), &(field), sizeof(field))
+
+static char* readCopy(GC* gc, ByteReader* reader, size_t size) {
+    if (reader->failed || size > reader->size - reader->offset) {
+        reader->failed = true;
+        return NULL;
+    }
+    char* copy = copyBytes(gc, reader->data + reader->offset, size);
+    if (size > 0 && copy == NULL) {
+        reader->failed = true;
+    }
+    reader->offset += size;
+    return copy;
+}
+
+static void writePlainValue(ByteWriter* writer, Value value) {
+    if ((VALUE_TYPE(&value) & VALUE_HEADER_OBJECT_MASK) != 0) {
+        writer->failed = true;
+        return;
+    }
+    WRITE_FIELD(writer, value.header);
+    WRITE_FIELD(writer, value.as);
+}
+
+static Value readPlainValue(ByteReader* reader) {
+    Value value;
+    READ_FIELD(reader, value.header);
+    READ_FIELD(reader, value.as);
+    if ((VALUE_TYPE(&value) & VALUE_HEADER_OBJECT_MASK) != 0) {
+        reader->failed = true;
+    }
+    return value;
+}
+
+static void writeFunctionProto(ByteWriter* writer, const FunctionProto* fn) {
+    WRITE_FIELD(writer, fn->upvalueCount);
+    WRITE_FIELD(writer, fn->arity);
+    WRITE_FIELD(writer, fn->coarity);
+    WRITE_FIELD(writer, fn->maxStackSize);
+    WRITE_FIELD(writer, fn->chunk.size);
+    writeBytes(writer, fn->chunk.data, sizeof(Instruction) * fn->chunk.size);
+    WRITE_FIELD(writer, fn->attrCacheCount);
+    writeBytes(writer, fn->attrCaches, sizeof(AttrCache) * fn->attrCacheCount);
+    writeBytes(writer, fn->upvalues, sizeof(UpvalueDescription) * fn->upvalueCount);
+}
+
+static FunctionProto* readFunctionProto(GC* gc, ByteReader* reader) {
+    uint8_t upvalueCount;
+    if (!READ_FIELD(reader, upvalueCount)) {
+        return NULL;
+    }
+    FunctionProto* fn = semiFunctionProtoCreate(gc, upvalueCount);
+    if (fn == NULL) {
+        reader->failed = true;
+        return NULL;
+    }
+
+    uint32_t chunkSize;
+    READ_FIELD(reader, fn->arity);
+    READ_FIELD(reader, fn->coarity);
+    READ_FIELD(reader, fn->maxStackSize);
+    if (!READ_FIELD(reader, chunkSize) || chunkSize > (reader->size - reader->offset) / sizeof(Instruction) ||
+        ChunkEnsureCapacity(gc, &fn->chunk, chunkSize) != 0) {
+        goto failure;
+    }
+    readBytes(reader, fn->chunk.data, sizeof(Instruction) * chunkSize);
+    fn->chunk.size = chunkSize;
+
+    uint16_t attrCacheCount;
+    if (!READ_FIELD(reader, attrCacheCount)) {
+        goto failure;
+    }
+    if (attrCacheCount > 0) {
+        fn->attrCaches = (AttrCache*)(void*)readCopy(gc, reader, sizeof(AttrCache) * attrCacheCount);
+        if (fn->attrCaches == NULL) {
+            goto failure;
+        }
+        fn->attrCacheCount = attrCacheCount;
+    }
+    if (!readBytes(reader, fn->upvalues, sizeof(UpvalueDescription) * upvalueCount)) {
+        goto failure;
+    }
+    return fn;
+
+failure:
+    reader->failed = true;
+    semiFunctionProtoDestroy(gc, fn);
+    return NULL;
+}
+
+static void writeDict(ByteWriter* writer, const ObjectDict* dict) {
+    if (dict->used != dict->len) {
+        writer->failed = true;
+        return;
+    }
+    WRITE_FIELD(writer, dict->used);
+    for (uint32_t i = 0; i < dict->used; i++) {
+        writePlainValue(writer, dict->keys[i].key);
+        writePlainValue(writer, dict->values[i]);
+        WRITE_FIELD(writer, dict->keys[i].hash);
+    }
+}
+
+static void readDict(GC* gc, ByteReader* reader, ObjectDict* dict) {
+    uint32_t count = 0;
+    READ_FIELD(reader, count);
+    for (uint32_t i = 0; i < count && !reader->failed; i++) {
+        Value key   = readPlainValue(reader);
+        Value value = readPlainValue(reader);
+        ValueHash hash;
+        if (READ_FIELD(reader, hash) && !semiDictSetWithHash(gc, dict, key, value, hash)) {
+            reader->failed = true;
+        }
+    }
+}
+
+static void writeConstant(ByteWriter* writer, Value value) {
+    WRITE_FIELD(writer, value.header);
+    switch (VALUE_TYPE(&value)) {
+        case VALUE_TYPE_OBJECT_STRING: {
+            ObjectString* string = AS_OBJECT_STRING(&value);
+            WRITE_FIELD(writer, string->length);
+            writeBytes(writer, string->str, string->length);
+            break;
+        }
+
+        case VALUE_TYPE_OBJECT_INT_RANGE:
+        case VALUE_TYPE_OBJECT_FLOAT_RANGE:
+            WRITE_FIELD(writer, AS_OBJECT_RANGE(&value)->as);
+            break;
+
+        case VALUE_TYPE_FUNCTION_PROTO:
+            writeFunctionProto(writer, AS_FUNCTION_PROTO(&value));
+            break;
+
+        default:
+            if ((VALUE_TYPE(&value) & VALUE_HEADER_OBJECT_MASK) != 0) {
+                writer->failed = true;
+            }
+            WRITE_FIELD(writer, value.as);
+            break;
+    }
+}
+
+static Value readConstant(GC* gc, ByteReader* reader) {
+    Value value = INVALID_VALUE;
+    if (!READ_FIELD(reader, value.header)) {
+        return INVALID_VALUE;
+    }
+    switch (VALUE_TYPE(&value)) {
+        case VALUE_TYPE_OBJECT_STRING: {
+            size_t length;
+            if (!READ_FIELD(reader, length) || length > reader->size - reader->offset) {
+                reader->failed = true;
+                return INVALID_VALUE;
+            }
+            value = semiValueStringCreate(gc, reader->data + reader->offset, length);
+            reader->offset += length;
+            break;
+        }
+
+        case VALUE_TYPE_OBJECT_INT_RANGE:
+        case VALUE_TYPE_OBJECT_FLOAT_RANGE: {
+            ObjectRange range;
+            if (!READ_FIELD(reader, range.as)) {
+                return INVALID_VALUE;
+            }
+            ObjectRange* copy = semiObjectRangeCopy(gc, &range);
+            value             = copy != NULL ? OBJECT_VALUE(copy, VALUE_TYPE(&value)) : INVALID_VALUE;
+            break;
+        }
+
+        case VALUE_TYPE_FUNCTION_PROTO: {
+            FunctionProto* fn = readFunctionProto(gc, reader);
+            value             = fn != NULL ? semiValueFunctionProtoCreate(fn) : INVALID_VALUE;
+            break;
+        }
+
+        default:
+            if ((VALUE_TYPE(&value) & VALUE_HEADER_OBJECT_MASK) != 0 || !READ_FIELD(reader, value.as)) {
+                reader->failed = true;
+                return INVALID_VALUE;
+            }
+            break;
+    }
+    if (IS_INVALID(&value)) {
+        reader->failed = true;
+    }
+    return value;
+}
+
+static void writeCachedModule(ByteWriter* writer, const CachedModule* cached) {
+    uint32_t magic   = CACHED_MODULE_MAGIC;
+    uint32_t version = SEMI_VERSION_NUMBER;
+    WRITE_FIELD(writer, magic);
+    WRITE_FIELD(writer, version);
+    WRITE_FIELD(writer, cached->environment);
+    WRITE_FIELD(writer, cached->configuration);
+    WRITE_FIELD(writer, cached->nameLength);
+    writeBytes(writer, cached->name, cached->nameLength);
+    WRITE_FIELD(writer, cached->sourceLength);
+    writeBytes(writer, cached->source, cached->sourceLength);
+    WRITE_FIELD(writer, cached->identifiersSize);
+    writeBytes(writer, cached->identifiers, cached->identifiersSize);
+    WRITE_FIELD(writer, cached->structTypes.size);
+    writeBytes(writer, cached->structTypes.data, sizeof(IdentifierId) * cached->structTypes.size);
+
+    const SemiModule* module = cached->module;
+    writeDict(writer, &module->exports);
+    writeDict(writer, &module->globals);
+    writeDict(writer, &module->types);
+    uint32_t constantCount = (uint32_t)semiConstantTableSize(&module->constantTable);
+    WRITE_FIELD(writer, constantCount);
+    for (ConstantIndex i = 0; i < constantCount; i++) {
+        writeConstant(writer, semiConstantTableGet(&module->constantTable, i));
+    }
+    writeFunctionProto(writer, module->moduleInit);
+    WRITE_FIELD(writer, module->peepholeRemovedCount);
+    WRITE_FIELD(writer, module->inlinedCallCount);
+    WRITE_FIELD(writer, module->hoistedInstructionCount);
+}
+
+// The identifiers and struct types of a module are replayed without bounds checks, so the ones read from storage are
+// checked here.
+static bool isReplayable(const CachedModule* cached) {
+    for (uint32_t offset = 0; offset < cached->identifiersSize;) {
+        uint32_t length = (unsigned char)cached->identifiers[offset];
+        if (length == 0 || length > cached->identifiersSize - offset - 1) {
+            return false;
+        }
+        offset += 1 + length;
+    }
+
+    const IdentifierIdList* types = &cached->structTypes;
+    for (uint32_t i = 0; i < types->size;) {
+        if (types->size - i < 2) {
+            return false;
+        }
+        IdentifierId fieldCount = types->data[i + 1];
+        if (fieldCount > MAX_STRUCT_FIELD_COUNT || fieldCount > types->size - i - 2) {
+            return false;
+        }
+        i += 2 + fieldCount;
+    }
+    return true;
+}
+
+static CachedModule* readCachedModule(GC* gc, const void* data, size_t size) {
+    ByteReader reader    = {.data = data, .size = size, .offset = 0, .failed = false};
+    uint32_t magic       = 0;
+    uint32_t version     = 0;
+    CachedModule* cached = createCachedModule(gc);
+    if (cached == NULL || !READ_FIELD(&reader, magic) || !READ_FIELD(&reader, version) ||
+        magic != CACHED_MODULE_MAGIC || version != SEMI_VERSION_NUMBER) {
+        goto failure;
+    }
+
+    READ_FIELD(&reader, cached->environment);
+    READ_FIELD(&reader, cached->configuration);
+    READ_FIELD(&reader, cached->nameLength);
+    cached->name = readCopy(gc, &reader, cached->nameLength);
+    READ_FIELD(&reader, cached->sourceLength);
+    cached->source = readCopy(gc, &reader, cached->sourceLength);
+    READ_FIELD(&reader, cached->identifiersSize);
+    cached->identifiers = readCopy(gc, &reader, cached->identifiersSize);
+
+    uint32_t structTypeCount = 0;
+    if (!READ_FIELD(&reader, structTypeCount) || structTypeCount > (size - reader.offset) / sizeof(IdentifierId) ||
+        IdentifierIdListEnsureCapacity(gc, &cached->structTypes, structTypeCount) != 0) {
+        goto failure;
+    }
+    readBytes(&reader, cached->structTypes.data, sizeof(IdentifierId) * structTypeCount);
+    cached->structTypes.size = structTypeCount;
+
+    SemiModule* module = cached->module = semiVMModuleCreate(gc, 0);
+    if (module == NULL) {
+        goto failure;
+    }
+    readDict(gc, &reader, &module->exports);
+    readDict(gc, &reader, &module->globals);
+    readDict(gc, &reader, &module->types);
+    uint32_t constantCount = 0;
+    READ_FIELD(&reader, constantCount);
+    for (ConstantIndex i = 0; i < constantCount && !reader.failed; i++) {
+        Value constant = readConstant(gc, &reader);
+        if (!reader.failed && semiConstantTableInsert(&module->constantTable, constant) != i) {
+            if (IS_FUNCTION_PROTO(&constant)) {
+                semiFunctionProtoDestroy(gc, AS_FUNCTION_PROTO(&constant));
+            }
+            reader.failed = true;
+        }
+    }
+    if (!reader.failed) {
+        module->moduleInit = readFunctionProto(gc, &reader);
+    }
+    READ_FIELD(&reader, module->peepholeRemovedCount);
+    READ_FIELD(&reader, module->inlinedCallCount);
+    READ_FIELD(&reader, module->hoistedInstructionCount);
+    if (reader.failed || reader.offset != size || !isReplayable(cached)) {
+        goto failure;
+    }
+    return cached;
+
+failure:
+    if (cached != NULL) {
+        destroyCachedModule(gc, cached);
+    }
+    return NULL;
+}
+
+// Return the cached module compiled from `moduleSource` with `configuration`, from the memory of the cache or else
+// from its storage.
+static CachedModule* findCachedModule(SemiCompileCache* cache,
+                                      uint64_t key,
+                                      const SemiModuleSource* moduleSource,
+                                      uint32_t configuration) {
+    Value keyValue = semiValueIntCreate((IntValue)key);
+    Value entry    = semiDictGet(&cache->modules, keyValue);
+    if (IS_VALID(&entry)) {
+        CachedModule* cached = AS_PTR(&entry, CachedModule);
+        return isSameSource(cached, moduleSource, configuration) ? cached : NULL;
+    }
+    if (cache->storage.loadFn == NULL) {
+        return NULL;
+    }
+
+    const void* data     = NULL;
+    size_t size          = cache->storage.loadFn(key, &data, cache->storage.storageUserData);
+    CachedModule* cached = size > 0 && data != NULL ? readCachedModule(&cache->gc, data, size) : NULL;
+    if (cached == NULL) {
+        return NULL;
+    }
+    if (!isSameSource(cached, moduleSource, configuration) ||
+        !semiDictSet(&cache->gc, &cache->modules, keyValue, semiValuePtrCreate(cached, VALUE_TYPE_UNSET))) {
+        destroyCachedModule(&cache->gc, cached);
+        return NULL;
+    }
+    return cached;
+}
+
+static void storeCachedModule(SemiCompileCache* cache, uint64_t key, const CachedModule* cached) {
+    if (cache->storage.storeFn == NULL) {
+        return;
+    }
+
+    ByteWriter writer = {.gc = &cache->gc, .failed = false};
+    ByteListInit(&writer.bytes);
+    writeCachedModule(&writer, cached);
+    if (!writer.failed) {
+        cache->storage.storeFn(key, writer.bytes.data, writer.bytes.size, cache->storage.storageUserData);
+    }
+    ByteListCleanup(&cache->gc, &writer.bytes);
+}
+
+static bool isSameEnvironment(const CompileEnvironment* a, const CompileEnvironment* b) {
+    return a->nextIdentifierId == b->nextIdentifierId && a->symbolFingerprint == b->symbolFingerprint &&
+           a->classCount == b->classCount && a->classFingerprint == b->classFingerprint &&
+           a->globalsFingerprint == b->globalsFingerprint;
+}
+
+static bool isModuleDefined(SemiVM* vm, const SemiModuleSource* moduleSource) {
+    InternedChar* name = semiSymbolTableGet(&vm->symbolTable, moduleSource->name, moduleSource->nameLength);
+    return name != NULL && semiDictHas(&vm->modules, semiValueIntCreate(semiSymbolTableGetId(name)));
+}
+
+void semiCompileEnvironmentCapture(SemiVM* vm, CompileEnvironment* environment) {
+    ClassTable* classes       = &vm->classes;
+    uint64_t classFingerprint = 0;
+    for (TypeId typeId = MIN_CUSTOM_BASE_VALUE_TYPE; typeId < classes->classCount; typeId++) {
+        StructType* type = semiPrimitivesGetStructType(classes, typeId);
+        classFingerprint = semiHash64Bits(classFingerprint ^ semiSymbolTableGetId(type->name));
+        classFingerprint = semiHash64Bits(classFingerprint ^ type->fieldCount);
+        for (size_t i = 0; i < type->fieldCount; i++) {
+            classFingerprint = semiHash64Bits(classFingerprint ^ semiSymbolTableGetId(type->fields[i].name));
+        }
+    }
+
+    uint64_t globalsFingerprint = vm->globalIdentifiers.size;
+    for (ModuleVariableId i = 0; i < vm->globalIdentifiers.size; i++) {
+        globalsFingerprint = semiHash64Bits(globalsFingerprint ^ vm->globalIdentifiers.data[i]);
+    }
+
+    environment->nextIdentifierId   = vm->symbolTable.nextId;
+    environment->symbolFingerprint  = vm->symbolTable.fingerprint;
+    environment->classCount         = classes->classCount;
+    environment->classFingerprint   = classFingerprint;
+    environment->globalsFingerprint = globalsFingerprint;
+}
+
+uint64_t semiCompileCacheKey(const SemiModuleSource* moduleSource, uint32_t configuration) {
+    uint64_t key = semiHashBytes64(moduleSource->source, moduleSource->length) ^ moduleSource->length;
+    key          = semiHash64Bits(key ^ semiHashBytes64(moduleSource->name, moduleSource->nameLength));
+    return semiHash64Bits(key ^ (((uint64_t)SEMI_VERSION_NUMBER << 32) | configuration));
+}
+
+SemiModule* semiCompileCacheLoad(SemiCompileCache* cache,
+                                 SemiVM* vm,
+                                 const SemiModuleSource* moduleSource,
+                                 uint32_t configuration,
+                                 const CompileEnvironment* environment) {
+    // A module added again is recompiled in place, which a copy can't do, so it misses before the source is hashed
+    // and the storage is read.
+    if (isModuleDefined(vm, moduleSource) || vm->modules.len >= SEMI_MAX_MODULE_COUNT) {
+        cache->missCount++;
+        return NULL;
+    }
+
+    uint64_t key         = semiCompileCacheKey(moduleSource, configuration);
+    CachedModule* cached = findCachedModule(cache, key, moduleSource, configuration);
+    if (cached == NULL || !isSameEnvironment(&cached->environment, environment)) {
+        cache->missCount++;
+        return NULL;
+    }
+
+    // The environments are the same, so the identifiers and types added again get the ids the module refers to. If
+    // that still fails, they are left behind and the module is compiled.
+    SemiModule* module = NULL;
+    if (!replayIdentifiers(&vm->symbolTable, cached) || !replayStructTypes(vm, cached) ||
+        (module = copyModule(&vm->gc, cached->module, (ModuleId)vm->modules.len)) == NULL) {
+        cache->missCount++;
+        return NULL;
+    }
+
+    InternedChar* name = semiSymbolTableGet(&vm->symbolTable, moduleSource->name, moduleSource->nameLength);
+    if (name == NULL || !semiDictSet(&vm->gc,
+                                     &vm->modules,
+                                     semiValueIntCreate(semiSymbolTableGetId(name)),
+                                     semiValuePtrCreate(module, VALUE_TYPE_UNSET))) {
+        semiVMModuleDestroy(&vm->gc, module);
+        cache->missCount++;
+        return NULL;
+    }
+
+    cache->hitCount++;
+    return module;
+}
+
+void semiCompileCacheStore(SemiCompileCache* cache,
+                           SemiVM* vm,
+                           const SemiModuleSource* moduleSource,
+                           uint32_t configuration,
+                           const CompileEnvironment* environment,
+                           const SemiModule* module) {
+    // The first module compiled from a source is kept, so that the memory of the cache is bounded by the number of
+    // distinct sources.
+    uint64_t key   = semiCompileCacheKey(moduleSource, configuration);
+    Value keyValue = semiValueIntCreate((IntValue)key);
+    if (semiDictHas(&cache->modules, keyValue)) {
+        return;
+    }
+
+    CachedModule* cached = createCachedModule(&cache->gc);
+    if (cached == NULL) {
+        return;
+    }
+    cached->environment   = *environment;
+    cached->configuration = configuration;
+    cached->nameLength    = moduleSource->nameLength;
+    cached->sourceLength  = moduleSource->length;
+    cached->name          = copyBytes(&cache->gc, moduleSource->name, moduleSource->nameLength);
+    cached->source        = copyBytes(&cache->gc, moduleSource->source, moduleSource->length);
+
+    if ((cached->nameLength > 0 && cached->name == NULL) || (cached->sourceLength > 0 && cached->source == NULL) ||
+        !recordIdentifiers(&cache->gc, &vm->symbolTable, cached) ||
+        !recordStructTypes(&cache->gc, &vm->classes, cached) ||
+        (cached->module = copyModule(&cache->gc, module, module->moduleId)) == NULL ||
+        !semiDictSet(&cache->gc, &cache->modules, keyValue, semiValuePtrCreate(cached, VALUE_TYPE_UNSET))) {
+        destroyCachedModule(&cache->gc, cached);
+        return;
+    }
+    storeCachedModule(cache, key, cached);
+}
+
+SEMI_EXPORT SemiCompileCache* semiCreateCompileCache(SemiVMConfig* inputConfig) {
+    SemiVMConfig config;
+    if (inputConfig == NULL) {
+        semiInitConfig(&config);
+    } else {
+        config = *inputConfig;
+    }
+
+    SemiCompileCache* cache = config.reallocateFn(NULL, sizeof(SemiCompileCache), config.reallocateUserData);
+    if (cache == NULL) {
+        return NULL;
+    }
+
+    semiGCInit(&cache->gc, config.reallocateFn, config.reallocateUserData);
+    semiObjectStackDictInit(&cache->modules);
+    cache->storage   = (SemiCompileCacheStorage){0};
+    cache->hitCount  = 0;
+    cache->missCount = 0;
+    return cache;
+}
+
+SEMI_EXPORT void semiDestroyCompileCache(SemiCompileCache* cache) {
+    if (cache == NULL) {
+        return;
+    }
+
+    for (uint32_t i = 0; i < cache->modules.used; i++) {
+        destroyCachedModule(&cache->gc, AS_PTR(&cache->modules.values[i], CachedModule));
+    }
+    semiObjectStackDictCleanup(&cache->gc, &cache->modules);
+
+    SemiReallocateFn reallocateFn = cache->gc.reallocateFn;
+    void* reallocateUserData      = cache->gc.reallocateUserData;
+    semiGCCleanup(&cache->gc);
+    reallocateFn(cache, 0, reallocateUserData);
+}
+
+SEMI_EXPORT void semiVMSetCompileCache(SemiVM* vm, SemiCompileCache* cache) {
+    vm->compileCache = cache;
+}
+
+SEMI_EXPORT void semiCompileCacheSetStorage(SemiCompileCache* cache, const SemiCompileCacheStorage* storage) {
+    cache->storage = storage != NULL ? *storage : (SemiCompileCacheStorage){0};
+}
@@ -0,0 +1,85 @@
+// Copyright (c) 2025 Ian Chen
+// SPDX-License-Identifier: MPL-2.0
+
+#ifndef SEMI_COMPILE_CACHE_H
+#define SEMI_COMPILE_CACHE_H
+
+#include <stdint.h>
+
+#include "./gc.h"
+#include "./symbol_table.h"
+#include "./vm.h"
+#include "semi/semi.h"
+
+// The state of a VM that compiled code depends on, since it refers to identifiers, struct types and global variables
+// by their ids.
+typedef struct CompileEnvironment {
+    IdentifierId nextIdentifierId;
+    uint64_t symbolFingerprint;
+    uint16_t classCount;
+    uint64_t classFingerprint;
+    uint64_t globalsFingerprint;
+} CompileEnvironment;
+
+DECLARE_DARRAY(IdentifierIdList, IdentifierId, uint32_t)
+
+// A module compiled by a VM, together with what the compilation added to the VM.
+typedef struct CachedModule {
+    CompileEnvironment environment;
+
+    // What the key was computed from, compared on every lookup since different sources can have the same key.
+    uint32_t configuration;
+    char* name;
+    uint8_t nameLength;
+    char* source;
+    uint32_t sourceLength;
+
+    // The identifiers the compilation added to the symbol table in order, each prefixed by its length.
+    char* identifiers;
+    uint32_t identifiersSize;
+
+    // The struct types the compilation registered in order. Each is its name, the number of its fields and the
+    // fields sorted by their identifier ids.
+    IdentifierIdList structTypes;
+
+    // A copy of the module made right after it was compiled, owned by the cache.
+    SemiModule* module;
+} CachedModule;
+
+struct SemiCompileCache {
+    // Owns the cached modules. Never collected.
+    GC gc;
+
+    // The key of a module source -> CachedModule*.
+    ObjectDict modules;
+
+    // Where modules are loaded from on a miss and stored to, if `loadFn` and `storeFn` are not NULL.
+    SemiCompileCacheStorage storage;
+
+    uint32_t hitCount;
+    uint32_t missCount;
+};
+
+void semiCompileEnvironmentCapture(SemiVM* vm, CompileEnvironment* environment);
+
+// Return the key of a module source compiled with a compiler configuration.
+uint64_t semiCompileCacheKey(const SemiModuleSource* moduleSource, uint32_t configuration);
+
+// Add a copy of the cached module of `moduleSource` compiled with `configuration` to the VM and return it, if it was
+// compiled in the same environment. Return NULL otherwise, in which case the module has to be compiled.
+SemiModule* semiCompileCacheLoad(SemiCompileCache* cache,
+                                 SemiVM* vm,
+                                 const SemiModuleSource* moduleSource,
+                                 uint32_t configuration,
+                                 const CompileEnvironment* environment);
+
+// Store a copy of a module that was just compiled from scratch in `environment`, the state of the VM before the
+// compilation. Modules that can't be copied are not stored.
+void semiCompileCacheStore(SemiCompileCache* cache,
+                           SemiVM* vm,
+                           const SemiModuleSource* moduleSource,
+                           uint32_t configuration,
+                           const CompileEnvironment* environment,
+                           const SemiModule* module);
+
+#endif /* SEMI_COMPILE_CACHE_H */
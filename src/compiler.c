@@ -12,6 +12,13 @@
 #include <stdlib.h>
 #include <string.h>
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
+#include "./compile_cache.h"
 #include "./darray.h"
 #include "./instruction.h"
 #include "./primitives.h"
@@ -90,85 +97,264 @@
 
 #define IS_TYPE_IDENTIFIER(s) (((s)[0]) >= 'A' && ((s)[0]) <= 'Z')
 
-// Map keyword strings to their corresponding Token enum values.
-typedef struct {
-    const char* str;
-    Token token;
-} KeywordMap;
+static inline bool isIdentifierChar(char c) {
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_';
+}
 
-typedef struct {
-    const KeywordMap* keywords;
-    unsigned short count;
-} KeywordLengthMap;
-
-static const KeywordMap KEYWORDS_LEN_2[] = {
-    {"or", TK_OR},
-    {"in", TK_IN},
-    {"is", TK_IS},
-    {"if", TK_IF},
-    {"as", TK_AS},
-    {"fn", TK_FN},
-    {"by", TK_BY},
-};
+// Whether `c` is in [1, 127] regardless of the signedness of `char`.
+static inline bool isNonZeroAsciiChar(char c) {
+    return (unsigned char)c >= 1 && (unsigned char)c <= 127;
+}
 
-static const KeywordMap KEYWORDS_LEN_3[] = {
-    {"and", TK_AND},
-    {"for", TK_FOR},
-};
+// Byte classification over LEXER_VECTOR_WIDTH bytes at a time. A mask has every bit of a byte set if the byte is in the
+// class. Without SSE2 or NEON, the scanners below fall back to their scalar loops.
+#if defined(__SSE2__)
 
-static const KeywordMap KEYWORDS_LEN_4[] = {
-    {"elif", TK_ELIF},
-    {"else", TK_ELSE},
-    {"true", TK_TRUE},
-};
+#define LEXER_VECTOR_WIDTH 16
+typedef __m128i LexerVector;
 
-static const KeywordMap KEYWORDS_LEN_5[] = {
-    {"defer", TK_DEFER},
-    {"raise", TK_RAISE},
-    {"break", TK_BREAK},
-    {"false", TK_FALSE},
-    {"unset", TK_UNSET},
-};
+static inline LexerVector lexerVectorLoad(const char* p) {
+    return _mm_loadu_si128((const __m128i*)(const void*)p);
+}
+static inline LexerVector lexerVectorEq(LexerVector v, char c) {
+    return _mm_cmpeq_epi8(v, _mm_set1_epi8(c));
+}
+// Bytes in [lo, hi]. Both bounds must be ASCII since the comparison is signed.
+static inline LexerVector lexerVectorInRange(LexerVector v, char lo, char hi) {
+    return _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8((char)(lo - 1))),
+                         _mm_cmplt_epi8(v, _mm_set1_epi8((char)(hi + 1))));
+}
+// Bytes in [1, 127].
+static inline LexerVector lexerVectorAscii(LexerVector v) {
+    return _mm_cmpgt_epi8(v, _mm_setzero_si128());
+}
+static inline LexerVector lexerVectorOr(LexerVector a, LexerVector b) {
+    return _mm_or_si128(a, b);
+}
+static inline LexerVector lexerVectorAndNot(LexerVector a, LexerVector b) {
+    return _mm_andnot_si128(b, a);
+}
+// The index of the first byte not in `mask`, or LEXER_VECTOR_WIDTH if all bytes are.
+static inline uint32_t lexerVectorFirstUnset(LexerVector mask) {
+    uint32_t bits = (uint32_t)_mm_movemask_epi8(mask) ^ 0xFFFFu;
+    return bits == 0 ? LEXER_VECTOR_WIDTH : countTrailingZeros64(bits);
+}
 
-static const KeywordMap KEYWORDS_LEN_6[] = {
-    {"export", TK_EXPORT},
-    {"return", TK_RETURN},
-    {"import", TK_IMPORT},
-    {"struct", TK_STRUCT},
-};
+#elif defined(__ARM_NEON)
 
-static const KeywordMap KEYWORDS_LEN_8[] = {
-    {"continue", TK_CONTINUE},
-};
+#define LEXER_VECTOR_WIDTH 16
+typedef uint8x16_t LexerVector;
+
+static inline LexerVector lexerVectorLoad(const char* p) {
+    return vld1q_u8((const uint8_t*)p);
+}
+static inline LexerVector lexerVectorEq(LexerVector v, char c) {
+    return vceqq_u8(v, vdupq_n_u8((uint8_t)c));
+}
+static inline LexerVector lexerVectorInRange(LexerVector v, char lo, char hi) {
+    return vandq_u8(vcgeq_u8(v, vdupq_n_u8((uint8_t)lo)), vcleq_u8(v, vdupq_n_u8((uint8_t)hi)));
+}
+static inline LexerVector lexerVectorAscii(LexerVector v) {
+    return vandq_u8(vcgtq_u8(v, vdupq_n_u8(0)), vcltq_u8(v, vdupq_n_u8(0x80)));
+}
+static inline LexerVector lexerVectorOr(LexerVector a, LexerVector b) {
+    return vorrq_u8(a, b);
+}
+static inline LexerVector lexerVectorAndNot(LexerVector a, LexerVector b) {
+    return vbicq_u8(a, b);
+}
+// NEON has no movemask, so the mask is narrowed to four bits per byte.
+static inline uint32_t lexerVectorFirstUnset(LexerVector mask) {
+    uint64_t bits = ~vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(mask), 4)), 0);
+    return bits == 0 ? LEXER_VECTOR_WIDTH : countTrailingZeros64(bits) / 4;
+}
+
+#endif
+
+// The scanners return the end of the run of bytes of their class starting at `p`.
+
+// Spaces, tabs and carriage returns.
+static const char* scanBlankRun(const char* p, const char* end) {
+#ifdef LEXER_VECTOR_WIDTH
+    while (end - p >= LEXER_VECTOR_WIDTH) {
+        LexerVector v     = lexerVectorLoad(p);
+        LexerVector blank =
+            lexerVectorOr(lexerVectorOr(lexerVectorEq(v, ' '), lexerVectorEq(v, '\t')), lexerVectorEq(v, '\r'));
+        uint32_t n = lexerVectorFirstUnset(blank);
+        p += n;
+        if (n < LEXER_VECTOR_WIDTH) {
+            return p;
+        }
+    }
+#endif
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\r')) {
+        p++;
+    }
+    return p;
+}
+
+// ASCII bytes of a comment other than the newline ending it.
+static const char* scanCommentRun(const char* p, const char* end) {
+#ifdef LEXER_VECTOR_WIDTH
+    while (end - p >= LEXER_VECTOR_WIDTH) {
+        LexerVector v = lexerVectorLoad(p);
+        uint32_t n    = lexerVectorFirstUnset(lexerVectorAndNot(lexerVectorAscii(v), lexerVectorEq(v, '\n')));
+        p += n;
+        if (n < LEXER_VECTOR_WIDTH) {
+            return p;
+        }
+    }
+#endif
+    while (p < end && isNonZeroAsciiChar(*p) && *p != '\n') {
+        p++;
+    }
+    return p;
+}
+
+static const char* scanIdentifierRun(const char* p, const char* end) {
+#ifdef LEXER_VECTOR_WIDTH
+    while (end - p >= LEXER_VECTOR_WIDTH) {
+        LexerVector v     = lexerVectorLoad(p);
+        LexerVector alpha = lexerVectorOr(lexerVectorInRange(v, 'a', 'z'), lexerVectorInRange(v, 'A', 'Z'));
+        LexerVector digit = lexerVectorOr(lexerVectorInRange(v, '0', '9'), lexerVectorEq(v, '_'));
+        uint32_t n        = lexerVectorFirstUnset(lexerVectorOr(alpha, digit));
+        p += n;
+        if (n < LEXER_VECTOR_WIDTH) {
+            return p;
+        }
+    }
+#endif
+    while (p < end && isIdentifierChar(*p)) {
+        p++;
+    }
+    return p;
+}
+
+// ASCII bytes of a string literal that are copied as is, i.e. anything but quotes, escapes and line breaks.
+static const char* scanStringRun(const char* p, const char* end) {
+#ifdef LEXER_VECTOR_WIDTH
+    while (end - p >= LEXER_VECTOR_WIDTH) {
+        LexerVector v       = lexerVectorLoad(p);
+        LexerVector special = lexerVectorOr(lexerVectorOr(lexerVectorEq(v, '"'), lexerVectorEq(v, '\\')),
+                                            lexerVectorOr(lexerVectorEq(v, '\n'), lexerVectorEq(v, '\r')));
+        uint32_t n          = lexerVectorFirstUnset(lexerVectorAndNot(lexerVectorAscii(v), special));
+        p += n;
+        if (n < LEXER_VECTOR_WIDTH) {
+            return p;
+        }
+    }
+#endif
+    while (p < end && isNonZeroAsciiChar(*p) && *p != '"' && *p != '\\' && *p != '\n' && *p != '\r') {
+        p++;
+    }
+    return p;
+}
+
+// Map keyword strings to their corresponding Token enum values.
+typedef struct {
+    const char* str;
+    unsigned short length;
+    Token token;
+} KeywordMap;
 
-static const KeywordLengthMap KEYWORD_MAP[] = {
-    {          NULL,                                                  0}, // length 0
-    {          NULL,                                                  0}, // length 1
-    {KEYWORDS_LEN_2, sizeof(KEYWORDS_LEN_2) / sizeof(KEYWORDS_LEN_2[0])},
-    {KEYWORDS_LEN_3, sizeof(KEYWORDS_LEN_3) / sizeof(KEYWORDS_LEN_3[0])},
-    {KEYWORDS_LEN_4, sizeof(KEYWORDS_LEN_4) / sizeof(KEYWORDS_LEN_4[0])},
-    {KEYWORDS_LEN_5, sizeof(KEYWORDS_LEN_5) / sizeof(KEYWORDS_LEN_5[0])},
-    {KEYWORDS_LEN_6, sizeof(KEYWORDS_LEN_6) / sizeof(KEYWORDS_LEN_6[0])},
-    {          NULL,                                                  0}, // length 7
-    {KEYWORDS_LEN_8, sizeof(KEYWORDS_LEN_8) / sizeof(KEYWORDS_LEN_8[0])},
+// Keywords are placed by a perfect hash of their first character, last character and length, so looking up an
+// identifier takes a single comparison. The slots are computed at compile time, and a collision after adding a keyword
+// shows up as an initializer override warning.
+#define KEYWORD_TABLE_SIZE 64
+#define KEYWORD_HASH(first, last, length) \
+    ((((unsigned)(first)) ^ ((unsigned)(last) * 17u) ^ (unsigned)(length)) & (KEYWORD_TABLE_SIZE - 1))
+#define KEYWORD_ENTRY(str, first, last, token) \
+    [KEYWORD_HASH(first, last, sizeof(str) - 1)] = {str, sizeof(str) - 1, token}
+#define KEYWORD_MIN_LENGTH 2
+#define KEYWORD_MAX_LENGTH 8
+
+static const KeywordMap KEYWORD_TABLE[KEYWORD_TABLE_SIZE] = {
+    KEYWORD_ENTRY("or", 'o', 'r', TK_OR),
+    KEYWORD_ENTRY("in", 'i', 'n', TK_IN),
+    KEYWORD_ENTRY("is", 'i', 's', TK_IS),
+    KEYWORD_ENTRY("if", 'i', 'f', TK_IF),
+    KEYWORD_ENTRY("as", 'a', 's', TK_AS),
+    KEYWORD_ENTRY("fn", 'f', 'n', TK_FN),
+    KEYWORD_ENTRY("by", 'b', 'y', TK_BY),
+    KEYWORD_ENTRY("and", 'a', 'd', TK_AND),
+    KEYWORD_ENTRY("for", 'f', 'r', TK_FOR),
+    KEYWORD_ENTRY("elif", 'e', 'f', TK_ELIF),
+    KEYWORD_ENTRY("else", 'e', 'e', TK_ELSE),
+    KEYWORD_ENTRY("true", 't', 'e', TK_TRUE),
+    KEYWORD_ENTRY("defer", 'd', 'r', TK_DEFER),
+    KEYWORD_ENTRY("raise", 'r', 'e', TK_RAISE),
+    KEYWORD_ENTRY("break", 'b', 'k', TK_BREAK),
+    KEYWORD_ENTRY("false", 'f', 'e', TK_FALSE),
+    KEYWORD_ENTRY("unset", 'u', 't', TK_UNSET),
+    KEYWORD_ENTRY("export", 'e', 't', TK_EXPORT),
+    KEYWORD_ENTRY("return", 'r', 'n', TK_RETURN),
+    KEYWORD_ENTRY("import", 'i', 't', TK_IMPORT),
+    KEYWORD_ENTRY("struct", 's', 't', TK_STRUCT),
+    KEYWORD_ENTRY("continue", 'c', 'e', TK_CONTINUE),
 };
 
 // Look up a keyword string and return its corresponding Token.
 // If the string is not a keyword, return TK_NON_TOKEN.
 static Token lookupKeyword(const char* str, unsigned short length) {
-    if (length == 0 || length >= (sizeof(KEYWORD_MAP) / sizeof(KEYWORD_MAP[0]))) {
+    if (length < KEYWORD_MIN_LENGTH || length > KEYWORD_MAX_LENGTH) {
         return TK_NON_TOKEN;
     }
 
-    const KeywordLengthMap* map = &KEYWORD_MAP[length];
-    for (int i = 0; i < map->count; i++) {
-        if (memcmp(str, map->keywords[i].str, (size_t)length) == 0) {
-            return map->keywords[i].token;
-        }
+    const KeywordMap* entry = &KEYWORD_TABLE[KEYWORD_HASH(str[0], str[length - 1], length)];
+    if (entry->length == length && memcmp(str, entry->str, (size_t)length) == 0) {
+        return entry->token;
     }
     return TK_NON_TOKEN;
 }
 
+// The window of a streamed source starts at twice the size of a read, and is grown to keep room for one read.
+#define LEXER_READ_SIZE 4096
+
+// Make sure the window of a streamed source holds the rest of the current line, unless the source ends first. Bytes
+// before the line are dropped, which is why identifiers of a streamed source are copied out of the window.
+static void refillLexer(Lexer* lexer) {
+    if (lexer->reader == NULL) {
+        return;
+    }
+
+    size_t searched = 0;
+    while (!lexer->isReaderDone &&
+           memchr(lexer->curr + searched, '\n', (size_t)(lexer->end - lexer->curr) - searched) == NULL) {
+        searched = (size_t)(lexer->end - lexer->curr);
+
+        size_t currOffset = (size_t)(lexer->curr - lexer->lineStart);
+        size_t length     = (size_t)(lexer->end - lexer->lineStart);
+        memmove(lexer->window, lexer->lineStart, length);
+
+        if (lexer->windowCapacity - length < LEXER_READ_SIZE) {
+            if (lexer->windowCapacity > UINT32_MAX / 2) {
+                SEMI_COMPILE_ABORT(lexer->compiler, SEMI_ERROR_MODULE_TOO_LARGE, "Line too long in streamed source");
+            }
+            char* window = semiRealloc(
+                lexer->compiler->gc, lexer->window, lexer->windowCapacity, (size_t)lexer->windowCapacity * 2);
+            if (window == NULL) {
+                SEMI_COMPILE_ABORT(lexer->compiler,
+                                   SEMI_ERROR_MEMORY_ALLOCATION_FAILURE,
+                                   "Memory allocation failure when reading source");
+            }
+            lexer->window = window;
+            lexer->windowCapacity *= 2;
+        }
+
+        lexer->curr      = lexer->window + currOffset;
+        lexer->lineStart = lexer->window;
+        lexer->end       = lexer->window + length;
+
+        size_t capacity   = lexer->windowCapacity - length;
+        size_t readLength = lexer->reader->readFn(lexer->window + length, capacity, lexer->reader->readUserData);
+        if (readLength > capacity) {
+            SEMI_COMPILE_ABORT(lexer->compiler, SEMI_ERROR_SOURCE_READ_FAILURE, "Failed to read source");
+        }
+        lexer->end += readLength;
+        lexer->isReaderDone = readLength == 0;
+    }
+}
+
 static void consumeHeader(Lexer* lexer) {
     // Check for Byte Order Mark (BOM)
     // BOM in UTF-8 is represented as EF BB BF (0xEF 0xBB 0xBF)
@@ -192,6 +378,7 @@ static void consumeHeader(Lexer* lexer) {
             if (codepoint == (uint32_t)'\n') {
                 lexer->line++;
                 lexer->lineStart = lexer->curr;
+                refillLexer(lexer);
                 return;
             }
         }
@@ -211,6 +398,21 @@ static void initLexer(Lexer* lexer, Compiler* compiler, const char* source, uint
     consumeHeader(lexer);
 }
 
+static void initReaderLexer(Lexer* lexer, Compiler* compiler, const SemiModuleReader* reader) {
+    char* window = semiMalloc(compiler->gc, LEXER_READ_SIZE * 2);
+    if (window == NULL) {
+        SEMI_COMPILE_ABORT(
+            compiler, SEMI_ERROR_MEMORY_ALLOCATION_FAILURE, "Memory allocation failure when reading source");
+    }
+
+    initLexer(lexer, compiler, window, 0);
+    lexer->reader         = reader;
+    lexer->window         = window;
+    lexer->windowCapacity = LEXER_READ_SIZE * 2;
+    refillLexer(lexer);
+    consumeHeader(lexer);
+}
+
 // Read a number until we reach a non-number character or EOF.
 //
 // If it is an integer, we accept the following forms:
@@ -415,25 +617,21 @@ static Token readNumber(Lexer* lexer) {
 // are valid and considered placeholders. They can appear at the
 // right side of an assignment or as a standalone expression.
 static Token readIdentifier(Lexer* lexer) {
-    uint8_t length   = 0;
     const char* head = lexer->curr;
-    char c;
-    while ((c = SAFE_PEEK(lexer)) != EOZ) {
-        if ((c >= 'a' && c <= 'z' || c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') || c == '_') {
-            if (length == UINT8_MAX) {
-                SEMI_LEXER_ERROR(lexer, SEMI_ERROR_IDENTIFIER_TOO_LONG, "Identifier too long");
-                return TK_EOF;
-            }
-
-            length++;
-            ADVANCE_CHAR(lexer);
-        } else {
-            break;
-        }
+    lexer->curr      = scanIdentifierRun(lexer->curr, lexer->end);
+    if (lexer->curr - head > UINT8_MAX) {
+        lexer->curr = head + UINT8_MAX;
+        SEMI_LEXER_ERROR(lexer, SEMI_ERROR_IDENTIFIER_TOO_LONG, "Identifier too long");
+        return TK_EOF;
     }
 
     lexer->tokenValue.identifier.name   = head;
-    lexer->tokenValue.identifier.length = length;
+    lexer->tokenValue.identifier.length = (uint8_t)(lexer->curr - head);
+    // The window of a streamed source may be refilled before the parser reads the name.
+    if (lexer->reader != NULL) {
+        memcpy(lexer->buffer, head, lexer->tokenValue.identifier.length);
+        lexer->tokenValue.identifier.name = lexer->buffer;
+    }
 
     return TK_IDENTIFIER;
 }
@@ -454,6 +652,20 @@ static Token readString(Lexer* lexer) {
     char c;
     ErrorId errId;
     while (lexer->curr < lexer->end) {
+        const char* runEnd = scanStringRun(lexer->curr, lexer->end);
+        if (runEnd != lexer->curr) {
+            uint32_t runLength = (uint32_t)(runEnd - lexer->curr);
+            if (SEMI_UNLIKELY(errId = ByteBufferEnsureCapacity(gc, &buffer, buffer.size + runLength)) != 0) {
+                ByteBufferCleanup(gc, &buffer);
+                SEMI_LEXER_ERROR(lexer, errId, "Memory allocation failure duing lexing string");
+                return TK_EOF;
+            }
+            memcpy(buffer.data + buffer.size, lexer->curr, runLength);
+            buffer.size += runLength;
+            lexer->curr = runEnd;
+            continue;
+        }
+
         c = *lexer->curr;
         if (c == '\0' || c == '\n' || c == '\r') {
             break;
@@ -551,7 +763,12 @@ static Token consumeSpaces(Lexer* lexer) {
             case '#': {
                 ADVANCE_CHAR(lexer);
                 uint32_t cp;
-                while ((cp = semiUTF8NextCodepoint(&lexer->curr, (unsigned int)(lexer->end - lexer->curr))) != EOZ) {
+                for (;;) {
+                    lexer->curr = scanCommentRun(lexer->curr, lexer->end);
+                    cp          = semiUTF8NextCodepoint(&lexer->curr, (unsigned int)(lexer->end - lexer->curr));
+                    if (cp == EOZ) {
+                        break;
+                    }
                     if (cp == '\n') {
                         lexer->curr--;  // roll back one character to behave
                                         // like peek
@@ -569,12 +786,13 @@ static Token consumeSpaces(Lexer* lexer) {
                 //       source code.
                 lexer->line++;
                 lexer->lineStart = lexer->curr;
+                refillLexer(lexer);
                 break;
             }
             case ' ':
             case '\t':
             case '\r':
-                ADVANCE_CHAR(lexer);
+                lexer->curr = scanBlankRun(lexer->curr + 1, lexer->end);
                 break;
 
             default:
@@ -611,6 +829,7 @@ static Token nextToken(Lexer* lexer) {
             ADVANCE_CHAR(lexer);
             lexer->line++;
             lexer->lineStart = lexer->curr;
+            refillLexer(lexer);
             return TK_SEPARATOR;
         }
         case '~':
@@ -859,6 +1078,61 @@ static void updateBracketCount(Compiler* compiler, Token token) {
     compiler->lexer.ignoreSeparators = (compiler->newlineState != 0);
 }
 
+// Collect every identifier that is directly followed by `=` in the source into `reassignedIdentifiers`. This is a
+// conservative over-approximation of the names that are assigned to (field names of `a.b = ...` are collected as well)
+// and it never reports errors, so malformed input is still diagnosed by the parser at the right location.
+static void scanReassignedIdentifiers(Compiler* compiler, const char* source, uint32_t length) {
+    const char* curr = source;
+    const char* end  = source + length;
+    while (curr < end) {
+        char c = *curr;
+        if (c == '#') {
+            const char* newline = memchr(curr, '\n', (size_t)(end - curr));
+            curr                = newline != NULL ? newline : end;
+            continue;
+        }
+        if (c == '"') {
+            curr++;
+            while (curr < end && *curr != '"' && *curr != '\n') {
+                curr += (*curr == '\\' && end - curr >= 2) ? 2 : 1;
+            }
+            if (curr < end) {
+                curr++;
+            }
+            continue;
+        }
+        if (!isIdentifierChar(c)) {
+            curr++;
+            continue;
+        }
+
+        const char* head = curr;
+        curr             = scanIdentifierRun(curr, end);
+        if ((head[0] >= '0' && head[0] <= '9') || curr - head > UINT8_MAX) {
+            continue;
+        }
+
+        const char* next = curr;
+        while (next < end && (*next == ' ' || *next == '\t' || *next == '\r' || *next == '\n')) {
+            next++;
+        }
+        if (next == end || *next != '=' || (end - next >= 2 && next[1] == '=')) {
+            continue;
+        }
+
+        InternedChar* identifier = semiSymbolTableInsert(compiler->symbolTable, head, (IdentifierLength)(curr - head));
+        if (identifier == NULL) {
+            SEMI_COMPILE_ABORT(
+                compiler, SEMI_ERROR_MEMORY_ALLOCATION_FAILURE, "Memory allocation failure when scanning source");
+        }
+        Value v = semiValueIntCreate(semiSymbolTableGetId(identifier));
+        if (!semiDictSet(compiler->gc, &compiler->reassignedIdentifiers, v, v)) {
+            SEMI_COMPILE_ABORT(
+                compiler, SEMI_ERROR_MEMORY_ALLOCATION_FAILURE, "Memory allocation failure when scanning source");
+        }
+    }
+}
+
 #pragma endregion
 
 /*
@@ -867,14 +1141,16 @@ static void updateBracketCount(Compiler* compiler, Token token) {
 #pragma region Code Emission
 
 DEFINE_DARRAY(Chunk, Instruction, uint32_t, UINT32_MAX)
+DEFINE_ARENA_DARRAY_OPS(Chunk, Instruction, uint32_t, UINT32_MAX)
 
 static inline PCLocation currentPCLocation(Compiler* compiler) {
     return compiler->currentFunction->chunk.size;
 }
 
 static PCLocation emitCode(Compiler* compiler, Instruction instruction) {
-    PCLocation pcLocation = compiler->currentFunction->chunk.size;
-    ErrorId errId         = ChunkAppend(compiler->gc, &compiler->currentFunction->chunk, instruction);
+    Chunk* chunk          = &compiler->currentFunction->chunk;
+    PCLocation pcLocation = chunk->size;
+    ErrorId errId         = ChunkArenaAppend(compiler->gc, &compiler->arena, chunk, instruction);
     if (errId == SEMI_ERROR_MEMORY_ALLOCATION_FAILURE) {
         SEMI_COMPILE_ABORT(
             compiler, SEMI_ERROR_MEMORY_ALLOCATION_FAILURE, "Memory allocation failure when emitting code");
@@ -903,32 +1179,163 @@ static void patchCode(Compiler* compiler, PCLocation pc, Instruction instruction
     chunk->data[pc] = instruction;
 }
 
+static bool peepholeBranchTarget(Instruction instruction, PCLocation pc, PCLocation* target) {
+    switch (GET_OPCODE(instruction)) {
+        case OP_JUMP: {
+            uint32_t j = OPERAND_J_J(instruction);
+            if (j == 0) {
+                return false;
+            }
+            *target = OPERAND_J_S(instruction) ? pc + j : pc - j;
+            return true;
+        }
+        case OP_C_JUMP: {
+            uint16_t k = OPERAND_K_K(instruction);
+            if (k == 0) {
+                return false;
+            }
+            *target = OPERAND_K_S(instruction) ? pc + k : pc - k;
+            return true;
+        }
+        case OP_ITER_NEXT:
+        case OP_RANGE_NEXT:
+            *target = pc + OPERAND_K_K(instruction);
+            return true;
+        default:
+            return false;
+    }
+}
+
+// Points the branch at `pc` to `target`. Returns false if the new offset doesn't fit in the instruction.
+static bool peepholeRetarget(Instruction* instruction, PCLocation pc, PCLocation target) {
+    bool forward    = target > pc;
+    uint32_t offset = forward ? target - pc : pc - target;
+    if (offset == 0) {
+        return false;
+    }
+
+    Opcode opcode = (Opcode)GET_OPCODE(*instruction);
+    if (opcode == OP_JUMP) {
+        if (offset > MAX_OPERAND_J) {
+            return false;
+        }
+        *instruction = INSTRUCTION_JUMP(offset, forward);
+        return true;
+    }
+
+    if (offset > MAX_OPERAND_K || (opcode != OP_C_JUMP && !forward)) {
+        return false;
+    }
+    bool s       = opcode == OP_C_JUMP ? forward : OPERAND_K_S(*instruction);
+    *instruction = (*instruction & ~((MAX_OPERAND_K << 8) | (1u << 6))) | (offset << 8) | ((Instruction)s << 6);
+    return true;
+}
+
 static inline PCLocation emitPlaceholder(Compiler* compiler) {
     return emitCode(compiler, INSTRUCTION_NOOP());
 }
 
+// Emits a K-type instruction whose operand `k` may not fit in 16 bits. The instruction holds the low 16 bits, and an
+// EXTRA_ARG in front of it holds the rest. Returns the location of the instruction.
+static PCLocation emitCodeWithExtendedK(Compiler* compiler, Instruction instruction, uint32_t k) {
+    if (k > MAX_OPERAND_K) {
+        emitCode(compiler, INSTRUCTION_EXTRA_ARG(k >> 16, false));
+    }
+    return emitCode(compiler, instruction);
+}
+
+// Inserts an EXTRA_ARG holding `extraArg` in front of the placeholder at `location`, which moves the code after it by
+// one instruction. Backward branches leaving the moved code are retargeted, and so are the pending `break` jumps of
+// the enclosing loops since they are linked by absolute locations.
+static void insertExtraArg(Compiler* compiler, PCLocation location, uint32_t extraArg) {
+    FunctionScope* currentFunction = compiler->currentFunction;
+    Chunk* chunk                   = &currentFunction->chunk;
+    PCLocation end                 = chunk->size;
+
+    size_t pendingSize   = sizeof(bool) * (end - location);
+    ArenaMark mark       = semiArenaMark(&compiler->scratchArena);
+    bool* isPendingBreak = semiArenaAlloc(compiler->gc, &compiler->scratchArena, pendingSize);
+    if (isPendingBreak == NULL) {
+        SEMI_COMPILE_ABORT(
+            compiler, SEMI_ERROR_MEMORY_ALLOCATION_FAILURE, "Memory allocation failure when extending a jump");
+    }
+    memset(isPendingBreak, 0, pendingSize);
+
+    for (BlockScope* block = currentFunction->currentBlock; block != NULL; block = block->parent) {
+        if (block->type != BLOCK_SCOPE_TYPE_LOOP) {
+            continue;
+        }
+        LoopScope* loopScope = (LoopScope*)block;
+        PCLocation pc        = loopScope->previousJumpLocation;
+        if (pc == INVALID_PC_LOCATION || pc < location) {
+            continue;
+        }
+        loopScope->previousJumpLocation = pc + 1;
+        for (;;) {
+            isPendingBreak[pc - location] = true;
+            PCLocation next               = OPERAND_J_J(chunk->data[pc]);
+            if (next == INVALID_PC_LOCATION || next < location) {
+                break;
+            }
+            chunk->data[pc] = INSTRUCTION_JUMP(next + 1, false);
+            pc              = next;
+        }
+    }
+
+    emitPlaceholder(compiler);
+    memmove(&chunk->data[location + 1], &chunk->data[location], sizeof(Instruction) * (end - location));
+    chunk->data[location] = INSTRUCTION_EXTRA_ARG(extraArg, false);
+
+    bool isRetargeted = true;
+    for (PCLocation pc = location + 1; pc < end && isRetargeted; pc++) {
+        PCLocation target;
+        if (!isPendingBreak[pc - location] && peepholeBranchTarget(chunk->data[pc + 1], pc, &target) &&
+            target <= location) {
+            isRetargeted = peepholeRetarget(&chunk->data[pc + 1], pc + 1, target);
+        }
+    }
+    semiArenaRelease(compiler->gc, &compiler->scratchArena, mark);
+    if (!isRetargeted) {
+        SEMI_COMPILE_ABORT(compiler, SEMI_ERROR_TOO_MANY_INSTRUCTIONS_FOR_JUMP, "Too many instructions for a jump");
+    }
+}
+
 static inline void overrideJumpHere(Compiler* compiler, PCLocation previous) {
     // Invariant: currentPCLocation(compiler) >= previous
-    uint16_t diff = (uint16_t)(currentPCLocation(compiler) - previous);
+    PCLocation diff = currentPCLocation(compiler) - previous;
+    if (diff > MAX_OPERAND_J) {
+        SEMI_COMPILE_ABORT(compiler, SEMI_ERROR_TOO_MANY_INSTRUCTIONS_FOR_JUMP, "Too many instructions for a jump");
+    }
 
     Instruction instruction = INSTRUCTION_JUMP(diff, true);
     patchCode(compiler, previous, instruction);
 }
 
-static inline void overrideConditionalJumpHere(Compiler* compiler,
+// Returns true if an EXTRA_ARG was inserted in front of the jump, which moves the code after `previous` by one
+// instruction.
+static inline bool overrideConditionalJumpHere(Compiler* compiler,
                                                PCLocation previous,
                                                LocalRegisterId condReg,
                                                bool jumpIfTrue) {
     // Invariant: currentPCLocation(compiler) >= previous
-    uint16_t diff = (uint16_t)(currentPCLocation(compiler) - previous);
+    PCLocation diff = currentPCLocation(compiler) - previous;
+    bool isExtended = diff > MAX_OPERAND_K;
+    if (isExtended) {
+        insertExtraArg(compiler, previous, diff >> 16);
+        previous++;
+    }
 
-    Instruction instruction = INSTRUCTION_C_JUMP(condReg, diff, jumpIfTrue, true);
+    Instruction instruction = INSTRUCTION_C_JUMP(condReg, (uint16_t)diff, jumpIfTrue, true);
     patchCode(compiler, previous, instruction);
+    return isExtended;
 }
 
 static inline void emitJumpBack(Compiler* compiler, PCLocation previous) {
     // Invariant: currentPCLocation(compiler) >= previous
-    uint16_t diff = (uint16_t)(currentPCLocation(compiler) - previous);
+    PCLocation diff = currentPCLocation(compiler) - previous;
+    if (diff > MAX_OPERAND_J) {
+        SEMI_COMPILE_ABORT(compiler, SEMI_ERROR_TOO_MANY_INSTRUCTIONS_FOR_JUMP, "Too many instructions for a jump");
+    }
 
     Instruction instruction = INSTRUCTION_JUMP(diff, false);
     emitCode(compiler, instruction);
@@ -939,111 +1346,1573 @@ static inline void emitConditionalJumpBack(Compiler* compiler,
                                            LocalRegisterId condReg,
                                            bool jumpIfTrue) {
     // Invariant: currentPCLocation(compiler) >= previous
-    uint16_t diff = (uint16_t)(currentPCLocation(compiler) - previous);
+    PCLocation diff = currentPCLocation(compiler) - previous;
+    if (diff > MAX_OPERAND_K) {
+        SEMI_COMPILE_ABORT(compiler, SEMI_ERROR_TOO_MANY_INSTRUCTIONS_FOR_JUMP, "Too many instructions for a jump");
+    }
 
-    Instruction instruction = INSTRUCTION_C_JUMP(condReg, diff, jumpIfTrue, false);
+    Instruction instruction = INSTRUCTION_C_JUMP(condReg, (uint16_t)diff, jumpIfTrue, false);
     emitCode(compiler, instruction);
 }
 
+// Drops the code emitted since `location`. The code must be unreachable from the rest of the chunk. Pending `break`
+// jumps in the dropped code are unlinked from their loops.
+static void discardCodeSince(Compiler* compiler, PCLocation location) {
+    FunctionScope* currentFunction = compiler->currentFunction;
+    for (BlockScope* block = currentFunction->currentBlock; block != NULL; block = block->parent) {
+        if (block->type != BLOCK_SCOPE_TYPE_LOOP) {
+            continue;
+        }
+        LoopScope* loopScope = (LoopScope*)block;
+        while (loopScope->previousJumpLocation != INVALID_PC_LOCATION && loopScope->previousJumpLocation >= location) {
+            loopScope->previousJumpLocation = OPERAND_J_J(currentFunction->chunk.data[loopScope->previousJumpLocation]);
+        }
+    }
+    currentFunction->chunk.size = location;
+}
+
 #pragma endregion
 
 /*
- │ Register Management & Variable Resolution
+ │ Peephole Optimization
 ─┴───────────────────────────────────────────────────────────────────────────────────────────────*/
-#pragma region Register Management & Variable Resolution
+#pragma region Peephole Optimization
 
-#define IS_TOP_LEVEL(compiler) ((compiler)->currentFunction->currentBlock == &(compiler)->rootFunction.rootBlock)
+// The peephole pass rewrites a finished chunk before it's moved to its function proto. By then every jump is patched,
+// so all branch targets are known. The pass only rewrites instructions in place or removes them; since jump offsets
+// are relative, the chunk is compacted by recomputing each offset from an old-to-new location map.
 
-DEFINE_DARRAY(VariableList, VariableDescription, uint16_t, UINT16_MAX)
-DEFINE_DARRAY(UpvalueList, UpvalueDescription, uint8_t, MAX_UPVALUE_COUNT)
+#define PEEPHOLE_MAX_ROUNDS          4
+#define PEEPHOLE_MAX_JUMP_THREADINGS 8
+#define PEEPHOLE_NO_REGISTER         (-1)
 
-static LocalRegisterId reserveTempRegister(Compiler* compiler) {
-    FunctionScope* currentFunction = compiler->currentFunction;
-    if (currentFunction->nextRegisterId == INVALID_LOCAL_REGISTER_ID) {
-        SEMI_COMPILE_ABORT(compiler, SEMI_ERROR_TOO_MANY_LOCAL_VARIABLES, "Too many temporary registers");
-    }
+// How an instruction uses registers. `uses[0]` is read through operand B and `uses[1]` through operand C, except for
+// SET_MODULE_VAR which reads operand A.
+typedef struct PeepholeRegisterUse {
+    int def;
+    int uses[2];
+} PeepholeRegisterUse;
 
-    LocalRegisterId registerId = currentFunction->nextRegisterId++;
-    if (currentFunction->nextRegisterId > currentFunction->maxUsedRegisterCount) {
-        currentFunction->maxUsedRegisterCount = currentFunction->nextRegisterId;
+static bool isFunctionProtoConstant(Compiler* compiler, Instruction instruction) {
+    if (OPERAND_K_S(instruction)) {
+        return true;  // Global constants are opaque to the compiler.
     }
-    return registerId;
+    Value v = semiConstantTableGet(&compiler->artifactModule->constantTable, OPERAND_K_K(instruction));
+    return IS_FUNCTION_PROTO(&v);
 }
 
-static inline LocalRegisterId getNextRegisterId(Compiler* compiler) {
-    return compiler->currentFunction->nextRegisterId;
-}
+// Returns false if the instruction branches, calls, or touches registers in a way that is not described by
+// `PeepholeRegisterUse`.
+static bool peepholeRegisterUse(Compiler* compiler, Instruction instruction, PeepholeRegisterUse* use) {
+    use->def     = PEEPHOLE_NO_REGISTER;
+    use->uses[0] = PEEPHOLE_NO_REGISTER;
+    use->uses[1] = PEEPHOLE_NO_REGISTER;
 
-static inline void restoreNextRegisterId(Compiler* compiler, LocalRegisterId registerId) {
-    FunctionScope* currentFunction = compiler->currentFunction;
+    switch (GET_OPCODE(instruction)) {
+        case OP_NOOP:
+            return true;
 
-    currentFunction->nextRegisterId = registerId;
-    if (currentFunction->nextRegisterId > currentFunction->maxUsedRegisterCount) {
-        currentFunction->maxUsedRegisterCount = currentFunction->nextRegisterId;
+        case OP_LOAD_CONSTANT:
+            if (isFunctionProtoConstant(compiler, instruction)) {
+                return false;  // Creating a closure captures registers.
+            }
+            use->def = OPERAND_K_A(instruction);
+            return true;
+        case OP_LOAD_BOOL:
+        case OP_LOAD_INLINE_INTEGER:
+        case OP_LOAD_INLINE_STRING:
+        case OP_GET_MODULE_VAR:
+            use->def = OPERAND_K_A(instruction);
+            return true;
+        case OP_SET_MODULE_VAR:
+            use->uses[0] = OPERAND_K_A(instruction);
+            return true;
+
+        case OP_GET_UPVALUE:
+            use->def = OPERAND_T_A(instruction);
+            return true;
+        case OP_SET_UPVALUE:
+            use->uses[0] = OPERAND_T_B(instruction);
+            return true;
+
+        case OP_MOVE:
+        case OP_NEGATE:
+        case OP_BITWISE_INVERT:
+        case OP_BOOL_NOT:
+            use->def     = OPERAND_T_A(instruction);
+            use->uses[0] = OPERAND_T_B(instruction);
+            return true;
+
+        case OP_GET_ATTR:
+            use->def     = OPERAND_T_A(instruction);
+            use->uses[0] = OPERAND_T_B(instruction);
+            use->uses[1] = OPERAND_T_KC(instruction) ? PEEPHOLE_NO_REGISTER : OPERAND_T_C(instruction);
+            return true;
+
+        case OP_NEW_COLLECTION:
+            use->def     = OPERAND_T_A(instruction);
+            use->uses[0] = OPERAND_T_KB(instruction) ? PEEPHOLE_NO_REGISTER : OPERAND_T_B(instruction);
+            return true;
+
+        case OP_ADD:
+        case OP_SUBTRACT:
+        case OP_MULTIPLY:
+        case OP_DIVIDE:
+        case OP_FLOOR_DIVIDE:
+        case OP_MODULO:
+        case OP_POWER:
+        case OP_GT:
+        case OP_GE:
+        case OP_EQ:
+        case OP_NEQ:
+        case OP_BITWISE_AND:
+        case OP_BITWISE_OR:
+        case OP_BITWISE_XOR:
+        case OP_BITWISE_L_SHIFT:
+        case OP_BITWISE_R_SHIFT:
+        case OP_GET_ITEM:
+        case OP_CONTAIN:
+        case OP_CHECK_TYPE:
+            use->def     = OPERAND_T_A(instruction);
+            use->uses[0] = OPERAND_T_KB(instruction) ? PEEPHOLE_NO_REGISTER : OPERAND_T_B(instruction);
+            use->uses[1] = OPERAND_T_KC(instruction) ? PEEPHOLE_NO_REGISTER : OPERAND_T_C(instruction);
+            return true;
+
+        default:
+            return false;
     }
 }
 
-static void enterFunctionScope(Compiler* compiler, bool isDeferredFunction) {
-    if (isDeferredFunction && compiler->currentFunction->isDeferredFunction) {
-        // Make sure deferred functions are not nested
-        SEMI_COMPILE_ABORT(compiler, SEMI_ERROR_NESTED_DEFER, "Nested defer block is not allowed");
-    }
-    FunctionScope* newFunction = semiMalloc(compiler->gc, sizeof(FunctionScope));
-    if (newFunction == NULL) {
-        SEMI_COMPILE_ABORT(
-            compiler, SEMI_ERROR_MEMORY_ALLOCATION_FAILURE, "Failed to allocate memory for function scope");
+// Instructions that only write their destination register and can never fail, so they can be dropped when the
+// register is overwritten before it's read.
+static bool isRemovableDefinition(Compiler* compiler, Instruction instruction) {
+    switch (GET_OPCODE(instruction)) {
+        case OP_LOAD_CONSTANT:
+            return !isFunctionProtoConstant(compiler, instruction);
+        case OP_LOAD_BOOL:
+        case OP_LOAD_INLINE_INTEGER:
+        case OP_LOAD_INLINE_STRING:
+        case OP_MOVE:
+        case OP_GET_UPVALUE:
+            return true;
+        default:
+            return false;
     }
-
-    FunctionScope* currentFunction = compiler->currentFunction;
-    BlockScope* currentBlock       = currentFunction->currentBlock;
-
-    newFunction->rootBlock.type               = BLOCK_SCOPE_TYPE_FN;
-    newFunction->rootBlock.parent             = NULL;
-    newFunction->rootBlock.variableStackStart = currentBlock->variableStackEnd;
-    newFunction->rootBlock.variableStackEnd   = currentBlock->variableStackEnd;
-    newFunction->currentBlock                 = &newFunction->rootBlock;
-
-    newFunction->parent               = currentFunction;
-    newFunction->nextRegisterId       = 0;
-    newFunction->maxUsedRegisterCount = 0;
-    newFunction->nReturns             = UINT8_MAX;
-    newFunction->isDeferredFunction   = isDeferredFunction;
-    ChunkInit(&newFunction->chunk);
-    UpvalueListInit(&newFunction->upvalues);
-
-    compiler->currentFunction = newFunction;
 }
 
-static void leaveFunctionScope(Compiler* compiler) {
-    FunctionScope* currentFunction = compiler->currentFunction;
-    FunctionScope* parentFunction  = currentFunction->parent;
-
-    ChunkCleanup(compiler->gc, &currentFunction->chunk);
-    UpvalueListCleanup(compiler->gc, &currentFunction->upvalues);
-    semiFree(compiler->gc, currentFunction, sizeof(FunctionScope));
-    compiler->currentFunction = parentFunction;
-    compiler->variables.size  = parentFunction->currentBlock->variableStackEnd;
+static inline Instruction replaceOperandA(Instruction instruction, uint8_t a) {
+    return (instruction & ~((Instruction)0xFF << 24)) | ((Instruction)a << 24);
 }
 
-static void enterBlockScope(Compiler* compiler, BlockScope* newBlock, BlockScopeType type) {
-    FunctionScope* currentFunction = compiler->currentFunction;
-    BlockScope* currentBlock       = currentFunction->currentBlock;
-    currentFunction->currentBlock  = newBlock;
-
-    newBlock->parent             = currentBlock;
-    newBlock->variableStackStart = currentBlock->variableStackEnd;
-    newBlock->variableStackEnd   = currentBlock->variableStackEnd;
-    newBlock->type               = type;
-    newBlock->terminalCoarity    = UINT8_MAX;
+static inline Instruction replaceOperandB(Instruction instruction, uint8_t b) {
+    return (instruction & ~((Instruction)0xFF << 16)) | ((Instruction)b << 16);
 }
 
-static void leaveBlockScope(Compiler* compiler) {
-    FunctionScope* currentFunction = compiler->currentFunction;
-    BlockScope* currentBlock       = currentFunction->currentBlock;
-    BlockScope* parentBlock        = currentBlock->parent;
+static inline Instruction replaceOperandC(Instruction instruction, uint8_t c) {
+    return (instruction & ~((Instruction)0xFF << 8)) | ((Instruction)c << 8);
+}
 
-    currentFunction->currentBlock = parentBlock;
-    compiler->variables.size      = parentBlock->variableStackEnd;
+static inline uint8_t shiftRegister(uint8_t reg, uint8_t from, uint8_t shift) {
+    return reg >= from ? (uint8_t)(reg + shift) : reg;
+}
+
+// Adds `shift` to every register operand of `instruction` that is at least `from`, and `cacheShift` to its inline
+// cache operand. Returns false if an operand is not known to be a register, or if a window of consecutive registers
+// read or written by the instruction starts below `from`, since shifting would split it.
+static bool shiftRegisterOperands(
+    Instruction instruction, uint8_t from, uint8_t shift, uint8_t cacheShift, Instruction* shifted) {
+    uint8_t a       = OPERAND_T_A(instruction);
+    uint8_t b       = OPERAND_T_B(instruction);
+    uint8_t c       = OPERAND_T_C(instruction);
+    bool kb         = OPERAND_T_KB(instruction);
+    bool kc         = OPERAND_T_KC(instruction);
+    Instruction ins = instruction;
+    switch (GET_OPCODE(instruction)) {
+        case OP_NOOP:
+        case OP_JUMP:
+        case OP_TRAP:
+        case OP_DEFER_CALL:
+            break;
+
+        case OP_RANGE_NEXT:
+        case OP_ITER_NEXT:
+        case OP_CALL:
+            if (a < from) {
+                return false;
+            }
+            ins = replaceOperandA(ins, shiftRegister(a, from, shift));
+            break;
+        case OP_RETURN:
+            if (a != UINT8_MAX) {
+                ins = replaceOperandA(ins, shiftRegister(a, from, shift));
+            }
+            break;
+        case OP_C_JUMP:
+        case OP_LOAD_CONSTANT:
+        case OP_LOAD_BOOL:
+        case OP_LOAD_INLINE_INTEGER:
+        case OP_LOAD_INLINE_STRING:
+        case OP_GET_MODULE_VAR:
+        case OP_SET_MODULE_VAR:
+        case OP_GET_UPVALUE:
+        case OP_CLOSE_UPVALUES:
+            ins = replaceOperandA(ins, shiftRegister(a, from, shift));
+            break;
+        case OP_SET_UPVALUE:
+            ins = replaceOperandB(ins, shiftRegister(b, from, shift));
+            break;
+
+        case OP_ITER_PREPARE:
+            if (a < from) {
+                return false;
+            }
+            // fall through
+        case OP_MOVE:
+        case OP_NEGATE:
+        case OP_BITWISE_INVERT:
+        case OP_BOOL_NOT:
+            ins = replaceOperandA(ins, shiftRegister(a, from, shift));
+            ins = replaceOperandB(ins, shiftRegister(b, from, shift));
+            break;
+
+        case OP_APPEND_LIST:
+        case OP_APPEND_MAP:
+            if (b < from && c > 0) {
+                return false;
+            }
+            ins = replaceOperandA(ins, shiftRegister(a, from, shift));
+            ins = replaceOperandB(ins, shiftRegister(b, from, shift));
+            break;
+
+        case OP_NEW_COLLECTION:
+            ins = replaceOperandA(ins, shiftRegister(a, from, shift));
+            if (!kb) {
+                ins = replaceOperandB(ins, shiftRegister(b, from, shift));
+            }
+            break;
+
+        case OP_GET_ATTR:
+            ins = replaceOperandA(ins, shiftRegister(a, from, shift));
+            ins = replaceOperandB(ins, shiftRegister(b, from, shift));
+            ins = replaceOperandC(ins, kc ? (uint8_t)(c + cacheShift) : shiftRegister(c, from, shift));
+            break;
+        case OP_SET_ATTR:
+            ins = replaceOperandA(ins, shiftRegister(a, from, shift));
+            ins = replaceOperandB(ins, kb ? (uint8_t)(b + cacheShift) : shiftRegister(b, from, shift));
+            ins = replaceOperandC(ins, shiftRegister(c, from, shift));
+            break;
+
+        case OP_ADD:
+        case OP_SUBTRACT:
+        case OP_MULTIPLY:
+        case OP_DIVIDE:
+        case OP_FLOOR_DIVIDE:
+        case OP_MODULO:
+        case OP_POWER:
+        case OP_GT:
+        case OP_GE:
+        case OP_EQ:
+        case OP_NEQ:
+        case OP_BITWISE_AND:
+        case OP_BITWISE_OR:
+        case OP_BITWISE_XOR:
+        case OP_BITWISE_L_SHIFT:
+        case OP_BITWISE_R_SHIFT:
+        case OP_MAKE_RANGE:
+        case OP_GET_ITEM:
+        case OP_SET_ITEM:
+        case OP_DEL_ITEM:
+        case OP_CONTAIN:
+        case OP_CHECK_TYPE:
+            ins = replaceOperandA(ins, shiftRegister(a, from, shift));
+            if (!kb) {
+                ins = replaceOperandB(ins, shiftRegister(b, from, shift));
+            }
+            if (!kc) {
+                ins = replaceOperandC(ins, shiftRegister(c, from, shift));
+            }
+            break;
+
+        default:
+            return false;
+    }
+    *shifted = ins;
+    return true;
+}
+
+// Rewrites reads of `from` to `to` in `instruction`. Returns whether anything was rewritten.
+static bool propagateCopy(Compiler* compiler, Instruction* instruction, uint8_t from, uint8_t to) {
+    PeepholeRegisterUse use;
+    if (!peepholeRegisterUse(compiler, *instruction, &use)) {
+        return false;
+    }
+
+    bool rewritten = false;
+    if (use.uses[0] == from) {
+        *instruction = GET_OPCODE(*instruction) == OP_SET_MODULE_VAR ? replaceOperandA(*instruction, to)
+                                                                     : replaceOperandB(*instruction, to);
+        rewritten    = true;
+    }
+    if (use.uses[1] == from) {
+        *instruction = replaceOperandC(*instruction, to);
+        rewritten    = true;
+    }
+    return rewritten;
+}
+
+// Whether the value written to `reg` at `pc` is overwritten before anything can read it.
+static bool isDeadStore(Compiler* compiler, const Chunk* chunk, PCLocation pc, int reg) {
+    for (PCLocation i = pc + 1; i < chunk->size; i++) {
+        PeepholeRegisterUse use;
+        if (!peepholeRegisterUse(compiler, chunk->data[i], &use)) {
+            return false;
+        }
+        if (use.uses[0] == reg || use.uses[1] == reg) {
+            return false;
+        }
+        if (use.def == reg) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// The highest register captured by closures created in the chunk, or -1 if there is none. Closing upvalues above it
+// is a no-op.
+static int maxCapturedRegister(Compiler* compiler, const Chunk* chunk) {
+    int maxRegister = -1;
+    for (PCLocation pc = 0; pc < chunk->size; pc++) {
+        Instruction instruction = chunk->data[pc];
+        Opcode opcode           = (Opcode)GET_OPCODE(instruction);
+        if (opcode != OP_DEFER_CALL && (opcode != OP_LOAD_CONSTANT || OPERAND_K_S(instruction))) {
+            continue;
+        }
+
+        Value v = semiConstantTableGet(&compiler->artifactModule->constantTable, OPERAND_K_K(instruction));
+        if (!IS_FUNCTION_PROTO(&v)) {
+            continue;
+        }
+        FunctionProto* proto = AS_FUNCTION_PROTO(&v);
+        for (uint8_t i = 0; i < proto->upvalueCount; i++) {
+            if (proto->upvalues[i].isLocal && proto->upvalues[i].index > maxRegister) {
+                maxRegister = proto->upvalues[i].index;
+            }
+        }
+    }
+    return maxRegister;
+}
+
+// Makes every jump that lands on an unconditional jump go to its final target directly, and replaces jumps to a
+// return with the return itself.
+static void threadJumps(Chunk* chunk) {
+    for (PCLocation pc = 0; pc < chunk->size; pc++) {
+        Instruction* instruction = &chunk->data[pc];
+        Opcode opcode            = (Opcode)GET_OPCODE(*instruction);
+        PCLocation target;
+        if ((opcode != OP_JUMP && opcode != OP_C_JUMP) || !peepholeBranchTarget(*instruction, pc, &target)) {
+            continue;
+        }
+
+        PCLocation finalTarget = target;
+        for (int i = 0; i < PEEPHOLE_MAX_JUMP_THREADINGS && finalTarget < chunk->size; i++) {
+            PCLocation next;
+            Instruction targetInstruction = chunk->data[finalTarget];
+            if (GET_OPCODE(targetInstruction) != OP_JUMP ||
+                !peepholeBranchTarget(targetInstruction, finalTarget, &next) || next == pc) {
+                break;
+            }
+            finalTarget = next;
+        }
+
+        if (opcode == OP_JUMP && finalTarget < chunk->size && GET_OPCODE(chunk->data[finalTarget]) == OP_RETURN) {
+            *instruction = chunk->data[finalTarget];
+        } else if (finalTarget != target) {
+            peepholeRetarget(instruction, pc, finalTarget);
+        }
+    }
+}
+
+// Runs one round of the peephole pass and returns the number of removed instructions.
+static uint32_t peepholeRound(Compiler* compiler, Chunk* chunk, uint8_t* flags, PCLocation* newLocations) {
+    enum { PEEPHOLE_TARGET = 1, PEEPHOLE_REMOVED = 2 };
+
+    threadJumps(chunk);
+
+    memset(flags, 0, chunk->size);
+    for (PCLocation pc = 0; pc < chunk->size; pc++) {
+        PCLocation target;
+        if (peepholeBranchTarget(chunk->data[pc], pc, &target) && target < chunk->size) {
+            flags[target] |= PEEPHOLE_TARGET;
+        }
+    }
+
+    int maxCaptured = maxCapturedRegister(compiler, chunk);
+    for (PCLocation pc = 0; pc < chunk->size; pc++) {
+        Instruction instruction = chunk->data[pc];
+        PCLocation target;
+        switch (GET_OPCODE(instruction)) {
+            case OP_NOOP:
+                flags[pc] |= PEEPHOLE_REMOVED;
+                continue;
+
+            case OP_JUMP:
+                if (!peepholeBranchTarget(instruction, pc, &target) || target == pc + 1) {
+                    flags[pc] |= PEEPHOLE_REMOVED;
+                }
+                continue;
+
+            case OP_CLOSE_UPVALUES:
+                if ((int)OPERAND_T_A(instruction) > maxCaptured) {
+                    flags[pc] |= PEEPHOLE_REMOVED;
+                }
+                continue;
+
+            case OP_MOVE: {
+                uint8_t a = OPERAND_T_A(instruction);
+                uint8_t b = OPERAND_T_B(instruction);
+                if (a == b) {
+                    flags[pc] |= PEEPHOLE_REMOVED;
+                    continue;
+                }
+
+                // MOVE R[a] := R[b] followed by an instruction reading R[a]: read R[b] instead. The MOVE is dead if
+                // that instruction also overwrites R[a].
+                PCLocation next = pc + 1;
+                if (next < chunk->size && !(flags[next] & PEEPHOLE_TARGET) &&
+                    propagateCopy(compiler, &chunk->data[next], a, b)) {
+                    PeepholeRegisterUse use;
+                    if (peepholeRegisterUse(compiler, chunk->data[next], &use) && use.def == a) {
+                        flags[pc] |= PEEPHOLE_REMOVED;
+                        continue;
+                    }
+                }
+                break;
+            }
+
+            default:
+                break;
+        }
+
+        if (isRemovableDefinition(compiler, instruction)) {
+            PeepholeRegisterUse use;
+            peepholeRegisterUse(compiler, instruction, &use);
+            if (isDeadStore(compiler, chunk, pc, use.def)) {
+                flags[pc] |= PEEPHOLE_REMOVED;
+            }
+        }
+    }
+
+    PCLocation newSize = 0;
+    for (PCLocation pc = 0; pc < chunk->size; pc++) {
+        newLocations[pc] = newSize;
+        if (!(flags[pc] & PEEPHOLE_REMOVED)) {
+            newSize++;
+        }
+    }
+    newLocations[chunk->size] = newSize;
+    uint32_t removedCount = chunk->size - newSize;
+    if (removedCount == 0) {
+        return 0;
+    }
+
+    // A removed instruction maps to the next kept one, so jumps to it land on whatever followed it.
+    for (PCLocation pc = 0; pc < chunk->size; pc++) {
+        if (flags[pc] & PEEPHOLE_REMOVED) {
+            continue;
+        }
+        Instruction instruction = chunk->data[pc];
+        PCLocation target;
+        if (peepholeBranchTarget(instruction, pc, &target) &&
+            !peepholeRetarget(&instruction, newLocations[pc], newLocations[target])) {
+            // The new offset is never larger than the old one, so this only happens for a jump to itself.
+            instruction = chunk->data[pc];
+        }
+        chunk->data[newLocations[pc]] = instruction;
+    }
+    chunk->size = newSize;
+    return removedCount;
+}
+
+// Returns the number of removed instructions.
+static uint32_t optimizeChunk(Compiler* compiler, Chunk* chunk) {
+    if (!compiler->enablePeephole || chunk->size == 0) {
+        return 0;
+    }
+    // Operands widened by EXTRA_ARG are not modelled by the pass, so such chunks are left as is.
+    for (PCLocation pc = 0; pc < chunk->size; pc++) {
+        if (GET_OPCODE(chunk->data[pc]) == OP_EXTRA_ARG) {
+            return 0;
+        }
+    }
+
+    // The pass is best-effort: without scratch memory the chunk is left as is. A jump may target the location right
+    // after the last instruction, so the location map has one extra entry.
+    size_t scratchSize = sizeof(PCLocation) * (chunk->size + 1) + sizeof(uint8_t) * chunk->size;
+    ArenaMark mark     = semiArenaMark(&compiler->scratchArena);
+    uint8_t* scratch   = semiArenaAlloc(compiler->gc, &compiler->scratchArena, scratchSize);
+    if (scratch == NULL) {
+        return 0;
+    }
+    PCLocation* newLocations = (PCLocation*)scratch;
+    uint8_t* flags           = scratch + sizeof(PCLocation) * (chunk->size + 1);
+
+    uint32_t removedCount = 0;
+    for (int round = 0; round < PEEPHOLE_MAX_ROUNDS; round++) {
+        uint32_t removed = peepholeRound(compiler, chunk, flags, newLocations);
+        if (removed == 0) {
+            break;
+        }
+        removedCount += removed;
+    }
+
+    semiArenaRelease(compiler->gc, &compiler->scratchArena, mark);
+    compiler->artifactModule->peepholeRemovedCount += removedCount;
+    return removedCount;
+}
+
+#pragma endregion
+
+/*
+ │ Function Inlining
+─┴───────────────────────────────────────────────────────────────────────────────────────────────*/
+#pragma region Function Inlining
+
+// A call to a small top-level function that captures nothing is replaced by a copy of the callee's chunk. The callee's
+// registers are shifted to the window right after the call's target register, which is where CALL would have placed
+// its frame, so the copy reads the arguments in place. Each RETURN becomes a MOVE to the target register followed by
+// a jump to the end of the copy.
+//
+// Functions that defer, capture variables or create closures, iterate with an iterator, build collections or trap are
+// never inlined, so the copy never needs a frame of its own.
+
+#define INLINE_MAX_CHUNK_SIZE 16
+
+static bool isInlinableFunction(Compiler* compiler, const FunctionProto* fn) {
+    // A call of a function without a return value still yields a value, so only single-value functions are inlined.
+    if (fn->upvalueCount != 0 || fn->coarity != 1 || fn->chunk.size > INLINE_MAX_CHUNK_SIZE) {
+        return false;
+    }
+
+    for (PCLocation pc = 0; pc < fn->chunk.size; pc++) {
+        Instruction instruction = fn->chunk.data[pc];
+        Instruction shifted;
+        switch (GET_OPCODE(instruction)) {
+            case OP_RETURN:
+                if (OPERAND_T_A(instruction) == UINT8_MAX) {
+                    return false;
+                }
+                break;
+            case OP_LOAD_CONSTANT:
+                if (isFunctionProtoConstant(compiler, instruction)) {
+                    return false;
+                }
+                break;
+            case OP_NOOP:
+            case OP_TRAP:
+            case OP_DEFER_CALL:
+            case OP_GET_UPVALUE:
+            case OP_SET_UPVALUE:
+            case OP_ITER_PREPARE:
+            case OP_ITER_NEXT:
+            case OP_NEW_COLLECTION:
+            case OP_APPEND_LIST:
+            case OP_APPEND_MAP:
+            case OP_DEL_ITEM:
+                return false;
+            default:
+                if (!shiftRegisterOperands(instruction, 0, 0, 0, &shifted)) {
+                    return false;
+                }
+                break;
+        }
+    }
+    return true;
+}
+
+// Emits the body of `fn` so that its result lands in `targetRegister`, with the arguments already saved to the
+// registers after it. Returns false without emitting anything if the copy doesn't fit in the current function.
+static bool inlineFunctionCall(Compiler* compiler, const FunctionProto* fn, LocalRegisterId targetRegister) {
+    FunctionScope* currentFunction = compiler->currentFunction;
+    uint32_t registerBase          = (uint32_t)targetRegister + 1;
+    uint32_t cacheBase             = currentFunction->attrCaches.size;
+    if (registerBase + fn->maxStackSize > MAX_LOCAL_REGISTER_ID + 1 ||
+        cacheBase + fn->attrCacheCount > MAX_ATTR_CACHE_COUNT) {
+        return false;
+    }
+
+    // Every RETURN but the last one grows into a MOVE and a JUMP.
+    PCLocation newLocations[INLINE_MAX_CHUNK_SIZE + 1];
+    Instruction code[INLINE_MAX_CHUNK_SIZE * 2];
+    PCLocation size   = 0;
+    PCLocation lastPC = fn->chunk.size - 1;
+    for (PCLocation pc = 0; pc < fn->chunk.size; pc++) {
+        newLocations[pc] = size;
+        size += GET_OPCODE(fn->chunk.data[pc]) == OP_RETURN && pc != lastPC ? 2 : 1;
+    }
+    newLocations[fn->chunk.size] = size;
+
+    for (PCLocation pc = 0; pc < fn->chunk.size; pc++) {
+        Instruction instruction = fn->chunk.data[pc];
+        PCLocation location     = newLocations[pc];
+        if (GET_OPCODE(instruction) == OP_RETURN) {
+            code[location] = INSTRUCTION_MOVE(
+                targetRegister, (uint8_t)(OPERAND_T_A(instruction) + registerBase), 0, false, false);
+            if (pc != lastPC) {
+                code[location + 1] = INSTRUCTION_JUMP(size - location - 1, true);
+            }
+            continue;
+        }
+
+        PCLocation target;
+        if (!shiftRegisterOperands(instruction, 0, (uint8_t)registerBase, (uint8_t)cacheBase, &code[location]) ||
+            (peepholeBranchTarget(instruction, pc, &target) &&
+             !peepholeRetarget(&code[location], location, newLocations[target]))) {
+            return false;
+        }
+    }
+
+    AttrCacheList* attrCaches = &currentFunction->attrCaches;
+    for (uint16_t i = 0; i < fn->attrCacheCount; i++) {
+        if (AttrCacheListArenaAppend(compiler->gc, &compiler->arena, attrCaches, fn->attrCaches[i]) != 0) {
+            SEMI_COMPILE_ABORT(compiler, SEMI_ERROR_MEMORY_ALLOCATION_FAILURE, "Failed to allocate attribute cache");
+        }
+    }
+    for (PCLocation i = 0; i < size; i++) {
+        emitCode(compiler, code[i]);
+    }
+    if (registerBase + fn->maxStackSize > currentFunction->maxUsedRegisterCount) {
+        currentFunction->maxUsedRegisterCount = (uint8_t)(registerBase + fn->maxStackSize);
+    }
+    compiler->artifactModule->inlinedCallCount++;
+    return true;
+}
+
+#pragma endregion
+
+/*
+ │ Loop-Invariant Code Motion
+─┴───────────────────────────────────────────────────────────────────────────────────────────────*/
+#pragma region Loop-Invariant Code Motion
+
+// When a range or iterator loop is finished, pure instructions in the first basic block of its body whose operands
+// don't change in the loop are moved in front of it. Each of them writes to a register of its own, made room for by
+// shifting the registers of the loop up, and leaves a MOVE from that register behind. Only the first basic block is
+// considered since it runs in every iteration. If a hoisted instruction may fail, the hoisted code is guarded by a copy
+// of the loop header, so that it only runs if the body runs too.
+
+#define LICM_MAX_HOISTED_COUNT 16
+#define LICM_NO_HOIST          (-1)
+
+typedef enum {
+    // Never fails and reads nothing the loop may change.
+    LICM_KIND_LOAD,
+    // May fail, but the result only depends on the operands.
+    LICM_KIND_PURE,
+    // May fail and reads the contents of an object, which stores and calls in the loop may change.
+    LICM_KIND_READ,
+    LICM_KIND_NONE,
+} LicmKind;
+
+static LicmKind licmKind(Compiler* compiler, Instruction instruction) {
+    switch (GET_OPCODE(instruction)) {
+        case OP_LOAD_CONSTANT:
+            return OPERAND_K_S(instruction) || !isFunctionProtoConstant(compiler, instruction) ? LICM_KIND_LOAD
+                                                                                               : LICM_KIND_NONE;
+        case OP_LOAD_BOOL:
+        case OP_LOAD_INLINE_INTEGER:
+        case OP_LOAD_INLINE_STRING:
+        case OP_GET_MODULE_VAR:
+            return LICM_KIND_LOAD;
+
+        // The built-in magic methods of these operators only take numbers and strings, which are immutable, so all
+        // iterations can share the result. Subtraction and bitwise and / or are left out as they build sets.
+        case OP_ADD:
+        case OP_MULTIPLY:
+        case OP_DIVIDE:
+        case OP_FLOOR_DIVIDE:
+        case OP_MODULO:
+        case OP_POWER:
+        case OP_NEGATE:
+        case OP_BITWISE_XOR:
+        case OP_BITWISE_L_SHIFT:
+        case OP_BITWISE_R_SHIFT:
+        case OP_BITWISE_INVERT:
+        case OP_CHECK_TYPE:
+            return LICM_KIND_PURE;
+
+        case OP_GT:
+        case OP_GE:
+        case OP_EQ:
+        case OP_NEQ:
+        case OP_BOOL_NOT:
+        case OP_GET_ITEM:
+        case OP_GET_ATTR:
+        case OP_CONTAIN:
+            return LICM_KIND_READ;
+
+        default:
+            return LICM_KIND_NONE;
+    }
+}
+
+// The registers read by an instruction that `licmKind` accepts, or `LICM_NO_HOIST`.
+static void licmReadRegisters(Instruction instruction, int reads[2]) {
+    reads[0] = LICM_NO_HOIST;
+    reads[1] = LICM_NO_HOIST;
+    switch (GET_OPCODE(instruction)) {
+        case OP_LOAD_CONSTANT:
+        case OP_LOAD_BOOL:
+        case OP_LOAD_INLINE_INTEGER:
+        case OP_LOAD_INLINE_STRING:
+        case OP_GET_MODULE_VAR:
+            return;
+        case OP_NEGATE:
+        case OP_BITWISE_INVERT:
+        case OP_BOOL_NOT:
+            reads[0] = OPERAND_T_B(instruction);
+            return;
+        default:
+            reads[0] = OPERAND_T_KB(instruction) ? LICM_NO_HOIST : OPERAND_T_B(instruction);
+            reads[1] = OPERAND_T_KC(instruction) ? LICM_NO_HOIST : OPERAND_T_C(instruction);
+            return;
+    }
+}
+
+// Sets `[*first, *last]` to the registers written by an instruction that `shiftRegisterOperands` accepts. Returns false
+// if it writes no register.
+static bool licmWrittenRegisters(Instruction instruction, int* first, int* last) {
+    int a = OPERAND_T_A(instruction);
+    switch (GET_OPCODE(instruction)) {
+        case OP_NOOP:
+        case OP_JUMP:
+        case OP_TRAP:
+        case OP_C_JUMP:
+        case OP_SET_MODULE_VAR:
+        case OP_DEFER_CALL:
+        case OP_SET_UPVALUE:
+        case OP_CLOSE_UPVALUES:
+        case OP_SET_ATTR:
+        case OP_SET_ITEM:
+        case OP_APPEND_LIST:
+        case OP_APPEND_MAP:
+        case OP_RETURN:
+            return false;
+        case OP_ITER_PREPARE:
+            *first = a + 1;
+            *last  = a + 2;
+            return true;
+        case OP_RANGE_NEXT:
+            *first = a + 1;
+            *last  = a + 3;
+            return true;
+        case OP_ITER_NEXT:
+            *first = a + 1;
+            *last  = a + 4;
+            return true;
+        case OP_CALL:
+            // The frame of the callee starts right after the function.
+            *first = a;
+            *last  = UINT8_MAX;
+            return true;
+        default:
+            *first = a;
+            *last  = a;
+            return true;
+    }
+}
+
+// Whether a module variable loaded in the loop holds the same value in all iterations.
+static bool isModuleVariableInvariant(
+    Compiler* compiler, const Chunk* chunk, PCLocation start, Instruction load, bool hasCall) {
+    for (PCLocation pc = start; pc < chunk->size; pc++) {
+        Instruction instruction = chunk->data[pc];
+        if (GET_OPCODE(instruction) == OP_SET_MODULE_VAR && OPERAND_K_K(instruction) == OPERAND_K_K(load) &&
+            OPERAND_K_S(instruction) == OPERAND_K_S(load)) {
+            return false;
+        }
+    }
+    if (!hasCall) {
+        return true;
+    }
+
+    // A called function may assign it, unless the name is never assigned to anywhere in the module.
+    SemiModule* module = compiler->artifactModule;
+    ObjectDict* dict   = OPERAND_K_S(load) ? &module->exports : &module->globals;
+    return !semiDictHas(&compiler->reassignedIdentifiers, dict->keys[OPERAND_K_K(load)].key);
+}
+
+static inline bool isBasicBlockEnd(Instruction instruction) {
+    switch (GET_OPCODE(instruction)) {
+        case OP_JUMP:
+        case OP_C_JUMP:
+        case OP_RANGE_NEXT:
+        case OP_ITER_NEXT:
+        case OP_RETURN:
+        case OP_TRAP:
+            return true;
+        default:
+            return false;
+    }
+}
+
+typedef struct LicmCandidate {
+    PCLocation pc;
+    LicmKind kind;
+    // The candidates whose results operands B and C read, or `LICM_NO_HOIST`.
+    int sources[2];
+    bool isUsed;
+    // The index of the register of the result among the hoisted registers, or `LICM_NO_HOIST` if it stays in the loop.
+    int index;
+} LicmCandidate;
+
+// Hoists the invariants of the loop that spans from `loopLocation` to the end of the chunk. Its header at
+// `headerLocation` is a RANGE_NEXT or ITER_NEXT, and the registers from `iterReg` on are only used by the loop.
+static void hoistLoopInvariants(Compiler* compiler,
+                                PCLocation loopLocation,
+                                PCLocation headerLocation,
+                                LocalRegisterId iterReg) {
+    FunctionScope* currentFunction = compiler->currentFunction;
+    Chunk* chunk                   = &currentFunction->chunk;
+    PCLocation end                 = chunk->size;
+    if (!compiler->enableLoopInvariantCodeMotion || headerLocation + 1 >= end) {
+        return;
+    }
+
+    // The location map has one extra entry for the location right after the loop.
+    uint32_t loopSize  = end - loopLocation;
+    uint32_t codeSize  = loopSize + LICM_MAX_HOISTED_COUNT + 2;
+    size_t scratchSize = sizeof(PCLocation) * (loopSize + 1) + sizeof(Instruction) * codeSize +
+                         sizeof(int8_t) * loopSize + sizeof(bool) * loopSize;
+    ArenaMark mark   = semiArenaMark(&compiler->scratchArena);
+    uint8_t* scratch = semiArenaAlloc(compiler->gc, &compiler->scratchArena, scratchSize);
+    if (scratch == NULL) {
+        return;
+    }
+    PCLocation* newLocations = (PCLocation*)scratch;
+    Instruction* code        = (Instruction*)(newLocations + loopSize + 1);
+    int8_t* candidateIndices = (int8_t*)(code + codeSize);
+    bool* isBranchTarget     = (bool*)(candidateIndices + loopSize);
+    memset(candidateIndices, LICM_NO_HOIST, sizeof(int8_t) * loopSize);
+    memset(isBranchTarget, 0, sizeof(bool) * loopSize);
+
+    bool isWritten[UINT8_MAX + 1] = {false};
+    bool hasCall                  = false;
+    bool hasStore                 = false;
+    for (PCLocation pc = loopLocation; pc < end; pc++) {
+        Instruction instruction = chunk->data[pc];
+        Opcode opcode           = (Opcode)GET_OPCODE(instruction);
+        // Closures capture registers by index, so the registers of a loop that creates them can't be shifted.
+        Instruction shifted;
+        if (!shiftRegisterOperands(instruction, iterReg, 0, 0, &shifted) || opcode == OP_DEFER_CALL ||
+            (opcode == OP_LOAD_CONSTANT && licmKind(compiler, instruction) == LICM_KIND_NONE)) {
+            goto cleanup;
+        }
+
+        // Only the header is entered from the code before it.
+        PCLocation target;
+        if (peepholeBranchTarget(instruction, pc, &target)) {
+            if (target < loopLocation || target > end || (pc < headerLocation) != (target < headerLocation)) {
+                goto cleanup;
+            }
+            if (target < end) {
+                isBranchTarget[target - loopLocation] = true;
+            }
+        }
+
+        if (pc < headerLocation) {
+            continue;
+        }
+        hasCall |= opcode == OP_CALL;
+        hasStore |= opcode == OP_CALL || opcode == OP_SET_ITEM || opcode == OP_SET_ATTR || opcode == OP_APPEND_LIST ||
+                    opcode == OP_APPEND_MAP || opcode == OP_DEL_ITEM;
+        int first, last;
+        if (licmWrittenRegisters(instruction, &first, &last)) {
+            for (int reg = first; reg <= last; reg++) {
+                isWritten[reg] = true;
+            }
+        }
+    }
+
+    // Walk the first basic block of the body. `barrier` is set once an instruction that stays in the loop may fail or
+    // has side effects, as hoisting an instruction that may fail past it would change which error is reported.
+    LicmCandidate candidates[LICM_MAX_HOISTED_COUNT];
+    int candidateCount = 0;
+    int definedBy[UINT8_MAX + 1];
+    for (int reg = 0; reg <= UINT8_MAX; reg++) {
+        definedBy[reg] = LICM_NO_HOIST;
+    }
+    bool barrier = false;
+    for (PCLocation pc = headerLocation + 1; pc < end; pc++) {
+        if (pc > headerLocation + 1 && isBranchTarget[pc - loopLocation]) {
+            break;
+        }
+        Instruction instruction = chunk->data[pc];
+        LicmKind kind           = licmKind(compiler, instruction);
+        bool isHoistable        = kind != LICM_KIND_NONE && candidateCount < LICM_MAX_HOISTED_COUNT &&
+                           (kind == LICM_KIND_LOAD || !barrier) && (kind != LICM_KIND_READ || !hasStore) &&
+                           (GET_OPCODE(instruction) != OP_GET_MODULE_VAR ||
+                            isModuleVariableInvariant(compiler, chunk, headerLocation, instruction, hasCall));
+
+        int reads[2];
+        licmReadRegisters(instruction, reads);
+        LicmCandidate candidate = {.pc = pc, .kind = kind, .isUsed = false, .index = LICM_NO_HOIST};
+        for (int i = 0; i < 2 && isHoistable; i++) {
+            candidate.sources[i] = reads[i] == LICM_NO_HOIST ? LICM_NO_HOIST : definedBy[reads[i]];
+            // Registers the loop never writes may still be assigned by a called closure.
+            isHoistable = reads[i] == LICM_NO_HOIST || definedBy[reads[i]] != LICM_NO_HOIST ||
+                          (!isWritten[reads[i]] && !hasCall);
+        }
+
+        if (isHoistable) {
+            for (int i = 0; i < 2; i++) {
+                if (candidate.sources[i] != LICM_NO_HOIST) {
+                    candidates[candidate.sources[i]].isUsed = true;
+                }
+            }
+            candidateIndices[pc - loopLocation] = (int8_t)candidateCount;
+            definedBy[OPERAND_T_A(instruction)] = candidateCount;
+            candidates[candidateCount++]        = candidate;
+            continue;
+        }
+
+        Opcode opcode = (Opcode)GET_OPCODE(instruction);
+        if (kind != LICM_KIND_LOAD && opcode != OP_MOVE && opcode != OP_NOOP) {
+            barrier = true;
+        }
+        int first, last;
+        if (licmWrittenRegisters(instruction, &first, &last)) {
+            for (int reg = first; reg <= last; reg++) {
+                definedBy[reg] = LICM_NO_HOIST;
+            }
+        }
+        if (isBasicBlockEnd(instruction)) {
+            break;
+        }
+    }
+
+    // A load on its own is as cheap as the MOVE it would leave behind, so it's only hoisted for another candidate.
+    PCLocation hoistedCount = 0;
+    bool needsGuard         = false;
+    for (int i = 0; i < candidateCount; i++) {
+        if (candidates[i].kind == LICM_KIND_LOAD && !candidates[i].isUsed) {
+            candidateIndices[candidates[i].pc - loopLocation] = LICM_NO_HOIST;
+            continue;
+        }
+        candidates[i].index = (int)hoistedCount++;
+        needsGuard |= candidates[i].kind != LICM_KIND_LOAD;
+    }
+    if (hoistedCount == 0 || currentFunction->maxUsedRegisterCount + hoistedCount > MAX_LOCAL_REGISTER_ID + 1) {
+        goto cleanup;
+    }
+    uint8_t shift = (uint8_t)hoistedCount;
+
+    // Layout: setup, [guard], hoisted instructions, [jump over the header], header, body.
+    PCLocation size = 0;
+    for (PCLocation pc = loopLocation; pc < end; pc++) {
+        if (pc == headerLocation) {
+            size += hoistedCount + (needsGuard ? 2 : 0);
+        }
+        newLocations[pc - loopLocation] = size++;
+    }
+    newLocations[loopSize] = size;
+
+    PCLocation hoistedLocation = newLocations[headerLocation - loopLocation] - hoistedCount - (needsGuard ? 1 : 0);
+    if (needsGuard) {
+        Instruction header = chunk->data[headerLocation];
+        PCLocation exit;
+        shiftRegisterOperands(header, iterReg, shift, 0, &code[hoistedLocation - 1]);
+        if (!peepholeBranchTarget(header, headerLocation, &exit) ||
+            !peepholeRetarget(
+                &code[hoistedLocation - 1], hoistedLocation - 1, newLocations[exit - loopLocation])) {
+            goto cleanup;
+        }
+        code[hoistedLocation + hoistedCount] = INSTRUCTION_JUMP(2, true);
+    }
+
+    for (PCLocation pc = loopLocation; pc < end; pc++) {
+        Instruction instruction = chunk->data[pc];
+        PCLocation location     = newLocations[pc - loopLocation];
+        int candidateIndex      = candidateIndices[pc - loopLocation];
+        shiftRegisterOperands(instruction, iterReg, shift, 0, &code[location]);
+
+        if (candidateIndex != LICM_NO_HOIST) {
+            LicmCandidate* candidate = &candidates[candidateIndex];
+            uint8_t hoistedReg       = (uint8_t)(iterReg + candidate->index);
+            Instruction hoisted      = replaceOperandA(code[location], hoistedReg);
+            if (candidate->sources[0] != LICM_NO_HOIST) {
+                hoisted = replaceOperandB(hoisted, (uint8_t)(iterReg + candidates[candidate->sources[0]].index));
+            }
+            if (candidate->sources[1] != LICM_NO_HOIST) {
+                hoisted = replaceOperandC(hoisted, (uint8_t)(iterReg + candidates[candidate->sources[1]].index));
+            }
+            code[hoistedLocation + (PCLocation)candidate->index] = hoisted;
+            code[location] = INSTRUCTION_MOVE(OPERAND_T_A(code[location]), hoistedReg, 0, false, false);
+            continue;
+        }
+
+        PCLocation target;
+        if (peepholeBranchTarget(instruction, pc, &target) &&
+            !peepholeRetarget(&code[location], location, newLocations[target - loopLocation])) {
+            goto cleanup;
+        }
+    }
+
+    rewindCode(compiler, loopLocation);
+    for (PCLocation i = 0; i < size; i++) {
+        emitCode(compiler, code[i]);
+    }
+    currentFunction->maxUsedRegisterCount += shift;
+    compiler->artifactModule->hoistedInstructionCount += hoistedCount;
+
+cleanup:
+    semiArenaRelease(compiler->gc, &compiler->scratchArena, mark);
+}
+
+#pragma endregion
+
+/*
+ │ Incremental Compilation
+─┴───────────────────────────────────────────────────────────────────────────────────────────────*/
+#pragma region Incremental Compilation
+
+// When a module is compiled again, a top-level function whose source after its name is unchanged reuses the proto from
+// the last compilation, which is still in the constant table of the module. The body may depend on facts from outside
+// its source: module constants folded into it, functions inlined into it, the module variables it resolved and the
+// names of its local variables are recorded as its dependencies and must be unchanged too, while the module-wide facts,
+// such as which identifiers are assigned to anywhere in the module, are summarized by the environment fingerprint.
+// Functions with upvalues are never cached.
+
+static inline uint64_t mixFingerprint(uint64_t key) {
+    key ^= (key >> 33);
+    key *= 0xff51afd7ed558ccd;
+    key ^= (key >> 33);
+    key *= 0xc4ceb9fe1a85ec53;
+    key ^= (key >> 33);
+    return key;
+}
+
+// The options that change the code the compiler generates, as bits.
+static uint32_t compilerConfiguration(const Compiler* compiler) {
+    return ((uint32_t)compiler->enablePeephole << 3) | ((uint32_t)compiler->enableConstantPropagation << 2) |
+           ((uint32_t)compiler->enableInlining << 1) | (uint32_t)compiler->enableLoopInvariantCodeMotion;
+}
+
+static uint64_t environmentFingerprint(Compiler* compiler) {
+    uint64_t fingerprint = mixFingerprint(compilerConfiguration(compiler));
+
+    // Both sets are summed so that the fingerprint doesn't depend on the order of their elements.
+    ObjectDict* reassigned = &compiler->reassignedIdentifiers;
+    for (uint32_t i = 0; i < reassigned->used; i++) {
+        Value key = reassigned->keys[i].key;
+        if (IS_INT(&key)) {
+            fingerprint += mixFingerprint((uint64_t)AS_INT(&key) << 1);
+        }
+    }
+    for (ModuleVariableId i = 0; i < compiler->globalIdentifiers->size; i++) {
+        fingerprint += mixFingerprint(((uint64_t)compiler->globalIdentifiers->data[i] << 1) | 1);
+    }
+    return fingerprint;
+}
+
+static uint64_t fingerprintValue(Value value) {
+    switch (VALUE_TYPE(&value)) {
+        case VALUE_TYPE_BOOL:
+            return AS_BOOL(&value);
+        case VALUE_TYPE_INLINE_STRING:
+            return semiHashBytes64(AS_INLINE_STRING(&value).c, AS_INLINE_STRING(&value).length);
+        case VALUE_TYPE_OBJECT_STRING:
+            return semiHashBytes64(AS_OBJECT_STRING(&value)->str, AS_OBJECT_STRING(&value)->length);
+        case VALUE_TYPE_FUNCTION_PROTO:
+            return (uint64_t)(uintptr_t)AS_FUNCTION_PROTO(&value);
+        default:
+            // Integers and floats are compared bit by bit.
+            return (uint64_t)value.as.i;
+    }
+}
+
+static void appendDependency(Compiler* compiler, DeclarationDependency dependency) {
+    if (DeclarationDependencyListAppend(compiler->gc, &compiler->declarationCache.dependencies, dependency) != 0) {
+        SEMI_COMPILE_ABORT(
+            compiler, SEMI_ERROR_MEMORY_ALLOCATION_FAILURE, "Memory allocation failure when recording dependency");
+    }
+}
+
+// Record that the body being compiled relies on `identifierId` being bound to `value`, a folded module constant or an
+// inlined function.
+static void recordValueDependency(Compiler* compiler, IdentifierId identifierId, Value value) {
+    appendDependency(compiler,
+                     (DeclarationDependency){
+                         .identifierId = identifierId,
+                         .kind         = IS_FUNCTION_PROTO(&value) ? DECLARATION_DEPENDENCY_INLINED_FUNCTION
+                                                                   : DECLARATION_DEPENDENCY_CONSTANT,
+                         .valueType    = VALUE_TYPE(&value),
+                         .fingerprint  = fingerprintValue(value),
+                     });
+}
+
+// Record that the body being compiled resolved `identifierId` to a module variable, or bound it as a local variable.
+static void recordNameDependency(Compiler* compiler,
+                                 IdentifierId identifierId,
+                                 DeclarationDependencyKind kind,
+                                 bool isExport) {
+    appendDependency(compiler,
+                     (DeclarationDependency){
+                         .identifierId = identifierId,
+                         .kind         = kind,
+                         .valueType    = VALUE_TYPE_INVALID,
+                         .fingerprint  = isExport,
+                     });
+}
+
+static bool isDependencyUnchanged(Compiler* compiler, const DeclarationDependency* dependency) {
+    SemiModule* module = compiler->artifactModule;
+    Value key          = semiValueIntCreate(dependency->identifierId);
+    ValueHash hash     = semiHash64Bits(dependency->identifierId);
+    switch (dependency->kind) {
+        case DECLARATION_DEPENDENCY_CONSTANT:
+        case DECLARATION_DEPENDENCY_INLINED_FUNCTION: {
+            ObjectDict* source = dependency->kind == DECLARATION_DEPENDENCY_INLINED_FUNCTION
+                                     ? &compiler->inlineCandidates
+                                     : &compiler->moduleConstants;
+            Value current      = semiDictLen(source) > 0 ? semiDictGet(source, key) : INVALID_VALUE;
+            return IS_VALID(&current) && VALUE_TYPE(&current) == dependency->valueType &&
+                   fingerprintValue(current) == dependency->fingerprint;
+        }
+
+        // Only a recompilation reuses declarations, so the module variables visible at this point are exactly the ones
+        // in `definedModuleVariables`.
+        case DECLARATION_DEPENDENCY_MODULE_VARIABLE: {
+            Value defined = semiDictGetWithHash(&compiler->definedModuleVariables, key, hash);
+            return IS_BOOL(&defined) && AS_BOOL(&defined) == (dependency->fingerprint != 0);
+        }
+        case DECLARATION_DEPENDENCY_LOCAL_VARIABLE:
+            return !semiDictHasWithHash(&compiler->definedModuleVariables, key, hash);
+    }
+    return false;
+}
+
+// Add a declaration to the cache built by this compilation, together with a copy of its `dependencies`.
+static void cacheDeclaration(Compiler* compiler,
+                             CachedDeclaration declaration,
+                             const DeclarationDependency* dependencies) {
+    DeclarationCache* cache = &compiler->declarationCache;
+    if (dependencies != NULL) {
+        declaration.dependencyStart = cache->dependencies.size;
+        for (uint32_t i = 0; i < declaration.dependencyCount; i++) {
+            if (DeclarationDependencyListAppend(compiler->gc, &cache->dependencies, dependencies[i]) != 0) {
+                goto allocation_failure;
+            }
+        }
+    }
+
+    if (!semiDictSet(compiler->gc,
+                     &cache->index,
+                     semiValueIntCreate(declaration.identifierId),
+                     semiValueIntCreate(cache->declarations.size)) ||
+        CachedDeclarationListAppend(compiler->gc, &cache->declarations, declaration) != 0) {
+        goto allocation_failure;
+    }
+    return;
+
+allocation_failure:
+    SEMI_COMPILE_ABORT(
+        compiler, SEMI_ERROR_MEMORY_ALLOCATION_FAILURE, "Memory allocation failure when caching declaration");
+}
+
+// Return the cached declaration of the top-level function `identifierId` if the source ahead of the lexer is the same
+// and nothing its body relied on has changed, or NULL if the function has to be compiled.
+static const CachedDeclaration* findUnchangedDeclaration(Compiler* compiler, IdentifierId identifierId) {
+    DeclarationCache* cache = &compiler->artifactModule->declarationCache;
+    Lexer* lexer            = &compiler->lexer;
+    if (!compiler->canReuseDeclarations || lexer->token != TK_NON_TOKEN) {
+        return NULL;
+    }
+
+    Value indexValue = semiDictGet(&cache->index, semiValueIntCreate(identifierId));
+    if (IS_INVALID(&indexValue)) {
+        return NULL;
+    }
+    const CachedDeclaration* declaration = &cache->declarations.data[AS_INT(&indexValue)];
+    if ((size_t)(lexer->end - lexer->curr) < declaration->sourceLength ||
+        semiHashBytes64(lexer->curr, declaration->sourceLength) != declaration->sourceHash) {
+        return NULL;
+    }
+    for (uint32_t i = 0; i < declaration->dependencyCount; i++) {
+        if (!isDependencyUnchanged(compiler, &cache->dependencies.data[declaration->dependencyStart + i])) {
+            return NULL;
+        }
+    }
+    return declaration;
+}
+
+// Move the lexer past the source of a reused declaration and carry the declaration over to the new cache.
+static FunctionProto* reuseDeclaration(Compiler* compiler, const CachedDeclaration* declaration) {
+    Lexer* lexer = &compiler->lexer;
+    if (declaration->lineCount > 0) {
+        lexer->line += declaration->lineCount;
+        lexer->lineStart = lexer->curr + declaration->lastLineOffset;
+    }
+    lexer->curr += declaration->sourceLength;
+
+    DeclarationCache* previous = &compiler->artifactModule->declarationCache;
+    cacheDeclaration(compiler, *declaration, &previous->dependencies.data[declaration->dependencyStart]);
+    compiler->artifactModule->reusedFunctionCount++;
+
+    Value fnValue = semiConstantTableGet(&compiler->artifactModule->constantTable, declaration->protoIndex);
+    return AS_FUNCTION_PROTO(&fnValue);
+}
+
+// A recompilation leaves the prototypes and constants of the replaced functions in the constant table, and the
+// variables no longer declared in the module dicts. They are dropped unless something may still run them: the module
+// initializer, the cached declarations, a value of the VM, or a function whose constants refer to them. The entries
+// after a dropped one move down, so the operands of every remaining function are relocated.
+
+typedef struct CompactedSlots {
+    uint32_t count;
+    bool* isDropped;
+    // The slot of each entry after the compaction.
+    uint32_t* slots;
+} CompactedSlots;
+
+typedef struct ModuleCompaction {
+    SemiModule* module;
+    CompactedSlots constants;
+    CompactedSlots exports;
+    CompactedSlots globals;
+
+    // The prototypes in the constant table by address, and the ones found live whose operands are not marked yet.
+    ObjectDict functionIndices;
+    ConstantIndex* pendingFunctions;
+    uint32_t pendingFunctionCount;
+} ModuleCompaction;
+
+static bool initCompactedSlots(GC* gc, CompactedSlots* slots, uint32_t count) {
+    slots->count     = count;
+    slots->isDropped = semiMalloc(gc, sizeof(bool) * count);
+    slots->slots     = semiMalloc(gc, sizeof(uint32_t) * count);
+    if (count > 0 && (slots->isDropped == NULL || slots->slots == NULL)) {
+        return false;
+    }
+    memset(slots->isDropped, true, sizeof(bool) * count);
+    return true;
+}
+
+static void cleanupCompactedSlots(GC* gc, CompactedSlots* slots) {
+    semiFree(gc, slots->isDropped, sizeof(bool) * slots->count);
+    semiFree(gc, slots->slots, sizeof(uint32_t) * slots->count);
+}
+
+// Number the entries that are kept, and return whether any entry is dropped.
+static bool numberCompactedSlots(CompactedSlots* slots) {
+    uint32_t next = 0;
+    for (uint32_t i = 0; i < slots->count; i++) {
+        slots->slots[i] = next;
+        next += !slots->isDropped[i];
+    }
+    return next != slots->count;
+}
+
+static void keepConstant(ModuleCompaction* compaction, uint32_t index) {
+    if (index >= compaction->constants.count || !compaction->constants.isDropped[index]) {
+        return;
+    }
+    compaction->constants.isDropped[index] = false;
+
+    Value value = semiConstantTableGet(&compaction->module->constantTable, index);
+    if (IS_FUNCTION_PROTO(&value)) {
+        compaction->pendingFunctions[compaction->pendingFunctionCount++] = index;
+    }
+}
+
+static void keepVisitedFunction(FunctionProto* function, void* userData) {
+    ModuleCompaction* compaction = (ModuleCompaction*)userData;
+    Value index                  = semiDictGet(&compaction->functionIndices, semiValueIntCreate((int64_t)(uintptr_t)function));
+    if (IS_INT(&index)) {
+        keepConstant(compaction, (uint32_t)AS_INT(&index));
+    }
+}
+
+// Keep the constants and module variables `function` refers to, or, once the kept entries are numbered, rewrite its
+// operands to their new slots. A slot never moves up, so the new operand fits where the old one was.
+static void compactFunctionOperands(ModuleCompaction* compaction, FunctionProto* function, bool isRelocating) {
+    Chunk* chunk = &function->chunk;
+    for (PCLocation pc = 0; pc < chunk->size; pc++) {
+        Instruction* extraArg = NULL;
+        if (GET_OPCODE(chunk->data[pc]) == OP_EXTRA_ARG && pc + 1 < chunk->size) {
+            extraArg = &chunk->data[pc++];
+        }
+        Instruction* instruction = &chunk->data[pc];
+        uint32_t k               = (extraArg != NULL ? OPERAND_J_J(*extraArg) << 16 : 0) | OPERAND_K_K(*instruction);
+
+        CompactedSlots* slots;
+        switch (GET_OPCODE(*instruction)) {
+            case OP_LOAD_CONSTANT:
+                if (OPERAND_K_I(*instruction)) {
+                    continue;
+                }
+                slots = &compaction->constants;
+                break;
+            case OP_DEFER_CALL:
+                slots = &compaction->constants;
+                break;
+            case OP_GET_MODULE_VAR:
+            case OP_SET_MODULE_VAR:
+                slots = OPERAND_K_S(*instruction) ? &compaction->exports : &compaction->globals;
+                break;
+            default:
+                continue;
+        }
+        if (k >= slots->count) {
+            continue;
+        }
+
+        if (!isRelocating) {
+            if (slots == &compaction->constants) {
+                keepConstant(compaction, k);
+            } else {
+                slots->isDropped[k] = false;
+            }
+            continue;
+        }
+        uint32_t slot = slots->slots[k];
+        *instruction  = (*instruction & ~(MAX_OPERAND_K << 8)) | ((slot & MAX_OPERAND_K) << 8);
+        if (extraArg != NULL) {
+            *extraArg = INSTRUCTION_EXTRA_ARG(slot >> 16, false);
+        }
+    }
+}
+
+static void keepModuleVariable(ModuleCompaction* compaction, Value identifier, bool isExport) {
+    ObjectDict* dict      = isExport ? &compaction->module->exports : &compaction->module->globals;
+    CompactedSlots* slots = isExport ? &compaction->exports : &compaction->globals;
+    TupleId tupleId       = semiDictFindTupleId(dict, identifier, semiHash64Bits((uint64_t)AS_INT(&identifier)));
+    if (tupleId >= 0) {
+        slots->isDropped[tupleId] = false;
+    }
+}
+
+// Drop what the last compilation of `module` left unreachable. `definedModuleVariables` holds the variables the
+// compilation defined, or is NULL if it failed, in which case no variable is dropped.
+static void compactModule(SemiVM* vm, SemiModule* module, ObjectDict* definedModuleVariables) {
+    GC* gc                      = &vm->gc;
+    ConstantTable* table        = &module->constantTable;
+    ModuleCompaction compaction = {.module = module};
+    semiObjectStackDictInit(&compaction.functionIndices);
+
+    uint32_t constantCount      = (uint32_t)semiConstantTableSize(table);
+    compaction.pendingFunctions = semiMalloc(gc, sizeof(ConstantIndex) * constantCount);
+    if (!initCompactedSlots(gc, &compaction.constants, constantCount) ||
+        !initCompactedSlots(gc, &compaction.exports, semiDictLen(&module->exports)) ||
+        !initCompactedSlots(gc, &compaction.globals, semiDictLen(&module->globals)) ||
+        (constantCount > 0 && compaction.pendingFunctions == NULL)) {
+        goto cleanup;
+    }
+    for (ConstantIndex i = 0; i < constantCount; i++) {
+        Value value = semiConstantTableGet(table, i);
+        if (IS_FUNCTION_PROTO(&value) &&
+            !semiDictSet(gc,
+                         &compaction.functionIndices,
+                         semiValueIntCreate((int64_t)(uintptr_t)AS_FUNCTION_PROTO(&value)),
+                         semiValueIntCreate(i))) {
+            goto cleanup;
+        }
+    }
+
+    if (module->moduleInit != NULL) {
+        compactFunctionOperands(&compaction, module->moduleInit, false);
+    }
+    DeclarationCache* cache = &module->declarationCache;
+    for (uint32_t i = 0; i < cache->declarations.size; i++) {
+        keepConstant(&compaction, cache->declarations.data[i].protoIndex);
+    }
+    if (definedModuleVariables != NULL) {
+        for (uint32_t i = 0; i < definedModuleVariables->used; i++) {
+            keepModuleVariable(
+                &compaction, definedModuleVariables->keys[i].key, AS_BOOL(&definedModuleVariables->values[i]));
+        }
+    } else {
+        // The variables of the last compilation are still bound by name, and some are never referred to by code.
+        memset(compaction.exports.isDropped, false, sizeof(bool) * compaction.exports.count);
+        memset(compaction.globals.isDropped, false, sizeof(bool) * compaction.globals.count);
+    }
+    if (!semiGCVisitFunctionProtos(gc, module, keepVisitedFunction, &compaction)) {
+        goto cleanup;
+    }
+    while (compaction.pendingFunctionCount > 0) {
+        Value value = semiConstantTableGet(table, compaction.pendingFunctions[--compaction.pendingFunctionCount]);
+        compactFunctionOperands(&compaction, AS_FUNCTION_PROTO(&value), false);
+    }
+
+    bool isConstantDropped = numberCompactedSlots(&compaction.constants);
+    bool isExportDropped   = numberCompactedSlots(&compaction.exports);
+    bool isGlobalDropped   = numberCompactedSlots(&compaction.globals);
+    if (!isConstantDropped && !isExportDropped && !isGlobalDropped) {
+        goto cleanup;
+    }
+
+    if (module->moduleInit != NULL) {
+        compactFunctionOperands(&compaction, module->moduleInit, true);
+    }
+    for (ConstantIndex i = 0; i < constantCount; i++) {
+        Value value = semiConstantTableGet(table, i);
+        if (!IS_FUNCTION_PROTO(&value)) {
+            continue;
+        }
+        if (compaction.constants.isDropped[i]) {
+            semiFunctionProtoDestroy(gc, AS_FUNCTION_PROTO(&value));
+        } else {
+            compactFunctionOperands(&compaction, AS_FUNCTION_PROTO(&value), true);
+        }
+    }
+    for (uint32_t i = 0; i < cache->declarations.size; i++) {
+        cache->declarations.data[i].protoIndex = compaction.constants.slots[cache->declarations.data[i].protoIndex];
+    }
+
+    semiDictDeleteTuples(table->constantMap, compaction.constants.isDropped);
+    for (ConstantIndex i = 0; i < semiConstantTableSize(table); i++) {
+        table->constantMap->values[i] = semiValueIntCreate(i);
+    }
+    semiDictDeleteTuples(&module->exports, compaction.exports.isDropped);
+    semiDictDeleteTuples(&module->globals, compaction.globals.isDropped);
+
+cleanup:
+    semiFree(gc, compaction.pendingFunctions, sizeof(ConstantIndex) * constantCount);
+    cleanupCompactedSlots(gc, &compaction.constants);
+    cleanupCompactedSlots(gc, &compaction.exports);
+    cleanupCompactedSlots(gc, &compaction.globals);
+    semiObjectStackDictCleanup(gc, &compaction.functionIndices);
+}
+
+#pragma endregion
+
+/*
+ │ Register Management & Variable Resolution
+─┴───────────────────────────────────────────────────────────────────────────────────────────────*/
+#pragma region Register Management & Variable Resolution
+
+#define IS_TOP_LEVEL(compiler) ((compiler)->currentFunction->currentBlock == &(compiler)->rootFunction.rootBlock)
+
+DEFINE_ARENA_DARRAY(VariableList, VariableDescription, uint16_t, UINT16_MAX)
+DEFINE_ARENA_DARRAY(UpvalueList, UpvalueDescription, uint8_t, MAX_UPVALUE_COUNT)
+DEFINE_ARENA_DARRAY(AttrCacheList, AttrCache, uint16_t, MAX_ATTR_CACHE_COUNT)
+
+static LocalRegisterId reserveTempRegister(Compiler* compiler) {
+    FunctionScope* currentFunction = compiler->currentFunction;
+    if (currentFunction->nextRegisterId == INVALID_LOCAL_REGISTER_ID) {
+        SEMI_COMPILE_ABORT(compiler, SEMI_ERROR_TOO_MANY_LOCAL_VARIABLES, "Too many temporary registers");
+    }
+
+    LocalRegisterId registerId = currentFunction->nextRegisterId++;
+    if (currentFunction->nextRegisterId > currentFunction->maxUsedRegisterCount) {
+        currentFunction->maxUsedRegisterCount = currentFunction->nextRegisterId;
+    }
+    return registerId;
+}
+
+static inline LocalRegisterId getNextRegisterId(Compiler* compiler) {
+    return compiler->currentFunction->nextRegisterId;
+}
+
+static inline void restoreNextRegisterId(Compiler* compiler, LocalRegisterId registerId) {
+    FunctionScope* currentFunction = compiler->currentFunction;
+
+    currentFunction->nextRegisterId = registerId;
+    if (currentFunction->nextRegisterId > currentFunction->maxUsedRegisterCount) {
+        currentFunction->maxUsedRegisterCount = currentFunction->nextRegisterId;
+    }
+}
+
+static void enterFunctionScope(Compiler* compiler, bool isDeferredFunction) {
+    if (isDeferredFunction && compiler->currentFunction->isDeferredFunction) {
+        // Make sure deferred functions are not nested
+        SEMI_COMPILE_ABORT(compiler, SEMI_ERROR_NESTED_DEFER, "Nested defer block is not allowed");
+    }
+    FunctionScope* newFunction = semiArenaAlloc(compiler->gc, &compiler->arena, sizeof(FunctionScope));
+    if (newFunction == NULL) {
+        SEMI_COMPILE_ABORT(
+            compiler, SEMI_ERROR_MEMORY_ALLOCATION_FAILURE, "Failed to allocate memory for function scope");
+    }
+
+    FunctionScope* currentFunction = compiler->currentFunction;
+    BlockScope* currentBlock       = currentFunction->currentBlock;
+
+    newFunction->rootBlock.type               = BLOCK_SCOPE_TYPE_FN;
+    newFunction->rootBlock.parent             = NULL;
+    newFunction->rootBlock.variableStackStart = currentBlock->variableStackEnd;
+    newFunction->rootBlock.variableStackEnd   = currentBlock->variableStackEnd;
+    newFunction->rootBlock.isTerminated       = false;
+    newFunction->rootBlock.hasUpvalue         = false;
+    newFunction->currentBlock                 = &newFunction->rootBlock;
+
+    newFunction->parent               = currentFunction;
+    newFunction->nextRegisterId       = 0;
+    newFunction->maxUsedRegisterCount = 0;
+    newFunction->nReturns             = UINT8_MAX;
+    newFunction->isDeferredFunction   = isDeferredFunction;
+    ChunkInit(&newFunction->chunk);
+    UpvalueListInit(&newFunction->upvalues);
+    AttrCacheListInit(&newFunction->attrCaches);
+
+    compiler->currentFunction = newFunction;
+}
+
+static void leaveFunctionScope(Compiler* compiler) {
+    FunctionScope* currentFunction = compiler->currentFunction;
+    FunctionScope* parentFunction  = currentFunction->parent;
+
+    compiler->currentFunction = parentFunction;
+    compiler->variables.size  = parentFunction->currentBlock->variableStackEnd;
+}
+
+// Moves the inline caches of the attribute accesses in `functionScope` to its compiled function proto.
+static void saveAttrCaches(Compiler* compiler, FunctionScope* functionScope, FunctionProto* fn) {
+    AttrCacheList* attrCaches = &functionScope->attrCaches;
+    if (attrCaches->size > 0) {
+        fn->attrCaches = semiMalloc(compiler->gc, sizeof(AttrCache) * attrCaches->size);
+        if (fn->attrCaches == NULL) {
+            SEMI_COMPILE_ABORT(
+                compiler, SEMI_ERROR_MEMORY_ALLOCATION_FAILURE, "Failed to allocate attribute caches for function");
+        }
+        memcpy(fn->attrCaches, attrCaches->data, sizeof(AttrCache) * attrCaches->size);
+        fn->attrCacheCount = attrCaches->size;
+    }
+    AttrCacheListInit(attrCaches);
+}
+
+// Copies the code of `functionScope` to its compiled function proto, in an allocation of the exact size.
+static void saveChunk(Compiler* compiler, FunctionScope* functionScope, FunctionProto* fn) {
+    Chunk* chunk   = &functionScope->chunk;
+    fn->chunk.data = semiMalloc(compiler->gc, sizeof(Instruction) * chunk->size);
+    if (fn->chunk.data == NULL && chunk->size > 0) {
+        SEMI_COMPILE_ABORT(compiler, SEMI_ERROR_MEMORY_ALLOCATION_FAILURE, "Failed to allocate code for function");
+    }
+    memcpy(fn->chunk.data, chunk->data, sizeof(Instruction) * chunk->size);
+    fn->chunk.size     = chunk->size;
+    fn->chunk.capacity = chunk->size;
+    ChunkInit(chunk);
+}
+
+static void enterBlockScope(Compiler* compiler, BlockScope* newBlock, BlockScopeType type) {
+    FunctionScope* currentFunction = compiler->currentFunction;
+    BlockScope* currentBlock       = currentFunction->currentBlock;
+    currentFunction->currentBlock  = newBlock;
+
+    newBlock->parent             = currentBlock;
+    newBlock->variableStackStart = currentBlock->variableStackEnd;
+    newBlock->variableStackEnd   = currentBlock->variableStackEnd;
+    newBlock->type               = type;
+    newBlock->terminalCoarity    = UINT8_MAX;
+    newBlock->isTerminated       = false;
+    newBlock->hasUpvalue         = false;
+}
+
+static void leaveBlockScope(Compiler* compiler) {
+    FunctionScope* currentFunction = compiler->currentFunction;
+    BlockScope* currentBlock       = currentFunction->currentBlock;
+    BlockScope* parentBlock        = currentBlock->parent;
+
+    currentFunction->currentBlock = parentBlock;
+    compiler->variables.size      = parentBlock->variableStackEnd;
 }
 
 static ModuleVariableId resolveGlobalVariable(Compiler* compiler, IdentifierId identifierId) {
@@ -1060,6 +2929,9 @@ static ModuleVariableId resolveGlobalVariable(Compiler* compiler, IdentifierId i
 static bool hasModuleVariable(Compiler* compiler, IdentifierId identifierId) {
     ValueHash hash = semiHash64Bits(identifierId);
     Value v        = semiValueIntCreate(identifierId);
+    if (compiler->isRecompilation) {
+        return semiDictHasWithHash(&compiler->definedModuleVariables, v, hash);
+    }
     return semiDictHasWithHash(&compiler->artifactModule->exports, v, hash) ||
            semiDictHasWithHash(&compiler->artifactModule->globals, v, hash);
 }
@@ -1070,25 +2942,36 @@ static ModuleVariableId bindModuleVariable(Compiler* compiler, IdentifierId iden
     Value v                = semiValueIntCreate(identifierId);
     ValueHash hash         = semiHash64Bits(identifierId);
 
-    if (semiDictHasWithHash(&module->exports, semiValueIntCreate(identifierId), hash)) {
-        SEMI_COMPILE_ABORT(compiler, SEMI_ERROR_VARIABLE_ALREADY_DEFINED, "Variable already defined in module exports");
-    }
-    if (semiDictHasWithHash(&module->globals, semiValueIntCreate(identifierId), hash)) {
-        SEMI_COMPILE_ABORT(compiler, SEMI_ERROR_VARIABLE_ALREADY_DEFINED, "Variable already defined in module globals");
+    // A recompilation may define the variables of the last compilation again. One that stays an export or a global
+    // keeps its slot, while one that turns into an export or back gets a slot in the other dict. The slot it leaves is
+    // dropped after the compilation unless a function of the last compilation still refers to it.
+    bool isLastCompilation = compiler->isRecompilation &&
+                             !semiDictHasWithHash(&compiler->definedModuleVariables, v, hash);
+    bool isRedefinition    = isLastCompilation && semiDictHasWithHash(targetDict, v, hash);
+    if (!isLastCompilation) {
+        if (semiDictHasWithHash(&module->exports, v, hash)) {
+            SEMI_COMPILE_ABORT(
+                compiler, SEMI_ERROR_VARIABLE_ALREADY_DEFINED, "Variable already defined in module exports");
+        }
+        if (semiDictHasWithHash(&module->globals, v, hash)) {
+            SEMI_COMPILE_ABORT(
+                compiler, SEMI_ERROR_VARIABLE_ALREADY_DEFINED, "Variable already defined in module globals");
+        }
     }
-
-    if (semiDictLen(targetDict) >= UINT32_MAX - 1) {
+    if (!isRedefinition && semiDictLen(targetDict) >= UINT32_MAX - 1) {
         SEMI_COMPILE_ABORT(compiler, SEMI_ERROR_TOO_MANY_VARIABLES, "Too many module variables");
     }
 
-    if (!semiDictSetWithHash(
-            compiler->gc, targetDict, semiValueIntCreate(identifierId), semiValueIntCreate(identifierId), hash)) {
+    ObjectDict* defined = &compiler->definedModuleVariables;
+    if ((!isRedefinition && !semiDictSetWithHash(compiler->gc, targetDict, v, v, hash)) ||
+        (compiler->isRecompilation &&
+         !semiDictSetWithHash(compiler->gc, defined, v, semiValueBoolCreate(isExport), hash))) {
         SEMI_COMPILE_ABORT(
             compiler, SEMI_ERROR_MEMORY_ALLOCATION_FAILURE, "Memory allocation failure when binding module variable");
     }
 
     TupleId tupleId = semiDictFindTupleId(targetDict, v, hash);
-    if (tupleId < 0 && tupleId > UINT16_MAX) {
+    if (tupleId < 0 || tupleId >= INVALID_MODULE_VARIABLE_ID) {
         SEMI_COMPILE_ABORT(compiler, SEMI_ERROR_TOO_MANY_VARIABLES, "Too many module variables");
     }
 
@@ -1099,18 +2982,33 @@ static ModuleVariableId resolveModuleVariable(Compiler* compiler, IdentifierId i
     SemiModule* module = compiler->artifactModule;
     ValueHash hash     = semiHash64Bits(identifierId);
     Value v            = semiValueIntCreate(identifierId);
-    TupleId tupleId    = semiDictFindTupleId(&module->exports, v, hash);
-    if (tupleId >= 0 && tupleId <= UINT32_MAX) {
-        *isExport = true;
-        return (ModuleVariableId)tupleId;
+    if (compiler->isRecompilation) {
+        // The name may still be in the other dict too, if the variable turned into an export or back.
+        Value defined = semiDictGetWithHash(&compiler->definedModuleVariables, v, hash);
+        if (IS_INVALID(&defined)) {
+            return INVALID_MODULE_VARIABLE_ID;
+        }
+        *isExport = AS_BOOL(&defined);
+    }
+
+    TupleId tupleId = -1;
+    if (!compiler->isRecompilation || *isExport) {
+        tupleId = semiDictFindTupleId(&module->exports, v, hash);
     }
-    tupleId = semiDictFindTupleId(&module->globals, v, hash);
     if (tupleId >= 0 && tupleId <= UINT32_MAX) {
+        *isExport = true;
+    } else {
+        tupleId = semiDictFindTupleId(&module->globals, v, hash);
+        if (tupleId < 0 || tupleId > UINT32_MAX) {
+            return INVALID_MODULE_VARIABLE_ID;
+        }
         *isExport = false;
-        return (ModuleVariableId)tupleId;
     }
 
-    return INVALID_MODULE_VARIABLE_ID;
+    if (compiler->isRecordingDependencies) {
+        recordNameDependency(compiler, identifierId, DECLARATION_DEPENDENCY_MODULE_VARIABLE, *isExport);
+    }
+    return (ModuleVariableId)tupleId;
 }
 
 static void bindLocalVariable(Compiler* compiler, IdentifierId identifierId, LocalRegisterId registerId) {
@@ -1128,12 +3026,15 @@ static void bindLocalVariable(Compiler* compiler, IdentifierId identifierId, Loc
     if (hasModuleVariable(compiler, identifierId)) {
         SEMI_COMPILE_ABORT(compiler, SEMI_ERROR_VARIABLE_ALREADY_DEFINED, "Variable already defined in module scope");
     }
+    if (compiler->isRecordingDependencies) {
+        recordNameDependency(compiler, identifierId, DECLARATION_DEPENDENCY_LOCAL_VARIABLE, false);
+    }
 
     VariableDescription varDesc = {
         .identifierId = identifierId,
         .registerId   = registerId,
     };
-    ErrorId errId = VariableListAppend(compiler->gc, &compiler->variables, varDesc);
+    ErrorId errId = VariableListArenaAppend(compiler->gc, &compiler->arena, &compiler->variables, varDesc);
     if (errId == SEMI_ERROR_MEMORY_ALLOCATION_FAILURE) {
         SEMI_COMPILE_ABORT(
             compiler, SEMI_ERROR_MEMORY_ALLOCATION_FAILURE, "Memory allocation failure when binding local variable");
@@ -1154,7 +3055,97 @@ static LocalRegisterId resolveLocalVariable(Compiler* compiler, IdentifierId ide
         }
     }
 
-    return INVALID_LOCAL_REGISTER_ID;
+    return INVALID_LOCAL_REGISTER_ID;
+}
+
+static VariableDescription* findLocalVariableByRegister(Compiler* compiler, LocalRegisterId registerId) {
+    uint16_t variableStackStart = compiler->currentFunction->rootBlock.variableStackStart;
+    uint16_t variableStackEnd   = compiler->currentFunction->currentBlock->variableStackEnd;
+
+    for (uint16_t i = variableStackStart; i < variableStackEnd; i++) {
+        if (compiler->variables.data[i].registerId == registerId) {
+            return &compiler->variables.data[i];
+        }
+    }
+
+    return NULL;
+}
+
+static TypeId getLocalVariableTypeHint(Compiler* compiler, LocalRegisterId registerId) {
+    VariableDescription* variable = findLocalVariableByRegister(compiler, registerId);
+    return variable != NULL ? variable->typeHint : (TypeId)BASE_VALUE_TYPE_INVALID;
+}
+
+// Remember the constant a new binding is initialized with if its name is never assigned to anywhere in the module, so
+// that later reads fold to it. Only scalars and strings are propagated.
+static void recordImmutableConstant(Compiler* compiler,
+                                    IdentifierId identifierId,
+                                    const LhsExpr* lhsExpr,
+                                    const PrattExpr* rhsExpr) {
+    if (!compiler->enableConstantPropagation || rhsExpr->type != PRATT_EXPR_TYPE_CONSTANT) {
+        return;
+    }
+    switch (VALUE_TYPE(&rhsExpr->value.constant)) {
+        case VALUE_TYPE_BOOL:
+        case VALUE_TYPE_INT:
+        case VALUE_TYPE_FLOAT:
+        case VALUE_TYPE_INLINE_STRING:
+        case VALUE_TYPE_OBJECT_STRING:
+            break;
+        default:
+            return;
+    }
+
+    Value key = semiValueIntCreate(identifierId);
+    if (semiDictHas(&compiler->reassignedIdentifiers, key)) {
+        return;
+    }
+
+    if (lhsExpr->type == LHS_EXPR_TYPE_MODULE_VAR) {
+        if (!semiDictSet(compiler->gc, &compiler->moduleConstants, key, rhsExpr->value.constant)) {
+            SEMI_COMPILE_ABORT(
+                compiler, SEMI_ERROR_MEMORY_ALLOCATION_FAILURE, "Memory allocation failure when recording constant");
+        }
+        return;
+    }
+
+    VariableDescription* variable = findLocalVariableByRegister(compiler, lhsExpr->baseRegister);
+    if (variable != NULL) {
+        variable->constant = rhsExpr->value.constant;
+    }
+}
+
+// Return the constant an immutable local, upvalue or module variable was bound to, or an invalid value if the
+// variable has to be read at runtime.
+static Value resolveImmutableConstant(Compiler* compiler, IdentifierId identifierId) {
+    for (uint16_t i = compiler->variables.size; i > 0; i--) {
+        if (compiler->variables.data[i - 1].identifierId == identifierId) {
+            return compiler->variables.data[i - 1].constant;
+        }
+    }
+
+    Value constant = semiDictLen(&compiler->moduleConstants) > 0
+                         ? semiDictGet(&compiler->moduleConstants, semiValueIntCreate(identifierId))
+                         : INVALID_VALUE;
+    if (compiler->isRecordingDependencies && IS_VALID(&constant)) {
+        recordValueDependency(compiler, identifierId, constant);
+    }
+    return constant;
+}
+
+// Remember a top-level function so that later calls to it are inlined, if its name is never assigned to anywhere in the
+// module.
+static void recordInlineCandidate(Compiler* compiler, IdentifierId identifierId, FunctionProto* fn) {
+    Value key = semiValueIntCreate(identifierId);
+    if (!compiler->enableInlining || semiDictHas(&compiler->reassignedIdentifiers, key) ||
+        !isInlinableFunction(compiler, fn)) {
+        return;
+    }
+
+    if (!semiDictSet(compiler->gc, &compiler->inlineCandidates, key, semiValueFunctionProtoCreate(fn))) {
+        SEMI_COMPILE_ABORT(
+            compiler, SEMI_ERROR_MEMORY_ALLOCATION_FAILURE, "Memory allocation failure when recording function");
+    }
 }
 
 static uint8_t addUpvalue(Compiler* compiler, FunctionScope* functionScope, uint8_t index, bool isLocal) {
@@ -1164,7 +3155,7 @@ static uint8_t addUpvalue(Compiler* compiler, FunctionScope* functionScope, uint
         .index   = index,
         .isLocal = isLocal,
     };
-    ErrorId errId = UpvalueListAppend(compiler->gc, &functionScope->upvalues, upvalueDesc);
+    ErrorId errId = UpvalueListArenaAppend(compiler->gc, &compiler->arena, &functionScope->upvalues, upvalueDesc);
     if (errId == SEMI_ERROR_MEMORY_ALLOCATION_FAILURE) {
         SEMI_COMPILE_ABORT(
             compiler, SEMI_ERROR_MEMORY_ALLOCATION_FAILURE, "Memory allocation failure when adding upvalue");
@@ -1187,6 +3178,15 @@ static uint8_t resolveUpvalue(Compiler* compiler, FunctionScope* functionScope,
     uint16_t variableStackEnd   = parentFunction->currentBlock->variableStackEnd;
     for (uint16_t i = variableStackStart; i < variableStackEnd; i++) {
         if (compiler->variables.data[i].identifierId == identifierId) {
+            // A `break` skips the CLOSE_UPVALUES of the blocks it leaves, so the enclosing blocks close it as well.
+            BlockScope* block = parentFunction->currentBlock;
+            while (block->variableStackStart > i) {
+                block = block->parent;
+            }
+            for (; block != NULL; block = block->parent) {
+                block->hasUpvalue = true;
+            }
+
             LocalRegisterId registerId = compiler->variables.data[i].registerId;
             return addUpvalue(compiler, functionScope, registerId, true);
         }
@@ -1263,12 +3263,7 @@ save_to_constant_table:
         SEMI_COMPILE_ABORT(
             compiler, SEMI_ERROR_MEMORY_ALLOCATION_FAILURE, "Memory allocation failure when saving integer constant");
     }
-    if (idx > MAX_OPERAND_K) {
-        // TODO: Spill with OP_EXTRA_ARG
-        SEMI_COMPILE_ABORT(compiler, SEMI_ERROR_TOO_MANY_CONSTANTS, "Too many constants in a module");
-    }
-
-    emitCode(compiler, INSTRUCTION_LOAD_CONSTANT(reg, (uint16_t)idx, false, false));
+    emitCodeWithExtendedK(compiler, INSTRUCTION_LOAD_CONSTANT(reg, (uint16_t)idx, false, false), idx);
     return;
 }
 
@@ -1308,9 +3303,44 @@ static void saveURKOperand(Compiler* compiler, IntValue value, uint8_t* operand,
 
     LocalRegisterId operandReg = reserveTempRegister(compiler);
     saveConstantToRegister(compiler, semiValueIntCreate(value), operandReg);
+    *operand         = operandReg;
     *isInlineOperand = false;
 }
 
+// Allocates an inline cache for an attribute access of `fieldName`. If the struct type of the object is known at
+// compile time, the cache is seeded with its slot so that the first execution already hits. When a function runs out
+// of caches, the identifier id of the field is saved to a register instead.
+static void saveAttrOperand(
+    Compiler* compiler, IdentifierId fieldName, TypeId typeHint, uint8_t* operand, bool* isCached) {
+    AttrCacheList* attrCaches = &compiler->currentFunction->attrCaches;
+    if (attrCaches->size >= MAX_ATTR_CACHE_COUNT) {
+        LocalRegisterId operandReg = reserveTempRegister(compiler);
+        saveConstantToRegister(compiler, semiValueIntCreate(fieldName), operandReg);
+        *operand  = operandReg;
+        *isCached = false;
+        return;
+    }
+
+    AttrCache cache = {
+        .fieldName = fieldName,
+        .typeId    = INVALID_ATTR_CACHE_TYPE_ID,
+        .slot      = 0,
+    };
+    // The hint is only a guess, e.g. a variable may be reassigned in a branch, so an unknown field is left to the VM.
+    StructType* structType = semiPrimitivesGetStructType(compiler->classes, typeHint);
+    uint16_t slot = structType != NULL ? semiStructTypeFindSlot(structType, fieldName) : INVALID_STRUCT_FIELD_SLOT;
+    if (slot != INVALID_STRUCT_FIELD_SLOT) {
+        cache.typeId = typeHint;
+        cache.slot   = slot;
+    }
+
+    *operand = (uint8_t)attrCaches->size;
+    if (AttrCacheListArenaAppend(compiler->gc, &compiler->arena, attrCaches, cache) != 0) {
+        SEMI_COMPILE_ABORT(compiler, SEMI_ERROR_MEMORY_ALLOCATION_FAILURE, "Failed to allocate attribute cache");
+    }
+    *isCached = true;
+}
+
 // First try to embed the constant in the instruction. If not, save it to a register and set
 // `allocatedReg` to the register ID to allow callers to free the register.
 static void saveConstantExprToOperand(Compiler* compiler, Value value, uint8_t* operand, bool* isInlineOperand) {
@@ -1387,6 +3417,7 @@ static void ternaryLed(Compiler* compiler, const PrattState state, PrattExpr* le
 static void binaryLed(Compiler* compiler, const PrattState state, PrattExpr* leftExpr, PrattExpr* retExpr);
 static void typeCheckLed(Compiler* compiler, const PrattState state, PrattExpr* leftExpr, PrattExpr* retExpr);
 static void indexLed(Compiler* compiler, const PrattState state, PrattExpr* leftExpr, PrattExpr* retExpr);
+static bool parseForRange(Compiler* compiler, PrattExpr startExpr, LocalRegisterId startReg);
 static void functionCallLed(Compiler* compiler, const PrattState state, PrattExpr* leftExpr, PrattExpr* retExpr);
 static void collectionInitializerLed(Compiler* compiler,
                                      const PrattState state,
@@ -1502,20 +3533,40 @@ static void variableNud(Compiler* compiler, const PrattState state, PrattExpr* r
     bool isExport;
     ModuleVariableId moduleVarId;
     if ((moduleVarId = resolveGlobalVariable(compiler, identifierId)) != INVALID_MODULE_VARIABLE_ID) {
-        emitCode(compiler, INSTRUCTION_LOAD_CONSTANT(state.targetRegister, moduleVarId, false, true));
+        emitCodeWithExtendedK(
+            compiler, INSTRUCTION_LOAD_CONSTANT(state.targetRegister, (uint16_t)moduleVarId, false, true), moduleVarId);
         *expr = PRATT_EXPR_REG(state.targetRegister);
         return;
     }
 
+    Value constant = resolveImmutableConstant(compiler, identifierId);
+    if (IS_VALID(&constant)) {
+        *expr = PRATT_EXPR_CONSTANT(constant);
+        return;
+    }
+
     if ((moduleVarId = resolveModuleVariable(compiler, identifierId, &isExport)) != INVALID_MODULE_VARIABLE_ID) {
-        emitCode(compiler, INSTRUCTION_GET_MODULE_VAR(state.targetRegister, moduleVarId, false, isExport));
+        emitCodeWithExtendedK(compiler,
+                              INSTRUCTION_GET_MODULE_VAR(state.targetRegister, (uint16_t)moduleVarId, false, isExport),
+                              moduleVarId);
         *expr = PRATT_EXPR_REG(state.targetRegister);
+        // The call site takes the load back, which only works for a load without EXTRA_ARG.
+        if (semiDictLen(&compiler->inlineCandidates) > 0 && moduleVarId <= MAX_OPERAND_K) {
+            Value fnValue = semiDictGet(&compiler->inlineCandidates, semiValueIntCreate(identifierId));
+            if (IS_VALID(&fnValue)) {
+                expr->inlineCallee = AS_FUNCTION_PROTO(&fnValue);
+                if (compiler->isRecordingDependencies) {
+                    recordValueDependency(compiler, identifierId, fnValue);
+                }
+            }
+        }
         return;
     }
 
     LocalRegisterId registerId = resolveLocalVariable(compiler, identifierId);
     if (registerId != INVALID_LOCAL_REGISTER_ID) {
-        *expr = PRATT_EXPR_VAR(registerId);
+        *expr          = PRATT_EXPR_VAR(registerId);
+        expr->typeHint = getLocalVariableTypeHint(compiler, registerId);
         return;
     }
 
@@ -1707,7 +3758,9 @@ static void ternaryLed(Compiler* compiler, const PrattState state, PrattExpr* co
     semiParseExpression(compiler, innerState, &truthyBranch);
     saveExprToRegister(compiler, &truthyBranch, innerState.targetRegister);
     PCLocation pcAfterTruthy = emitPlaceholder(compiler);
-    overrideConditionalJumpHere(compiler, pcAfterCond, condOperand, false);
+    if (overrideConditionalJumpHere(compiler, pcAfterCond, condOperand, false)) {
+        pcAfterTruthy++;
+    }
 
     if (nextToken(&compiler->lexer) != TK_COLON) {
         SEMI_COMPILE_ABORT(compiler, SEMI_ERROR_UNEXPECTED_TOKEN, "Expected colon after truthy branch");
@@ -1833,14 +3886,6 @@ static void binaryBooleanLed(Compiler* compiler,
         };
         semiParseExpression(compiler, innerState, &rightExpr);
         saveExprToRegister(compiler, &rightExpr, state.targetRegister);
-
-        PCLocation pcAfterRight = currentPCLocation(compiler);
-        if (pcAfterRight - pcAfterLeft >= MAX_OPERAND_K) {
-            // TODO: Spill with OP_EXTRA_ARG
-            SEMI_COMPILE_ABORT(compiler,
-                               SEMI_ERROR_TOO_MANY_INSTRUCTIONS_FOR_JUMP,
-                               "Too many instructions between logical expression and its branches");
-        }
         overrideConditionalJumpHere(compiler, pcAfterLeft, state.targetRegister, token == TK_AND);
 
         *retExpr = PRATT_EXPR_REG(state.targetRegister);
@@ -1859,7 +3904,10 @@ static void binaryLed(Compiler* compiler, const PrattState state, PrattExpr* lef
 
     LocalRegisterId rightTargetRegister;
 
-    if (leftExpr->type == PRATT_EXPR_TYPE_REG) {
+    // The right operand must not overwrite the left one, which is also the case for `a = a + b` where the target
+    // register is the register of the variable `a`.
+    if (leftExpr->type == PRATT_EXPR_TYPE_REG ||
+        (leftExpr->type == PRATT_EXPR_TYPE_VAR && leftExpr->value.reg == state.targetRegister)) {
         rightTargetRegister = reserveTempRegister(compiler);
     } else {
         rightTargetRegister = state.targetRegister;
@@ -1954,12 +4002,44 @@ static void typeCheckLed(Compiler* compiler, const PrattState state, PrattExpr*
 }
 
 static void accessLed(Compiler* compiler, const PrattState state, PrattExpr* leftExpr, PrattExpr* restrict retExpr) {
-    (void)state;
-    (void)leftExpr;
-    (void)retExpr;
+    nextToken(&compiler->lexer);  // Consume '.'
+    MATCH_NEXT_TOKEN_OR_ABORT(compiler, TK_IDENTIFIER, "Expected identifier after '.'");
+
+    InternedChar* identifier  = semiSymbolTableInsert(compiler->symbolTable,
+                                                     compiler->lexer.tokenValue.identifier.name,
+                                                     compiler->lexer.tokenValue.identifier.length);
+    IdentifierId identifierId = semiSymbolTableGetId(identifier);
+
+    LocalRegisterId objectReg;
+    switch (leftExpr->type) {
+        case PRATT_EXPR_TYPE_VAR:
+            objectReg = leftExpr->value.reg;
+            break;
+
+        case PRATT_EXPR_TYPE_REG:
+            objectReg = state.targetRegister;
+            break;
+
+        case PRATT_EXPR_TYPE_CONSTANT:
+            saveExprToRegister(compiler, leftExpr, state.targetRegister);
+            objectReg = state.targetRegister;
+            break;
+
+        case PRATT_EXPR_TYPE_TYPE:
+            SEMI_COMPILE_ABORT(
+                compiler, SEMI_ERROR_UNIMPLEMENTED_FEATURE, "Accessing type attributes is not implemented");
+
+        default:
+            SEMI_COMPILE_ABORT(compiler, SEMI_ERROR_INTERNAL_ERROR, "Unexpected expression type in access expression");
+    }
 
-    Token token = nextToken(&compiler->lexer);  // Consume the access token
-    SEMI_COMPILE_ABORT(compiler, SEMI_ERROR_UNIMPLEMENTED_FEATURE, "Accessing object fields is not implemented");
+    uint8_t operand;
+    bool isCached;
+    saveAttrOperand(compiler, identifierId, leftExpr->typeHint, &operand, &isCached);
+    emitCode(compiler, INSTRUCTION_GET_ATTR(state.targetRegister, objectReg, operand, false, isCached));
+
+    restoreNextRegisterId(compiler, state.targetRegister + 1);
+    *retExpr = PRATT_EXPR_REG(state.targetRegister);
 }
 
 static void indexLed(Compiler* compiler, const PrattState state, PrattExpr* leftExpr, PrattExpr* restrict retExpr) {
@@ -1995,6 +4075,15 @@ static void indexLed(Compiler* compiler, const PrattState state, PrattExpr* left
     PrattExpr indexExpr;
     semiParseExpression(compiler, innerState, &indexExpr);
 
+    if (peekToken(&compiler->lexer) == TK_DOUBLE_DOTS) {
+        // Slice: `list[a..b]` indexes with the range built into indexReg.
+        if (compiler->currentFunction->nextRegisterId <= indexReg) {
+            restoreNextRegisterId(compiler, indexReg + 1);
+        }
+        parseForRange(compiler, indexExpr, indexReg);
+        indexExpr = PRATT_EXPR_REG(indexReg);
+    }
+
     uint8_t indexOperand;
     bool isInlineOperand;
     saveExprToOperand(compiler, &indexExpr, &indexOperand, &isInlineOperand);
@@ -2017,7 +4106,19 @@ static void functionCallLed(Compiler* compiler,
 
     if (leftExpr->type == PRATT_EXPR_TYPE_TYPE) {
         SEMI_COMPILE_ABORT(compiler, SEMI_ERROR_UNIMPLEMENTED_FEATURE, "Type constructors are not implemented yet");
+    }
+
+    // The callee of an inlined call is never loaded, so its load is taken back until the arguments are parsed.
+    FunctionProto* inlineCallee = leftExpr->inlineCallee;
+    Instruction calleeLoad      = INSTRUCTION_NOOP();
+    PCLocation pc               = currentPCLocation(compiler);
+    if (inlineCallee != NULL && leftExpr->type == PRATT_EXPR_TYPE_REG && leftExpr->value.reg == state.targetRegister &&
+        pc > 0 && GET_OPCODE(compiler->currentFunction->chunk.data[pc - 1]) == OP_GET_MODULE_VAR &&
+        OPERAND_K_A(compiler->currentFunction->chunk.data[pc - 1]) == state.targetRegister) {
+        calleeLoad = compiler->currentFunction->chunk.data[pc - 1];
+        rewindCode(compiler, pc - 1);
     } else {
+        inlineCallee = NULL;
         saveExprToRegister(compiler, leftExpr, state.targetRegister);
     }
     uint8_t argCount = 0;
@@ -2036,6 +4137,9 @@ static void functionCallLed(Compiler* compiler,
             SEMI_COMPILE_ABORT(compiler, SEMI_ERROR_TOO_MANY_ARGUMENTS, "Too many arguments in function call");
         }
         LocalRegisterId argReg = reserveTempRegister(compiler);
+        if (argReg != state.targetRegister + 1 + argCount) {
+            inlineCallee = NULL;
+        }
         argCount++;
 
         PrattExpr argExpr;
@@ -2070,6 +4174,15 @@ parsed_arguments:
     MATCH_NEXT_TOKEN_OR_ABORT(compiler, TK_CLOSE_PAREN, "Expected closing parenthesis for function call");
     updateBracketCount(compiler, TK_CLOSE_PAREN);
 
+    if (inlineCallee != NULL && argCount == inlineCallee->arity &&
+        inlineFunctionCall(compiler, inlineCallee, state.targetRegister)) {
+        *retExpr = PRATT_EXPR_REG(state.targetRegister);
+        restoreNextRegisterId(compiler, state.targetRegister + 1);
+        return;
+    }
+    if (GET_OPCODE(calleeLoad) == OP_GET_MODULE_VAR) {
+        emitCode(compiler, calleeLoad);
+    }
     emitCode(compiler, INSTRUCTION_CALL(state.targetRegister, argCount, 0, false, false));
     *retExpr = PRATT_EXPR_REG(state.targetRegister);
     restoreNextRegisterId(compiler, state.targetRegister + 1);
@@ -2079,27 +4192,98 @@ static void structInitializerLed(Compiler* compiler,
                                  const PrattState state,
                                  PrattExpr* leftExpr,
                                  PrattExpr* restrict retExpr) {
-    (void)state;
-    (void)leftExpr;
-    (void)retExpr;
+    // OPEN_BRACE ( IDENTIFIER COLON EXPR ( COMMA IDENTIFIER COLON EXPR )* COMMA? )? CLOSE_BRACE
+    TypeId typeId          = leftExpr->value.type;
+    StructType* structType = semiPrimitivesGetStructType(compiler->classes, typeId);
+    if (structType == NULL) {
+        SEMI_COMPILE_ABORT(compiler, SEMI_ERROR_UNIMPLEMENTED_FEATURE, "Type is not a struct");
+    }
 
     nextToken(&compiler->lexer);  // Consume '{'
     updateBracketCount(compiler, TK_OPEN_BRACE);
 
-    // Currently we don't support any fields in struct initializer.
-    MATCH_NEXT_TOKEN_OR_ABORT(compiler, TK_CLOSE_BRACE, "Expected closing brace for struct initializer");
+    if (compiler->currentFunction->nextRegisterId <= state.targetRegister) {
+        restoreNextRegisterId(compiler, state.targetRegister + 1);
+    }
+    LocalRegisterId firstValueReg = compiler->currentFunction->nextRegisterId;
+
+    // Field values are evaluated into consecutive registers before the instance is created, so that the struct is
+    // never observable half-initialized.
+    IdentifierId fieldNames[MAX_STRUCT_FIELD_COUNT];
+    uint64_t seenSlots[(MAX_STRUCT_FIELD_COUNT + 64) / 64] = {0};
+    uint8_t fieldCount                                    = 0;
+    while (peekToken(&compiler->lexer) != TK_CLOSE_BRACE) {
+        MATCH_NEXT_TOKEN_OR_ABORT(compiler, TK_IDENTIFIER, "Expected field name in struct initializer");
+        InternedChar* identifier  = semiSymbolTableInsert(compiler->symbolTable,
+                                                         compiler->lexer.tokenValue.identifier.name,
+                                                         compiler->lexer.tokenValue.identifier.length);
+        IdentifierId identifierId = semiSymbolTableGetId(identifier);
+
+        uint16_t slot = semiStructTypeFindSlot(structType, identifierId);
+        if (slot == INVALID_STRUCT_FIELD_SLOT) {
+            SEMI_COMPILE_ABORT(compiler, SEMI_ERROR_UNKNOWN_FIELD, "Unknown field in struct initializer");
+        }
+        if (seenSlots[slot / 64] & (UINT64_C(1) << (slot % 64))) {
+            SEMI_COMPILE_ABORT(compiler, SEMI_ERROR_DUPLICATE_NAME, "Duplicate field in struct initializer");
+        }
+        seenSlots[slot / 64] |= UINT64_C(1) << (slot % 64);
+        fieldNames[fieldCount] = identifierId;
+
+        MATCH_NEXT_TOKEN_OR_ABORT(compiler, TK_COLON, "Expected ':' after field name in struct initializer");
+
+        LocalRegisterId valueReg = reserveTempRegister(compiler);
+        PrattState innerState    = {
+               .targetRegister    = valueReg,
+               .rightBindingPower = PRECEDENCE_NONE,
+        };
+        PrattExpr valueExpr;
+        semiParseExpression(compiler, innerState, &valueExpr);
+        saveExprToRegister(compiler, &valueExpr, valueReg);
+        restoreNextRegisterId(compiler, valueReg + 1);
+        fieldCount++;
+
+        if (peekToken(&compiler->lexer) != TK_COMMA) {
+            break;
+        }
+        nextToken(&compiler->lexer);  // Consume ','
+    }
+
     updateBracketCount(compiler, TK_CLOSE_BRACE);
+    MATCH_NEXT_TOKEN_OR_ABORT(compiler, TK_CLOSE_BRACE, "Expected closing brace for struct initializer");
+
+    if (fieldCount != structType->fieldCount) {
+        SEMI_COMPILE_ABORT(compiler, SEMI_ERROR_MISSING_FIELD, "Missing fields in struct initializer");
+    }
+
+    uint8_t typeOperand;
+    bool isInlineType;
+    saveURKOperand(compiler, typeId, &typeOperand, &isInlineType);
+    emitCode(compiler, INSTRUCTION_NEW_COLLECTION(state.targetRegister, typeOperand, 0, isInlineType, false));
+
+    for (uint8_t i = 0; i < fieldCount; i++) {
+        uint8_t operand;
+        bool isCached;
+        saveAttrOperand(compiler, fieldNames[i], typeId, &operand, &isCached);
+        LocalRegisterId valueReg = (LocalRegisterId)(firstValueReg + i);
+        emitCode(compiler, INSTRUCTION_SET_ATTR(state.targetRegister, operand, valueReg, isCached, false));
+    }
+
+    restoreNextRegisterId(compiler, state.targetRegister + 1);
+    *retExpr          = PRATT_EXPR_REG(state.targetRegister);
+    retExpr->typeHint = typeId;
 }
 
 static void collectionInitializerLed(Compiler* compiler,
                                      const PrattState state,
                                      PrattExpr* leftExpr,
                                      PrattExpr* restrict retExpr) {
+    // `Type[...]` of a struct type creates a columnar list of that struct type.
+    bool isColumnar = semiPrimitivesGetStructType(compiler->classes, leftExpr->value.type) != NULL;
     uint8_t regb;
     bool kb;
     saveURKOperand(compiler, leftExpr->value.type, &regb, &kb);
     PCLocation pcMakeCollection =
-        emitCode(compiler, INSTRUCTION_NEW_COLLECTION(state.targetRegister, regb, 0, kb, false));
+        emitCode(compiler, INSTRUCTION_NEW_COLLECTION(state.targetRegister, regb, 0, kb, isColumnar));
     restoreNextRegisterId(compiler, state.targetRegister + 1);
 
     nextToken(&compiler->lexer);  // Consume '['
@@ -2130,6 +4314,9 @@ static void collectionInitializerLed(Compiler* compiler,
 
     bool isMap;
     if (peekToken(&compiler->lexer) == TK_COLON) {
+        if (isColumnar) {
+            SEMI_COMPILE_ABORT(compiler, SEMI_ERROR_UNEXPECTED_TOKEN, "Unexpected ':' in columnar list initializer");
+        }
         isMap = true;
         unflushedCount++;
         totalElementCount++;
@@ -2236,10 +4423,10 @@ static void collectionInitializerLed(Compiler* compiler,
         restoreNextRegisterId(compiler, state.targetRegister + 1);
     }
 
+    uint8_t capacity = totalElementCount > 128 ? 128 : (uint8_t)totalElementCount;
     patchCode(compiler,
               pcMakeCollection,
-              INSTRUCTION_NEW_COLLECTION(
-                  state.targetRegister, regb, totalElementCount > 128 ? 128 : (uint8_t)totalElementCount, kb, false));
+              INSTRUCTION_NEW_COLLECTION(state.targetRegister, regb, capacity, kb, isColumnar));
 
     *retExpr = PRATT_EXPR_REG(state.targetRegister);
 }
@@ -2360,7 +4547,7 @@ void semiParseExpression(Compiler* compiler, const PrattState state, PrattExpr*
     SEMI_UNREACHABLE();
 }
 
-static void parseAndSaveRhs(Compiler* compiler, const LhsExpr lhsExpr) {
+static void parseAndSaveRhs(Compiler* compiler, const LhsExpr lhsExpr, PrattExpr* restrict rhsExpr) {
     LocalRegisterId targetRegister;
     ModuleVariableId moduleVarId;
     switch (lhsExpr.type) {
@@ -2384,19 +4571,25 @@ static void parseAndSaveRhs(Compiler* compiler, const LhsExpr lhsExpr) {
         .targetRegister    = targetRegister,
         .rightBindingPower = PRECEDENCE_NONE,
     };
-    PrattExpr expr;
-    semiParseExpression(compiler, state, &expr);
-    saveExprToRegister(compiler, &expr, targetRegister);
+    semiParseExpression(compiler, state, rhsExpr);
+    saveExprToRegister(compiler, rhsExpr, targetRegister);
 
     switch (lhsExpr.type) {
         case LHS_EXPR_TYPE_VAR: {
+            VariableDescription* variable = findLocalVariableByRegister(compiler, targetRegister);
+            if (variable != NULL) {
+                variable->typeHint = rhsExpr->typeHint;
+            }
             break;
         }
 
         case LHS_EXPR_TYPE_MODULE_VAR: {
-            emitCode(compiler,
-                     INSTRUCTION_SET_MODULE_VAR(
-                         targetRegister, lhsExpr.value.moduleVar.id, false, lhsExpr.value.moduleVar.isExport));
+            moduleVarId = lhsExpr.value.moduleVar.id;
+            emitCodeWithExtendedK(
+                compiler,
+                INSTRUCTION_SET_MODULE_VAR(
+                    targetRegister, (uint16_t)moduleVarId, false, lhsExpr.value.moduleVar.isExport),
+                moduleVarId);
             break;
         }
 
@@ -2417,8 +4610,11 @@ static void parseAndSaveRhs(Compiler* compiler, const LhsExpr lhsExpr) {
             SEMI_COMPILE_ABORT(compiler, SEMI_ERROR_VARIABLE_ALREADY_DEFINED, " Cannot assign to global variable");
         }
         case LHS_EXPR_TYPE_FIELD: {
-            SEMI_COMPILE_ABORT(
-                compiler, SEMI_ERROR_UNIMPLEMENTED_FEATURE, "Assigning to object fields is not implemented");
+            uint8_t operand;
+            bool isCached;
+            saveAttrOperand(compiler, lhsExpr.value.field.fieldName, lhsExpr.value.field.typeHint, &operand, &isCached);
+            emitCode(compiler, INSTRUCTION_SET_ATTR(lhsExpr.baseRegister, operand, targetRegister, isCached, false));
+            break;
         }
         default:
             SEMI_COMPILE_ABORT(compiler, SEMI_ERROR_INTERNAL_ERROR, "Unexpected lhs expression type");
@@ -2431,7 +4627,8 @@ static LocalRegisterId dereferenceLhsExpr(Compiler* compiler, LhsExpr* expr) {
             LocalRegisterId outReg       = reserveTempRegister(compiler);
             ModuleVariableId moduleVarId = expr->value.moduleVar.id;
             bool isExport                = expr->value.moduleVar.isExport;
-            emitCode(compiler, INSTRUCTION_GET_MODULE_VAR(outReg, moduleVarId, false, isExport));
+            emitCodeWithExtendedK(
+                compiler, INSTRUCTION_GET_MODULE_VAR(outReg, (uint16_t)moduleVarId, false, isExport), moduleVarId);
             return outReg;
         }
         case LHS_EXPR_TYPE_VAR: {
@@ -2457,8 +4654,12 @@ static LocalRegisterId dereferenceLhsExpr(Compiler* compiler, LhsExpr* expr) {
         }
 
         case LHS_EXPR_TYPE_FIELD: {
-            SEMI_COMPILE_ABORT(
-                compiler, SEMI_ERROR_UNIMPLEMENTED_FEATURE, "Accessing object fields is not implemented");
+            uint8_t operand;
+            bool isCached;
+            saveAttrOperand(compiler, expr->value.field.fieldName, expr->value.field.typeHint, &operand, &isCached);
+            emitCode(compiler, INSTRUCTION_GET_ATTR(expr->baseRegister, expr->baseRegister, operand, false, isCached));
+            restoreNextRegisterId(compiler, expr->baseRegister + 1);
+            return expr->baseRegister;
         }
 
         default:
@@ -2503,7 +4704,9 @@ void lhsFieldLed(Compiler* compiler, LhsExpr* expr, LhsExpr* restrict retExpr) {
     nextToken(&compiler->lexer);  // Consume '.'
     MATCH_NEXT_TOKEN_OR_ABORT(compiler, TK_IDENTIFIER, "Expected identifier after '.'");
 
-    retExpr->type         = LHS_EXPR_TYPE_FIELD;
+    TypeId typeHint = expr->type == LHS_EXPR_TYPE_VAR ? getLocalVariableTypeHint(compiler, expr->baseRegister)
+                                                      : (TypeId)BASE_VALUE_TYPE_INVALID;
+    retExpr->type   = LHS_EXPR_TYPE_FIELD;
     retExpr->baseRegister = dereferenceLhsExpr(compiler, expr);
 
     InternedChar* identifier       = semiSymbolTableInsert(compiler->symbolTable,
@@ -2511,6 +4714,7 @@ void lhsFieldLed(Compiler* compiler, LhsExpr* expr, LhsExpr* restrict retExpr) {
                                                      compiler->lexer.tokenValue.identifier.length);
     IdentifierId identifierId      = semiSymbolTableGetId(identifier);
     retExpr->value.field.fieldName = identifierId;
+    retExpr->value.field.typeHint  = typeHint;
 }
 
 // parseLhsNud may return these possible outcomes:
@@ -2548,7 +4752,8 @@ void parseLhsNud(Compiler* compiler, LhsExpr* restrict lhsExpr) {
     LocalRegisterId registerId;
     if ((moduleVarId = resolveGlobalVariable(compiler, identifierId)) != INVALID_MODULE_VARIABLE_ID) {
         registerId = reserveTempRegister(compiler);
-        emitCode(compiler, INSTRUCTION_LOAD_CONSTANT(registerId, moduleVarId, false, true));
+        emitCodeWithExtendedK(
+            compiler, INSTRUCTION_LOAD_CONSTANT(registerId, (uint16_t)moduleVarId, false, true), moduleVarId);
         *lhsExpr = LHS_EXPR_GLOBAL_VAR(registerId);
         goto parse_lhs;
     }
@@ -2650,7 +4855,9 @@ static void semiParseAssignmentOrExpr(Compiler* compiler, bool isModuleExport) {
             SEMI_COMPILE_ABORT(compiler, SEMI_ERROR_UNEXPECTED_TOKEN, "Expected assignment token");
         }
 
-        if (lhsExpr.type == LHS_EXPR_TYPE_UNINIT_VAR) {
+        bool isBinding         = lhsExpr.type == LHS_EXPR_TYPE_UNINIT_VAR;
+        IdentifierId bindingId = isBinding ? lhsExpr.value.identifierId : 0;
+        if (isBinding) {
             if (IS_TOP_LEVEL(compiler)) {
                 ModuleVariableId moduleVarId = bindModuleVariable(compiler, lhsExpr.value.identifierId, isModuleExport);
                 lhsExpr                      = LHS_EXPR_MODULE_VAR(moduleVarId, isModuleExport);
@@ -2662,7 +4869,11 @@ static void semiParseAssignmentOrExpr(Compiler* compiler, bool isModuleExport) {
             }
         }
         // Now lhsExpr is not LHS_EXPR_TYPE_UNINIT_VAR.
-        parseAndSaveRhs(compiler, lhsExpr);
+        PrattExpr rhsExpr;
+        parseAndSaveRhs(compiler, lhsExpr, &rhsExpr);
+        if (isBinding) {
+            recordImmutableConstant(compiler, bindingId, &lhsExpr, &rhsExpr);
+        }
 
         // Stop tokens for rvalue
         token = peekToken(&compiler->lexer);
@@ -2759,7 +4970,90 @@ static int structFieldCompare(const void* a, const void* b) {
 }
 
 static void parseStruct(Compiler* compiler) {
-    SEMI_COMPILE_ABORT(compiler, SEMI_ERROR_UNIMPLEMENTED_FEATURE, "Structs are not implemented");
+    // STRUCT TYPE_IDENTIFIER OPEN_BRACE ( IDENTIFIER ( ( COMMA | SEPARATOR )+ IDENTIFIER )* )? CLOSE_BRACE
+    nextToken(&compiler->lexer);  // Consume "struct"
+
+    if (!IS_TOP_LEVEL(compiler)) {
+        SEMI_COMPILE_ABORT(
+            compiler, SEMI_ERROR_UNEXPECTED_TOKEN, "Struct declaration inside a function or block scope");
+    }
+
+    MATCH_NEXT_TOKEN_OR_ABORT(compiler, TK_TYPE_IDENTIFIER, "Expected type name for struct declaration");
+    InternedChar* name  = semiSymbolTableInsert(compiler->symbolTable,
+                                               compiler->lexer.tokenValue.identifier.name,
+                                               compiler->lexer.tokenValue.identifier.length);
+    Value nameIdValue   = semiValueIntCreate(semiSymbolTableGetId(name));
+    Value existingType  = semiDictGet(&compiler->artifactModule->types, nameIdValue);
+
+    // A recompilation may declare a struct type of the last compilation again, which keeps the type if the fields are
+    // the same. The instances of the type can't change their layout, so other fields are an error.
+    bool isRedeclaration = false;
+    if (!IS_INVALID(&existingType)) {
+        isRedeclaration = compiler->isRecompilation && !semiDictHas(&compiler->definedTypes, nameIdValue);
+        if (!isRedeclaration) {
+            SEMI_COMPILE_ABORT(compiler, SEMI_ERROR_DUPLICATE_NAME, "Type is already defined");
+        }
+    }
+    if (compiler->isRecompilation && !semiDictSet(compiler->gc, &compiler->definedTypes, nameIdValue, nameIdValue)) {
+        SEMI_COMPILE_ABORT(compiler, SEMI_ERROR_MEMORY_ALLOCATION_FAILURE, "Failed to register struct type");
+    }
+
+    MATCH_NEXT_TOKEN_OR_ABORT(compiler, TK_OPEN_BRACE, "Expected opening brace for struct declaration");
+
+    StructField fields[MAX_STRUCT_FIELD_COUNT];
+    size_t fieldCount = 0;
+    Token token;
+    while ((token = nextToken(&compiler->lexer)) != TK_CLOSE_BRACE) {
+        switch (token) {
+            case TK_COMMA:
+            case TK_SEPARATOR:
+                continue;
+
+            case TK_IDENTIFIER:
+                break;
+
+            default:
+                SEMI_COMPILE_ABORT(compiler, SEMI_ERROR_UNEXPECTED_TOKEN, "Expected field name in struct declaration");
+        }
+
+        if (fieldCount == MAX_STRUCT_FIELD_COUNT) {
+            SEMI_COMPILE_ABORT(compiler, SEMI_ERROR_TOO_MANY_STRUCT_FIELDS, "Too many fields in struct declaration");
+        }
+        fields[fieldCount++] = (StructField){
+            .name = semiSymbolTableInsert(compiler->symbolTable,
+                                          compiler->lexer.tokenValue.identifier.name,
+                                          compiler->lexer.tokenValue.identifier.length),
+            .type = NULL,
+        };
+    }
+
+    qsort(fields, fieldCount, sizeof(StructField), structFieldCompare);
+    for (size_t i = 1; i < fieldCount; i++) {
+        if (fields[i].name == fields[i - 1].name) {
+            SEMI_COMPILE_ABORT(compiler, SEMI_ERROR_DUPLICATE_NAME, "Duplicate field in struct declaration");
+        }
+    }
+
+    if (isRedeclaration) {
+        StructType* type = semiPrimitivesGetStructType(compiler->classes, (TypeId)AS_INT(&existingType));
+        bool isSame      = type != NULL && type->fieldCount == fieldCount;
+        for (size_t i = 0; isSame && i < fieldCount; i++) {
+            isSame = type->fields[i].name == fields[i].name;
+        }
+        if (!isSame) {
+            SEMI_COMPILE_ABORT(compiler, SEMI_ERROR_DUPLICATE_NAME, "Type is already defined with other fields");
+        }
+        return;
+    }
+
+    TypeId typeId;
+    ErrorId errId = semiPrimitivesAddStructType(compiler->gc, compiler->classes, name, fields, fieldCount, &typeId);
+    if (errId != 0) {
+        SEMI_COMPILE_ABORT(compiler, errId, "Failed to register struct type");
+    }
+    if (!semiDictSet(compiler->gc, &compiler->artifactModule->types, nameIdValue, semiValueIntCreate(typeId))) {
+        SEMI_COMPILE_ABORT(compiler, SEMI_ERROR_MEMORY_ALLOCATION_FAILURE, "Failed to register struct type");
+    }
 }
 
 static void parseScopedStatements(Compiler* compiler);
@@ -2793,7 +5087,8 @@ static void parseIf(Compiler* compiler) {
 
     // If-blocks don't increase or decrease the number of variables and registers used, so we choose
     // to write a single CLOSE_UPVALUES instruction at the end of the if-elif-else chain to close
-    // all upvalues opened in the chain. If there are other control flow statements that leave the
+    // all upvalues opened in the chain. It is omitted when no closure captures a variable declared
+    // in the chain. If there are other control flow statements that leave the
     // scope, they need to take care of closing upvalues of this scope. Since block scopes have
     // stack semantics, their implementation should just work.
     LocalRegisterId currentNextRegisterId = getNextRegisterId(compiler);
@@ -2805,9 +5100,19 @@ static void parseIf(Compiler* compiler) {
     // block's coarity.
     uint8_t terminalCoarity = UINT8_MAX;
 
+    // Whether one of the branches is known to run, because there is an else-branch or a constantly truthy condition.
+    // Branches after it are dead, and so are branches with a constantly falsy condition. If the chain is exhaustive and
+    // all live branches are terminated, so is the parent block.
+    bool isExhaustive = false;
+    bool isTerminated = true;
+
+    // Whether a variable declared in one of the branches is captured, so that the chain needs to close upvalues.
+    bool hasUpvalue = false;
+
     do {
         ifTypeToken = nextToken(&compiler->lexer);  // Consume if / elif
 
+        PCLocation branchLocation = currentPCLocation(compiler);
         LocalRegisterId condReg, targetReg;
         condReg              = reserveTempRegister(compiler);
         PrattState condState = {
@@ -2817,23 +5122,26 @@ static void parseIf(Compiler* compiler) {
         PrattExpr condExpr;
         semiParseExpression(compiler, condState, &condExpr);
         switch (condExpr.type) {
-            case PRATT_EXPR_TYPE_CONSTANT: {
+            case PRATT_EXPR_TYPE_CONSTANT:
+            case PRATT_EXPR_TYPE_REG:
                 targetReg = condReg;
-                saveExprToRegister(compiler, &condExpr, condReg);
                 break;
-            }
             case PRATT_EXPR_TYPE_VAR:
                 targetReg = condExpr.value.reg;
                 break;
-            case PRATT_EXPR_TYPE_REG:
-                targetReg = condReg;
-                break;
             default:
                 SEMI_COMPILE_ABORT(compiler, SEMI_ERROR_INTERNAL_ERROR, "Unexpected expression type in if condition");
         }
         restoreNextRegisterId(compiler, currentNextRegisterId);
 
-        PCLocation pcAfterCond = emitPlaceholder(compiler);
+        bool isConstantCond = condExpr.type == PRATT_EXPR_TYPE_CONSTANT;
+        bool isDeadBranch   = isExhaustive || (isConstantCond && !isConstantExprTruthy(compiler, &condExpr));
+        bool isAlwaysTaken  = !isDeadBranch && isConstantCond;
+
+        PCLocation pcAfterCond = INVALID_PC_LOCATION;
+        if (!isDeadBranch && !isConstantCond) {
+            pcAfterCond = emitPlaceholder(compiler);
+        }
 
         if (peekToken(&compiler->lexer) != TK_OPEN_BRACE) {
             SEMI_COMPILE_ABORT(compiler, SEMI_ERROR_UNEXPECTED_TOKEN, "Expected opening brace for if body");
@@ -2849,23 +5157,45 @@ static void parseIf(Compiler* compiler) {
         } else if (branchCoarity == UINT8_MAX) {
             terminalCoarity = UINT8_MAX;
         }
+        bool isBranchTerminated = ifScope.base.isTerminated;
+        hasUpvalue              = hasUpvalue || ifScope.base.hasUpvalue;
 
         leaveBlockScope(compiler);
         restoreNextRegisterId(compiler, currentNextRegisterId);
 
-        // If it's not the end of the if-elif-else chain, we need to provide the jump-to-end
-        // instruction.
         ifTypeToken = peekToken(&compiler->lexer);
-        if (ifTypeToken == TK_ELIF || ifTypeToken == TK_ELSE) {
-            patchHead = emitCode(compiler, INSTRUCTION_JUMP(patchHead, false));
+        if (isDeadBranch) {
+            discardCodeSince(compiler, branchLocation);
+            continue;
         }
 
-        overrideConditionalJumpHere(compiler, pcAfterCond, targetReg, false);
+        // If it's not the end of the if-elif-else chain, we need to provide the jump-to-end instruction unless the
+        // branch never reaches its end or the rest of the chain is dead.
+        isTerminated = isTerminated && isBranchTerminated;
+        if (isAlwaysTaken) {
+            isExhaustive = true;
+        }
+        // The jump to the end is linked into the chain only after the conditional jump is patched, since patching may
+        // move the code after the condition.
+        bool isJumpingToEnd =
+            (ifTypeToken == TK_ELIF || ifTypeToken == TK_ELSE) && !isBranchTerminated && !isAlwaysTaken;
+        if (isJumpingToEnd) {
+            emitPlaceholder(compiler);
+        }
+        if (pcAfterCond != INVALID_PC_LOCATION) {
+            overrideConditionalJumpHere(compiler, pcAfterCond, targetReg, false);
+        }
+        if (isJumpingToEnd) {
+            PCLocation jumpLocation = currentPCLocation(compiler) - 1;
+            patchCode(compiler, jumpLocation, INSTRUCTION_JUMP(patchHead, false));
+            patchHead = jumpLocation;
+        }
     } while (ifTypeToken == TK_ELIF);
 
     if (ifTypeToken == TK_ELSE) {
         MATCH_NEXT_TOKEN_OR_ABORT(compiler, TK_ELSE, "Expected 'else' token");
 
+        PCLocation branchLocation = currentPCLocation(compiler);
         IfScope ifScope;
         enterBlockScope(compiler, (BlockScope*)&ifScope, BLOCK_SCOPE_TYPE_IF);
         parseScopedStatements(compiler);
@@ -2873,9 +5203,18 @@ static void parseIf(Compiler* compiler) {
         if (ifScope.base.terminalCoarity == UINT8_MAX) {
             terminalCoarity = UINT8_MAX;
         }
+        bool isBranchTerminated = ifScope.base.isTerminated;
+        hasUpvalue              = hasUpvalue || ifScope.base.hasUpvalue;
 
         leaveBlockScope(compiler);
         restoreNextRegisterId(compiler, currentNextRegisterId);
+
+        if (isExhaustive) {
+            discardCodeSince(compiler, branchLocation);
+        } else {
+            isTerminated = isTerminated && isBranchTerminated;
+            isExhaustive = true;
+        }
     } else {
         terminalCoarity = UINT8_MAX;
     }
@@ -2891,7 +5230,14 @@ static void parseIf(Compiler* compiler) {
         compiler->currentFunction->currentBlock->terminalCoarity = terminalCoarity;
     }
 
-    emitCode(compiler, INSTRUCTION_CLOSE_UPVALUES(currentNextRegisterId, 0, 0, false, false));
+    if (isExhaustive && isTerminated) {
+        // Nothing jumps to the end of the chain.
+        compiler->currentFunction->currentBlock->isTerminated = true;
+        return;
+    }
+    if (hasUpvalue) {
+        emitCode(compiler, INSTRUCTION_CLOSE_UPVALUES(currentNextRegisterId, 0, 0, false, false));
+    }
 }
 
 static void saveRangeOperand(
@@ -2918,13 +5264,32 @@ static void saveRangeOperand(
     *operandInline = false;
 }
 
+static bool isConstantRangeEmpty(Value range) {
+    switch (VALUE_TYPE(&range)) {
+        case VALUE_TYPE_INLINE_RANGE:
+            return AS_INLINE_RANGE(&range).start >= AS_INLINE_RANGE(&range).end;
+        case VALUE_TYPE_OBJECT_INT_RANGE: {
+            ObjectRange* r = AS_OBJECT_RANGE(&range);
+            return r->as.ir.step > 0 ? r->as.ir.start >= r->as.ir.end : r->as.ir.start <= r->as.ir.end;
+        }
+        case VALUE_TYPE_OBJECT_FLOAT_RANGE: {
+            ObjectRange* r = AS_OBJECT_RANGE(&range);
+            return r->as.fr.step > 0 ? r->as.fr.end - r->as.fr.start <= FLOAT_EPSILON
+                                     : r->as.fr.start - r->as.fr.end <= FLOAT_EPSILON;
+        }
+        default:
+            return false;
+    }
+}
+
 // parse range with startExpr just parsed, assuming that the next token is "..". The result
-// will be saved to startReg.
-static void parseForRange(Compiler* compiler, PrattExpr startExpr, LocalRegisterId startReg) {
+// will be saved to startReg. Returns true if the range is a constant without any element.
+static bool parseForRange(Compiler* compiler, PrattExpr startExpr, LocalRegisterId startReg) {
     // we handle each expression one by one with the guarantee that each expression
     // uses only one register (the targetRegister) to store the result.
 
     PrattExpr endExpr, stepExpr;
+    bool isEmpty = false;
     if (startExpr.type == PRATT_EXPR_TYPE_CONSTANT && !IS_NUMBER(&startExpr.value.constant)) {
         SEMI_COMPILE_ABORT(compiler, SEMI_ERROR_INVALID_VALUE, "Range operands must be numbers");
     }
@@ -2972,11 +5337,12 @@ static void parseForRange(Compiler* compiler, PrattExpr startExpr, LocalRegister
             SEMI_COMPILE_ABORT(compiler, SEMI_ERROR_MEMORY_ALLOCATION_FAILURE, "failed to create range constant");
         }
         ConstantIndex idx = semiConstantTableInsert(&compiler->artifactModule->constantTable, range);
-        if (idx > MAX_OPERAND_K) {
-            // TODO: Spill with OP_EXTRA_ARG
-            SEMI_COMPILE_ABORT(compiler, SEMI_ERROR_TOO_MANY_CONSTANTS, "Too many constants in a module");
+        if (idx == CONST_INDEX_INVALID) {
+            SEMI_COMPILE_ABORT(
+                compiler, SEMI_ERROR_MEMORY_ALLOCATION_FAILURE, "Memory allocation failure when saving range constant");
         }
-        emitCode(compiler, INSTRUCTION_LOAD_CONSTANT(startReg, (uint16_t)idx, false, false));
+        emitCodeWithExtendedK(compiler, INSTRUCTION_LOAD_CONSTANT(startReg, (uint16_t)idx, false, false), idx);
+        isEmpty = isConstantRangeEmpty(range);
     } else {
         // At least one operand is not constant, we have to save them to registers.
         bool kb, kc;
@@ -2988,13 +5354,18 @@ static void parseForRange(Compiler* compiler, PrattExpr startExpr, LocalRegister
     }
 
     restoreNextRegisterId(compiler, startReg + 1);
+    return isEmpty;
 }
 
+// The iterable is saved to iterReg and followed by two internal registers: the cursor and the counter of the index
+// variable. ITER_PREPARE initializes both, so iterating a built-in collection does not allocate.
 static void parseForIter(Compiler* compiler, PrattExpr iterExpr, LocalRegisterId iterReg) {
     saveExprToRegister(compiler, &iterExpr, iterReg);
-    emitCode(compiler, INSTRUCTION_ITER_PREPARE(iterReg, iterReg, 0, false, false));
-
     restoreNextRegisterId(compiler, iterReg + 1);
+
+    reserveTempRegister(compiler);  // cursor
+    reserveTempRegister(compiler);  // counter
+    emitCode(compiler, INSTRUCTION_ITER_PREPARE(iterReg, iterReg, 0, false, false));
 }
 
 typedef enum {
@@ -3006,6 +5377,8 @@ typedef enum {
 typedef struct ForHeader {
     ForHeaderType type;
     bool hasIndexVar;
+    // Whether the loop iterates over a constant empty range, so that its body never runs.
+    bool isEmpty;
 } ForHeader;
 
 static ForHeader parseForHeader(Compiler* compiler, LocalRegisterId iterReg) {
@@ -3018,6 +5391,7 @@ static ForHeader parseForHeader(Compiler* compiler, LocalRegisterId iterReg) {
     }
 
     ForHeaderType forHeaderType;
+    bool isEmpty = false;
     IdentifierId firstIdentifierId, secondIdentifierId;
     firstIdentifierId = newIdentifierNud(compiler);
 
@@ -3051,7 +5425,7 @@ static ForHeader parseForHeader(Compiler* compiler, LocalRegisterId iterReg) {
         case TK_DOUBLE_DOTS: {
             // for ... in startExpr..endExpr [by stepExpr]
             forHeaderType = FOR_HEADER_TYPE_RANGE;
-            parseForRange(compiler, iterExpr, iterReg);
+            isEmpty       = parseForRange(compiler, iterExpr, iterReg);
             if (hasIndexVar) {
                 // reserve internal index register and initialize it to 0
                 LocalRegisterId internalCounterReg = reserveTempRegister(compiler);
@@ -3077,6 +5451,7 @@ static ForHeader parseForHeader(Compiler* compiler, LocalRegisterId iterReg) {
     return (ForHeader){
         .type        = forHeaderType,
         .hasIndexVar = hasIndexVar,
+        .isEmpty     = isEmpty,
     };
 }
 
@@ -3109,11 +5484,13 @@ static void parseFor(Compiler* compiler) {
 
     // For-blocks don't increase or decrease the number of variables and registers used, so we
     // choose to write a single CLOSE_UPVALUES instruction at the end of the block to close all
-    // opened upvalues. If there are other control flow statements that leave the scope, they need
-    // to take care of closing upvalues of this scope. Since block scopes have stack semantics,
-    // their implementation should just work.
+    // opened upvalues. It is omitted when no closure captures a variable declared in the loop.
+    // If there are other control flow statements that leave the scope, they need to take care
+    // of closing upvalues of this scope. Since block scopes have stack semantics, their
+    // implementation should just work.
     LocalRegisterId currentNextRegisterId = getNextRegisterId(compiler);
     LocalRegisterId iterReg               = reserveTempRegister(compiler);
+    PCLocation loopLocation               = currentPCLocation(compiler);
 
     LoopScope loopScope;
     enterBlockScope(compiler, (BlockScope*)&loopScope, BLOCK_SCOPE_TYPE_LOOP);
@@ -3131,31 +5508,53 @@ static void parseFor(Compiler* compiler) {
     MATCH_PEEK_TOKEN_OR_ABORT(compiler, TK_OPEN_BRACE, "Expected opening brace for for body");
     parseScopedStatements(compiler);
 
-    emitJumpBack(compiler, loopScope.loopStartLocation);
+    if (!loopScope.base.isTerminated) {
+        emitJumpBack(compiler, loopScope.loopStartLocation);
+    }
     leaveBlockScope(compiler);
 
+    if (forHeader.isEmpty) {
+        discardCodeSince(compiler, loopLocation);
+        restoreNextRegisterId(compiler, currentNextRegisterId);
+        return;
+    }
+    if (forHeader.type == FOR_HEADER_TYPE_INFINITE && loopScope.previousJumpLocation == INVALID_PC_LOCATION) {
+        // Without a `break`, nothing jumps to the end of the loop.
+        compiler->currentFunction->currentBlock->isTerminated = true;
+        restoreNextRegisterId(compiler, currentNextRegisterId);
+        return;
+    }
+
     // Patch all break statements to jump to the loop end.
     while (loopScope.previousJumpLocation != INVALID_PC_LOCATION) {
         PCLocation temp                = loopScope.previousJumpLocation;
         loopScope.previousJumpLocation = OPERAND_J_J(compiler->currentFunction->chunk.data[temp]);
         overrideJumpHere(compiler, temp);
     }
-    PCLocation loopEndPCLocation =
+    PCLocation loopEndPCLocation = currentPCLocation(compiler);
+    if (loopScope.base.hasUpvalue) {
         emitCode(compiler, INSTRUCTION_CLOSE_UPVALUES(currentNextRegisterId, 0, 0, false, false));
+    }
 
     // Invariant: loopEndPCLocation >= loopScope.loopStartLocation
-    uint16_t diff = (uint16_t)(loopEndPCLocation - loopScope.loopStartLocation);
+    PCLocation diff           = loopEndPCLocation - loopScope.loopStartLocation;
+    PCLocation headerLocation = loopScope.loopStartLocation;
+    if (forHeader.type != FOR_HEADER_TYPE_INFINITE && diff > MAX_OPERAND_K) {
+        // The jumps back to the loop start now run the EXTRA_ARG in front of the header.
+        insertExtraArg(compiler, headerLocation, diff >> 16);
+        headerLocation++;
+    }
     switch (forHeader.type) {
         case FOR_HEADER_TYPE_ITER:
             patchCode(compiler,
-                      loopScope.loopStartLocation,
-                      INSTRUCTION_ITER_NEXT(iterReg, diff, forHeader.hasIndexVar, false));
+                      headerLocation,
+                      INSTRUCTION_ITER_NEXT(iterReg, (uint16_t)diff, forHeader.hasIndexVar, false));
             break;
 
         case FOR_HEADER_TYPE_RANGE:
             patchCode(compiler,
-                      loopScope.loopStartLocation,
-                      INSTRUCTION_RANGE_NEXT(iterReg, diff, forHeader.hasIndexVar, false));
+                      headerLocation,
+                      INSTRUCTION_RANGE_NEXT(iterReg, (uint16_t)diff, forHeader.hasIndexVar, false));
             break;
 
         case FOR_HEADER_TYPE_INFINITE:
@@ -3164,6 +5563,9 @@ static void parseFor(Compiler* compiler) {
         default:
             SEMI_UNREACHABLE();
     }
+    if (forHeader.type != FOR_HEADER_TYPE_INFINITE) {
+        hoistLoopInvariants(compiler, loopLocation, loopScope.loopStartLocation, iterReg);
+    }
 
     restoreNextRegisterId(compiler, currentNextRegisterId);
 }
@@ -3173,11 +5575,14 @@ static void parseFunction(Compiler* compiler, bool isModuleExport) {
 
     // Get function name
     IdentifierId fnIdentifierId = newIdentifierNud(compiler);
-    if (nextToken(&compiler->lexer) != TK_OPEN_PAREN) {
-        SEMI_COMPILE_ABORT(
-            compiler, SEMI_ERROR_UNEXPECTED_TOKEN, "Expected opening parenthesis for function parameters");
-    }
-    updateBracketCount(compiler, TK_OPEN_PAREN);
+
+    // The source of a cached declaration starts right after the name.
+    const CachedDeclaration* cachedDeclaration = NULL;
+    const char* sourceStart                    = compiler->lexer.curr;
+    uint32_t sourceLine                        = compiler->lexer.line;
+    uint32_t dependencyStart                   = compiler->declarationCache.dependencies.size;
+    bool isCacheable =
+        compiler->enableIncrementalCompilation && IS_TOP_LEVEL(compiler) && compiler->lexer.token == TK_NON_TOKEN;
 
     // Add the symbol before parsing the body so that the function can be recursive.
     // This also avoid using the same name in the parameters.
@@ -3189,6 +5594,29 @@ static void parseFunction(Compiler* compiler, bool isModuleExport) {
         bindLocalVariable(compiler, fnIdentifierId, fnReg);
     }
 
+    // The name is bound first, as a recursive body depends on it.
+    if (isCacheable) {
+        cachedDeclaration = findUnchangedDeclaration(compiler, fnIdentifierId);
+    }
+    if (cachedDeclaration == NULL) {
+        if (nextToken(&compiler->lexer) != TK_OPEN_PAREN) {
+            SEMI_COMPILE_ABORT(
+                compiler, SEMI_ERROR_UNEXPECTED_TOKEN, "Expected opening parenthesis for function parameters");
+        }
+        updateBracketCount(compiler, TK_OPEN_PAREN);
+    }
+
+    FunctionProto* fn;
+    ConstantIndex fnIndex;
+    if (cachedDeclaration != NULL) {
+        fn      = reuseDeclaration(compiler, cachedDeclaration);
+        fnIndex = cachedDeclaration->protoIndex;
+        goto emit_function;
+    }
+
+    if (isCacheable) {
+        compiler->isRecordingDependencies = true;
+    }
     enterFunctionScope(compiler, false);
 
     // Collect function parameters one by one
@@ -3248,7 +5676,14 @@ parsed_arguments:
             compiler, SEMI_ERROR_MISSING_RETURN_STATEMENT, "Missing return statement at the end of function");
     }
 
-    FunctionProto* fn = semiFunctionProtoCreate(compiler->gc, compiler->currentFunction->upvalues.size);
+    // Chunks must end with a RETURN. This one is never reached, e.g. when the function ends with an infinite loop and
+    // the return statement after it is discarded.
+    Chunk* chunk = &compiler->currentFunction->chunk;
+    if (chunk->size == 0 || GET_OPCODE(chunk->data[chunk->size - 1]) != OP_RETURN) {
+        emitCode(compiler, INSTRUCTION_RETURN(UINT8_MAX, 0, 0, false, false));
+    }
+
+    fn = semiFunctionProtoCreate(compiler->gc, compiler->currentFunction->upvalues.size);
     if (fn == NULL) {
         SEMI_COMPILE_ABORT(compiler, SEMI_ERROR_MEMORY_ALLOCATION_FAILURE, "Failed to allocate function object");
     }
@@ -3260,25 +5695,48 @@ parsed_arguments:
            compiler->currentFunction->upvalues.data,
            sizeof(UpvalueDescription) * compiler->currentFunction->upvalues.size);
 
-    // Change the owner of the chunk to the function.
-    fn->chunk    = compiler->currentFunction->chunk;
+    optimizeChunk(compiler, &compiler->currentFunction->chunk);
     fn->moduleId = compiler->artifactModule->moduleId;
-    ChunkInit(&compiler->currentFunction->chunk);
+    saveChunk(compiler, compiler->currentFunction, fn);
+    saveAttrCaches(compiler, compiler->currentFunction, fn);
     leaveFunctionScope(compiler);
+    if (isCacheable) {
+        compiler->isRecordingDependencies = false;
+    }
 
-    Value fnValue         = semiValueFunctionProtoCreate(fn);
-    ConstantIndex fnIndex = semiConstantTableInsert(&compiler->artifactModule->constantTable, fnValue);
+    fnIndex = semiConstantTableInsert(&compiler->artifactModule->constantTable, semiValueFunctionProtoCreate(fn));
+    if (fnIndex == CONST_INDEX_INVALID) {
+        SEMI_COMPILE_ABORT(
+            compiler, SEMI_ERROR_MEMORY_ALLOCATION_FAILURE, "Memory allocation failure when saving function constant");
+    }
+    if (isCacheable) {
+        if (fn->upvalueCount == 0) {
+            CachedDeclaration declaration = {
+                .identifierId    = fnIdentifierId,
+                .sourceLength    = (uint32_t)(compiler->lexer.curr - sourceStart),
+                .sourceHash      = semiHashBytes64(sourceStart, (size_t)(compiler->lexer.curr - sourceStart)),
+                .lineCount       = compiler->lexer.line - sourceLine,
+                .lastLineOffset  = (uint32_t)(compiler->lexer.lineStart - sourceStart),
+                .protoIndex      = fnIndex,
+                .dependencyStart = dependencyStart,
+                .dependencyCount = compiler->declarationCache.dependencies.size - dependencyStart,
+            };
+            cacheDeclaration(compiler, declaration, NULL);
+        } else {
+            compiler->declarationCache.dependencies.size = dependencyStart;
+        }
+    }
 
+emit_function:
     // Load the function proto from the constant table. This makes the register a function.
-    if (fnIndex > MAX_OPERAND_K) {
-        // TODO: Spill with OP_EXTRA_ARG
-        SEMI_COMPILE_ABORT(compiler, SEMI_ERROR_TOO_MANY_CONSTANTS, "Too many constants in a module");
-    }
-    emitCode(compiler, INSTRUCTION_LOAD_CONSTANT(fnReg, (uint16_t)fnIndex, false, false));
+    emitCodeWithExtendedK(compiler, INSTRUCTION_LOAD_CONSTANT(fnReg, (uint16_t)fnIndex, false, false), fnIndex);
 
     if (IS_TOP_LEVEL(compiler)) {
-        emitCode(compiler, INSTRUCTION_SET_MODULE_VAR(fnReg, moduleVarId, false, isModuleExport));
+        emitCodeWithExtendedK(compiler,
+                              INSTRUCTION_SET_MODULE_VAR(fnReg, (uint16_t)moduleVarId, false, isModuleExport),
+                              moduleVarId);
         restoreNextRegisterId(compiler, fnReg);
+        recordInlineCandidate(compiler, fnIdentifierId, fn);
     }
 }
 
@@ -3374,6 +5832,7 @@ check_coarity:
     }
 
     compiler->currentFunction->currentBlock->terminalCoarity = coarity;
+    compiler->currentFunction->currentBlock->isTerminated    = true;
 }
 
 static void parseRaise(Compiler* compiler) {
@@ -3392,6 +5851,7 @@ static void parseContinue(Compiler* compiler) {
 
     LoopScope* loopScope = (LoopScope*)currentBlock;
     emitJumpBack(compiler, loopScope->loopStartLocation);
+    compiler->currentFunction->currentBlock->isTerminated = true;
 }
 
 static void parseBreak(Compiler* compiler) {
@@ -3408,6 +5868,7 @@ static void parseBreak(Compiler* compiler) {
     LoopScope* loopScope            = (LoopScope*)currentBlock;
     PCLocation pcJump               = emitCode(compiler, INSTRUCTION_JUMP(loopScope->previousJumpLocation, false));
     loopScope->previousJumpLocation = pcJump;
+    compiler->currentFunction->currentBlock->isTerminated = true;
 }
 
 static void parseDefer(Compiler* compiler) {
@@ -3430,33 +5891,38 @@ static void parseDefer(Compiler* compiler) {
            compiler->currentFunction->upvalues.data,
            sizeof(UpvalueDescription) * compiler->currentFunction->upvalues.size);
 
-    // Change the owner of the chunk to the function.
-    fn->chunk    = compiler->currentFunction->chunk;
+    optimizeChunk(compiler, &compiler->currentFunction->chunk);
     fn->moduleId = compiler->artifactModule->moduleId;
-    ChunkInit(&compiler->currentFunction->chunk);
+    saveChunk(compiler, compiler->currentFunction, fn);
+    saveAttrCaches(compiler, compiler->currentFunction, fn);
     leaveFunctionScope(compiler);
 
     Value fnValue         = semiValueFunctionProtoCreate(fn);
     ConstantIndex fnIndex = semiConstantTableInsert(&compiler->artifactModule->constantTable, fnValue);
 
     // Load the function proto from the constant table. This makes the register a function.
-    if (fnIndex > MAX_OPERAND_K) {
-        // TODO: Spill with OP_EXTRA_ARG
-        SEMI_COMPILE_ABORT(compiler, SEMI_ERROR_TOO_MANY_CONSTANTS, "Too many constants in a module");
+    if (fnIndex == CONST_INDEX_INVALID) {
+        SEMI_COMPILE_ABORT(
+            compiler, SEMI_ERROR_MEMORY_ALLOCATION_FAILURE, "Memory allocation failure when saving function constant");
     }
-    emitCode(compiler, INSTRUCTION_DEFER_CALL(0, (uint16_t)fnIndex, false, false));
+    emitCodeWithExtendedK(compiler, INSTRUCTION_DEFER_CALL(0, (uint16_t)fnIndex, false, false), fnIndex);
 }
 
 static void parseBlock(Compiler* compiler) {
     BlockScope blockScope;
     uint8_t terminalCoarity;
+    bool isTerminated;
 
     enterBlockScope(compiler, &blockScope, BLOCK_SCOPE_TYPE_NORMAL);
     parseScopedStatements(compiler);
     terminalCoarity = compiler->currentFunction->currentBlock->terminalCoarity;
+    isTerminated    = compiler->currentFunction->currentBlock->isTerminated;
     leaveBlockScope(compiler);
 
     compiler->currentFunction->currentBlock->terminalCoarity = terminalCoarity;
+    if (isTerminated) {
+        compiler->currentFunction->currentBlock->isTerminated = true;
+    }
 }
 
 void semiParseStatement(Compiler* compiler) {
@@ -3509,6 +5975,9 @@ void semiParseStatement(Compiler* compiler) {
 }
 
 static void parseStatements(Compiler* compiler) {
+    // Statements after a terminating one are still parsed to report errors, but their code is discarded.
+    PCLocation unreachableLocation = INVALID_PC_LOCATION;
+
     Token t;
     while ((t = peekToken(&compiler->lexer)) != TK_EOF) {
         if (t == TK_SEPARATOR || t == TK_SEMICOLON) {
@@ -3516,10 +5985,17 @@ static void parseStatements(Compiler* compiler) {
             continue;  // Skip whitespace and separators
         }
         if (t == TK_CLOSE_BRACE) {
-            return;  // End of scoped statements
+            break;  // End of scoped statements
         }
 
         semiParseStatement(compiler);
+        if (unreachableLocation == INVALID_PC_LOCATION && compiler->currentFunction->currentBlock->isTerminated) {
+            unreachableLocation = currentPCLocation(compiler);
+        }
+    }
+
+    if (unreachableLocation != INVALID_PC_LOCATION) {
+        discardCodeSince(compiler, unreachableLocation);
     }
 }
 
@@ -3544,21 +6020,27 @@ static void finalizeCompiler(struct Compiler* compiler) {
         SEMI_COMPILE_ABORT(compiler, SEMI_ERROR_MEMORY_ALLOCATION_FAILURE, "Failed to allocate function object");
     }
 
-    fn->chunk        = compiler->rootFunction.chunk;
+    optimizeChunk(compiler, &compiler->rootFunction.chunk);
+    saveChunk(compiler, &compiler->rootFunction, fn);
     fn->maxStackSize = compiler->rootFunction.maxUsedRegisterCount;
     fn->arity        = 0;
     fn->upvalueCount = 0;
     fn->moduleId     = compiler->artifactModule->moduleId;
-
-    ChunkInit(&compiler->rootFunction.chunk);
+    saveAttrCaches(compiler, &compiler->rootFunction, fn);
 
     SemiModule* module = compiler->artifactModule;
     module->moduleInit = fn;
 }
 
-void semiCompilerCompileModule(Compiler* compiler, SemiModuleSource* moduleSource, SemiModule* target) {
+// Compile the module the lexer was initialized with into `target`.
+static void compileLexedModule(Compiler* compiler, SemiModule* target) {
     compiler->artifactModule = target;
-    initLexer(&compiler->lexer, compiler, moduleSource->source, moduleSource->length);
+    if (compiler->enableIncrementalCompilation) {
+        compiler->declarationCache.environmentFingerprint = environmentFingerprint(compiler);
+        compiler->canReuseDeclarations =
+            target->declarationCache.declarations.size > 0 &&
+            target->declarationCache.environmentFingerprint == compiler->declarationCache.environmentFingerprint;
+    }
 
     parseStatements(compiler);
     if (nextToken(&compiler->lexer) != TK_EOF) {
@@ -3566,6 +6048,33 @@ void semiCompilerCompileModule(Compiler* compiler, SemiModuleSource* moduleSourc
     }
 
     finalizeCompiler(compiler);
+
+    if (compiler->enableIncrementalCompilation) {
+        semiDeclarationCacheCleanup(compiler->gc, &target->declarationCache);
+        target->declarationCache = compiler->declarationCache;
+        semiDeclarationCacheInit(&compiler->declarationCache);
+    }
+}
+
+void semiCompilerCompileModule(Compiler* compiler, SemiModuleSource* moduleSource, SemiModule* target) {
+    initLexer(&compiler->lexer, compiler, moduleSource->source, moduleSource->length);
+    if (compiler->enableConstantPropagation || compiler->enableInlining || compiler->enableLoopInvariantCodeMotion) {
+        scanReassignedIdentifiers(compiler, moduleSource->source, moduleSource->length);
+    }
+    compileLexedModule(compiler, target);
+}
+
+// The source is lexed as it is read. The passes over the whole source can't run, so the optimizations relying on them
+// are turned off.
+static void compileModuleFromReader(Compiler* compiler, const SemiModuleReader* reader, SemiModule* target) {
+    compiler->enableConstantPropagation     = false;
+    compiler->enableInlining                = false;
+    compiler->enableLoopInvariantCodeMotion = false;
+    compiler->enableIncrementalCompilation  = false;
+    // The declarations cached by an earlier compilation can't be checked against this one.
+    semiDeclarationCacheCleanup(compiler->gc, &target->declarationCache);
+    initReaderLexer(&compiler->lexer, compiler, reader);
+    compileLexedModule(compiler, target);
 }
 
 void semiCompilerInit(Compiler* compiler) {
@@ -3582,9 +6091,18 @@ void semiCompilerInit(Compiler* compiler) {
     rootFunction->nextRegisterId               = 0;
     rootFunction->maxUsedRegisterCount         = 0;
     UpvalueListInit(&rootFunction->upvalues);
+    AttrCacheListInit(&rootFunction->attrCaches);
     ChunkInit(&rootFunction->chunk);
 
     VariableListInit(&compiler->variables);
+    semiArenaInit(&compiler->arena);
+    semiArenaInit(&compiler->scratchArena);
+    semiObjectStackDictInit(&compiler->reassignedIdentifiers);
+    semiObjectStackDictInit(&compiler->moduleConstants);
+    semiObjectStackDictInit(&compiler->inlineCandidates);
+    semiObjectStackDictInit(&compiler->definedModuleVariables);
+    semiObjectStackDictInit(&compiler->definedTypes);
+    semiDeclarationCacheInit(&compiler->declarationCache);
     compiler->currentFunction     = &compiler->rootFunction;
     compiler->newlineState        = 0;
     compiler->newlineState        = 0;
@@ -3595,17 +6113,53 @@ void semiCompilerInit(Compiler* compiler) {
 }
 
 void semiCompilerCleanup(struct Compiler* compiler) {
-    while (compiler->currentFunction != &compiler->rootFunction) {
-        leaveFunctionScope(compiler);
-    }
-    ChunkCleanup(compiler->gc, &compiler->rootFunction.chunk);
-    UpvalueListCleanup(compiler->gc, &compiler->rootFunction.upvalues);
-    VariableListCleanup(compiler->gc, &compiler->variables);
-    ChunkCleanup(compiler->gc, &compiler->rootFunction.chunk);
+    semiFree(compiler->gc, compiler->lexer.window, compiler->lexer.windowCapacity);
+    compiler->lexer.window = NULL;
+    semiArenaCleanup(compiler->gc, &compiler->arena);
+    semiArenaCleanup(compiler->gc, &compiler->scratchArena);
+    compiler->currentFunction = &compiler->rootFunction;
+    ChunkInit(&compiler->rootFunction.chunk);
+    UpvalueListInit(&compiler->rootFunction.upvalues);
+    AttrCacheListInit(&compiler->rootFunction.attrCaches);
+    VariableListInit(&compiler->variables);
+    semiObjectStackDictCleanup(compiler->gc, &compiler->reassignedIdentifiers);
+    semiObjectStackDictCleanup(compiler->gc, &compiler->moduleConstants);
+    semiObjectStackDictCleanup(compiler->gc, &compiler->inlineCandidates);
+    semiObjectStackDictCleanup(compiler->gc, &compiler->definedModuleVariables);
+    semiObjectStackDictCleanup(compiler->gc, &compiler->definedTypes);
+    semiDeclarationCacheCleanup(compiler->gc, &compiler->declarationCache);
 }
 
-SemiModule* semiVMCompileModule(SemiVM* vm, SemiModuleSource* moduleSource) {
-    InternedChar* moduleName = semiSymbolTableInsert(&vm->symbolTable, moduleSource->name, moduleSource->nameLength);
+// Compile the module of `moduleSource`, or the one streamed from `reader` if it is not NULL.
+static SemiModule* compileModule(SemiVM* vm, SemiModuleSource* moduleSource, const SemiModuleReader* reader) {
+    Compiler compiler;
+    semiCompilerInit(&compiler);
+
+    compiler.gc                            = &vm->gc;
+    compiler.symbolTable                   = &vm->symbolTable;
+    compiler.classes                       = &vm->classes;
+    compiler.globalIdentifiers             = &vm->globalIdentifiers;
+    compiler.enablePeephole                = true;
+    compiler.enableConstantPropagation     = true;
+    compiler.enableInlining                = true;
+    compiler.enableLoopInvariantCodeMotion = true;
+    compiler.enableIncrementalCompilation  = true;
+
+    // A streamed module is never cached, as the cache is keyed by the whole source.
+    SemiCompileCache* compileCache = reader == NULL ? vm->compileCache : NULL;
+    CompileEnvironment environment;
+    if (compileCache != NULL) {
+        semiCompileEnvironmentCapture(vm, &environment);
+        SemiModule* module =
+            semiCompileCacheLoad(compileCache, vm, moduleSource, compilerConfiguration(&compiler), &environment);
+        if (module != NULL) {
+            return module;
+        }
+    }
+
+    const char* name                    = reader != NULL ? reader->name : moduleSource->name;
+    uint8_t nameLength                  = reader != NULL ? reader->nameLength : moduleSource->nameLength;
+    InternedChar* moduleName            = semiSymbolTableInsert(&vm->symbolTable, name, nameLength);
     IdentifierId moduleNameIdentifierId = semiSymbolTableGetId(moduleName);
     FunctionProto* oldModuleInit        = NULL;
     SemiModule* artifactModule          = NULL;
@@ -3633,16 +6187,18 @@ SemiModule* semiVMCompileModule(SemiVM* vm, SemiModuleSource* moduleSource) {
         semiPrimitivesInitBuiltInModuleTypes(&vm->gc, &vm->symbolTable, artifactModule);
     }
 
-    Compiler compiler;
-    semiCompilerInit(&compiler);
-
-    compiler.gc                = &vm->gc;
-    compiler.symbolTable       = &vm->symbolTable;
-    compiler.classes           = &vm->classes;
-    compiler.globalIdentifiers = &vm->globalIdentifiers;
+    compiler.isRecompilation = isModuleExisted;
 
+    artifactModule->peepholeRemovedCount    = 0;
+    artifactModule->inlinedCallCount        = 0;
+    artifactModule->hoistedInstructionCount = 0;
+    artifactModule->reusedFunctionCount     = 0;
     if (setjmp(compiler.errorJmpBuf.env) == 0) {
-        semiCompilerCompileModule(&compiler, moduleSource, artifactModule);
+        if (reader != NULL) {
+            compileModuleFromReader(&compiler, reader, artifactModule);
+        } else {
+            semiCompilerCompileModule(&compiler, moduleSource, artifactModule);
+        }
     }
 
     if (compiler.errorJmpBuf.errorId != 0) {
@@ -3662,9 +6218,11 @@ SemiModule* semiVMCompileModule(SemiVM* vm, SemiModuleSource* moduleSource) {
 
         if (isModuleExisted) {
             artifactModule->moduleInit = oldModuleInit;
+            compactModule(vm, artifactModule, NULL);
         } else {
             semiVMModuleDestroy(&vm->gc, artifactModule);
         }
+        semiCompilerCleanup(&compiler);
         return NULL;
     }
 
@@ -3673,15 +6231,26 @@ SemiModule* semiVMCompileModule(SemiVM* vm, SemiModuleSource* moduleSource) {
                     &vm->modules,
                     semiValueIntCreate(moduleNameIdentifierId),
                     semiValuePtrCreate(artifactModule, VALUE_TYPE_UNSET));
+        if (compileCache != NULL) {
+            semiCompileCacheStore(
+                compileCache, vm, moduleSource, compilerConfiguration(&compiler), &environment, artifactModule);
+        }
     }
     if (oldModuleInit != NULL) {
         semiFunctionProtoDestroy(&vm->gc, oldModuleInit);
     }
+    if (isModuleExisted) {
+        compactModule(vm, artifactModule, &compiler.definedModuleVariables);
+    }
 
     semiCompilerCleanup(&compiler);
     return artifactModule;
 }
 
+SemiModule* semiVMCompileModule(SemiVM* vm, SemiModuleSource* moduleSource) {
+    return compileModule(vm, moduleSource, NULL);
+}
+
 ErrorId semiVMAddModule(SemiVM* vm, SemiModuleSource moduleSource, bool transitive) {
     (void)transitive;  // Currently unused
 
@@ -3689,6 +6258,13 @@ ErrorId semiVMAddModule(SemiVM* vm, SemiModuleSource moduleSource, bool transiti
     return vm->error;
 }
 
+ErrorId semiVMAddModuleFromReader(SemiVM* vm, SemiModuleReader reader, bool transitive) {
+    (void)transitive;  // Currently unused
+
+    compileModule(vm, NULL, &reader);
+    return vm->error;
+}
+
 #pragma endregion
 
 /*
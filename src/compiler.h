@@ -8,6 +8,7 @@
 #include <stdbool.h>
 #include <stdint.h>
 
+#include "./arena.h"
 #include "./const_table.h"
 #include "./gc.h"
 #include "./instruction.h"
@@ -197,7 +198,16 @@ typedef struct Lexer {
         } identifier;
     } tokenValue;
 
+    // The digits of the last number, or the name of the last identifier of a streamed source.
     char buffer[MAX_NUMBER_CHAR];
+
+    // The reader of a streamed source, or NULL if the whole source is in memory. A streamed source is lexed from
+    // `window`, which is refilled at the start of every line so that it holds the rest of the line, as no token spans
+    // lines.
+    const SemiModuleReader* reader;
+    char* window;
+    uint32_t windowCapacity;
+    bool isReaderDone;
 } Lexer;
 
 typedef enum {
@@ -302,6 +312,12 @@ typedef union PrattExprValue {
 typedef struct PrattExpr {
     PrattExprType type;
     PrattExprValue value;
+    // The struct type of the value if it is known at compile time, otherwise `BASE_VALUE_TYPE_INVALID`. It is only a
+    // hint for attribute access, and the VM checks it before use.
+    TypeId typeHint;
+    // The function the value is known to be at compile time if it can be inlined at call sites, otherwise `NULL`.
+    // See `Compiler.enableInlining`.
+    FunctionProto* inlineCallee;
 } PrattExpr;
 
 // PrattState is used to track the state of the Pratt compiler as we parse
@@ -397,6 +413,7 @@ typedef struct LhsExpr {
         } moduleVar;
         struct {
             IdentifierId fieldName;
+            TypeId typeHint;
         } field;
         struct {
             uint8_t operand;
@@ -465,10 +482,18 @@ typedef struct BlockScope {
     //     } else {
     //         return 2   <-- terminal coarity = 1
     //     }              <-- parent block's terminal coarity = 1
-    //                    <-- dead code (currently we don't optimize for this)
+    //                    <-- dead code (discarded, see `isTerminated`)
     // }                  <-- function's terminal coarity = 1
     // ```
     uint8_t terminalCoarity;
+
+    // Whether the control flow never reaches the end of this block, because it returns, breaks or continues on every
+    // path. The code of the statements following the terminating one is discarded.
+    bool isTerminated;
+
+    // Whether a closure captures a variable of this block scope or of one nested in it. Only then do the upvalues need
+    // to be closed when the control flow leaves this block.
+    bool hasUpvalue;
 } BlockScope;
 
 typedef struct LoopScope {
@@ -485,17 +510,21 @@ typedef struct LoopScope {
     // location; and so on. When the compiler reaches the end of the loop, it traverses the linked list all the way
     // until the location is `INVALID_PC_LOCATION`.
     PCLocation previousJumpLocation;
-
-    // TODO: add `hasUpvalue`. If it is false, we can remove the `CLOSE_UPVALUE` instructions at the end of the loop.
 } LoopScope;
 
 typedef struct IfScope {
     BlockScope base;
-
-    // TODO: add `hasUpvalue`. If it is false, we can remove the `CLOSE_UPVALUE` instructions at the end of the block.
 } IfScope;
 
-DECLARE_DARRAY(UpvalueList, UpvalueDescription, uint8_t)
+DECLARE_ARENA_DARRAY(UpvalueList, UpvalueDescription, uint8_t)
+
+// The operand of GET_ATTR / SET_ATTR that refers to an inline cache is 8 bits.
+#define MAX_ATTR_CACHE_COUNT (UINT8_MAX + 1)
+
+DECLARE_ARENA_DARRAY(AttrCacheList, AttrCache, uint16_t)
+
+// The chunk of a function scope grows in the compiler arena, and is copied to its function proto once compiled.
+DECLARE_ARENA_DARRAY_OPS(Chunk, Instruction, uint32_t)
 
 typedef struct FunctionScope {
     BlockScope rootBlock;
@@ -512,6 +541,9 @@ typedef struct FunctionScope {
 
     UpvalueList upvalues;
 
+    // The inline caches of the attribute accesses in this function, moved to the function proto once it is compiled.
+    AttrCacheList attrCaches;
+
     // The next available register ID. Valid register IDs are in the range `[0, MAX_LOCAL_REGISTER_ID]`.
     //
     // Register allocation has stack semantics. When we request a new register, it returns the current `nextRegisterId`
@@ -544,9 +576,14 @@ typedef struct FunctionScope {
 typedef struct VariableDescription {
     IdentifierId identifierId;
     LocalRegisterId registerId;
+    // The struct type of the last value assigned to the variable, if known. See `PrattExpr.typeHint`.
+    TypeId typeHint;
+    // The constant the variable was bound to if it is never reassigned, or an invalid value otherwise. See
+    // `Compiler.enableConstantPropagation`.
+    Value constant;
 } VariableDescription;
 
-DECLARE_DARRAY(VariableList, VariableDescription, uint16_t)
+DECLARE_ARENA_DARRAY(VariableList, VariableDescription, uint16_t)
 
 typedef struct ErrorJmpBuf {
     jmp_buf env;
@@ -570,15 +607,60 @@ typedef struct Compiler {
     // The artifact module that is being compiled. This is not owned by the compiler.
     SemiModule* artifactModule;
 
+    // The function scopes, variables, upvalues, attribute caches and chunks of the compilation. Released at once by
+    // `semiCompilerCleanup`, also after compilation aborts.
+    Arena arena;
+    // The scratch buffers of passes over a chunk, released when the pass ends.
+    Arena scratchArena;
+
     FunctionScope rootFunction;
     // The current, innermost function scope. Never `NULL`. If it's currnetly not in a function
     // scope (i.e. it's in the module scope), it points to `rootFunction`.
     FunctionScope* currentFunction;
 
     VariableList variables;
+    // Whether the target module was compiled before. The variables of the last compilation are then only visible once
+    // this compilation defines them again, which keeps their slot unless they turn into an export or back.
+    bool isRecompilation;
+    // The module variables defined by a recompilation, keyed by identifier id, mapped to whether they are exports.
+    ObjectDict definedModuleVariables;
+    // The struct types declared by a recompilation, keyed by the identifier id of their name.
+    ObjectDict definedTypes;
 
     uint32_t newlineState;
 
+    // Whether finished chunks go through the peephole pass. `semiVMCompileModule` enables it; it's off by default so
+    // that the output of the code generator can be inspected as is.
+    bool enablePeephole;
+
+    // Whether reads of bindings that are never reassigned fold to the constant they were bound to. Only
+    // `semiCompilerCompileModule` honors it, as it needs the whole module source to find reassigned names up front.
+    bool enableConstantPropagation;
+    // Identifiers that appear as an assignment target anywhere in the module source, keyed by identifier id.
+    ObjectDict reassignedIdentifiers;
+    // The constants immutable module variables were bound to, keyed by identifier id.
+    ObjectDict moduleConstants;
+
+    // Whether calls to small top-level functions that are never reassigned are replaced by a copy of their body. Like
+    // `enableConstantPropagation`, it relies on `reassignedIdentifiers`.
+    bool enableInlining;
+    // The function protos of top-level functions that can be inlined, keyed by identifier id.
+    ObjectDict inlineCandidates;
+    // Whether invariant instructions in the body of a range or iterator loop are moved in front of the loop. It relies
+    // on `reassignedIdentifiers` to tell whether a call in the loop may assign a module variable.
+    bool enableLoopInvariantCodeMotion;
+
+    // Whether top-level functions that are unchanged since the last compilation of the target module reuse their proto
+    // instead of being compiled again. Only `semiCompilerCompileModule` honors it.
+    bool enableIncrementalCompilation;
+    // Whether the declaration cache of the target module was built against the same module-wide facts as this
+    // compilation, so that its entries can be reused.
+    bool canReuseDeclarations;
+    // Whether the body of a top-level function is being compiled, so that the facts it relies on are recorded.
+    bool isRecordingDependencies;
+    // The cache built by this compilation. It replaces the one of the target module once compilation succeeds.
+    DeclarationCache declarationCache;
+
     ErrorJmpBuf errorJmpBuf;
 } Compiler;
 
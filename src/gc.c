@@ -76,8 +76,13 @@ gray_begin:
         // These objects may contain references to other objects, so we need to gray them.
         case OBJECT_TYPE_RANGE:
         case OBJECT_TYPE_LIST:
+        case OBJECT_TYPE_DEQUE:
         case OBJECT_TYPE_DICT:
+        case OBJECT_TYPE_SET:
         case OBJECT_TYPE_FUNCTION:
+        case OBJECT_TYPE_STRUCT:
+        case OBJECT_TYPE_COLUMNAR_LIST:
+        case OBJECT_TYPE_STRUCT_VIEW:
             break;
 
         // Upvalue may reference another object.
@@ -159,16 +164,31 @@ void semiGCMarkAndSweep(GC* gc) {
 
             case OBJECT_TYPE_LIST: {
                 ObjectList* list = (ObjectList*)obj;
+                if (list->elementKind == LIST_ELEMENT_KIND_INT || list->elementKind == LIST_ELEMENT_KIND_FLOAT) {
+                    break;
+                }
                 for (uint32_t i = 0; i < list->size; i++) {
                     grayValue(gc, &list->values[i]);
                 }
                 break;
             }
-            case OBJECT_TYPE_DICT: {
+            case OBJECT_TYPE_DEQUE: {
+                ObjectDeque* deque = (ObjectDeque*)obj;
+                for (uint32_t i = 0; i < deque->size; i++) {
+                    grayValue(gc, semiDequeAt(deque, i));
+                }
+                break;
+            }
+            case OBJECT_TYPE_DICT:
+            case OBJECT_TYPE_SET: {
                 ObjectDict* dict = (ObjectDict*)obj;
-                for (uint32_t i = 0; i < dict->used; i++) {
-                    grayValue(gc, &dict->keys[i].key);
-                    grayValue(gc, &dict->values[i]);
+                uint32_t cursor  = 0;
+                TupleId tid;
+                while ((tid = semiDictNextTupleId(dict, &cursor)) >= 0) {
+                    grayValue(gc, &dict->keys[tid].key);
+                    if (!dict->keysOnly) {
+                        grayValue(gc, &dict->values[tid]);
+                    }
                 }
                 break;
             }
@@ -181,6 +201,31 @@ void semiGCMarkAndSweep(GC* gc) {
                 break;
             }
 
+            case OBJECT_TYPE_STRUCT: {
+                ObjectStruct* object = (ObjectStruct*)obj;
+                for (uint16_t i = 0; i < object->fieldCount; i++) {
+                    grayValue(gc, &object->fields[i]);
+                }
+                break;
+            }
+            case OBJECT_TYPE_COLUMNAR_LIST: {
+                ObjectColumnarList* list = (ObjectColumnarList*)obj;
+                for (uint16_t i = 0; i < list->columnCount; i++) {
+                    ListColumn* column = &list->columns[i];
+                    if (column->kind != LIST_ELEMENT_KIND_MIXED) {
+                        continue;
+                    }
+                    for (uint32_t j = 0; j < list->size; j++) {
+                        grayValue(gc, &column->as.values[j]);
+                    }
+                }
+                break;
+            }
+            case OBJECT_TYPE_STRUCT_VIEW: {
+                semiGCGrayObject(gc, (Object*)((ObjectStructView*)obj)->list);
+                break;
+            }
+
             case OBJECT_TYPE_UPVALUE: {
                 ObjectUpvalue* upvalue = (ObjectUpvalue*)obj;
                 obj                    = AS_OBJECT(upvalue->value);
@@ -212,6 +257,168 @@ void semiGCMarkAndSweep(GC* gc) {
     }
 }
 
+// The state of `semiGCVisitFunctionProtos`. Objects are queued through `grayNext`, which is only used while marking,
+// and the ones already queued are kept in `queued` by address so that the GC bits are left untouched.
+typedef struct ProtoVisit {
+    GC* gc;
+    ObjectDict queued;
+    Object* pending;
+    const Object* skipped;
+    GCFunctionProtoVisitor visit;
+    void* userData;
+    bool failed;
+} ProtoVisit;
+
+static void queueObject(ProtoVisit* visit, Object* obj) {
+    if (obj == NULL || obj == visit->skipped) {
+        return;
+    }
+    Value key = semiValueIntCreate((int64_t)(uintptr_t)obj);
+    if (semiDictHas(&visit->queued, key)) {
+        return;
+    }
+    if (!semiDictSet(visit->gc, &visit->queued, key, key)) {
+        visit->failed = true;
+        return;
+    }
+    obj->grayNext  = visit->pending;
+    visit->pending = obj;
+}
+
+static void visitValue(ProtoVisit* visit, const Value* value) {
+    if (IS_FUNCTION_PROTO(value)) {
+        visit->visit(AS_FUNCTION_PROTO(value), visit->userData);
+    } else if (IS_OBJECT(value)) {
+        queueObject(visit, AS_OBJECT(value));
+    }
+}
+
+static void visitDict(ProtoVisit* visit, ObjectDict* dict) {
+    uint32_t cursor = 0;
+    TupleId tid;
+    while ((tid = semiDictNextTupleId(dict, &cursor)) >= 0) {
+        visitValue(visit, &dict->keys[tid].key);
+        if (!dict->keysOnly) {
+            visitValue(visit, &dict->values[tid]);
+        }
+    }
+}
+
+static void visitFunction(ProtoVisit* visit, ObjectFunction* function) {
+    visit->visit(function->proto, visit->userData);
+    for (uint8_t i = 0; i < function->upvalueCount; i++) {
+        queueObject(visit, (Object*)function->upvalues[i]);
+    }
+    queueObject(visit, (Object*)function->prevDeferredFn);
+}
+
+static void visitObject(ProtoVisit* visit, Object* obj) {
+    switch (OBJECT_TYPE(obj)) {
+        case OBJECT_TYPE_STRING:
+        case OBJECT_TYPE_RANGE:
+            break;
+
+        case OBJECT_TYPE_LIST: {
+            ObjectList* list = (ObjectList*)obj;
+            if (list->elementKind == LIST_ELEMENT_KIND_INT || list->elementKind == LIST_ELEMENT_KIND_FLOAT) {
+                break;
+            }
+            for (uint32_t i = 0; i < list->size; i++) {
+                visitValue(visit, &list->values[i]);
+            }
+            break;
+        }
+        case OBJECT_TYPE_DEQUE: {
+            ObjectDeque* deque = (ObjectDeque*)obj;
+            for (uint32_t i = 0; i < deque->size; i++) {
+                visitValue(visit, semiDequeAt(deque, i));
+            }
+            break;
+        }
+        case OBJECT_TYPE_DICT:
+        case OBJECT_TYPE_SET:
+            visitDict(visit, (ObjectDict*)obj);
+            break;
+
+        case OBJECT_TYPE_FUNCTION:
+            visitFunction(visit, (ObjectFunction*)obj);
+            break;
+
+        case OBJECT_TYPE_STRUCT: {
+            ObjectStruct* object = (ObjectStruct*)obj;
+            for (uint16_t i = 0; i < object->fieldCount; i++) {
+                visitValue(visit, &object->fields[i]);
+            }
+            break;
+        }
+        case OBJECT_TYPE_COLUMNAR_LIST: {
+            ObjectColumnarList* list = (ObjectColumnarList*)obj;
+            for (uint16_t i = 0; i < list->columnCount; i++) {
+                ListColumn* column = &list->columns[i];
+                if (column->kind != LIST_ELEMENT_KIND_MIXED) {
+                    continue;
+                }
+                for (uint32_t j = 0; j < list->size; j++) {
+                    visitValue(visit, &column->as.values[j]);
+                }
+            }
+            break;
+        }
+        case OBJECT_TYPE_STRUCT_VIEW:
+            queueObject(visit, (Object*)((ObjectStructView*)obj)->list);
+            break;
+
+        case OBJECT_TYPE_UPVALUE:
+            visitValue(visit, ((ObjectUpvalue*)obj)->value);
+            break;
+
+        default:
+            SEMI_UNREACHABLE();
+            break;
+    }
+}
+
+bool semiGCVisitFunctionProtos(GC* gc, const SemiModule* skippedModule, GCFunctionProtoVisitor visit, void* userData) {
+    // GC must be the first field of SemiVM
+    SemiVM* vm = (SemiVM*)gc;
+
+    ProtoVisit state = {
+        .gc       = gc,
+        .pending  = NULL,
+        .skipped  = skippedModule != NULL ? (const Object*)skippedModule->constantTable.constantMap : NULL,
+        .visit    = visit,
+        .userData = userData,
+        .failed   = false,
+    };
+    semiObjectStackDictInit(&state.queued);
+
+    // The frames are left behind by a run that fails, so they are not walked. The function of a frame is in a register
+    // of its caller, except for the module initializer, and its deferred functions are constants of its prototype.
+    for (uint32_t i = 0; i < vm->valueCount; i++) {
+        visitValue(&state, &vm->values[i]);
+    }
+    for (uint16_t i = 0; i < vm->modules.len; i++) {
+        SemiModule* module = AS_PTR(&vm->modules.values[i], SemiModule);
+        visitDict(&state, &module->exports);
+        visitDict(&state, &module->globals);
+        queueObject(&state, (Object*)module->constantTable.constantMap);
+    }
+    if (vm->globalConstants != NULL) {
+        for (uint16_t i = 0; i < vm->globalIdentifiers.size; i++) {
+            visitValue(&state, &vm->globalConstants[i]);
+        }
+    }
+
+    while (state.pending != NULL && !state.failed) {
+        Object* obj   = state.pending;
+        state.pending = obj->grayNext;
+        visitObject(&state, obj);
+    }
+
+    semiObjectStackDictCleanup(gc, &state.queued);
+    return !state.failed;
+}
+
 void semiGCFreeObject(GC* gc, Object* obj) {
     switch (OBJECT_TYPE(obj)) {
         case OBJECT_TYPE_STRING: {
@@ -227,11 +434,21 @@ void semiGCFreeObject(GC* gc, Object* obj) {
             break;
         }
 
+        case OBJECT_TYPE_DEQUE: {
+            semiObjectDequeDestroy(gc, (ObjectDeque*)obj);
+            break;
+        }
+
         case OBJECT_TYPE_DICT: {
             semiObjectDictDestroy(gc, (ObjectDict*)obj);
             break;
         }
 
+        case OBJECT_TYPE_SET: {
+            semiObjectSetDestroy(gc, (ObjectSet*)obj);
+            break;
+        }
+
         case OBJECT_TYPE_UPVALUE: {
             semiObjectUpvalueDestroy(gc, (ObjectUpvalue*)obj);
             break;
@@ -242,6 +459,21 @@ void semiGCFreeObject(GC* gc, Object* obj) {
             break;
         }
 
+        case OBJECT_TYPE_STRUCT: {
+            semiObjectStructDestroy(gc, (ObjectStruct*)obj);
+            break;
+        }
+
+        case OBJECT_TYPE_COLUMNAR_LIST: {
+            semiObjectColumnarListDestroy(gc, (ObjectColumnarList*)obj);
+            break;
+        }
+
+        case OBJECT_TYPE_STRUCT_VIEW: {
+            semiObjectStructViewDestroy(gc, (ObjectStructView*)obj);
+            break;
+        }
+
         default:
             SEMI_UNREACHABLE();
             break;
@@ -12,9 +12,14 @@ typedef enum {
     OBJECT_TYPE_STRING,
     OBJECT_TYPE_RANGE,
     OBJECT_TYPE_LIST,
+    OBJECT_TYPE_DEQUE,
     OBJECT_TYPE_DICT,
+    OBJECT_TYPE_SET,
     OBJECT_TYPE_UPVALUE,
     OBJECT_TYPE_FUNCTION,
+    OBJECT_TYPE_STRUCT,
+    OBJECT_TYPE_COLUMNAR_LIST,
+    OBJECT_TYPE_STRUCT_VIEW,
 } ObjectType;
 
 // In order to save space, we encode the gc state `isReachable` - whether the object is accessible
@@ -66,6 +71,12 @@ static inline void semiGCAttachObject(GC* gc, Object* obj) {
 }
 
 void semiGCMarkAndSweep(GC* gc);
+
+// Call `visit` with every function prototype reachable from the GC roots, except through the constants of
+// `skippedModule`. Returns false if the walk ran out of memory, in which case some prototypes may not be visited.
+struct FunctionProto;
+typedef void (*GCFunctionProtoVisitor)(struct FunctionProto* function, void* userData);
+bool semiGCVisitFunctionProtos(GC* gc, const SemiModule* skippedModule, GCFunctionProtoVisitor visit, void* userData);
 void semiGCFreeObject(GC* gc, struct Object* object);
 
 #endif /* SEMI_GC_H */
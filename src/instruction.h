@@ -149,12 +149,16 @@ typedef uint32_t Instruction;
 //                            integer value X.
 //   * range(from, to, step): Create a range object with start, end, and step.
 //   * inline_range(K):       Create an inline range object with start=(K>>8), end=(K&(2^8-1)), step=1.
+//   * attr(X, k):            If k is true, the field cached by the inline cache X of the function, otherwise the
+//                            field whose identifier id is the value of register X.
 typedef enum {
     // clang-format off
     OP_NOOP = 0,                // |       |  no operation
     
     OP_JUMP,                    // |   J   |  if J != 0, pc += (s ? J : -J)
-    OP_EXTRA_ARG,               // |   J   |  reset extraarg to 0 if s, then extraarg = (extraarg << 24) + J
+    OP_EXTRA_ARG,               // |   J   |  K of the next instruction := (J << 16) + K
+                                //            Only for C_JUMP, LOAD_CONSTANT, GET/SET_MODULE_VAR, DEFER_CALL,
+                                //            ITER_NEXT and RANGE_NEXT. Their jumps are relative to themselves.
     
     OP_TRAP,                    // |   K   |  trap and exit with K
     OP_C_JUMP,                  // |   K   |  if to_bool(R[A]) == i and K != 0, pc += (s ? K : -K)
@@ -169,9 +173,9 @@ typedef enum {
                                 //            Mod is the module of the current frame
     OP_DEFER_CALL,              // |   K   |  push Mod.constants[K] to the defer stack
                                 //            Mod is the module of the current frame
-    OP_ITER_NEXT,               // |   K   |  R[A](R[A+1], R[A+2], R[A+3]) (set the next value to R[A+3])
-                                //            If R[A+3] != nil, update counter R[A+4] if i is true.
-                                //            If R[A+3] == nil, set pc += K
+    OP_ITER_NEXT,               // |   K   |  R[A+3] := TYPE(R[A]).__next__(R[A], &R[A+1])
+                                //            If exhausted, pc += K.
+                                //            Otherwise, if i is true, (R[A+4], R[A+2]) := (R[A+2], R[A+2] + 1)
     OP_RANGE_NEXT,              // |   K   |  range R[A] can proceed ? R[A+1] := next value : pc += K
                                 //            If i is true, (R[A+2], R[A+3]) := (next value, counter) if it can proceed.
 
@@ -198,14 +202,13 @@ typedef enum {
     OP_BITWISE_R_SHIFT,         // |   T   |  R[A] := RK(B, kb) >> RK(C, kc)
     OP_BITWISE_INVERT,          // |   T   |  R[A] := ~R[B]
     OP_MAKE_RANGE,              // |   T   |  R[A] := make_range(R[A], RK(B, kb), RK(C, kc))
-    OP_ITER_PREPARE,            // |   T   |  TYPE(R[A]).__iter__(&R[A], &R[A+1], &R[A+2]), which has the effect of:
-                                //            R[A], R[A+1], R[A+2] := next function, invariant data, iter state
+    OP_ITER_PREPARE,            // |   T   |  R[A+1], R[A+2] := TYPE(R[A]).__iter__(R[A]), 0
+                                //            R[A+1] is the cursor and R[A+2] is the counter of the index variable
     OP_BOOL_NOT,                // |   T   |  R[A] := !R[B]
-    OP_GET_ATTR,                // |   T   |  R[A] := GET_ATTR(R[B], uRK(C, kc), kb)
-                                //            GET_ATTR(object, index, type_index_or_symbol_index)
-    OP_SET_ATTR,                // |   T   |  SET_ATTR(R[A], uRK(B, kb), kc, R[C])
-                                //            SET_ATTR(object, index, type_index_or_symbol_index, value)
+    OP_GET_ATTR,                // |   T   |  R[A] := R[B].attr(C, kc)
+    OP_SET_ATTR,                // |   T   |  R[A].attr(B, kb) := R[C]
     OP_NEW_COLLECTION,          // |   T   |  R[A] := new collection of type uRK(B, kb) with initial capacity C
+                                //            For a struct type, kc selects a columnar list over an instance
     OP_GET_ITEM,                // |   T   |  R[A] := R[B][RK(C, kc)]
     OP_SET_ITEM,                // |   T   |  R[A][RK(B, kb)] = R[C]
     OP_DEL_ITEM,                // |   T   |  R[A] = delete R[B][RK(C, kc)]
@@ -95,7 +95,7 @@
 ─┴───────────────────────────────────────────────────────────────────────────────────────────────*/
 
 #define COLLECTION_X_MACRO(MACRO, ...)                                                     \
-    /* ret = iter(iterable)  */                                                            \
+    /* ret = iter(iterable), the initial cursor passed to next */                          \
     MACRO(iter, (GC * gc, Value * ret, Value * iterable), __VA_ARGS__)                     \
     /* ret = item in collection */                                                         \
     MACRO(contain, (GC * gc, Value * ret, Value * item, Value * collection), __VA_ARGS__)  \
@@ -112,6 +112,8 @@
     /* extend(collection, iterable) */                                                     \
     MACRO(extend, (GC * gc, Value * collection, Value * iterable), __VA_ARGS__)            \
     /* ret = pop(collection) */                                                            \
-    MACRO(pop, (GC * gc, Value * ret, Value * collection), __VA_ARGS__)
+    MACRO(pop, (GC * gc, Value * ret, Value * collection), __VA_ARGS__)                    \
+    /* ret = next(iterable, &cursor); ret is invalid when exhausted */                     \
+    MACRO(next, (GC * gc, Value * ret, Value * iterable, Value * cursor), __VA_ARGS__)
 
 #endif /* SEMI_PRIMITIVE_X_MACRO_H */
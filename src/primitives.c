@@ -79,6 +79,12 @@ CONVERSION_X_MACRO(GENERATE_SIG_FOR_TYPE_MACRO, STRING)
 
 COLLECTION_X_MACRO(GENERATE_SIG_FOR_TYPE_MACRO, LIST)
 
+/*
+ │ Deque
+─┴───────────────────────────────────────────────────────────────────────────────────────────────*/
+
+COLLECTION_X_MACRO(GENERATE_SIG_FOR_TYPE_MACRO, DEQUE)
+
 /*
  │ Dictionary
 ─┴───────────────────────────────────────────────────────────────────────────────────────────────*/
@@ -349,10 +355,11 @@ static ErrorId MAGIC_METHOD_SIGNATURE_NAME(INVALID, pop)(GC* gc, Value* ret, Val
     return SEMI_ERROR_UNEXPECTED_TYPE;
 }
 
-static ErrorId MAGIC_METHOD_SIGNATURE_NAME(INVALID, next)(GC* gc, Value* ret, Value* iterator) {
+static ErrorId MAGIC_METHOD_SIGNATURE_NAME(INVALID, next)(GC* gc, Value* ret, Value* iterable, Value* cursor) {
     (void)gc;
     (void)ret;
-    (void)iterator;
+    (void)iterable;
+    (void)cursor;
     return SEMI_ERROR_UNEXPECTED_TYPE;
 }
 
@@ -827,6 +834,9 @@ static ErrorId MAGIC_METHOD_SIGNATURE_NAME(STRING, hash)(GC* gc, ValueHash* ret,
 
 static ErrorId MAGIC_METHOD_SIGNATURE_NAME(STRING, add)(GC* gc, Value* ret, Value* left, Value* right) {
     // TODO: We can define string as a list of ObjectString* to avoid copying on concatenation.
+    if (!IS_STRING(left) || !IS_STRING(right)) {
+        return SEMI_ERROR_UNEXPECTED_TYPE;
+    }
 
     uint32_t leftSize, rightSize;
     const char *leftStr, *rightStr;
@@ -835,28 +845,39 @@ static ErrorId MAGIC_METHOD_SIGNATURE_NAME(STRING, add)(GC* gc, Value* ret, Valu
         leftSize = AS_INLINE_STRING(left).length;
         leftStr  = AS_INLINE_STRING(left).c;
     } else {
-        leftSize = (uint32_t)AS_OBJECT_STRING(right)->length;
-        leftStr  = AS_OBJECT_STRING(right)->str;
+        leftSize = (uint32_t)AS_OBJECT_STRING(left)->length;
+        leftStr  = AS_OBJECT_STRING(left)->str;
     }
 
     if (IS_INLINE_STRING(right)) {
-        rightSize += AS_INLINE_STRING(right).length;
-        rightStr = AS_INLINE_STRING(right).c;
-    } else if (IS_OBJECT_STRING(right)) {
-        rightSize += (uint32_t)AS_OBJECT_STRING(right)->length;
-        rightStr = AS_OBJECT_STRING(right)->str;
+        rightSize = AS_INLINE_STRING(right).length;
+        rightStr  = AS_INLINE_STRING(right).c;
     } else {
-        return SEMI_ERROR_UNEXPECTED_TYPE;
+        rightSize = (uint32_t)AS_OBJECT_STRING(right)->length;
+        rightStr  = AS_OBJECT_STRING(right)->str;
     }
 
     if (UINT32_MAX - leftSize < rightSize) {
         return SEMI_ERROR_STRING_TOO_LONG;
     }
 
+    char buffer[2];
+    if (leftSize + rightSize <= sizeof(buffer)) {
+        // Keep short results inline so that they compare and hash like literals of the same content.
+        memcpy(buffer, leftStr, leftSize);
+        memcpy(buffer + leftSize, rightStr, rightSize);
+        *ret = semiValueStringCreate(gc, buffer, leftSize + rightSize);
+        return IS_INVALID(ret) ? SEMI_ERROR_MEMORY_ALLOCATION_FAILURE : 0;
+    }
+
     ObjectString* retStr = semiObjectStringCreateUninit(gc, leftSize + rightSize);
+    if (retStr == NULL) {
+        return SEMI_ERROR_MEMORY_ALLOCATION_FAILURE;
+    }
     memcpy((void*)retStr->str, leftStr, leftSize);
     memcpy((void*)(retStr->str + leftSize), rightStr, rightSize);
-    *ret = (Value){.header = VALUE_TYPE_OBJECT_STRING, .as = {.obj = (Object*)retStr}};
+    retStr->hash = semiHashString(retStr->str, leftSize + rightSize);
+    *ret         = (Value){.header = VALUE_TYPE_OBJECT_STRING, .as = {.obj = (Object*)retStr}};
 
     return 0;
 }
@@ -1123,6 +1144,38 @@ static ErrorId MAGIC_METHOD_SIGNATURE_NAME(STRING, len)(GC* gc, Value* ret, Valu
     return 0;
 }
 
+static ErrorId MAGIC_METHOD_SIGNATURE_NAME(STRING, iter)(GC* gc, Value* ret, Value* iterable) {
+    (void)gc;
+    if (!IS_STRING(iterable)) {
+        return SEMI_ERROR_UNEXPECTED_TYPE;
+    }
+    *ret = semiValueIntCreate(0);
+    return 0;
+}
+
+static ErrorId MAGIC_METHOD_SIGNATURE_NAME(STRING, next)(GC* gc, Value* ret, Value* iterable, Value* cursor) {
+    (void)gc;
+    IntValue pos = AS_INT(cursor);
+    uint32_t size;
+    const char* str;
+
+    if (IS_INLINE_STRING(iterable)) {
+        size = AS_INLINE_STRING(iterable).length;
+        str  = AS_INLINE_STRING(iterable).c;
+    } else {
+        size = (uint32_t)AS_OBJECT_STRING(iterable)->length;
+        str  = AS_OBJECT_STRING(iterable)->str;
+    }
+
+    if (pos >= (IntValue)size) {
+        *ret = INVALID_VALUE;
+        return 0;
+    }
+    *ret         = semiValueInlineStringCreat1(str[pos]);
+    cursor->as.i = pos + 1;
+    return 0;
+}
+
 static ErrorId MAGIC_METHOD_SIGNATURE_NAME(STRING, getItem)(GC* gc, Value* ret, Value* collection, Value* key) {
     (void)gc;
 
@@ -1211,6 +1264,88 @@ static ErrorId MAGIC_METHOD_SIGNATURE_NAME(RANGE, neq)(GC* gc, Value* ret, Value
 ─┴───────────────────────────────────────────────────────────────────────────────────────────────*/
 #pragma region
 
+// Columnar lists share the magic methods of lists, and each method branches on the variant. Indexing and iterating
+// a columnar list yield struct views of its rows, while slicing copies the rows into a new columnar list.
+
+static inline ErrorId columnarListRow(ObjectColumnarList* list, Value* key, uint32_t* row) {
+    if (!IS_INT(key)) {
+        return SEMI_ERROR_UNEXPECTED_TYPE;
+    }
+
+    IntValue index = AS_INT(key);
+    if (index < 0) {
+        index += list->size;
+    }
+    if (index < 0 || (uint32_t)index >= list->size) {
+        return SEMI_ERROR_INDEX_OOB;
+    }
+    *row = (uint32_t)index;
+    return 0;
+}
+
+static ErrorId columnarListView(GC* gc, Value* ret, ObjectColumnarList* list, uint32_t row) {
+    *ret = semiValueStructViewCreate(gc, list, row);
+    return IS_VALID(ret) ? 0 : SEMI_ERROR_MEMORY_ALLOCATION_FAILURE;
+}
+
+static ErrorId columnarListTake(GC* gc, Value* ret, ObjectColumnarList* list, uint32_t row) {
+    *ret = semiColumnarListMaterialize(gc, list, row);
+    if (IS_INVALID(ret)) {
+        return SEMI_ERROR_MEMORY_ALLOCATION_FAILURE;
+    }
+    semiColumnarListRemove(gc, list, row);
+    return 0;
+}
+
+static ErrorId columnarListExtend(GC* gc, ObjectColumnarList* list, Value* iterable) {
+    if (IS_LIST(iterable)) {
+        ObjectList* listIter = AS_LIST(iterable);
+        for (uint32_t i = 0; i < listIter->size; i++) {
+            ErrorId errorId = semiColumnarListAppend(gc, list, &listIter->values[i]);
+            if (errorId != 0) {
+                return errorId;
+            }
+        }
+        return 0;
+    }
+    if (IS_COLUMNAR_LIST(iterable)) {
+        ObjectColumnarList* listIter = AS_COLUMNAR_LIST(iterable);
+        uint32_t size                = listIter->size;
+        ObjectStructView view        = {.list = listIter, .row = 0};
+        Value item                   = OBJECT_VALUE(&view, STRUCT_VIEW_VALUE_TYPE(listIter->typeId));
+        for (; view.row < size; view.row++) {
+            ErrorId errorId = semiColumnarListAppend(gc, list, &item);
+            if (errorId != 0) {
+                return errorId;
+            }
+        }
+        return 0;
+    }
+    if (IS_DEQUE(iterable)) {
+        ObjectDeque* deque = AS_DEQUE(iterable);
+        for (uint32_t i = 0; i < deque->size; i++) {
+            ErrorId errorId = semiColumnarListAppend(gc, list, semiDequeAt(deque, i));
+            if (errorId != 0) {
+                return errorId;
+            }
+        }
+        return 0;
+    }
+    if (IS_DICT(iterable) || IS_SET(iterable)) {
+        ObjectDict* dictIter = AS_DICT(iterable);
+        uint32_t cursor      = 0;
+        TupleId tid;
+        while ((tid = semiDictNextTupleId(dictIter, &cursor)) >= 0) {
+            ErrorId errorId = semiColumnarListAppend(gc, list, &dictIter->keys[tid].key);
+            if (errorId != 0) {
+                return errorId;
+            }
+        }
+        return 0;
+    }
+    return SEMI_ERROR_UNIMPLEMENTED_FEATURE;
+}
+
 static ErrorId MAGIC_METHOD_SIGNATURE_NAME(LIST,
                                            collectionInit)(GC* gc, Value* ret, Value* objectClass, Value* minCapacity) {
     (void)objectClass;
@@ -1221,12 +1356,40 @@ static ErrorId MAGIC_METHOD_SIGNATURE_NAME(LIST,
 
 static ErrorId MAGIC_METHOD_SIGNATURE_NAME(LIST, iter)(GC* gc, Value* ret, Value* iterable) {
     (void)gc;
-    (void)ret;
     (void)iterable;
-    return SEMI_ERROR_UNIMPLEMENTED_FEATURE;
+    *ret = semiValueIntCreate(0);
+    return 0;
+}
+
+static ErrorId MAGIC_METHOD_SIGNATURE_NAME(LIST, next)(GC* gc, Value* ret, Value* iterable, Value* cursor) {
+    IntValue pos = AS_INT(cursor);
+    if (IS_COLUMNAR_LIST(iterable)) {
+        ObjectColumnarList* list = AS_COLUMNAR_LIST(iterable);
+        if (pos >= (IntValue)list->size) {
+            *ret = INVALID_VALUE;
+            return 0;
+        }
+        cursor->as.i = pos + 1;
+        return columnarListView(gc, ret, list, (uint32_t)pos);
+    }
+
+    ObjectList* list = AS_LIST(iterable);
+
+    if (pos >= (IntValue)list->size) {
+        *ret = INVALID_VALUE;
+        return 0;
+    }
+    *ret         = list->values[pos];
+    cursor->as.i = pos + 1;
+    return 0;
 }
 
 static ErrorId MAGIC_METHOD_SIGNATURE_NAME(LIST, contain)(GC* gc, Value* ret, Value* item, Value* collection) {
+    if (IS_COLUMNAR_LIST(collection)) {
+        *ret = semiValueBoolCreate(semiColumnarListIndex(AS_COLUMNAR_LIST(collection), item) >= 0);
+        return 0;
+    }
+
     ObjectList* list = AS_LIST(collection);
     *ret             = semiValueBoolCreate(semiListHas(gc, list, *item));
     return 0;
@@ -1234,15 +1397,97 @@ static ErrorId MAGIC_METHOD_SIGNATURE_NAME(LIST, contain)(GC* gc, Value* ret, Va
 
 static ErrorId MAGIC_METHOD_SIGNATURE_NAME(LIST, len)(GC* gc, Value* ret, Value* collection) {
     (void)gc;
+    if (IS_COLUMNAR_LIST(collection)) {
+        *ret = semiValueIntCreate((IntValue)AS_COLUMNAR_LIST(collection)->size);
+        return 0;
+    }
+
     ObjectList* list = AS_LIST(collection);
     *ret             = semiValueIntCreate((IntValue)semiListLen(list));
     return 0;
 }
 
+static inline IntValue clampSliceIndex(IntValue index, uint32_t size) {
+    if (index < 0) {
+        index += size;
+    }
+    return index < 0 ? 0 : (index > (IntValue)size ? (IntValue)size : index);
+}
+
+static ErrorId columnarListGetSlice(
+    GC* gc, Value* ret, ObjectColumnarList* list, IntValue start, IntValue end, IntValue step) {
+    if (step <= 0) {
+        return SEMI_ERROR_INVALID_VALUE;
+    }
+
+    start = clampSliceIndex(start, list->size);
+    end   = clampSliceIndex(end, list->size);
+    ObjectColumnarList* slice =
+        semiColumnarListSlice(gc, list, (uint32_t)start, (uint32_t)(end < start ? start : end), (uint32_t)step);
+    if (slice == NULL) {
+        return SEMI_ERROR_MEMORY_ALLOCATION_FAILURE;
+    }
+
+    *ret = OBJECT_VALUE(slice, VALUE_TYPE_COLUMNAR_LIST);
+    return 0;
+}
+
+static ErrorId listGetSlice(GC* gc, Value* ret, ObjectList* list, IntValue start, IntValue end, IntValue step) {
+    if (step <= 0) {
+        return SEMI_ERROR_INVALID_VALUE;
+    }
+
+    start = clampSliceIndex(start, list->size);
+    end   = clampSliceIndex(end, list->size);
+    if (end < start) {
+        end = start;
+    }
+
+    ObjectList* slice;
+    if (step == 1) {
+        slice = semiListSlice(gc, list, (uint32_t)start, (uint32_t)end);
+    } else {
+        slice = semiObjectListCreate(gc, (uint32_t)((end - start + step - 1) / step));
+        if (slice != NULL) {
+            for (IntValue i = start; i < end; i += step) {
+                slice->values[slice->size++] = list->values[i];
+            }
+            semiListRefreshElementKind(slice, 0);
+        }
+    }
+    if (slice == NULL) {
+        return SEMI_ERROR_MEMORY_ALLOCATION_FAILURE;
+    }
+
+    *ret = OBJECT_VALUE(slice, VALUE_TYPE_LIST);
+    return 0;
+}
+
 static ErrorId MAGIC_METHOD_SIGNATURE_NAME(LIST, getItem)(GC* gc, Value* ret, Value* collection, Value* key) {
-    (void)gc;
+    if (IS_COLUMNAR_LIST(collection)) {
+        ObjectColumnarList* list = AS_COLUMNAR_LIST(collection);
+        if (IS_INLINE_RANGE(key)) {
+            return columnarListGetSlice(gc, ret, list, AS_INLINE_RANGE(key).start, AS_INLINE_RANGE(key).end, 1);
+        }
+        if (IS_OBJECT_INT_RANGE(key)) {
+            ObjectRange* range = AS_OBJECT_RANGE(key);
+            return columnarListGetSlice(gc, ret, list, range->as.ir.start, range->as.ir.end, range->as.ir.step);
+        }
+
+        uint32_t row;
+        ErrorId errorId = columnarListRow(list, key, &row);
+        return errorId != 0 ? errorId : columnarListView(gc, ret, list, row);
+    }
+
     ObjectList* list = AS_LIST(collection);
 
+    if (IS_INLINE_RANGE(key)) {
+        return listGetSlice(gc, ret, list, AS_INLINE_RANGE(key).start, AS_INLINE_RANGE(key).end, 1);
+    }
+    if (IS_OBJECT_INT_RANGE(key)) {
+        ObjectRange* range = AS_OBJECT_RANGE(key);
+        return listGetSlice(gc, ret, list, range->as.ir.start, range->as.ir.end, range->as.ir.step);
+    }
     if (!IS_INT(key)) {
         return SEMI_ERROR_UNEXPECTED_TYPE;
     }
@@ -1260,7 +1505,13 @@ static ErrorId MAGIC_METHOD_SIGNATURE_NAME(LIST, getItem)(GC* gc, Value* ret, Va
 }
 
 static ErrorId MAGIC_METHOD_SIGNATURE_NAME(LIST, setItem)(GC* gc, Value* collection, Value* key, Value* value) {
-    (void)gc;
+    if (IS_COLUMNAR_LIST(collection)) {
+        ObjectColumnarList* list = AS_COLUMNAR_LIST(collection);
+        uint32_t row;
+        ErrorId errorId = columnarListRow(list, key, &row);
+        return errorId != 0 ? errorId : semiColumnarListSetRow(gc, list, row, value);
+    }
+
     ObjectList* list = AS_LIST(collection);
 
     if (!IS_INT(key)) {
@@ -1275,12 +1526,20 @@ static ErrorId MAGIC_METHOD_SIGNATURE_NAME(LIST, setItem)(GC* gc, Value* collect
         return SEMI_ERROR_INDEX_OOB;
     }
 
+    semiListEnsureUnique(gc, list);
+    semiListMergeElementKind(list, value);
     list->values[index] = *value;
     return 0;
 }
 
 static ErrorId MAGIC_METHOD_SIGNATURE_NAME(LIST, delItem)(GC* gc, Value* ret, Value* collection, Value* key) {
-    (void)gc;
+    if (IS_COLUMNAR_LIST(collection)) {
+        ObjectColumnarList* list = AS_COLUMNAR_LIST(collection);
+        uint32_t row;
+        ErrorId errorId = columnarListRow(list, key, &row);
+        return errorId != 0 ? errorId : columnarListTake(gc, ret, list, row);
+    }
+
     ObjectList* list = AS_LIST(collection);
 
     if (!IS_INT(key)) {
@@ -1297,44 +1556,76 @@ static ErrorId MAGIC_METHOD_SIGNATURE_NAME(LIST, delItem)(GC* gc, Value* ret, Va
 
     *ret = list->values[index];
 
+    semiListEnsureUnique(gc, list);
     if ((uint32_t)index < list->size - 1) {
         memcpy(&list->values[index], &list->values[index + 1], (list->size - (uint32_t)index - 1) * sizeof(Value));
     }
     list->size--;
+    if (list->size == 0) {
+        list->elementKind = LIST_ELEMENT_KIND_EMPTY;
+    }
 
     return 0;
 }
 
 static ErrorId MAGIC_METHOD_SIGNATURE_NAME(LIST, append)(GC* gc, Value* collection, Value* item) {
+    if (IS_COLUMNAR_LIST(collection)) {
+        return semiColumnarListAppend(gc, AS_COLUMNAR_LIST(collection), item);
+    }
+
     ObjectList* list = AS_LIST(collection);
     semiListAppend(gc, list, *item);
     return 0;
 }
 
 static ErrorId MAGIC_METHOD_SIGNATURE_NAME(LIST, extend)(GC* gc, Value* collection, Value* iterable) {
+    if (IS_COLUMNAR_LIST(collection)) {
+        return columnarListExtend(gc, AS_COLUMNAR_LIST(collection), iterable);
+    }
+
     ObjectList* list = AS_LIST(collection);
+    uint32_t oldSize = list->size;
     if (IS_LIST(iterable)) {
         ObjectList* listIter = AS_LIST(iterable);
         semiListEnsureCapacity(gc, list, list->size + listIter->size);
         memcpy(&list->values[list->size], &listIter->values[0], listIter->size * sizeof(Value));
         list->size += listIter->size;
 
-    } else if (IS_DICT(iterable)) {
+    } else if (IS_COLUMNAR_LIST(iterable)) {
+        ObjectColumnarList* listIter = AS_COLUMNAR_LIST(iterable);
+        semiListEnsureCapacity(gc, list, list->size + listIter->size);
+        for (uint32_t i = 0; i < listIter->size; i++) {
+            Value item = semiColumnarListMaterialize(gc, listIter, i);
+            if (IS_INVALID(&item)) {
+                semiListRefreshElementKind(list, oldSize);
+                return SEMI_ERROR_MEMORY_ALLOCATION_FAILURE;
+            }
+            list->values[list->size++] = item;
+        }
+
+    } else if (IS_DICT(iterable) || IS_SET(iterable)) {
         ObjectDict* dictIter = AS_DICT(iterable);
         semiListEnsureCapacity(gc, list, list->size + dictIter->len);
-        for (uint32_t i; i < dictIter->len; i++) {
-            list->values[i + list->size] = dictIter->keys[i].key;
+        uint32_t cursor = 0;
+        TupleId tid;
+        while ((tid = semiDictNextTupleId(dictIter, &cursor)) >= 0) {
+            list->values[list->size++] = dictIter->keys[tid].key;
         }
-        list->size += dictIter->len;
 
     } else {
         return SEMI_ERROR_UNIMPLEMENTED_FEATURE;
     }
 
+    semiListRefreshElementKind(list, oldSize);
     return 0;
 }
 
 static ErrorId MAGIC_METHOD_SIGNATURE_NAME(LIST, pop)(GC* gc, Value* ret, Value* collection) {
+    if (IS_COLUMNAR_LIST(collection)) {
+        ObjectColumnarList* list = AS_COLUMNAR_LIST(collection);
+        return list->size == 0 ? SEMI_ERROR_INDEX_OOB : columnarListTake(gc, ret, list, list->size - 1);
+    }
+
     ObjectList* list = AS_LIST(collection);
 
     if (list->size == 0) {
@@ -1348,6 +1639,148 @@ static ErrorId MAGIC_METHOD_SIGNATURE_NAME(LIST, pop)(GC* gc, Value* ret, Value*
 
 #pragma endregion
 
+/*
+ │ Deque
+─┴───────────────────────────────────────────────────────────────────────────────────────────────*/
+#pragma region
+
+static inline ErrorId dequeIndex(ObjectDeque* deque, Value* key, uint32_t* index) {
+    if (!IS_INT(key)) {
+        return SEMI_ERROR_UNEXPECTED_TYPE;
+    }
+
+    IntValue i = AS_INT(key);
+    if (i < 0) {
+        i += deque->size;
+    }
+    if (i < 0 || (uint32_t)i >= deque->size) {
+        return SEMI_ERROR_INDEX_OOB;
+    }
+    *index = (uint32_t)i;
+    return 0;
+}
+
+static ErrorId MAGIC_METHOD_SIGNATURE_NAME(DEQUE,
+                                           collectionInit)(GC* gc, Value* ret, Value* objectClass, Value* minCapacity) {
+    (void)objectClass;
+
+    *ret = semiValueDequeCreate(gc, (uint32_t)AS_INT(minCapacity));
+    return 0;
+}
+
+static ErrorId MAGIC_METHOD_SIGNATURE_NAME(DEQUE, iter)(GC* gc, Value* ret, Value* iterable) {
+    (void)gc;
+    (void)iterable;
+    *ret = semiValueIntCreate(0);
+    return 0;
+}
+
+static ErrorId MAGIC_METHOD_SIGNATURE_NAME(DEQUE, next)(GC* gc, Value* ret, Value* iterable, Value* cursor) {
+    (void)gc;
+    ObjectDeque* deque = AS_DEQUE(iterable);
+    IntValue pos       = AS_INT(cursor);
+
+    if (pos >= (IntValue)deque->size) {
+        *ret = INVALID_VALUE;
+        return 0;
+    }
+    *ret         = *semiDequeAt(deque, (uint32_t)pos);
+    cursor->as.i = pos + 1;
+    return 0;
+}
+
+static ErrorId MAGIC_METHOD_SIGNATURE_NAME(DEQUE, contain)(GC* gc, Value* ret, Value* item, Value* collection) {
+    (void)gc;
+    ObjectDeque* deque = AS_DEQUE(collection);
+    for (uint32_t i = 0; i < deque->size; i++) {
+        if (semiBuiltInEquals(*semiDequeAt(deque, i), *item)) {
+            *ret = semiValueBoolCreate(true);
+            return 0;
+        }
+    }
+    *ret = semiValueBoolCreate(false);
+    return 0;
+}
+
+static ErrorId MAGIC_METHOD_SIGNATURE_NAME(DEQUE, len)(GC* gc, Value* ret, Value* collection) {
+    (void)gc;
+    *ret = semiValueIntCreate((IntValue)AS_DEQUE(collection)->size);
+    return 0;
+}
+
+static ErrorId MAGIC_METHOD_SIGNATURE_NAME(DEQUE, getItem)(GC* gc, Value* ret, Value* collection, Value* key) {
+    (void)gc;
+    ObjectDeque* deque = AS_DEQUE(collection);
+
+    uint32_t index;
+    ErrorId err = dequeIndex(deque, key, &index);
+    if (err != 0) {
+        return err;
+    }
+    *ret = *semiDequeAt(deque, index);
+    return 0;
+}
+
+static ErrorId MAGIC_METHOD_SIGNATURE_NAME(DEQUE, setItem)(GC* gc, Value* collection, Value* key, Value* value) {
+    (void)gc;
+    ObjectDeque* deque = AS_DEQUE(collection);
+
+    uint32_t index;
+    ErrorId err = dequeIndex(deque, key, &index);
+    if (err != 0) {
+        return err;
+    }
+    *semiDequeAt(deque, index) = *value;
+    return 0;
+}
+
+static ErrorId MAGIC_METHOD_SIGNATURE_NAME(DEQUE, delItem)(GC* gc, Value* ret, Value* collection, Value* key) {
+    (void)gc;
+    ObjectDeque* deque = AS_DEQUE(collection);
+
+    uint32_t index;
+    ErrorId err = dequeIndex(deque, key, &index);
+    if (err != 0) {
+        return err;
+    }
+    *ret = *semiDequeAt(deque, index);
+    semiDequeRemoveAt(deque, index);
+    return 0;
+}
+
+static ErrorId MAGIC_METHOD_SIGNATURE_NAME(DEQUE, append)(GC* gc, Value* collection, Value* item) {
+    semiDequePushBack(gc, AS_DEQUE(collection), *item);
+    return 0;
+}
+
+static ErrorId MAGIC_METHOD_SIGNATURE_NAME(DEQUE, extend)(GC* gc, Value* collection, Value* iterable) {
+    ObjectDeque* deque = AS_DEQUE(collection);
+    if (IS_LIST(iterable)) {
+        ObjectList* list = AS_LIST(iterable);
+        semiDequeEnsureCapacity(gc, deque, deque->size + list->size);
+        for (uint32_t i = 0; i < list->size; i++) {
+            semiDequePushBack(gc, deque, list->values[i]);
+        }
+    } else if (IS_DEQUE(iterable)) {
+        ObjectDeque* other = AS_DEQUE(iterable);
+        uint32_t count     = other->size;
+        semiDequeEnsureCapacity(gc, deque, deque->size + count);
+        for (uint32_t i = 0; i < count; i++) {
+            semiDequePushBack(gc, deque, *semiDequeAt(other, i));
+        }
+    } else {
+        return SEMI_ERROR_UNIMPLEMENTED_FEATURE;
+    }
+    return 0;
+}
+
+static ErrorId MAGIC_METHOD_SIGNATURE_NAME(DEQUE, pop)(GC* gc, Value* ret, Value* collection) {
+    (void)gc;
+    return semiDequePopBack(AS_DEQUE(collection), ret) ? 0 : SEMI_ERROR_INDEX_OOB;
+}
+
+#pragma endregion
+
 /*
  │ Dictionary
 ─┴───────────────────────────────────────────────────────────────────────────────────────────────*/
@@ -1365,9 +1798,22 @@ static ErrorId MAGIC_METHOD_SIGNATURE_NAME(DICT,
 
 static ErrorId MAGIC_METHOD_SIGNATURE_NAME(DICT, iter)(GC* gc, Value* ret, Value* iterable) {
     (void)gc;
-    (void)ret;
     (void)iterable;
-    return SEMI_ERROR_UNIMPLEMENTED_FEATURE;
+    *ret = semiValueIntCreate(0);
+    return 0;
+}
+
+// Iterating a dict yields its keys in insertion order. The cursor is a position in the dense tuple table, so deleted
+// entries are skipped without touching the index.
+static ErrorId MAGIC_METHOD_SIGNATURE_NAME(DICT, next)(GC* gc, Value* ret, Value* iterable, Value* cursor) {
+    (void)gc;
+    ObjectDict* dict = AS_DICT(iterable);
+    uint32_t pos     = (uint32_t)AS_INT(cursor);
+    TupleId tid      = semiDictNextTupleId(dict, &pos);
+
+    *ret         = tid >= 0 ? dict->keys[tid].key : INVALID_VALUE;
+    cursor->as.i = (IntValue)pos;
+    return 0;
 }
 
 static ErrorId MAGIC_METHOD_SIGNATURE_NAME(DICT, contain)(GC* gc, Value* ret, Value* item, Value* collection) {
@@ -1443,6 +1889,133 @@ static ErrorId MAGIC_METHOD_SIGNATURE_NAME(DICT, pop)(GC* gc, Value* ret, Value*
 
 #pragma endregion
 
+/*
+ │ Set
+─┴───────────────────────────────────────────────────────────────────────────────────────────────*/
+#pragma region
+
+static ErrorId MAGIC_METHOD_SIGNATURE_NAME(SET,
+                                           collectionInit)(GC* gc, Value* ret, Value* objectClass, Value* minCapacity) {
+    (void)objectClass;
+    (void)minCapacity;
+
+    *ret = semiValueSetCreate(gc);
+    return 0;
+}
+
+static ErrorId MAGIC_METHOD_SIGNATURE_NAME(SET, iter)(GC* gc, Value* ret, Value* iterable) {
+    (void)gc;
+    (void)iterable;
+    *ret = semiValueIntCreate(0);
+    return 0;
+}
+
+static ErrorId MAGIC_METHOD_SIGNATURE_NAME(SET, next)(GC* gc, Value* ret, Value* iterable, Value* cursor) {
+    (void)gc;
+    ObjectSet* set = AS_SET(iterable);
+    uint32_t pos   = (uint32_t)AS_INT(cursor);
+    TupleId tid    = semiDictNextTupleId(set, &pos);
+
+    *ret         = tid >= 0 ? set->keys[tid].key : INVALID_VALUE;
+    cursor->as.i = (IntValue)pos;
+    return 0;
+}
+
+static ErrorId MAGIC_METHOD_SIGNATURE_NAME(SET, contain)(GC* gc, Value* ret, Value* item, Value* collection) {
+    (void)gc;
+    *ret = semiValueBoolCreate(semiSetHas(AS_SET(collection), *item));
+    return 0;
+}
+
+static ErrorId MAGIC_METHOD_SIGNATURE_NAME(SET, len)(GC* gc, Value* ret, Value* collection) {
+    (void)gc;
+    *ret = semiValueIntCreate((IntValue)semiSetLen(AS_SET(collection)));
+    return 0;
+}
+
+static ErrorId MAGIC_METHOD_SIGNATURE_NAME(SET, delItem)(GC* gc, Value* ret, Value* collection, Value* key) {
+    if (!semiSetRemove(gc, AS_SET(collection), *key)) {
+        return SEMI_ERROR_KEY_NOT_FOUND;
+    }
+
+    *ret = *key;
+    return 0;
+}
+
+static ErrorId MAGIC_METHOD_SIGNATURE_NAME(SET, append)(GC* gc, Value* collection, Value* item) {
+    return semiSetAdd(gc, AS_SET(collection), *item) ? 0 : SEMI_ERROR_MEMORY_ALLOCATION_FAILURE;
+}
+
+static ErrorId MAGIC_METHOD_SIGNATURE_NAME(SET, extend)(GC* gc, Value* collection, Value* iterable) {
+    ObjectSet* set = AS_SET(collection);
+    bool ok        = true;
+    if (IS_LIST(iterable)) {
+        ObjectList* list = AS_LIST(iterable);
+        for (uint32_t i = 0; i < list->size && ok; i++) {
+            ok = semiSetAdd(gc, set, list->values[i]);
+        }
+    } else if (IS_DEQUE(iterable)) {
+        ObjectDeque* deque = AS_DEQUE(iterable);
+        for (uint32_t i = 0; i < deque->size && ok; i++) {
+            ok = semiSetAdd(gc, set, *semiDequeAt(deque, i));
+        }
+    } else if (IS_SET(iterable) || IS_DICT(iterable)) {
+        ObjectDict* other = AS_DICT(iterable);
+        uint32_t cursor   = 0;
+        TupleId tid;
+        while (ok && (tid = semiDictNextTupleId(other, &cursor)) >= 0) {
+            ok = semiDictSetWithHash(gc, set, other->keys[tid].key, INVALID_VALUE, other->keys[tid].hash);
+        }
+    } else {
+        return SEMI_ERROR_UNIMPLEMENTED_FEATURE;
+    }
+    return ok ? 0 : SEMI_ERROR_MEMORY_ALLOCATION_FAILURE;
+}
+
+// Remove and return the most recently added key.
+static ErrorId MAGIC_METHOD_SIGNATURE_NAME(SET, pop)(GC* gc, Value* ret, Value* collection) {
+    ObjectSet* set = AS_SET(collection);
+    for (uint32_t i = set->used; i > 0; i--) {
+        if (!IS_INVALID(&set->keys[i - 1].key)) {
+            *ret = set->keys[i - 1].key;
+            semiSetRemove(gc, set, *ret);
+            return 0;
+        }
+    }
+    return SEMI_ERROR_INDEX_OOB;
+}
+
+static inline ErrorId setResult(Value* ret, ObjectSet* set) {
+    if (set == NULL) {
+        return SEMI_ERROR_MEMORY_ALLOCATION_FAILURE;
+    }
+    *ret = OBJECT_VALUE(set, VALUE_TYPE_SET);
+    return 0;
+}
+
+static ErrorId MAGIC_METHOD_SIGNATURE_NAME(SET, bitwiseOr)(GC* gc, Value* ret, Value* left, Value* right) {
+    if (!IS_SET(right)) {
+        return SEMI_ERROR_UNEXPECTED_TYPE;
+    }
+    return setResult(ret, semiSetUnion(gc, AS_SET(left), AS_SET(right)));
+}
+
+static ErrorId MAGIC_METHOD_SIGNATURE_NAME(SET, bitwiseAnd)(GC* gc, Value* ret, Value* left, Value* right) {
+    if (!IS_SET(right)) {
+        return SEMI_ERROR_UNEXPECTED_TYPE;
+    }
+    return setResult(ret, semiSetIntersection(gc, AS_SET(left), AS_SET(right)));
+}
+
+static ErrorId MAGIC_METHOD_SIGNATURE_NAME(SET, subtract)(GC* gc, Value* ret, Value* left, Value* right) {
+    if (!IS_SET(right)) {
+        return SEMI_ERROR_UNEXPECTED_TYPE;
+    }
+    return setResult(ret, semiSetDifference(gc, AS_SET(left), AS_SET(right)));
+}
+
+#pragma endregion
+
 bool semiBuiltInEquals(Value a, Value b) {
     BaseValueType baseTypeA = BASE_TYPE(&a);
     BaseValueType baseTypeB = BASE_TYPE(&b);
@@ -1482,7 +2055,7 @@ ValueHash semiBuiltInHash(const Value value) {
 
         case VALUE_TYPE_INT:
             // signed-to-unsigned conversion is safe and defined.
-            return semiHash64Bits((unsigned)AS_INT(&value));
+            return semiHash64Bits((uint64_t)AS_INT(&value));
 
         case VALUE_TYPE_FLOAT: {
             uint64_t key;
@@ -1505,6 +2078,52 @@ ValueHash semiBuiltInHash(const Value value) {
     }
 }
 
+/*
+ │ Struct
+─┴───────────────────────────────────────────────────────────────────────────────────────────────*/
+#pragma region
+
+// Views of the same row of a columnar list are the same struct even though each view is a separate object.
+static inline bool structIdentical(Value* left, Value* right) {
+    if (!IS_STRUCT(right)) {
+        return false;
+    }
+    if (IS_STRUCT_VIEW(left) && IS_STRUCT_VIEW(right)) {
+        ObjectStructView* l = AS_STRUCT_VIEW(left);
+        ObjectStructView* r = AS_STRUCT_VIEW(right);
+        return l->list == r->list && l->row == r->row;
+    }
+    return AS_OBJECT(left) == AS_OBJECT(right);
+}
+
+static ErrorId MAGIC_METHOD_SIGNATURE_NAME(STRUCT, eq)(GC* gc, Value* ret, Value* left, Value* right) {
+    (void)gc;
+    *ret = semiValueBoolCreate(structIdentical(left, right));
+    return 0;
+}
+
+static ErrorId MAGIC_METHOD_SIGNATURE_NAME(STRUCT, neq)(GC* gc, Value* ret, Value* left, Value* right) {
+    (void)gc;
+    *ret = semiValueBoolCreate(!structIdentical(left, right));
+    return 0;
+}
+
+static ErrorId MAGIC_METHOD_SIGNATURE_NAME(STRUCT, toBool)(GC* gc, Value* ret, Value* operand) {
+    (void)gc;
+    (void)operand;
+    *ret = semiValueBoolCreate(true);
+    return 0;
+}
+
+static ErrorId MAGIC_METHOD_SIGNATURE_NAME(STRUCT, inverse)(GC* gc, Value* ret, Value* operand) {
+    (void)gc;
+    (void)operand;
+    *ret = semiValueBoolCreate(false);
+    return 0;
+}
+
+#pragma endregion
+
 /*
  │ Built-in Primitives Setter
 ─┴───────────────────────────────────────────────────────────────────────────────────────────────*/
@@ -1555,10 +2174,26 @@ static const MagicMethodsTable numberMagicMethodsTable = {
     .collectionMethods = &invalidCollectionMethods,
 };
 
+static NumericMethods stringNumericMethods = {
+    .add               = MAGIC_METHOD_SIGNATURE_NAME(STRING, add),
+    .subtract          = MAGIC_METHOD_SIGNATURE_NAME(INVALID, subtract),
+    .multiply          = MAGIC_METHOD_SIGNATURE_NAME(INVALID, multiply),
+    .divide            = MAGIC_METHOD_SIGNATURE_NAME(INVALID, divide),
+    .floorDivide       = MAGIC_METHOD_SIGNATURE_NAME(INVALID, floorDivide),
+    .modulo            = MAGIC_METHOD_SIGNATURE_NAME(INVALID, modulo),
+    .power             = MAGIC_METHOD_SIGNATURE_NAME(INVALID, power),
+    .negate            = MAGIC_METHOD_SIGNATURE_NAME(INVALID, negate),
+    .bitwiseAnd        = MAGIC_METHOD_SIGNATURE_NAME(INVALID, bitwiseAnd),
+    .bitwiseOr         = MAGIC_METHOD_SIGNATURE_NAME(INVALID, bitwiseOr),
+    .bitwiseXor        = MAGIC_METHOD_SIGNATURE_NAME(INVALID, bitwiseXor),
+    .bitwiseInvert     = MAGIC_METHOD_SIGNATURE_NAME(INVALID, bitwiseInvert),
+    .bitwiseShiftLeft  = MAGIC_METHOD_SIGNATURE_NAME(INVALID, bitwiseShiftLeft),
+    .bitwiseShiftRight = MAGIC_METHOD_SIGNATURE_NAME(INVALID, bitwiseShiftRight),
+};
 static ComparisonMethods stringComparisonMethods = {COMPARISON_X_MACRO(FIELD_INIT_MACRO, STRING)};
 static ConversionMethods stringConversionMethods = {CONVERSION_X_MACRO(FIELD_INIT_MACRO, STRING)};
 static CollectionMethods stringCollectionMethods = {
-    .iter    = MAGIC_METHOD_SIGNATURE_NAME(INVALID, iter),
+    .iter    = MAGIC_METHOD_SIGNATURE_NAME(STRING, iter),
     .contain = MAGIC_METHOD_SIGNATURE_NAME(STRING, contain),
     .len     = MAGIC_METHOD_SIGNATURE_NAME(STRING, len),
     .getItem = MAGIC_METHOD_SIGNATURE_NAME(STRING, getItem),
@@ -1567,12 +2202,13 @@ static CollectionMethods stringCollectionMethods = {
     .append  = MAGIC_METHOD_SIGNATURE_NAME(INVALID, append),
     .extend  = MAGIC_METHOD_SIGNATURE_NAME(INVALID, extend),
     .pop     = MAGIC_METHOD_SIGNATURE_NAME(INVALID, pop),
+    .next    = MAGIC_METHOD_SIGNATURE_NAME(STRING, next),
 };
 
 static const MagicMethodsTable stringMagicMethodsTable = {
     .typeInitMethods   = &invalidTypeInitMethods,
     .hash              = MAGIC_METHOD_SIGNATURE_NAME(STRING, hash),
-    .numericMethods    = &invalidNumericMethods,
+    .numericMethods    = &stringNumericMethods,
     .comparisonMethods = &stringComparisonMethods,
     .conversionMethods = &stringConversionMethods,
     .collectionMethods = &stringCollectionMethods,
@@ -1612,6 +2248,22 @@ static const MagicMethodsTable listMagicMethodsTable = {
     .collectionMethods = &listCollectionMethods,
 };
 
+static TypeInitMethods dequeTypeInitMethods = {
+    .collectionInit = MAGIC_METHOD_SIGNATURE_NAME(DEQUE, collectionInit),
+    .structInit     = MAGIC_METHOD_SIGNATURE_NAME(INVALID, structInit),
+};
+
+static CollectionMethods dequeCollectionMethods = {COLLECTION_X_MACRO(FIELD_INIT_MACRO, DEQUE)};
+
+static const MagicMethodsTable dequeMagicMethodsTable = {
+    .typeInitMethods   = &dequeTypeInitMethods,
+    .hash              = MAGIC_METHOD_SIGNATURE_NAME(INVALID, hash),
+    .numericMethods    = &invalidNumericMethods,
+    .comparisonMethods = &invalidComparisonMethods,
+    .conversionMethods = &invalidConversionMethods,
+    .collectionMethods = &dequeCollectionMethods,
+};
+
 static TypeInitMethods dictTypeInitMethods = {
     .collectionInit = MAGIC_METHOD_SIGNATURE_NAME(DICT, collectionInit),
     .structInit     = MAGIC_METHOD_SIGNATURE_NAME(INVALID, structInit),
@@ -1628,6 +2280,77 @@ static const MagicMethodsTable dictMagicMethodsTable = {
     .collectionMethods = &dictCollectionMethods,
 };
 
+static TypeInitMethods setTypeInitMethods = {
+    .collectionInit = MAGIC_METHOD_SIGNATURE_NAME(SET, collectionInit),
+    .structInit     = MAGIC_METHOD_SIGNATURE_NAME(INVALID, structInit),
+};
+
+static NumericMethods setNumericMethods = {
+    .add               = MAGIC_METHOD_SIGNATURE_NAME(INVALID, add),
+    .subtract          = MAGIC_METHOD_SIGNATURE_NAME(SET, subtract),
+    .multiply          = MAGIC_METHOD_SIGNATURE_NAME(INVALID, multiply),
+    .divide            = MAGIC_METHOD_SIGNATURE_NAME(INVALID, divide),
+    .floorDivide       = MAGIC_METHOD_SIGNATURE_NAME(INVALID, floorDivide),
+    .modulo            = MAGIC_METHOD_SIGNATURE_NAME(INVALID, modulo),
+    .power             = MAGIC_METHOD_SIGNATURE_NAME(INVALID, power),
+    .negate            = MAGIC_METHOD_SIGNATURE_NAME(INVALID, negate),
+    .bitwiseAnd        = MAGIC_METHOD_SIGNATURE_NAME(SET, bitwiseAnd),
+    .bitwiseOr         = MAGIC_METHOD_SIGNATURE_NAME(SET, bitwiseOr),
+    .bitwiseXor        = MAGIC_METHOD_SIGNATURE_NAME(INVALID, bitwiseXor),
+    .bitwiseInvert     = MAGIC_METHOD_SIGNATURE_NAME(INVALID, bitwiseInvert),
+    .bitwiseShiftLeft  = MAGIC_METHOD_SIGNATURE_NAME(INVALID, bitwiseShiftLeft),
+    .bitwiseShiftRight = MAGIC_METHOD_SIGNATURE_NAME(INVALID, bitwiseShiftRight),
+};
+
+static CollectionMethods setCollectionMethods = {
+    .iter    = MAGIC_METHOD_SIGNATURE_NAME(SET, iter),
+    .contain = MAGIC_METHOD_SIGNATURE_NAME(SET, contain),
+    .len     = MAGIC_METHOD_SIGNATURE_NAME(SET, len),
+    .getItem = MAGIC_METHOD_SIGNATURE_NAME(INVALID, getItem),
+    .setItem = MAGIC_METHOD_SIGNATURE_NAME(INVALID, setItem),
+    .delItem = MAGIC_METHOD_SIGNATURE_NAME(SET, delItem),
+    .append  = MAGIC_METHOD_SIGNATURE_NAME(SET, append),
+    .extend  = MAGIC_METHOD_SIGNATURE_NAME(SET, extend),
+    .pop     = MAGIC_METHOD_SIGNATURE_NAME(SET, pop),
+    .next    = MAGIC_METHOD_SIGNATURE_NAME(SET, next),
+};
+
+static const MagicMethodsTable setMagicMethodsTable = {
+    .typeInitMethods   = &setTypeInitMethods,
+    .hash              = MAGIC_METHOD_SIGNATURE_NAME(INVALID, hash),
+    .numericMethods    = &setNumericMethods,
+    .comparisonMethods = &invalidComparisonMethods,
+    .conversionMethods = &invalidConversionMethods,
+    .collectionMethods = &setCollectionMethods,
+};
+
+static ComparisonMethods structComparisonMethods = {
+    .gt  = MAGIC_METHOD_SIGNATURE_NAME(INVALID, gt),
+    .gte = MAGIC_METHOD_SIGNATURE_NAME(INVALID, gte),
+    .lt  = MAGIC_METHOD_SIGNATURE_NAME(INVALID, lt),
+    .lte = MAGIC_METHOD_SIGNATURE_NAME(INVALID, lte),
+    .eq  = MAGIC_METHOD_SIGNATURE_NAME(STRUCT, eq),
+    .neq = MAGIC_METHOD_SIGNATURE_NAME(STRUCT, neq),
+};
+
+static ConversionMethods structConversionMethods = {
+    .toBool   = MAGIC_METHOD_SIGNATURE_NAME(STRUCT, toBool),
+    .inverse  = MAGIC_METHOD_SIGNATURE_NAME(STRUCT, inverse),
+    .toInt    = MAGIC_METHOD_SIGNATURE_NAME(INVALID, toInt),
+    .toFloat  = MAGIC_METHOD_SIGNATURE_NAME(INVALID, toFloat),
+    .toString = MAGIC_METHOD_SIGNATURE_NAME(INVALID, toString),
+    .toType   = MAGIC_METHOD_SIGNATURE_NAME(INVALID, toType),
+};
+
+static const MagicMethodsTable structMagicMethodsTable = {
+    .typeInitMethods   = &invalidTypeInitMethods,
+    .hash              = MAGIC_METHOD_SIGNATURE_NAME(INVALID, hash),
+    .numericMethods    = &invalidNumericMethods,
+    .comparisonMethods = &structComparisonMethods,
+    .conversionMethods = &structConversionMethods,
+    .collectionMethods = &invalidCollectionMethods,
+};
+
 void semiPrimitivesFinalizeMagicMethodsTable(MagicMethodsTable* table) {
     if (table->typeInitMethods == NULL) {
         table->typeInitMethods = &invalidTypeInitMethods;
@@ -1660,7 +2383,9 @@ static const TypeIdentifierBaseValueTypePair typeIdentifierBaseValueTypePair[] =
     { "Float",  BASE_VALUE_TYPE_FLOAT},
     {"String", BASE_VALUE_TYPE_STRING},
     {  "List",   BASE_VALUE_TYPE_LIST},
+    { "Deque",  BASE_VALUE_TYPE_DEQUE},
     {  "Dict",   BASE_VALUE_TYPE_DICT},
+    {   "Set",    BASE_VALUE_TYPE_SET},
 };
 
 void semiPrimitivesInitBuiltInModuleTypes(GC* gc, SymbolTable* symbolTable, SemiModule* module) {
@@ -1690,21 +2415,94 @@ void semiPrimitivesIntializeBuiltInPrimitives(GC* gc, ClassTable* classes, Symbo
         [BASE_VALUE_TYPE_DICT]           = dictMagicMethodsTable,
         [BASE_VALUE_TYPE_FUNCTION_PROTO] = invalidMagicMethodsTable,
         [BASE_VALUE_TYPE_CLASS]          = invalidMagicMethodsTable,
+        [BASE_VALUE_TYPE_DEQUE]          = dequeMagicMethodsTable,
+        [BASE_VALUE_TYPE_SET]            = setMagicMethodsTable,
     };
 
     uint16_t newCapacity               = (uint16_t)(sizeof(builtInClasses) / sizeof(MagicMethodsTable));
     MagicMethodsTable* newClassMethods = semiMalloc(gc, newCapacity * sizeof(MagicMethodsTable));
 
     classes->classMethods  = newClassMethods;
+    classes->structTypes   = NULL;
     classes->classCount    = newCapacity;
     classes->classCapacity = newCapacity;
 
     memcpy(classes->classMethods, builtInClasses, sizeof(builtInClasses));
 }
 
+ErrorId semiPrimitivesAddStructType(GC* gc,
+                                    ClassTable* classes,
+                                    InternedChar* name,
+                                    const StructField* fields,
+                                    size_t fieldCount,
+                                    TypeId* typeId) {
+    // The largest type id is reserved for `INVALID_ATTR_CACHE_TYPE_ID`.
+    if (classes->classCount >= MAX_CUSTOM_BASE_VALUE_TYPE) {
+        return SEMI_ERROR_REACH_ALLOCATION_LIMIT;
+    }
+
+    if (classes->classCount == classes->classCapacity) {
+        uint32_t newCapacity = (uint32_t)classes->classCapacity * 2;
+        if (newCapacity > MAX_CUSTOM_BASE_VALUE_TYPE) {
+            newCapacity = MAX_CUSTOM_BASE_VALUE_TYPE;
+        }
+
+        MagicMethodsTable* newClassMethods = semiRealloc(gc,
+                                                         classes->classMethods,
+                                                         classes->classCapacity * sizeof(MagicMethodsTable),
+                                                         newCapacity * sizeof(MagicMethodsTable));
+        if (newClassMethods == NULL) {
+            return SEMI_ERROR_MEMORY_ALLOCATION_FAILURE;
+        }
+        classes->classMethods = newClassMethods;
+
+        StructType* newStructTypes =
+            semiRealloc(gc,
+                        classes->structTypes,
+                        (classes->classCapacity - MIN_CUSTOM_BASE_VALUE_TYPE) * sizeof(StructType),
+                        (newCapacity - MIN_CUSTOM_BASE_VALUE_TYPE) * sizeof(StructType));
+        if (newStructTypes == NULL) {
+            return SEMI_ERROR_MEMORY_ALLOCATION_FAILURE;
+        }
+        classes->structTypes   = newStructTypes;
+        classes->classCapacity = (uint16_t)newCapacity;
+    }
+
+    StructField* ownedFields = NULL;
+    if (fieldCount > 0) {
+        ownedFields = semiMalloc(gc, fieldCount * sizeof(StructField));
+        if (ownedFields == NULL) {
+            return SEMI_ERROR_MEMORY_ALLOCATION_FAILURE;
+        }
+        memcpy(ownedFields, fields, fieldCount * sizeof(StructField));
+    }
+
+    TypeId newTypeId                 = classes->classCount++;
+    classes->classMethods[newTypeId] = structMagicMethodsTable;
+
+    classes->structTypes[newTypeId - MIN_CUSTOM_BASE_VALUE_TYPE] = (StructType){
+        .name       = name,
+        .fields     = ownedFields,
+        .fieldCount = fieldCount,
+    };
+
+    *typeId = newTypeId;
+    return 0;
+}
+
 void semiPrimitivesCleanupClassTable(GC* gc, ClassTable* classes) {
+    for (uint16_t i = MIN_CUSTOM_BASE_VALUE_TYPE; i < classes->classCount; i++) {
+        StructType* structType = &classes->structTypes[i - MIN_CUSTOM_BASE_VALUE_TYPE];
+        semiFree(gc, structType->fields, structType->fieldCount * sizeof(StructField));
+    }
+    if (classes->structTypes != NULL) {
+        semiFree(
+            gc, classes->structTypes, (classes->classCapacity - MIN_CUSTOM_BASE_VALUE_TYPE) * sizeof(StructType));
+    }
+
     semiFree(gc, classes->classMethods, classes->classCapacity * sizeof(MagicMethodsTable));
     classes->classMethods  = NULL;
+    classes->structTypes   = NULL;
     classes->classCount    = 0;
     classes->classCapacity = 0;
 }
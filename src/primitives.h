@@ -7,6 +7,7 @@
 #include "./gc.h"
 #include "./primitive_x_macro.h"
 #include "./symbol_table.h"
+#include "./types.h"
 #include "./value.h"
 #include "semi/error.h"
 
@@ -19,14 +20,30 @@ ValueHash semiBuiltInHash(const Value v);
 
 typedef struct ClassTable {
     MagicMethodsTable* classMethods;
+    // The layouts of the struct types, indexed by `typeId - MIN_CUSTOM_BASE_VALUE_TYPE`.
+    StructType* structTypes;
     uint16_t classCount;
     uint16_t classCapacity;
 } ClassTable;
 
+static inline StructType* semiPrimitivesGetStructType(ClassTable* classes, TypeId typeId) {
+    if (typeId < MIN_CUSTOM_BASE_VALUE_TYPE || typeId >= classes->classCount) {
+        return NULL;
+    }
+    return &classes->structTypes[typeId - MIN_CUSTOM_BASE_VALUE_TYPE];
+}
+
 void semiPrimitivesFinalizeMagicMethodsTable(MagicMethodsTable* table);
 void semiPrimitivesInitBuiltInModuleTypes(GC* gc, SymbolTable* symbolTable, SemiModule* module);
 void semiPrimitivesIntializeBuiltInPrimitives(GC* gc, ClassTable* classes, SymbolTable* symbolTable);
 void semiPrimitivesCleanupClassTable(GC* gc, ClassTable* classes);
+// Registers a struct type with a copy of `fields`, which must be sorted by the identifier ids of the field names.
+ErrorId semiPrimitivesAddStructType(GC* gc,
+                                    ClassTable* classes,
+                                    InternedChar* name,
+                                    const StructField* fields,
+                                    size_t fieldCount,
+                                    TypeId* typeId);
 ErrorId semiPrimitivesDispatchHash(MagicMethodsTable* table, GC* gc, ValueHash* ret, Value* a);
 ErrorId semiPrimitivesDispatch1Operand(MagicMethodsTable* table, GC* gc, Opcode method, Value* ret, Value* a);
 ErrorId semiPrimitivesDispatch2Operands(MagicMethodsTable* table, GC* gc, Opcode method, Value* a, Value* b, Value* c);
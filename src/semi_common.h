@@ -92,4 +92,17 @@ static inline uint32_t nextPowerOfTwoCapacity(uint32_t x) {
 #endif
 }
 
+static inline uint32_t countTrailingZeros64(uint64_t x) {
+#if __has_builtin(__builtin_ctzll)
+    return (uint32_t)__builtin_ctzll(x);
+#else
+    uint32_t n = 0;
+    while ((x & 1) == 0) {
+        x >>= 1;
+        n++;
+    }
+    return n;
+#endif
+}
+
 #endif /* SEMI_COMMON_H */
@@ -25,7 +25,8 @@ void semiSymbolTableInit(GC* gc, SymbolTable* table) {
     semiObjectStackDictInit(&table->identifierMap);
     table->identifierMap.keyCmpFn = keyCompareFn;
 
-    table->nextId = MAX_RESERVED_IDENTIFIER_ID + 1;
+    table->nextId      = MAX_RESERVED_IDENTIFIER_ID + 1;
+    table->fingerprint = 0;
 }
 
 void semiSymbolTableCleanup(SymbolTable* table) {
@@ -88,6 +89,7 @@ InternedChar* semiSymbolTableInsert(struct SymbolTable* table,
 
     Value entryValue = semiValuePtrCreate((void*)newEntry, VALUE_TYPE_UNSET);
     semiDictSetWithHash(table->gc, &table->identifierMap, entryValue, entryValue, hash);
+    table->fingerprint = semiHash64Bits(table->fingerprint ^ semiHashBytes64(identifier, identifierLength));
 
     return strData;
 }
@@ -112,6 +114,16 @@ InternedChar* semiSymbolTableGet(struct SymbolTable* table, const char* str, Ide
     return NULL;
 }
 
+InternedChar* semiSymbolTableGetById(struct SymbolTable* table, IdentifierId id) {
+    if (id <= MAX_RESERVED_IDENTIFIER_ID || id >= table->nextId) {
+        return NULL;
+    }
+
+    // Identifiers are never removed, so the tuple of an identifier is at the position of its ID.
+    Value entry = table->identifierMap.keys[id - MAX_RESERVED_IDENTIFIER_ID - 1].key;
+    return AS_PTR(&entry, IdentifierEntry)->str;
+}
+
 inline IdentifierId semiSymbolTableGetId(const InternedChar* str) {
     IdentifierId id;
     memcpy(&id, (char*)str - sizeof(IdentifierId), sizeof(IdentifierId));
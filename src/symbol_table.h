@@ -34,6 +34,8 @@ typedef struct SymbolTable {
 
     ObjectDict identifierMap;
     IdentifierId nextId;
+    // An order-sensitive hash of all interned identifiers, so that two tables can be compared in constant time.
+    uint64_t fingerprint;
 } SymbolTable;
 
 // Initialize the string table
@@ -50,6 +52,9 @@ InternedChar* semiSymbolTableGet(struct SymbolTable* table, const char* str, Ide
 // So symbol comparison can be done with pointer comparison.
 InternedChar* semiSymbolTableInsert(struct SymbolTable* table, const char* str, IdentifierLength length);
 
+// Get the interned string of an identifier ID. Return NULL if no identifier has the ID.
+InternedChar* semiSymbolTableGetById(struct SymbolTable* table, IdentifierId id);
+
 // Get the length of a string.
 IdentifierLength semiSymbolTableLength(const InternedChar* str);
 
@@ -18,6 +18,8 @@ typedef struct StructField {
     struct StructType* type;
 } StructField;
 
+// The layout of a struct type. `fields` is sorted by the identifier ids of the field names, and the index of a field
+// in `fields` is its slot in the instances of the type.
 typedef struct StructType {
     InternedChar* name;
 
@@ -25,4 +27,25 @@ typedef struct StructType {
     size_t fieldCount;
 } StructType;
 
+#define MAX_STRUCT_FIELD_COUNT    UINT8_MAX
+#define INVALID_STRUCT_FIELD_SLOT UINT16_MAX
+
+static inline uint16_t semiStructTypeFindSlot(const StructType* type, IdentifierId fieldName) {
+    size_t low  = 0;
+    size_t high = type->fieldCount;
+    while (low < high) {
+        size_t mid         = low + (high - low) / 2;
+        IdentifierId midId = semiSymbolTableGetId(type->fields[mid].name);
+        if (midId == fieldName) {
+            return (uint16_t)mid;
+        }
+        if (midId < fieldName) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return INVALID_STRUCT_FIELD_SLOT;
+}
+
 #endif /* SEMI_TYPES_H */
@@ -158,13 +158,83 @@ ObjectList* semiObjectListCreate(GC* gc, uint32_t capacity) {
         return NULL;  // Allocation failed
     }
 
-    o->values   = (Value*)semiMalloc(gc, sizeof(Value) * capacity);
-    o->size     = 0;
-    o->capacity = capacity;
+    o->values      = (Value*)semiMalloc(gc, sizeof(Value) * capacity);
+    o->size        = 0;
+    o->capacity    = capacity;
+    o->elementKind = LIST_ELEMENT_KIND_EMPTY;
+    o->storage     = NULL;
+    return o;
+}
+
+static void listStorageRelease(GC* gc, ListStorage* storage, bool freeValues) {
+    if (--storage->refCount > 0) {
+        return;
+    }
+    if (freeValues) {
+        semiFree(gc, storage->values, sizeof(Value) * storage->capacity);
+    }
+    semiFree(gc, storage, sizeof(ListStorage));
+}
+
+void semiObjectListDestroy(GC* gc, ObjectList* list) {
+    if (list->storage != NULL) {
+        listStorageRelease(gc, list->storage, true);
+    } else {
+        semiFree(gc, list->values, sizeof(Value) * list->capacity);
+    }
+    semiFree(gc, list, sizeof(ObjectList));
+}
+
+void semiListDetach(GC* gc, ObjectList* list) {
+    ListStorage* storage = list->storage;
+    list->storage        = NULL;
+
+    // The last reference to the front of the buffer can take it over instead of copying.
+    if (storage->refCount == 1 && list->values == storage->values) {
+        list->capacity = storage->capacity;
+        listStorageRelease(gc, storage, false);
+        return;
+    }
+
+    uint32_t capacity = nextPowerOfTwoCapacity(list->size);
+    Value* values     = (Value*)semiMalloc(gc, sizeof(Value) * capacity);
+    memcpy(values, list->values, sizeof(Value) * list->size);
+    list->values   = values;
+    list->capacity = capacity;
+    listStorageRelease(gc, storage, true);
+}
+
+ObjectList* semiListSlice(GC* gc, ObjectList* list, uint32_t start, uint32_t end) {
+    ASSERT(start <= end && end <= list->size, "Slice bounds out of range");
+
+    if (list->storage == NULL) {
+        ListStorage* storage = (ListStorage*)semiMalloc(gc, sizeof(ListStorage));
+        if (!storage) {
+            return NULL;
+        }
+        storage->refCount = 1;
+        storage->capacity = list->capacity;
+        storage->values   = list->values;
+        list->storage     = storage;
+        list->capacity    = list->size;
+    }
+
+    ObjectList* o = (ObjectList*)newObject(gc, OBJECT_TYPE_LIST, sizeof(ObjectList));
+    if (!o) {
+        return NULL;
+    }
+
+    list->storage->refCount++;
+    o->values      = list->values + start;
+    o->size        = end - start;
+    o->capacity    = o->size;
+    o->elementKind = o->size == 0 ? LIST_ELEMENT_KIND_EMPTY : list->elementKind;
+    o->storage     = list->storage;
     return o;
 }
 
 void semiListEnsureCapacity(GC* gc, ObjectList* list, uint32_t capacity) {
+    semiListEnsureUnique(gc, list);
     if (list->capacity < capacity) {
         uint32_t newCapacity = nextPowerOfTwoCapacity(capacity);
         list->values =
@@ -174,18 +244,22 @@ void semiListEnsureCapacity(GC* gc, ObjectList* list, uint32_t capacity) {
 }
 
 void semiListAppend(GC* gc, ObjectList* list, Value value) {
+    semiListEnsureUnique(gc, list);
     if (list->size == list->capacity) {
         semiListEnsureCapacity(gc, list, list->capacity + 1);
     }
 
+    semiListMergeElementKind(list, &value);
     list->values[list->size++] = value;
 }
 
 void semiListInsert(GC* gc, ObjectList* list, uint32_t index, Value value) {
+    semiListEnsureUnique(gc, list);
     if (list->size == list->capacity) {
         semiListEnsureCapacity(gc, list, list->capacity + 1);
     }
 
+    semiListMergeElementKind(list, &value);
     if (index >= list->size) {
         list->values[list->size++] = value;
     } else {
@@ -199,6 +273,7 @@ void semiListInsert(GC* gc, ObjectList* list, uint32_t index, Value value) {
 }
 
 void semiListShrink(GC* gc, ObjectList* list) {
+    semiListEnsureUnique(gc, list);
     uint32_t newCapacity = nextPowerOfTwoCapacity(list->capacity / LIST_GROW_FACTOR);
     if (newCapacity >= list->size) {
         list->values =
@@ -210,10 +285,14 @@ void semiListShrink(GC* gc, ObjectList* list) {
 IntValue semiListRemove(GC* gc, ObjectList* list, Value value) {
     for (uint32_t i = 0; i < list->size; i++) {
         if (semiBuiltInEquals(list->values[i], value)) {
+            semiListEnsureUnique(gc, list);
             for (uint32_t j = i; j < list->size - 1; j++) {
                 list->values[j] = list->values[j + 1];
             }
             list->size--;
+            if (list->size == 0) {
+                list->elementKind = LIST_ELEMENT_KIND_EMPTY;
+            }
 
             semiListShrink(gc, list);
             return i;
@@ -227,23 +306,44 @@ bool semiListPop(GC* gc, ObjectList* list) {
         return false;
     }
 
+    semiListEnsureUnique(gc, list);
     list->size--;
+    if (list->size == 0) {
+        list->elementKind = LIST_ELEMENT_KIND_EMPTY;
+    }
     semiListShrink(gc, list);
     return true;
 }
 
 bool semiListHas(GC* gc, ObjectList* list, Value value) {
-    (void)gc;
-    for (uint32_t i = 0; i < list->size; i++) {
-        if (semiBuiltInEquals(list->values[i], value)) {
-            return true;
-        }
-    }
-    return false;
+    return semiListIndex(gc, list, value) >= 0;
 }
 
 IntValue semiListIndex(GC* gc, ObjectList* list, Value value) {
     (void)gc;
+    const Value* values = list->values;
+    const uint32_t size = list->size;
+
+    // Homogeneous lists compare payloads directly. Mixed int/float equality still goes through the general path.
+    if (list->elementKind == LIST_ELEMENT_KIND_INT && IS_INT(&value)) {
+        IntValue needle = AS_INT(&value);
+        for (uint32_t i = 0; i < size; i++) {
+            if (values[i].as.i == needle) {
+                return i;
+            }
+        }
+        return -1;
+    }
+    if (list->elementKind == LIST_ELEMENT_KIND_FLOAT && IS_FLOAT(&value)) {
+        FloatValue needle = AS_FLOAT(&value);
+        for (uint32_t i = 0; i < size; i++) {
+            if (values[i].as.f == needle) {
+                return i;
+            }
+        }
+        return -1;
+    }
+
     for (uint32_t i = 0; i < list->size; i++) {
         if (semiBuiltInEquals(list->values[i], value)) {
             return i;
@@ -252,6 +352,435 @@ IntValue semiListIndex(GC* gc, ObjectList* list, Value value) {
     return -1;
 }
 
+void semiListRefreshElementKind(ObjectList* list, uint32_t from) {
+    if (list->size == 0) {
+        list->elementKind = LIST_ELEMENT_KIND_EMPTY;
+        return;
+    }
+    for (uint32_t i = from; i < list->size && list->elementKind != LIST_ELEMENT_KIND_MIXED; i++) {
+        semiListMergeElementKind(list, &list->values[i]);
+    }
+}
+
+// The kernels below keep four independent accumulators so the loop-carried dependency chain is short and the compiler
+// is free to vectorize the body.
+
+bool semiListSum(const ObjectList* list, Value* ret) {
+    const Value* values = list->values;
+    const uint32_t size = list->size;
+    uint32_t i          = 0;
+
+    switch (list->elementKind) {
+        case LIST_ELEMENT_KIND_EMPTY:
+            *ret = semiValueIntCreate(0);
+            return true;
+
+        case LIST_ELEMENT_KIND_INT: {
+            // Unsigned accumulation wraps like the int add magic method does in practice, without signed overflow UB.
+            uint64_t s0 = 0, s1 = 0, s2 = 0, s3 = 0;
+            for (; i + 4 <= size; i += 4) {
+                s0 += (uint64_t)values[i].as.i;
+                s1 += (uint64_t)values[i + 1].as.i;
+                s2 += (uint64_t)values[i + 2].as.i;
+                s3 += (uint64_t)values[i + 3].as.i;
+            }
+            for (; i < size; i++) {
+                s0 += (uint64_t)values[i].as.i;
+            }
+            *ret = semiValueIntCreate((IntValue)(s0 + s1 + s2 + s3));
+            return true;
+        }
+
+        case LIST_ELEMENT_KIND_FLOAT: {
+            FloatValue s0 = 0.0, s1 = 0.0, s2 = 0.0, s3 = 0.0;
+            for (; i + 4 <= size; i += 4) {
+                s0 += values[i].as.f;
+                s1 += values[i + 1].as.f;
+                s2 += values[i + 2].as.f;
+                s3 += values[i + 3].as.f;
+            }
+            for (; i < size; i++) {
+                s0 += values[i].as.f;
+            }
+            *ret = semiValueFloatCreate((s0 + s1) + (s2 + s3));
+            return true;
+        }
+
+        default:
+            return false;
+    }
+}
+
+#define LIST_MIN_MAX_KERNEL(name, cmp)                                    \
+    bool name(const ObjectList* list, Value* ret) {                       \
+        const Value* values = list->values;                               \
+        const uint32_t size = list->size;                                 \
+        if (list->elementKind == LIST_ELEMENT_KIND_INT) {                 \
+            IntValue m = values[0].as.i;                                  \
+            for (uint32_t i = 1; i < size; i++) {                         \
+                IntValue v = values[i].as.i;                              \
+                m          = v cmp m ? v : m;                             \
+            }                                                             \
+            *ret = semiValueIntCreate(m);                                 \
+            return true;                                                  \
+        }                                                                 \
+        if (list->elementKind == LIST_ELEMENT_KIND_FLOAT) {               \
+            FloatValue m = values[0].as.f;                                \
+            for (uint32_t i = 1; i < size; i++) {                         \
+                FloatValue v = values[i].as.f;                            \
+                m            = v cmp m ? v : m;                           \
+            }                                                             \
+            *ret = semiValueFloatCreate(m);                               \
+            return true;                                                  \
+        }                                                                 \
+        return false;                                                     \
+    }
+
+LIST_MIN_MAX_KERNEL(semiListMin, <)
+LIST_MIN_MAX_KERNEL(semiListMax, >)
+
+#undef LIST_MIN_MAX_KERNEL
+
+bool semiListDot(const ObjectList* a, const ObjectList* b, Value* ret) {
+    if (a->size != b->size || a->elementKind != b->elementKind) {
+        return false;
+    }
+
+    const Value* x      = a->values;
+    const Value* y      = b->values;
+    const uint32_t size = a->size;
+    uint32_t i          = 0;
+
+    switch (a->elementKind) {
+        case LIST_ELEMENT_KIND_EMPTY:
+            *ret = semiValueIntCreate(0);
+            return true;
+
+        case LIST_ELEMENT_KIND_INT: {
+            uint64_t s0 = 0, s1 = 0;
+            for (; i + 2 <= size; i += 2) {
+                s0 += (uint64_t)x[i].as.i * (uint64_t)y[i].as.i;
+                s1 += (uint64_t)x[i + 1].as.i * (uint64_t)y[i + 1].as.i;
+            }
+            for (; i < size; i++) {
+                s0 += (uint64_t)x[i].as.i * (uint64_t)y[i].as.i;
+            }
+            *ret = semiValueIntCreate((IntValue)(s0 + s1));
+            return true;
+        }
+
+        case LIST_ELEMENT_KIND_FLOAT: {
+            FloatValue s0 = 0.0, s1 = 0.0;
+            for (; i + 2 <= size; i += 2) {
+                s0 += x[i].as.f * y[i].as.f;
+                s1 += x[i + 1].as.f * y[i + 1].as.f;
+            }
+            for (; i < size; i++) {
+                s0 += x[i].as.f * y[i].as.f;
+            }
+            *ret = semiValueFloatCreate(s0 + s1);
+            return true;
+        }
+
+        default:
+            return false;
+    }
+}
+
+typedef struct RadixRecord {
+    uint64_t key;
+    uint32_t index;
+} RadixRecord;
+
+typedef struct SortState {
+    const Value* keys;
+    ValueLessThanFn lessThan;
+    void* context;
+    bool strings;
+    ErrorId error;
+} SortState;
+
+#define SORT_INSERTION_THRESHOLD 16
+
+static inline void stringView(const Value* v, const char** str, size_t* length) {
+    if (IS_INLINE_STRING(v)) {
+        *str    = AS_INLINE_STRING(v).c;
+        *length = AS_INLINE_STRING(v).length;
+    } else {
+        *str    = AS_OBJECT_STRING(v)->str;
+        *length = AS_OBJECT_STRING(v)->length;
+    }
+}
+
+static bool sortLessThan(SortState* state, uint32_t a, uint32_t b) {
+    if (state->strings) {
+        const char *aStr, *bStr;
+        size_t aLength, bLength;
+        stringView(&state->keys[a], &aStr, &aLength);
+        stringView(&state->keys[b], &bStr, &bLength);
+        int cmp = memcmp(aStr, bStr, aLength < bLength ? aLength : bLength);
+        return cmp < 0 || (cmp == 0 && aLength < bLength);
+    }
+
+    bool ret = false;
+    if (state->error == 0) {
+        state->error = state->lessThan(state->context, (Value*)&state->keys[a], (Value*)&state->keys[b], &ret);
+    }
+    return ret;
+}
+
+// Top-down merge sort over an index permutation. Sorted runs skip the merge, so presorted input is linear.
+static void mergeSortIndices(SortState* state, uint32_t* order, uint32_t* scratch, uint32_t count) {
+    if (count <= SORT_INSERTION_THRESHOLD) {
+        for (uint32_t i = 1; i < count; i++) {
+            uint32_t item = order[i];
+            uint32_t j    = i;
+            while (j > 0 && sortLessThan(state, item, order[j - 1])) {
+                order[j] = order[j - 1];
+                j--;
+            }
+            order[j] = item;
+        }
+        return;
+    }
+
+    uint32_t mid = count / 2;
+    mergeSortIndices(state, order, scratch, mid);
+    mergeSortIndices(state, order + mid, scratch, count - mid);
+    if (state->error != 0 || !sortLessThan(state, order[mid], order[mid - 1])) {
+        return;
+    }
+
+    memcpy(scratch, order, sizeof(uint32_t) * mid);
+    uint32_t i = 0, j = mid, k = 0;
+    while (i < mid && j < count) {
+        order[k++] = sortLessThan(state, order[j], scratch[i]) ? order[j++] : scratch[i++];
+    }
+    while (i < mid) {
+        order[k++] = scratch[i++];
+    }
+}
+
+static inline uint64_t radixKey(const Value* v) {
+    if (IS_INT(v)) {
+        return (uint64_t)v->as.i ^ ((uint64_t)1 << 63);
+    }
+
+    // Map IEEE-754 doubles to unsigned integers with the same ordering.
+    uint64_t bits;
+    memcpy(&bits, &v->as.f, sizeof(bits));
+    return (bits >> 63) ? ~bits : bits | ((uint64_t)1 << 63);
+}
+
+// LSD radix sort, one byte per pass. Passes where every key shares the same byte are skipped. Returns whichever of the
+// two buffers holds the sorted records.
+static RadixRecord* radixSortRecords(RadixRecord* records, RadixRecord* scratch, uint32_t count) {
+    for (uint32_t shift = 0; shift < 64; shift += 8) {
+        uint32_t histogram[256] = {0};
+        for (uint32_t i = 0; i < count; i++) {
+            histogram[(records[i].key >> shift) & 0xFF]++;
+        }
+        if (histogram[(records[0].key >> shift) & 0xFF] == count) {
+            continue;
+        }
+
+        uint32_t offset = 0;
+        for (uint32_t b = 0; b < 256; b++) {
+            uint32_t n   = histogram[b];
+            histogram[b] = offset;
+            offset += n;
+        }
+        for (uint32_t i = 0; i < count; i++) {
+            scratch[histogram[(records[i].key >> shift) & 0xFF]++] = records[i];
+        }
+
+        RadixRecord* tmp = records;
+        records          = scratch;
+        scratch          = tmp;
+    }
+    return records;
+}
+
+static void applyPermutation(Value* values, Value* scratch, const uint32_t* order, uint32_t count) {
+    for (uint32_t i = 0; i < count; i++) {
+        scratch[i] = values[order[i]];
+    }
+    memcpy(values, scratch, sizeof(Value) * count);
+}
+
+ErrorId semiValuesSort(GC* gc, Value* keys, Value* payload, uint32_t count, ValueLessThanFn lessThan, void* context) {
+    if (count < 2) {
+        return 0;
+    }
+
+    ListElementKind kind = LIST_ELEMENT_KIND_EMPTY;
+    bool strings         = true;
+    for (uint32_t i = 0; i < count; i++) {
+        ListElementKind k = semiListElementKindOf(&keys[i]);
+        kind              = (kind == LIST_ELEMENT_KIND_EMPTY || kind == k) ? k : LIST_ELEMENT_KIND_MIXED;
+        strings           = strings && IS_STRING(&keys[i]);
+    }
+    if (!strings && kind == LIST_ELEMENT_KIND_MIXED && lessThan == NULL) {
+        return SEMI_ERROR_UNEXPECTED_TYPE;
+    }
+
+    ErrorId error   = 0;
+    uint32_t* order = (uint32_t*)semiMalloc(gc, sizeof(uint32_t) * count);
+    Value* permuted = (Value*)semiMalloc(gc, sizeof(Value) * count);
+    if (order == NULL || permuted == NULL) {
+        error = SEMI_ERROR_MEMORY_ALLOCATION_FAILURE;
+        goto cleanup;
+    }
+
+    if (kind == LIST_ELEMENT_KIND_INT || kind == LIST_ELEMENT_KIND_FLOAT) {
+        RadixRecord* records = (RadixRecord*)semiMalloc(gc, sizeof(RadixRecord) * count * 2);
+        if (records == NULL) {
+            error = SEMI_ERROR_MEMORY_ALLOCATION_FAILURE;
+            goto cleanup;
+        }
+        for (uint32_t i = 0; i < count; i++) {
+            records[i] = (RadixRecord){.key = radixKey(&keys[i]), .index = i};
+        }
+        RadixRecord* sorted = radixSortRecords(records, records + count, count);
+        for (uint32_t i = 0; i < count; i++) {
+            order[i] = sorted[i].index;
+        }
+        semiFree(gc, records, sizeof(RadixRecord) * count * 2);
+    } else {
+        uint32_t* scratch = (uint32_t*)semiMalloc(gc, sizeof(uint32_t) * (count / 2 + 1));
+        if (scratch == NULL) {
+            error = SEMI_ERROR_MEMORY_ALLOCATION_FAILURE;
+            goto cleanup;
+        }
+        for (uint32_t i = 0; i < count; i++) {
+            order[i] = i;
+        }
+        SortState state = {
+            .keys     = keys,
+            .lessThan = lessThan,
+            .context  = context,
+            .strings  = strings,
+            .error    = 0,
+        };
+        mergeSortIndices(&state, order, scratch, count);
+        semiFree(gc, scratch, sizeof(uint32_t) * (count / 2 + 1));
+        if ((error = state.error) != 0) {
+            goto cleanup;
+        }
+    }
+
+    applyPermutation(keys, permuted, order, count);
+    if (payload != NULL) {
+        applyPermutation(payload, permuted, order, count);
+    }
+
+cleanup:
+    semiFree(gc, order, sizeof(uint32_t) * count);
+    semiFree(gc, permuted, sizeof(Value) * count);
+    return error;
+}
+
+ErrorId semiListSort(GC* gc, ObjectList* list, ValueLessThanFn lessThan, void* context) {
+    semiListEnsureUnique(gc, list);
+    return semiValuesSort(gc, list->values, NULL, list->size, lessThan, context);
+}
+
+#undef SORT_INSERTION_THRESHOLD
+
+#pragma endregion
+
+/*
+ │ ObjectDeque
+─┴───────────────────────────────────────────────────────────────────────────────────────────────*/
+#pragma region
+
+ObjectDeque* semiObjectDequeCreate(GC* gc, uint32_t capacity) {
+    ObjectDeque* o = (ObjectDeque*)newObject(gc, OBJECT_TYPE_DEQUE, sizeof(ObjectDeque));
+    if (!o) {
+        return NULL;  // Allocation failed
+    }
+
+    capacity    = capacity == 0 ? 0 : nextPowerOfTwoCapacity(capacity);
+    o->values   = capacity == 0 ? NULL : (Value*)semiMalloc(gc, sizeof(Value) * capacity);
+    o->head     = 0;
+    o->size     = 0;
+    o->capacity = capacity;
+    return o;
+}
+
+void semiDequeEnsureCapacity(GC* gc, ObjectDeque* deque, uint32_t capacity) {
+    if (deque->capacity >= capacity) {
+        return;
+    }
+
+    // Unwrap the ring into the new buffer so that the head starts at 0.
+    uint32_t newCapacity = nextPowerOfTwoCapacity(capacity);
+    Value* values        = (Value*)semiMalloc(gc, sizeof(Value) * newCapacity);
+    uint32_t firstPart   = deque->capacity - deque->head;
+    if (firstPart >= deque->size) {
+        memcpy(values, deque->values + deque->head, sizeof(Value) * deque->size);
+    } else {
+        memcpy(values, deque->values + deque->head, sizeof(Value) * firstPart);
+        memcpy(values + firstPart, deque->values, sizeof(Value) * (deque->size - firstPart));
+    }
+
+    semiFree(gc, deque->values, sizeof(Value) * deque->capacity);
+    deque->values   = values;
+    deque->head     = 0;
+    deque->capacity = newCapacity;
+}
+
+void semiDequePushBack(GC* gc, ObjectDeque* deque, Value value) {
+    if (deque->size == deque->capacity) {
+        semiDequeEnsureCapacity(gc, deque, deque->capacity + 1);
+    }
+    deque->size++;
+    *semiDequeAt(deque, deque->size - 1) = value;
+}
+
+void semiDequePushFront(GC* gc, ObjectDeque* deque, Value value) {
+    if (deque->size == deque->capacity) {
+        semiDequeEnsureCapacity(gc, deque, deque->capacity + 1);
+    }
+    deque->head                = (deque->head - 1) & (deque->capacity - 1);
+    deque->values[deque->head] = value;
+    deque->size++;
+}
+
+bool semiDequePopBack(ObjectDeque* deque, Value* ret) {
+    if (deque->size == 0) {
+        return false;
+    }
+    *ret = *semiDequeAt(deque, deque->size - 1);
+    deque->size--;
+    return true;
+}
+
+bool semiDequePopFront(ObjectDeque* deque, Value* ret) {
+    if (deque->size == 0) {
+        return false;
+    }
+    *ret        = deque->values[deque->head];
+    deque->head = (deque->head + 1) & (deque->capacity - 1);
+    deque->size--;
+    return true;
+}
+
+void semiDequeRemoveAt(ObjectDeque* deque, uint32_t index) {
+    // Shift whichever side of the removed element is shorter.
+    if (index < deque->size / 2) {
+        for (uint32_t i = index; i > 0; i--) {
+            *semiDequeAt(deque, i) = *semiDequeAt(deque, i - 1);
+        }
+        deque->head = (deque->head + 1) & (deque->capacity - 1);
+    } else {
+        for (uint32_t i = index; i + 1 < deque->size; i++) {
+            *semiDequeAt(deque, i) = *semiDequeAt(deque, i + 1);
+        }
+    }
+    deque->size--;
+}
+
 #pragma endregion
 
 /*
@@ -265,13 +794,7 @@ ObjectDict* semiObjectDictCreate(GC* gc) {
         return NULL;  // Allocation failed
     }
 
-    dict->keyCmpFn  = semiBuiltInEquals;
-    dict->keys      = NULL;
-    dict->tids      = NULL;
-    dict->values    = NULL;
-    dict->indexSize = 0;
-    dict->used      = 0;
-    dict->len       = 0;
+    semiObjectStackDictInit(dict);
     return dict;
 }
 
@@ -279,44 +802,223 @@ void semiObjectStackDictInit(ObjectDict* dict) {
     dict->keyCmpFn  = semiBuiltInEquals;
     dict->keys      = NULL;
     dict->tids      = NULL;
+    dict->ctrl      = NULL;
     dict->values    = NULL;
     dict->indexSize = 0;
     dict->used      = 0;
     dict->len       = 0;
+    dict->keyKind   = OBJECT_DICT_KEYS_NONE;
+    dict->keysOnly  = false;
 }
 
 void semiObjectStackDictCleanup(GC* gc, ObjectDict* dict) {
     semiFree(gc, dict->keys, sizeof(ObjectDictKey) * OBJECT_DICT_MAX_INDEX_LOAD(dict->indexSize));
-    semiFree(gc, dict->tids, sizeof(TupleId) * dict->indexSize);
+    semiFree(gc, dict->tids, OBJECT_DICT_TID_WIDTH(dict->indexSize) * dict->indexSize);
+    semiFree(gc, dict->ctrl, dict->indexSize);
     semiFree(gc, dict->values, sizeof(Value) * OBJECT_DICT_MAX_INDEX_LOAD(dict->indexSize));
 
-    dict->keys      = NULL;
-    dict->tids      = NULL;
-    dict->values    = NULL;
-    dict->indexSize = 0;
-    dict->used      = 0;
-    dict->len       = 0;
+    semiObjectStackDictInit(dict);
 }
 
-// Return the index of an empty slot in the `tid` table for insertion, assuming that the dict
-// has been resized, and that the hash does not exist in the dict.
-static inline TupleId dictFindEmptyIndex(ObjectDict* dict, ValueHash hash) {
-    uint64_t perturb = hash;
-    uint32_t mask    = dict->indexSize - 1;
-    uint32_t index   = hash & mask;
+#define DICT_CTRL_LSBS 0x0101010101010101ull
+#define DICT_CTRL_MSBS 0x8080808080808080ull
 
-    while (true) {
-        if (dict->tids[index] < 0) {
-            return index;  // Found an empty slot
+static inline uint8_t dictHashTag(ValueHash hash) {
+    return (uint8_t)(hash & 0x7F);
+}
+
+static inline uint64_t dictLoadGroup(const ObjectDict* dict, uint32_t group) {
+    uint64_t word;
+    memcpy(&word, dict->ctrl + (size_t)group * OBJECT_DICT_GROUP_WIDTH, sizeof(word));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+    word = __builtin_bswap64(word);
+#endif
+    return word;
+}
+
+// The following return a mask with the top bit of a byte set for each matching control byte, so that the first match
+// is at `countTrailingZeros64(mask) / 8`. `dictGroupMatchTag` may report false positives after a real match, which
+// callers filter by re-checking the control byte.
+static inline uint64_t dictGroupMatchTag(uint64_t group, uint8_t tag) {
+    uint64_t x = group ^ (DICT_CTRL_LSBS * tag);
+    return (x - DICT_CTRL_LSBS) & ~x & DICT_CTRL_MSBS;
+}
+
+static inline uint64_t dictGroupMatchEmpty(uint64_t group) {
+    return group & ~(group << 6) & DICT_CTRL_MSBS;
+}
+
+static inline uint64_t dictGroupMatchEmptyOrDeleted(uint64_t group) {
+    return group & ~(group << 7) & DICT_CTRL_MSBS;
+}
+
+static inline uint32_t dictGroupSlot(uint32_t group, uint64_t mask) {
+    return group * OBJECT_DICT_GROUP_WIDTH + countTrailingZeros64(mask) / 8;
+}
+
+// Groups are visited in triangular order, which covers every group when the group count is a power of two.
+#define DICT_PROBE_START(dict, hash) ((uint32_t)((hash) >> 7) & ((dict)->indexSize / OBJECT_DICT_GROUP_WIDTH - 1))
+#define DICT_PROBE_NEXT(dict, group, step) \
+    (((group) + (step)) & ((dict)->indexSize / OBJECT_DICT_GROUP_WIDTH - 1))
+
+// Return the index of an empty slot in the index table for insertion, assuming that the dict
+// has been resized, and that the hash does not exist in the dict.
+static inline uint32_t dictFindEmptyIndex(ObjectDict* dict, ValueHash hash) {
+    uint32_t group = DICT_PROBE_START(dict, hash);
+    for (uint32_t step = 1;; step++) {
+        uint64_t available = dictGroupMatchEmptyOrDeleted(dictLoadGroup(dict, group));
+        if (available != 0) {
+            return dictGroupSlot(group, available);
         }
+        group = DICT_PROBE_NEXT(dict, group, step);
+    }
+}
 
-        // Probing the next slot index with linear congruential generator
-        perturb >>= 5;
-        index = (uint32_t)(perturb + 1 + index * 5) & mask;
+static inline uint32_t dictGetTid(const ObjectDict* dict, uint32_t slot) {
+    switch (OBJECT_DICT_TID_WIDTH(dict->indexSize)) {
+        case 1:
+            return ((const uint8_t*)dict->tids)[slot];
+        case 2:
+            return ((const uint16_t*)dict->tids)[slot];
+        default:
+            return ((const uint32_t*)dict->tids)[slot];
     }
+}
 
-    SEMI_UNREACHABLE();
-    return -1;
+static inline void dictSetTid(ObjectDict* dict, uint32_t slot, uint32_t tid) {
+    switch (OBJECT_DICT_TID_WIDTH(dict->indexSize)) {
+        case 1:
+            ((uint8_t*)dict->tids)[slot] = (uint8_t)tid;
+            break;
+        case 2:
+            ((uint16_t*)dict->tids)[slot] = (uint16_t)tid;
+            break;
+        default:
+            ((uint32_t*)dict->tids)[slot] = tid;
+            break;
+    }
+}
+
+static inline ObjectDictKeyKind dictKeyKindOf(const ObjectDict* dict, Value key) {
+    if (dict->keyCmpFn != semiBuiltInEquals) {
+        return OBJECT_DICT_KEYS_MIXED;
+    }
+    if (IS_INT(&key)) {
+        return OBJECT_DICT_KEYS_INT;
+    }
+    if (IS_STRING(&key)) {
+        return OBJECT_DICT_KEYS_STRING;
+    }
+    return OBJECT_DICT_KEYS_MIXED;
+}
+
+static inline void dictTrackKeyKind(ObjectDict* dict, Value key) {
+    if (dict->keyKind == OBJECT_DICT_KEYS_MIXED) {
+        return;
+    }
+    ObjectDictKeyKind kind = dictKeyKindOf(dict, key);
+    if (dict->keyKind != OBJECT_DICT_KEYS_NONE && dict->keyKind != kind) {
+        kind = OBJECT_DICT_KEYS_MIXED;
+    }
+    dict->keyKind = (uint8_t)kind;
+}
+
+static inline bool dictIntKeyEquals(const ObjectDict* dict, Value a, Value b) {
+    (void)dict;
+    return AS_INT(&a) == AS_INT(&b);
+}
+
+static inline bool dictStringKeyEquals(const ObjectDict* dict, Value a, Value b) {
+    (void)dict;
+    const char *aStr, *bStr;
+    size_t aLength, bLength;
+    stringView(&a, &aStr, &aLength);
+    stringView(&b, &bStr, &bLength);
+    return aLength == bLength && memcmp(aStr, bStr, aLength) == 0;
+}
+
+static inline bool dictGenericKeyEquals(const ObjectDict* dict, Value a, Value b) {
+    return dict->keyCmpFn(a, b);
+}
+
+// Return the index slot holding the key, or -1 if it does not exist. One copy is generated per
+// TID width and key kind so that the probe loop does not re-dispatch for every candidate.
+#define DICT_FIND_INDEX_FN(name, TidType, keyEquals)                                              \
+    static int64_t name(ObjectDict* dict, Value key, ValueHash hash) {                            \
+        const TidType* tids = (const TidType*)dict->tids;                                         \
+        uint8_t tag         = dictHashTag(hash);                                                  \
+        uint32_t group      = DICT_PROBE_START(dict, hash);                                       \
+        for (uint32_t step = 1;; step++) {                                                        \
+            uint64_t ctrl = dictLoadGroup(dict, group);                                           \
+            for (uint64_t match = dictGroupMatchTag(ctrl, tag); match != 0; match &= match - 1) { \
+                uint32_t slot = dictGroupSlot(group, match);                                      \
+                if (dict->ctrl[slot] != tag) {                                                    \
+                    continue;                                                                     \
+                }                                                                                 \
+                TidType tid = tids[slot];                                                         \
+                if (dict->keys[tid].hash == hash && keyEquals(dict, dict->keys[tid].key, key)) {  \
+                    return slot;                                                                  \
+                }                                                                                 \
+            }                                                                                     \
+            if (dictGroupMatchEmpty(ctrl) != 0) {                                                 \
+                return -1;                                                                        \
+            }                                                                                     \
+            group = DICT_PROBE_NEXT(dict, group, step);                                           \
+        }                                                                                         \
+    }
+
+#define DICT_FIND_INDEX_WIDTHS(kind, keyEquals)                      \
+    DICT_FIND_INDEX_FN(dictFind##kind##Index8, uint8_t, keyEquals)   \
+    DICT_FIND_INDEX_FN(dictFind##kind##Index16, uint16_t, keyEquals) \
+    DICT_FIND_INDEX_FN(dictFind##kind##Index32, uint32_t, keyEquals)
+
+DICT_FIND_INDEX_WIDTHS(Int, dictIntKeyEquals)
+DICT_FIND_INDEX_WIDTHS(String, dictStringKeyEquals)
+DICT_FIND_INDEX_WIDTHS(Generic, dictGenericKeyEquals)
+
+#undef DICT_FIND_INDEX_WIDTHS
+#undef DICT_FIND_INDEX_FN
+
+#define DICT_FIND_INDEX_DISPATCH(kind, dict, key, hash)            \
+    switch (OBJECT_DICT_TID_WIDTH((dict)->indexSize)) {            \
+        case 1:                                                    \
+            return dictFind##kind##Index8((dict), (key), (hash));  \
+        case 2:                                                    \
+            return dictFind##kind##Index16((dict), (key), (hash)); \
+        default:                                                   \
+            return dictFind##kind##Index32((dict), (key), (hash)); \
+    }
+
+static inline int64_t dictFindIndex(ObjectDict* dict, Value key, ValueHash hash) {
+    switch (dict->keyKind) {
+        case OBJECT_DICT_KEYS_INT:
+            if (!IS_INT(&key)) {
+                return -1;  // Only an int can equal an int
+            }
+            DICT_FIND_INDEX_DISPATCH(Int, dict, key, hash);
+
+        case OBJECT_DICT_KEYS_STRING:
+            if (!IS_STRING(&key)) {
+                return -1;  // Only a string can equal a string
+            }
+            DICT_FIND_INDEX_DISPATCH(String, dict, key, hash);
+
+        default:
+            DICT_FIND_INDEX_DISPATCH(Generic, dict, key, hash);
+    }
+}
+
+#undef DICT_FIND_INDEX_DISPATCH
+
+// Equivalent to `semiBuiltInHash`, with the common key types handled without a call.
+static inline ValueHash dictHashKey(Value key) {
+    if (IS_INT(&key)) {
+        return semiHash64Bits((uint64_t)AS_INT(&key));
+    }
+    if (IS_OBJECT_STRING(&key)) {
+        return AS_OBJECT_STRING(&key)->hash;
+    }
+    return semiBuiltInHash(key);
 }
 
 // Return the Tuple ID of the key.
@@ -325,28 +1027,51 @@ TupleId semiDictFindTupleId(ObjectDict* dict, Value key, ValueHash hash) {
         return -1;  // Empty dictionary
     }
 
-    uint64_t perturb = hash;
-    uint32_t mask    = dict->indexSize - 1;
-    uint32_t index   = hash & mask;
+    int64_t slot = dictFindIndex(dict, key, hash);
+    return slot < 0 ? -1 : (TupleId)dictGetTid(dict, (uint32_t)slot);
+}
 
-    while (true) {
-        TupleId tid = dict->tids[index];
-        if (tid == OBJECT_DICT_KEY_EMPTY) {
-            return -1;  // Not found
-        }
-        if (tid >= 0) {
-            if (dict->keys[tid].hash == hash && dict->keyCmpFn(dict->keys[tid].key, key)) {
-                return tid;  // Found
-            }
+static bool dictAllocateIndex(GC* gc, ObjectDict* dict, uint32_t indexSize) {
+    void* tids    = semiMalloc(gc, OBJECT_DICT_TID_WIDTH(indexSize) * indexSize);
+    uint8_t* ctrl = (uint8_t*)semiMalloc(gc, indexSize);
+    if (!tids || !ctrl) {
+        semiFree(gc, tids, OBJECT_DICT_TID_WIDTH(indexSize) * indexSize);
+        semiFree(gc, ctrl, indexSize);
+        return false;  // Allocation failed
+    }
+    memset(ctrl, OBJECT_DICT_CTRL_EMPTY, indexSize);
+
+    semiFree(gc, dict->tids, OBJECT_DICT_TID_WIDTH(dict->indexSize) * dict->indexSize);
+    semiFree(gc, dict->ctrl, dict->indexSize);
+    dict->tids      = tids;
+    dict->ctrl      = ctrl;
+    dict->indexSize = indexSize;
+    return true;
+}
+
+// Rebuild the index and squeeze deleted entries out of the tuple table, keeping insertion order.
+// The index must already be cleared to `OBJECT_DICT_CTRL_EMPTY`.
+static void dictCompact(ObjectDict* dict) {
+    uint32_t toBeFilled = 0;
+    dict->keyKind       = OBJECT_DICT_KEYS_NONE;
+    for (uint32_t curr = 0; curr < dict->used; curr += 1) {
+        if (IS_INVALID(&dict->keys[curr].key)) {
+            continue;
         }
 
-        // Probing the next slot index with linear congruential generator
-        perturb >>= 5;
-        index = (uint32_t)(perturb + 1 + index * 5) & mask;
-    }
+        ValueHash hash         = dict->keys[curr].hash;
+        uint32_t emptyIndex    = dictFindEmptyIndex(dict, hash);
+        dict->ctrl[emptyIndex] = dictHashTag(hash);
+        dictSetTid(dict, emptyIndex, toBeFilled);
+        dictTrackKeyKind(dict, dict->keys[curr].key);
 
-    SEMI_UNREACHABLE();
-    return -1;
+        dict->keys[toBeFilled] = dict->keys[curr];
+        if (!dict->keysOnly) {
+            dict->values[toBeFilled] = dict->values[curr];
+        }
+        toBeFilled += 1;
+    }
+    dict->used = toBeFilled;
 }
 
 static bool dictResize(GC* gc, ObjectDict* dict) {
@@ -355,53 +1080,34 @@ static bool dictResize(GC* gc, ObjectDict* dict) {
         indexSize = OBJECT_DICT_MIN_INDEX_SIZE;
     }
     if (indexSize == dict->indexSize) {
+        memset(dict->ctrl, OBJECT_DICT_CTRL_EMPTY, dict->indexSize);
+        dictCompact(dict);
         return true;
     }
 
     uint32_t oldTupleTableSize = OBJECT_DICT_MAX_INDEX_LOAD(dict->indexSize);
     uint32_t newTupleTableSize = OBJECT_DICT_MAX_INDEX_LOAD(indexSize);
-
-    TupleId* newTIDs =
-        (TupleId*)semiRealloc(gc, dict->tids, sizeof(TupleId) * dict->indexSize, sizeof(TupleId) * indexSize);
-    if (!newTIDs) {
-        return false;  // Allocation failed
+    if (!dictAllocateIndex(gc, dict, indexSize)) {
+        return false;
     }
+    dictCompact(dict);
 
-    // Initialize new tids array to empty
-    for (uint32_t i = 0; i < indexSize; i++) {
-        newTIDs[i] = OBJECT_DICT_KEY_EMPTY;
+    ObjectDictKey* newKeys = (ObjectDictKey*)semiRealloc(
+        gc, dict->keys, sizeof(ObjectDictKey) * oldTupleTableSize, sizeof(ObjectDictKey) * newTupleTableSize);
+    if (!newKeys) {
+        return false;
     }
-
-    ObjectDict tempDict = {.tids = newTIDs, .indexSize = indexSize};
-
-    uint32_t toBeFilled = 0;
-    for (uint32_t curr = 0; curr < oldTupleTableSize; curr += 1) {
-        if (IS_INVALID(&dict->keys[curr].key)) {
-            continue;
-        }
-
-        ValueHash hash      = dict->keys[curr].hash;
-        TupleId emptyIndex  = dictFindEmptyIndex(&tempDict, hash);
-        newTIDs[emptyIndex] = toBeFilled;
-
-        dict->keys[toBeFilled]   = dict->keys[curr];
-        dict->values[toBeFilled] = dict->values[curr];
-        toBeFilled += 1;
+    dict->keys = newKeys;
+    if (dict->keysOnly) {
+        return true;
     }
 
-    ObjectDictKey* newKeys = (ObjectDictKey*)semiRealloc(
-        gc, dict->keys, sizeof(ObjectDictKey) * oldTupleTableSize, sizeof(ObjectDictKey) * newTupleTableSize);
     Value* newValues =
         (Value*)semiRealloc(gc, dict->values, sizeof(Value) * oldTupleTableSize, sizeof(Value) * newTupleTableSize);
-    if (!newKeys || !newValues) {
+    if (!newValues) {
         return false;
     }
-
-    dict->tids      = newTIDs;
-    dict->keys      = newKeys;
-    dict->values    = newValues;
-    dict->indexSize = indexSize;
-    dict->used      = dict->len;
+    dict->values = newValues;
     return true;
 }
 
@@ -410,7 +1116,7 @@ bool semiDictHas(ObjectDict* dict, Value key) {
         return false;  // Empty dictionary
     }
 
-    ValueHash hash = semiBuiltInHash(key);
+    ValueHash hash = dictHashKey(key);
     TupleId tid    = semiDictFindTupleId(dict, key, hash);
     return tid >= 0;
 }
@@ -429,7 +1135,7 @@ Value semiDictGet(ObjectDict* dict, Value key) {
         return INVALID_VALUE;  // Empty dictionary
     }
 
-    ValueHash hash = semiBuiltInHash(key);
+    ValueHash hash = dictHashKey(key);
     TupleId tid    = semiDictFindTupleId(dict, key, hash);
     if (tid < 0) {
         return INVALID_VALUE;  // Not found
@@ -449,24 +1155,22 @@ Value semiDictGetWithHash(ObjectDict* dict, Value key, ValueHash hash) {
 
 bool semiDictSetWithHash(GC* gc, ObjectDict* dict, Value key, Value value, ValueHash hash) {
     if (dict->keys == NULL) {
-        dict->indexSize         = OBJECT_DICT_MIN_INDEX_SIZE;
         uint32_t tupleTableSize = OBJECT_DICT_MAX_INDEX_LOAD(OBJECT_DICT_MIN_INDEX_SIZE);
-        dict->tids              = (TupleId*)semiMalloc(gc, sizeof(TupleId) * dict->indexSize);
         dict->keys              = (ObjectDictKey*)semiMalloc(gc, sizeof(ObjectDictKey) * tupleTableSize);
-        dict->values            = (Value*)semiMalloc(gc, sizeof(Value) * tupleTableSize);
-        if (!dict->keys || !dict->tids || !dict->values) {
-            return false;  // Allocation failed
+        if (!dict->keysOnly) {
+            dict->values = (Value*)semiMalloc(gc, sizeof(Value) * tupleTableSize);
         }
-
-        // Initialize tids array to empty
-        for (uint32_t i = 0; i < dict->indexSize; i++) {
-            dict->tids[i] = OBJECT_DICT_KEY_EMPTY;
+        if (!dict->keys || (!dict->keysOnly && !dict->values) ||
+            !dictAllocateIndex(gc, dict, OBJECT_DICT_MIN_INDEX_SIZE)) {
+            return false;  // Allocation failed
         }
     }
 
     TupleId tid = semiDictFindTupleId(dict, key, hash);
     if (tid >= 0) {
-        dict->values[tid] = value;
+        if (!dict->keysOnly) {
+            dict->values[tid] = value;
+        }
         return true;
     }
 
@@ -474,52 +1178,202 @@ bool semiDictSetWithHash(GC* gc, ObjectDict* dict, Value key, Value value, Value
         dictResize(gc, dict);
     }
 
-    TupleId emptyIndex = dictFindEmptyIndex(dict, hash);
-    if (emptyIndex < 0) {
-        return false;  // No free slot found
-    }
-    dict->tids[emptyIndex] = dict->used;
+    uint32_t emptyIndex    = dictFindEmptyIndex(dict, hash);
+    dict->ctrl[emptyIndex] = dictHashTag(hash);
+    dictSetTid(dict, emptyIndex, dict->used);
+    dictTrackKeyKind(dict, key);
     dict->keys[dict->used] = (ObjectDictKey){
         .hash = hash,
         .key  = key,
     };
-    dict->values[dict->used] = value;
+    if (!dict->keysOnly) {
+        dict->values[dict->used] = value;
+    }
     dict->used++;
     dict->len++;
     return true;
 }
 
 bool semiDictSet(GC* gc, ObjectDict* dict, Value key, Value value) {
-    ValueHash hash = semiBuiltInHash(key);
+    ValueHash hash = dictHashKey(key);
     return semiDictSetWithHash(gc, dict, key, value, hash);
 }
 
-Value semiDictDelete(GC* gc, ObjectDict* dict, Value key) {
+// Return the deleted value, or the deleted key for a keys-only dict.
+static Value dictDeleteWithHash(GC* gc, ObjectDict* dict, Value key, ValueHash hash) {
     if (dict->keys == NULL) {
         return INVALID_VALUE;  // Empty dictionary
     }
 
-    ValueHash hash = semiBuiltInHash(key);
-    TupleId tid    = semiDictFindTupleId(dict, key, hash);
-    if (tid < 0) {
+    int64_t slot = dictFindIndex(dict, key, hash);
+    if (slot < 0) {
         return INVALID_VALUE;  // Not found
     }
 
-    Value deletedValue = dict->values[tid];
+    uint32_t tid       = dictGetTid(dict, (uint32_t)slot);
+    Value deletedValue = dict->keysOnly ? dict->keys[tid].key : dict->values[tid];
 
-    dict->tids[tid]            = OBJECT_DICT_KEY_TOMBSTONE;
+    dict->ctrl[slot]           = OBJECT_DICT_CTRL_DELETED;
     dict->keys[tid].key.header = VALUE_TYPE_INVALID;
-    dict->values[tid].header   = VALUE_TYPE_INVALID;
+    if (!dict->keysOnly) {
+        dict->values[tid].header = VALUE_TYPE_INVALID;
+    }
     dict->len--;
 
-    // After resizing, `used` = `len` and we want to make sure `used <<< newIndexSize * 2/3`.
+    // After resizing, `used` = `len` and we want to make sure `used <<< newIndexSize * 2/3`. Otherwise, once
+    // deleted entries make up most of the tuple table, compact in place so scans stay proportional to `len`.
+    uint32_t deleted = dict->used - dict->len;
     if (dict->indexSize > OBJECT_DICT_MIN_INDEX_SIZE && dict->len < dict->indexSize / 8) {
         dictResize(gc, dict);
+    } else if (deleted >= OBJECT_DICT_MIN_INDEX_SIZE && deleted > dict->len) {
+        memset(dict->ctrl, OBJECT_DICT_CTRL_EMPTY, dict->indexSize);
+        dictCompact(dict);
     }
 
     return deletedValue;
 }
 
+Value semiDictDelete(GC* gc, ObjectDict* dict, Value key) {
+    return dictDeleteWithHash(gc, dict, key, dictHashKey(key));
+}
+
+// Delete the tuples whose entry in `isDeleted` is set, without looking up their keys, and squeeze them out of the tuple
+// table, so that the Tuple IDs of the remaining entries are their positions in insertion order.
+void semiDictDeleteTuples(ObjectDict* dict, const bool* isDeleted) {
+    for (uint32_t tid = 0; tid < dict->used; tid++) {
+        if (!isDeleted[tid] || IS_INVALID(&dict->keys[tid].key)) {
+            continue;
+        }
+        dict->keys[tid].key.header = VALUE_TYPE_INVALID;
+        if (!dict->keysOnly) {
+            dict->values[tid].header = VALUE_TYPE_INVALID;
+        }
+        dict->len--;
+    }
+    if (dict->used != dict->len) {
+        memset(dict->ctrl, OBJECT_DICT_CTRL_EMPTY, dict->indexSize);
+        dictCompact(dict);
+    }
+}
+
+#pragma endregion
+
+/*
+ │ ObjectSet
+─┴───────────────────────────────────────────────────────────────────────────────────────────────*/
+#pragma region
+
+ObjectSet* semiObjectSetCreate(GC* gc) {
+    ObjectSet* set = (ObjectSet*)newObject(gc, OBJECT_TYPE_SET, sizeof(ObjectSet));
+    if (!set) {
+        return NULL;  // Allocation failed
+    }
+
+    semiObjectStackDictInit(set);
+    set->keysOnly = true;
+    return set;
+}
+
+bool semiSetAdd(GC* gc, ObjectSet* set, Value key) {
+    return semiDictSetWithHash(gc, set, key, INVALID_VALUE, dictHashKey(key));
+}
+
+bool semiSetRemove(GC* gc, ObjectSet* set, Value key) {
+    Value removed = dictDeleteWithHash(gc, set, key, dictHashKey(key));
+    return !IS_INVALID(&removed);
+}
+
+// Create a set holding the same keys as `src`. The tables are copied as they are, so no key is rehashed.
+static ObjectSet* setClone(GC* gc, ObjectSet* src) {
+    ObjectSet* set = semiObjectSetCreate(gc);
+    if (!set || src->keys == NULL) {
+        return set;
+    }
+
+    uint32_t tupleTableSize = OBJECT_DICT_MAX_INDEX_LOAD(src->indexSize);
+    set->keys               = (ObjectDictKey*)semiMalloc(gc, sizeof(ObjectDictKey) * tupleTableSize);
+    if (!set->keys || !dictAllocateIndex(gc, set, src->indexSize)) {
+        return NULL;  // Allocation failed
+    }
+    memcpy(set->keys, src->keys, sizeof(ObjectDictKey) * src->used);
+    memcpy(set->ctrl, src->ctrl, src->indexSize);
+    memcpy(set->tids, src->tids, OBJECT_DICT_TID_WIDTH(src->indexSize) * src->indexSize);
+    set->keyCmpFn = src->keyCmpFn;
+    set->keyKind  = src->keyKind;
+    set->used     = src->used;
+    set->len      = src->len;
+    return set;
+}
+
+// Copy the larger side and add whatever the smaller side has on top.
+ObjectSet* semiSetUnion(GC* gc, ObjectSet* a, ObjectSet* b) {
+    ObjectSet* larger  = a->len >= b->len ? a : b;
+    ObjectSet* smaller = a->len >= b->len ? b : a;
+    ObjectSet* set     = setClone(gc, larger);
+    if (!set) {
+        return NULL;
+    }
+
+    uint32_t cursor = 0;
+    TupleId tid;
+    while ((tid = semiDictNextTupleId(smaller, &cursor)) >= 0) {
+        if (!semiDictSetWithHash(gc, set, smaller->keys[tid].key, INVALID_VALUE, smaller->keys[tid].hash)) {
+            return NULL;
+        }
+    }
+    return set;
+}
+
+// Probe the larger side with the keys of the smaller one, keeping the order of the smaller side.
+ObjectSet* semiSetIntersection(GC* gc, ObjectSet* a, ObjectSet* b) {
+    ObjectSet* larger  = a->len >= b->len ? a : b;
+    ObjectSet* smaller = a->len >= b->len ? b : a;
+    ObjectSet* set     = semiObjectSetCreate(gc);
+    if (!set) {
+        return NULL;
+    }
+
+    uint32_t cursor = 0;
+    TupleId tid;
+    while ((tid = semiDictNextTupleId(smaller, &cursor)) >= 0) {
+        ObjectDictKey* entry = &smaller->keys[tid];
+        if (semiDictHasWithHash(larger, entry->key, entry->hash) &&
+            !semiDictSetWithHash(gc, set, entry->key, INVALID_VALUE, entry->hash)) {
+            return NULL;
+        }
+    }
+    return set;
+}
+
+// Either filter `a` by probing `b`, or copy `a` and remove the keys of `b`, whichever walks fewer keys.
+ObjectSet* semiSetDifference(GC* gc, ObjectSet* a, ObjectSet* b) {
+    uint32_t cursor = 0;
+    TupleId tid;
+    if (b->len < a->len) {
+        ObjectSet* set = setClone(gc, a);
+        if (!set) {
+            return NULL;
+        }
+        while ((tid = semiDictNextTupleId(b, &cursor)) >= 0 && set->len > 0) {
+            dictDeleteWithHash(gc, set, b->keys[tid].key, b->keys[tid].hash);
+        }
+        return set;
+    }
+
+    ObjectSet* set = semiObjectSetCreate(gc);
+    if (!set) {
+        return NULL;
+    }
+    while ((tid = semiDictNextTupleId(a, &cursor)) >= 0) {
+        ObjectDictKey* entry = &a->keys[tid];
+        if (!semiDictHasWithHash(b, entry->key, entry->hash) &&
+            !semiDictSetWithHash(gc, set, entry->key, INVALID_VALUE, entry->hash)) {
+            return NULL;
+        }
+    }
+    return set;
+}
+
 #pragma endregion
 
 /*
@@ -545,10 +1399,12 @@ FunctionProto* semiFunctionProtoCreate(GC* gc, uint8_t upvalueCount) {
         return NULL;  // Allocation failed
     }
 
-    o->arity        = 0;
-    o->coarity      = 0;
-    o->maxStackSize = 0;
-    o->upvalueCount = upvalueCount;
+    o->attrCaches     = NULL;
+    o->attrCacheCount = 0;
+    o->arity          = 0;
+    o->coarity        = 0;
+    o->maxStackSize   = 0;
+    o->upvalueCount   = upvalueCount;
     ChunkInit(&o->chunk);
     memset(o->upvalues, 0, sizeof(UpvalueDescription) * upvalueCount);
     return o;
@@ -557,6 +1413,7 @@ FunctionProto* semiFunctionProtoCreate(GC* gc, uint8_t upvalueCount) {
 
 void semiFunctionProtoDestroy(GC* gc, FunctionProto* function) {
     ChunkCleanup(gc, &function->chunk);
+    semiFree(gc, function->attrCaches, sizeof(AttrCache) * function->attrCacheCount);
     semiFree(gc, function, sizeof(FunctionProto) + sizeof(UpvalueDescription) * function->upvalueCount);
 }
 
@@ -600,3 +1457,275 @@ ObjectFunction* semiObjectFunctionCreate(GC* gc, FunctionProto* proto) {
 }
 
 #pragma endregion
+
+/*
+ │ Object Struct
+─┴───────────────────────────────────────────────────────────────────────────────────────────────*/
+#pragma region
+
+ObjectStruct* semiObjectStructCreate(GC* gc, uint16_t fieldCount) {
+    ObjectStruct* o =
+        (ObjectStruct*)newObject(gc, OBJECT_TYPE_STRUCT, sizeof(ObjectStruct) + sizeof(Value) * fieldCount);
+    if (!o) {
+        return NULL;  // Allocation failed
+    }
+
+    o->fieldCount = fieldCount;
+    for (uint16_t i = 0; i < fieldCount; i++) {
+        o->fields[i] = INVALID_VALUE;
+    }
+    return o;
+}
+
+ErrorId semiStructGetField(const Value* object, uint16_t slot, Value* ret) {
+    if (!IS_STRUCT_VIEW(object)) {
+        *ret = AS_STRUCT(object)->fields[slot];
+        return 0;
+    }
+
+    ObjectStructView* view = AS_STRUCT_VIEW(object);
+    if (view->row >= view->list->size) {
+        return SEMI_ERROR_INDEX_OOB;
+    }
+    *ret = semiColumnarListGet(view->list, view->row, slot);
+    return 0;
+}
+
+ErrorId semiStructSetField(GC* gc, Value* object, uint16_t slot, Value value) {
+    if (!IS_STRUCT_VIEW(object)) {
+        AS_STRUCT(object)->fields[slot] = value;
+        return 0;
+    }
+
+    ObjectStructView* view = AS_STRUCT_VIEW(object);
+    if (view->row >= view->list->size) {
+        return SEMI_ERROR_INDEX_OOB;
+    }
+    return semiColumnarListSet(gc, view->list, view->row, slot, value) ? 0 : SEMI_ERROR_MEMORY_ALLOCATION_FAILURE;
+}
+
+#pragma endregion
+
+/*
+ │ Columnar List
+─┴───────────────────────────────────────────────────────────────────────────────────────────────*/
+#pragma region
+
+static inline size_t columnElementSize(uint8_t kind) {
+    switch (kind) {
+        case LIST_ELEMENT_KIND_INT:
+            return sizeof(IntValue);
+        case LIST_ELEMENT_KIND_FLOAT:
+            return sizeof(FloatValue);
+        case LIST_ELEMENT_KIND_MIXED:
+            return sizeof(Value);
+        default:
+            return 0;
+    }
+}
+
+ObjectColumnarList* semiObjectColumnarListCreate(GC* gc, TypeId typeId, uint16_t columnCount, uint32_t capacity) {
+    ObjectColumnarList* o = (ObjectColumnarList*)newObject(
+        gc, OBJECT_TYPE_COLUMNAR_LIST, sizeof(ObjectColumnarList) + sizeof(ListColumn) * columnCount);
+    if (!o) {
+        return NULL;  // Allocation failed
+    }
+
+    o->typeId      = typeId;
+    o->columnCount = columnCount;
+    o->size        = 0;
+    o->capacity    = capacity;
+    for (uint16_t i = 0; i < columnCount; i++) {
+        o->columns[i].kind      = LIST_ELEMENT_KIND_EMPTY;
+        o->columns[i].as.values = NULL;
+    }
+    return o;
+}
+
+void semiObjectColumnarListDestroy(GC* gc, ObjectColumnarList* list) {
+    for (uint16_t i = 0; i < list->columnCount; i++) {
+        ListColumn* column = &list->columns[i];
+        semiFree(gc, column->as.values, columnElementSize(column->kind) * list->capacity);
+    }
+    semiFree(gc, list, sizeof(ObjectColumnarList) + sizeof(ListColumn) * list->columnCount);
+}
+
+static bool columnarListEnsureCapacity(GC* gc, ObjectColumnarList* list, uint32_t capacity) {
+    if (list->capacity >= capacity) {
+        return true;
+    }
+
+    uint32_t newCapacity = nextPowerOfTwoCapacity(capacity);
+    for (uint16_t i = 0; i < list->columnCount; i++) {
+        ListColumn* column = &list->columns[i];
+        size_t elementSize = columnElementSize(column->kind);
+        if (elementSize == 0) {
+            continue;
+        }
+
+        void* data = semiRealloc(gc, column->as.values, elementSize * list->capacity, elementSize * newCapacity);
+        if (data == NULL) {
+            return false;
+        }
+        column->as.values = data;
+    }
+    list->capacity = newCapacity;
+    return true;
+}
+
+bool semiColumnarListSet(GC* gc, ObjectColumnarList* list, uint32_t row, uint16_t column, Value value) {
+    ListColumn* c        = &list->columns[column];
+    ListElementKind kind = semiListElementKindOf(&value);
+
+    if (c->kind == LIST_ELEMENT_KIND_EMPTY) {
+        Value* data = semiMalloc(gc, columnElementSize(kind) * list->capacity);
+        if (data == NULL) {
+            return false;
+        }
+        c->kind      = (uint8_t)kind;
+        c->as.values = data;
+    } else if (c->kind != kind && c->kind != LIST_ELEMENT_KIND_MIXED) {
+        // Widen the packed column to values.
+        Value* data = semiMalloc(gc, sizeof(Value) * list->capacity);
+        if (data == NULL) {
+            return false;
+        }
+        for (uint32_t i = 0; i < list->size; i++) {
+            data[i] = semiColumnarListGet(list, i, column);
+        }
+        semiFree(gc, c->as.values, columnElementSize(c->kind) * list->capacity);
+        c->kind      = LIST_ELEMENT_KIND_MIXED;
+        c->as.values = data;
+    }
+
+    switch (c->kind) {
+        case LIST_ELEMENT_KIND_INT:
+            c->as.ints[row] = AS_INT(&value);
+            break;
+        case LIST_ELEMENT_KIND_FLOAT:
+            c->as.floats[row] = AS_FLOAT(&value);
+            break;
+        default:
+            c->as.values[row] = value;
+            break;
+    }
+    return true;
+}
+
+ErrorId semiColumnarListSetRow(GC* gc, ObjectColumnarList* list, uint32_t row, const Value* item) {
+    if (!IS_STRUCT(item) || BASE_TYPE(item) != list->typeId) {
+        return SEMI_ERROR_UNEXPECTED_TYPE;
+    }
+    if (row == list->size && !columnarListEnsureCapacity(gc, list, list->size + 1)) {
+        return SEMI_ERROR_MEMORY_ALLOCATION_FAILURE;
+    }
+
+    for (uint16_t i = 0; i < list->columnCount; i++) {
+        Value field;
+        ErrorId errorId = semiStructGetField(item, i, &field);
+        if (errorId != 0) {
+            return errorId;
+        }
+        if (!semiColumnarListSet(gc, list, row, i, field)) {
+            return SEMI_ERROR_MEMORY_ALLOCATION_FAILURE;
+        }
+    }
+    return 0;
+}
+
+ErrorId semiColumnarListAppend(GC* gc, ObjectColumnarList* list, const Value* item) {
+    ErrorId errorId = semiColumnarListSetRow(gc, list, list->size, item);
+    if (errorId == 0) {
+        list->size++;
+    }
+    return errorId;
+}
+
+void semiColumnarListRemove(GC* gc, ObjectColumnarList* list, uint32_t row) {
+    uint32_t tailCount = list->size - row - 1;
+    for (uint16_t i = 0; i < list->columnCount; i++) {
+        ListColumn* column = &list->columns[i];
+        size_t elementSize = columnElementSize(column->kind);
+        char* data         = (char*)column->as.values;
+        memmove(data + elementSize * row, data + elementSize * (row + 1), elementSize * tailCount);
+    }
+    list->size--;
+
+    // An emptied list packs its columns again.
+    if (list->size == 0) {
+        for (uint16_t i = 0; i < list->columnCount; i++) {
+            ListColumn* column = &list->columns[i];
+            semiFree(gc, column->as.values, columnElementSize(column->kind) * list->capacity);
+            column->kind      = LIST_ELEMENT_KIND_EMPTY;
+            column->as.values = NULL;
+        }
+    }
+}
+
+Value semiColumnarListMaterialize(GC* gc, const ObjectColumnarList* list, uint32_t row) {
+    Value value = semiValueStructCreate(gc, list->typeId, list->columnCount);
+    if (IS_VALID(&value)) {
+        ObjectStruct* object = AS_STRUCT(&value);
+        for (uint16_t i = 0; i < list->columnCount; i++) {
+            object->fields[i] = semiColumnarListGet(list, row, i);
+        }
+    }
+    return value;
+}
+
+IntValue semiColumnarListIndex(const ObjectColumnarList* list, const Value* item) {
+    if (!IS_STRUCT(item) || BASE_TYPE(item) != list->typeId) {
+        return -1;
+    }
+    if (IS_STRUCT_VIEW(item) && AS_STRUCT_VIEW(item)->list == list && AS_STRUCT_VIEW(item)->row < list->size) {
+        return AS_STRUCT_VIEW(item)->row;
+    }
+
+    for (uint32_t row = 0; row < list->size; row++) {
+        uint16_t i = 0;
+        for (; i < list->columnCount; i++) {
+            Value field;
+            if (semiStructGetField(item, i, &field) != 0 ||
+                !semiBuiltInEquals(semiColumnarListGet(list, row, i), field)) {
+                break;
+            }
+        }
+        if (i == list->columnCount) {
+            return row;
+        }
+    }
+    return -1;
+}
+
+ObjectColumnarList* semiColumnarListSlice(
+    GC* gc, const ObjectColumnarList* list, uint32_t start, uint32_t end, uint32_t step) {
+    uint32_t count            = end > start ? (end - start + step - 1) / step : 0;
+    ObjectColumnarList* slice = semiObjectColumnarListCreate(gc, list->typeId, list->columnCount, count);
+    if (slice == NULL) {
+        return NULL;
+    }
+
+    for (uint32_t row = 0; row < count; row++) {
+        for (uint16_t i = 0; i < list->columnCount; i++) {
+            // The partial slice is left to the GC.
+            if (!semiColumnarListSet(gc, slice, row, i, semiColumnarListGet(list, start + row * step, i))) {
+                return NULL;
+            }
+        }
+        slice->size++;
+    }
+    return slice;
+}
+
+ObjectStructView* semiObjectStructViewCreate(GC* gc, ObjectColumnarList* list, uint32_t row) {
+    ObjectStructView* o = (ObjectStructView*)newObject(gc, OBJECT_TYPE_STRUCT_VIEW, sizeof(ObjectStructView));
+    if (!o) {
+        return NULL;  // Allocation failed
+    }
+
+    o->list = list;
+    o->row  = row;
+    return o;
+}
+
+#pragma endregion
@@ -21,9 +21,9 @@ typedef uint16_t ModuleId;
 #define SEMI_REPL_MODULE_ID   ((ModuleId)(0))
 #define SEMI_SYSTEM_MODULE_ID ((ModuleId)(UINT16_MAX))
 
-typedef uint16_t ModuleVariableId;
+typedef uint32_t ModuleVariableId;
 
-#define INVALID_MODULE_VARIABLE_ID ((ModuleVariableId)(UINT16_MAX))
+#define INVALID_MODULE_VARIABLE_ID ((ModuleVariableId)(UINT32_MAX))
 
 typedef uint32_t PCLocation;
 
@@ -86,10 +86,13 @@ typedef enum {
     BASE_VALUE_TYPE_FUNCTION,
     BASE_VALUE_TYPE_FUNCTION_PROTO,
     BASE_VALUE_TYPE_CLASS,
+    // Appended after the original built-ins so that existing type ids stay stable.
+    BASE_VALUE_TYPE_DEQUE,
+    BASE_VALUE_TYPE_SET,
 } BaseValueType;
 
-#define SEMI_BUILTIN_CLASS_COUNT   (BASE_VALUE_TYPE_CLASS + 1)
-#define MIN_CUSTOM_BASE_VALUE_TYPE (BASE_VALUE_TYPE_CLASS + 1)
+#define SEMI_BUILTIN_CLASS_COUNT   (BASE_VALUE_TYPE_SET + 1)
+#define MIN_CUSTOM_BASE_VALUE_TYPE (BASE_VALUE_TYPE_SET + 1)
 #define MAX_CUSTOM_BASE_VALUE_TYPE ((1 << 16) - 1)
 
 // Masks
@@ -128,7 +131,14 @@ typedef enum {
         BASE_VALUE_TYPE_RANGE | (2 << VALUE_HEADER_VARIANT_SHIFT) | VALUE_HEADER_OBJECT_MASK,
 
     // List
-    VALUE_TYPE_LIST = BASE_VALUE_TYPE_LIST | VALUE_HEADER_OBJECT_MASK,
+    VALUE_TYPE_LIST          = BASE_VALUE_TYPE_LIST | VALUE_HEADER_OBJECT_MASK,
+    VALUE_TYPE_COLUMNAR_LIST = BASE_VALUE_TYPE_LIST | (1 << VALUE_HEADER_VARIANT_SHIFT) | VALUE_HEADER_OBJECT_MASK,
+
+    // Deque
+    VALUE_TYPE_DEQUE = BASE_VALUE_TYPE_DEQUE | VALUE_HEADER_OBJECT_MASK,
+
+    // Set
+    VALUE_TYPE_SET = BASE_VALUE_TYPE_SET | VALUE_HEADER_OBJECT_MASK,
 
     // Dictionary
     VALUE_TYPE_DICT = BASE_VALUE_TYPE_DICT | VALUE_HEADER_OBJECT_MASK,
@@ -158,11 +168,16 @@ typedef enum {
 #define IS_OBJECT_FLOAT_RANGE(v) (VALUE_TYPE(v) == VALUE_TYPE_OBJECT_FLOAT_RANGE)
 #define IS_INLINE_RANGE(v)       (VALUE_TYPE(v) == VALUE_TYPE_INLINE_RANGE)
 #define IS_LIST(v)               (VALUE_TYPE(v) == VALUE_TYPE_LIST)
+#define IS_COLUMNAR_LIST(v)      (VALUE_TYPE(v) == VALUE_TYPE_COLUMNAR_LIST)
+#define IS_DEQUE(v)              (VALUE_TYPE(v) == VALUE_TYPE_DEQUE)
+#define IS_SET(v)                (VALUE_TYPE(v) == VALUE_TYPE_SET)
 #define IS_DICT(v)               (VALUE_TYPE(v) == VALUE_TYPE_DICT)
 #define IS_FUNCTION_PROTO(v)     (VALUE_TYPE(v) == VALUE_TYPE_FUNCTION_PROTO)
 #define IS_COMPILED_FUNCTION(v)  (VALUE_TYPE(v) == VALUE_TYPE_COMPILED_FUNCTION)
 #define IS_NATIVE_FUNCTION(v)    (VALUE_TYPE(v) == VALUE_TYPE_NATIVE_FUNCTION)
 #define IS_CLASS(v)              (VALUE_TYPE(v) == VALUE_TYPE_CLASS)
+#define IS_STRUCT(v)             (BASE_TYPE(v) >= MIN_CUSTOM_BASE_VALUE_TYPE && IS_OBJECT(v))
+#define IS_STRUCT_VIEW(v)        (IS_STRUCT(v) && VALUE_VARIANT(v) == STRUCT_VIEW_VARIANT)
 
 #define IS_VALID(v)   (VALUE_TYPE(v) != VALUE_TYPE_INVALID)
 #define IS_INVALID(v) (VALUE_TYPE(v) == VALUE_TYPE_INVALID)
@@ -181,11 +196,16 @@ typedef enum {
 #define AS_INLINE_RANGE(v)      ((v)->as.ir)
 #define AS_OBJECT_RANGE(v)      ((ObjectRange*)((v)->as.obj))
 #define AS_LIST(v)              ((ObjectList*)((v)->as.obj))
+#define AS_COLUMNAR_LIST(v)     ((ObjectColumnarList*)((v)->as.obj))
+#define AS_DEQUE(v)             ((ObjectDeque*)((v)->as.obj))
+#define AS_SET(v)               ((ObjectSet*)((v)->as.obj))
 #define AS_DICT(v)              ((ObjectDict*)((v)->as.obj))
 #define AS_FUNCTION_PROTO(v)    (AS_PTR((v), FunctionProto))
 #define AS_COMPILED_FUNCTION(v) ((ObjectFunction*)((v)->as.obj))
 #define AS_NATIVE_FUNCTION(v)   (AS_PTR((v), NativeFunction))
 #define AS_CLASS(v)             ((ObjectClass*)((v)->as.obj))
+#define AS_STRUCT(v)            ((ObjectStruct*)((v)->as.obj))
+#define AS_STRUCT_VIEW(v)       ((ObjectStructView*)((v)->as.obj))
 
 #define OBJECT_VALUE(o, t) ((Value){.header = (ValueType)(t), .as = {.obj = (Object*)(o)}})
 
@@ -368,25 +388,54 @@ ObjectRange* semiObjectRangeCopy(GC* gc, const ObjectRange* range);
  │ ObjectList
 ─┴───────────────────────────────────────────────────────────────────────────────────────────────*/
 
+// The element kind is a conservative summary of what `values` holds. While a list only ever held ints (or only
+// floats) the numeric kernels below run without per-element type dispatch, and the GC skips tracing the elements.
+// Once a list becomes mixed it stays mixed until it is emptied.
+typedef enum {
+    LIST_ELEMENT_KIND_EMPTY = 0,
+    LIST_ELEMENT_KIND_INT,
+    LIST_ELEMENT_KIND_FLOAT,
+    LIST_ELEMENT_KIND_MIXED,
+} ListElementKind;
+
+// A value buffer shared by a list and its slices. It is created lazily the first time a list is sliced, and every list
+// referencing it holds one reference. A list must own its buffer before mutating it (see `semiListEnsureUnique`), which
+// gives slices copy-on-write semantics.
+typedef struct ListStorage {
+    uint32_t refCount;
+    uint32_t capacity;
+    Value* values;
+} ListStorage;
+
 typedef struct ObjectList {
     Object obj;
 
+    // When `storage` is not NULL, `values` points into `storage->values` and `capacity` equals `size`.
     Value* values;
     uint32_t size;
     uint32_t capacity;
+    uint8_t elementKind;
+    ListStorage* storage;
 } ObjectList;
 
 ObjectList* semiObjectListCreate(GC* gc, uint32_t capacity);
-static inline void semiObjectListDestroy(GC* gc, ObjectList* list) {
-    semiFree(gc, list->values, sizeof(Value) * list->capacity);
-    semiFree(gc, list, sizeof(ObjectList));
-}
+void semiObjectListDestroy(GC* gc, ObjectList* list);
 
 static inline Value semiValueListCreate(GC* gc, uint32_t capacity) {
     ObjectList* o = semiObjectListCreate(gc, capacity);
     return o ? OBJECT_VALUE(o, VALUE_TYPE_LIST) : INVALID_VALUE;
 }
 
+void semiListDetach(GC* gc, ObjectList* list);
+static inline void semiListEnsureUnique(GC* gc, ObjectList* list) {
+    if (list->storage != NULL) {
+        semiListDetach(gc, list);
+    }
+}
+
+// Create a list viewing `list[start..end]` without copying. Both lists share the buffer until one of them mutates.
+ObjectList* semiListSlice(GC* gc, ObjectList* list, uint32_t start, uint32_t end);
+
 void semiListEnsureCapacity(GC* gc, ObjectList* list, uint32_t capacity);
 void semiListAppend(GC* gc, ObjectList* list, Value value);
 void semiListInsert(GC* gc, ObjectList* list, uint32_t index, Value value);
@@ -400,6 +449,76 @@ static inline uint32_t semiListLen(const ObjectList* list) {
     return list->size;
 }
 
+static inline ListElementKind semiListElementKindOf(const Value* value) {
+    if (IS_INT(value)) {
+        return LIST_ELEMENT_KIND_INT;
+    }
+    return IS_FLOAT(value) ? LIST_ELEMENT_KIND_FLOAT : LIST_ELEMENT_KIND_MIXED;
+}
+
+static inline void semiListMergeElementKind(ObjectList* list, const Value* value) {
+    ListElementKind kind = semiListElementKindOf(value);
+    if (list->elementKind == LIST_ELEMENT_KIND_EMPTY) {
+        list->elementKind = (uint8_t)kind;
+    } else if (list->elementKind != kind) {
+        list->elementKind = LIST_ELEMENT_KIND_MIXED;
+    }
+}
+
+void semiListRefreshElementKind(ObjectList* list, uint32_t from);
+
+// Numeric kernels. They return false when the list is not homogeneously numeric, in which case the caller should fall
+// back to magic method dispatch.
+bool semiListSum(const ObjectList* list, Value* ret);
+bool semiListMin(const ObjectList* list, Value* ret);
+bool semiListMax(const ObjectList* list, Value* ret);
+bool semiListDot(const ObjectList* a, const ObjectList* b, Value* ret);
+
+typedef ErrorId (*ValueLessThanFn)(void* context, Value* a, Value* b, bool* ret);
+
+// Stable sort of `keys` in ascending order, permuting `payload` (if not NULL) alongside. Ints and floats are radix
+// sorted and strings are compared bytewise; other keys are ordered by `lessThan`, and
+// SEMI_ERROR_UNEXPECTED_TYPE is returned when it is NULL.
+ErrorId semiValuesSort(GC* gc, Value* keys, Value* payload, uint32_t count, ValueLessThanFn lessThan, void* context);
+ErrorId semiListSort(GC* gc, ObjectList* list, ValueLessThanFn lessThan, void* context);
+
+/*
+ │ ObjectDeque
+─┴───────────────────────────────────────────────────────────────────────────────────────────────*/
+
+// A double-ended queue backed by a ring buffer. `capacity` is zero or a power of two, and the element at logical index
+// `i` lives at `values[(head + i) & (capacity - 1)]`.
+typedef struct ObjectDeque {
+    Object obj;
+
+    Value* values;
+    uint32_t head;
+    uint32_t size;
+    uint32_t capacity;
+} ObjectDeque;
+
+ObjectDeque* semiObjectDequeCreate(GC* gc, uint32_t capacity);
+static inline void semiObjectDequeDestroy(GC* gc, ObjectDeque* deque) {
+    semiFree(gc, deque->values, sizeof(Value) * deque->capacity);
+    semiFree(gc, deque, sizeof(ObjectDeque));
+}
+
+static inline Value semiValueDequeCreate(GC* gc, uint32_t capacity) {
+    ObjectDeque* o = semiObjectDequeCreate(gc, capacity);
+    return o ? OBJECT_VALUE(o, VALUE_TYPE_DEQUE) : INVALID_VALUE;
+}
+
+static inline Value* semiDequeAt(ObjectDeque* deque, uint32_t index) {
+    return &deque->values[(deque->head + index) & (deque->capacity - 1)];
+}
+
+void semiDequeEnsureCapacity(GC* gc, ObjectDeque* deque, uint32_t capacity);
+void semiDequePushBack(GC* gc, ObjectDeque* deque, Value value);
+void semiDequePushFront(GC* gc, ObjectDeque* deque, Value value);
+bool semiDequePopBack(ObjectDeque* deque, Value* ret);
+bool semiDequePopFront(ObjectDeque* deque, Value* ret);
+void semiDequeRemoveAt(ObjectDeque* deque, uint32_t index);
+
 /*
  │ ObjectDict
 ─┴───────────────────────────────────────────────────────────────────────────────────────────────*/
@@ -407,13 +526,31 @@ static inline uint32_t semiListLen(const ObjectList* list) {
 #define OBJECT_DICT_MAX_INDEX_LOAD(indexSize) ((indexSize * 2) / 3)
 #define OBJECT_DICT_MIN_INDEX_SIZE            8
 
-#define OBJECT_DICT_KEY_EMPTY     (-1)
-#define OBJECT_DICT_KEY_TOMBSTONE (-2)
+// The index is probed in groups of control bytes that are matched a whole group at a time. A control byte is either
+// one of the markers below or the low 7 bits of the hash of the key in that slot.
+#define OBJECT_DICT_GROUP_WIDTH  8
+#define OBJECT_DICT_CTRL_EMPTY   ((uint8_t)0x80)
+#define OBJECT_DICT_CTRL_DELETED ((uint8_t)0xFE)
+
+// The width in bytes of each entry in `tids`. Empty and deleted slots are tracked by the control bytes, so every
+// entry is an unsigned tuple ID below `OBJECT_DICT_MAX_INDEX_LOAD(indexSize)`.
+#define OBJECT_DICT_TID_WIDTH(indexSize) \
+    ((indexSize) <= (UINT8_MAX + 1) ? 1 : (indexSize) <= (UINT16_MAX + 1) ? 2 : 4)
 
 typedef int64_t TupleId;
 
 typedef bool (*DictKeyCompareFn)(Value a, Value b);
 
+// What the keys of a dict have in common. Dicts whose keys are all ints or all strings compare them
+// inline instead of going through `keyCmpFn`.
+typedef enum {
+    OBJECT_DICT_KEYS_NONE = 0,
+    OBJECT_DICT_KEYS_INT,
+    OBJECT_DICT_KEYS_STRING,
+    // Keys of several types, or a custom `keyCmpFn`.
+    OBJECT_DICT_KEYS_MIXED,
+} ObjectDictKeyKind;
+
 // This has to be exposed because we use it in the constant table.
 typedef struct ObjectDictKey {
     ValueHash hash;
@@ -427,25 +564,33 @@ typedef struct ObjectDict {
     DictKeyCompareFn keyCmpFn;
 
     // The hashtable storing tuple IDs, which we can use to locate the actual keys and values.
-    // The term "Tuple ID (TID)" comes from PostgreSQL.
-    //
-    // The use of signed integers is needed because we use negative values to represent empty and
-    // tombestone keys.
-    TupleId* tids;
+    // The term "Tuple ID (TID)" comes from PostgreSQL. A slot's TID is only meaningful when its
+    // control byte holds a hash tag. Entries are `OBJECT_DICT_TID_WIDTH(indexSize)` bytes wide.
+    void* tids;
+
+    // One control byte per index slot, see `OBJECT_DICT_CTRL_EMPTY`.
+    uint8_t* ctrl;
 
     // The key part of the tuple table.
     ObjectDictKey* keys;
-    // The value part of the tuple table.
+    // The value part of the tuple table. Always NULL when `keysOnly` is set.
     Value* values;
 
     // The size of the index table.
     uint32_t indexSize;
 
-    // The number of non-empty indexes in `tids`.
+    // The number of tuples written since the last compaction, including deleted ones. `used - len`
+    // is the number of deleted tuples.
     uint32_t used;
 
     // The actual number of entries in the dictionary.
     uint32_t len;
+
+    // An `ObjectDictKeyKind` covering every key in the tuple table.
+    uint8_t keyKind;
+
+    // Whether this dict backs a set and only stores keys.
+    bool keysOnly;
 } ObjectDict;
 
 ObjectDict* semiObjectDictCreate(GC* gc);
@@ -455,8 +600,9 @@ static inline Value semiValueDictCreate(GC* gc) {
 }
 static inline void semiObjectDictDestroy(GC* gc, ObjectDict* dict) {
     semiFree(gc, dict->keys, sizeof(ObjectDictKey) * OBJECT_DICT_MAX_INDEX_LOAD(dict->indexSize));
-    semiFree(gc, dict->tids, sizeof(TupleId) * dict->indexSize);
-    semiFree(gc, dict->values, sizeof(Value) * dict->indexSize);
+    semiFree(gc, dict->tids, OBJECT_DICT_TID_WIDTH(dict->indexSize) * dict->indexSize);
+    semiFree(gc, dict->ctrl, dict->indexSize);
+    semiFree(gc, dict->values, sizeof(Value) * OBJECT_DICT_MAX_INDEX_LOAD(dict->indexSize));
     semiFree(gc, dict, sizeof(ObjectDict));
 }
 
@@ -470,10 +616,56 @@ Value semiDictGetWithHash(ObjectDict* dict, Value key, ValueHash hash);
 bool semiDictSet(GC* gc, ObjectDict* dict, Value key, Value value);
 bool semiDictSetWithHash(GC* gc, ObjectDict* dict, Value key, Value value, ValueHash hash);
 Value semiDictDelete(GC* gc, ObjectDict* dict, Value key);
+void semiDictDeleteTuples(ObjectDict* dict, const bool* isDeleted);
 static inline uint32_t semiDictLen(ObjectDict* dict) {
     return dict->len;
 }
 
+// Return the TID of the first live entry at or after `*cursor` in insertion order and move the cursor past it, or -1
+// once the entries are exhausted. Deleted entries are compacted away once they outnumber live ones, so a full scan
+// costs O(len).
+static inline TupleId semiDictNextTupleId(const ObjectDict* dict, uint32_t* cursor) {
+    for (uint32_t pos = *cursor; pos < dict->used; pos++) {
+        if (!IS_INVALID(&dict->keys[pos].key)) {
+            *cursor = pos + 1;
+            return pos;
+        }
+    }
+    *cursor = dict->used;
+    return -1;
+}
+
+/*
+ │ ObjectSet
+─┴───────────────────────────────────────────────────────────────────────────────────────────────*/
+
+// A set is a dict in `keysOnly` mode, so it shares the index, the key-kind fast paths, compaction and the ordered
+// iteration of `semiDictNextTupleId`.
+typedef ObjectDict ObjectSet;
+
+ObjectSet* semiObjectSetCreate(GC* gc);
+static inline Value semiValueSetCreate(GC* gc) {
+    ObjectSet* o = semiObjectSetCreate(gc);
+    return o ? OBJECT_VALUE(o, VALUE_TYPE_SET) : INVALID_VALUE;
+}
+static inline void semiObjectSetDestroy(GC* gc, ObjectSet* set) {
+    semiObjectDictDestroy(gc, set);
+}
+
+static inline uint32_t semiSetLen(ObjectSet* set) {
+    return set->len;
+}
+static inline bool semiSetHas(ObjectSet* set, Value key) {
+    return semiDictHas(set, key);
+}
+bool semiSetAdd(GC* gc, ObjectSet* set, Value key);
+bool semiSetRemove(GC* gc, ObjectSet* set, Value key);
+
+// These return a new set, or NULL if allocation failed.
+ObjectSet* semiSetUnion(GC* gc, ObjectSet* a, ObjectSet* b);
+ObjectSet* semiSetIntersection(GC* gc, ObjectSet* a, ObjectSet* b);
+ObjectSet* semiSetDifference(GC* gc, ObjectSet* a, ObjectSet* b);
+
 /*
  │ Native Function
 ─┴───────────────────────────────────────────────────────────────────────────────────────────────*/
@@ -490,8 +682,22 @@ typedef struct UpvalueDescription {
     bool isLocal;
 } UpvalueDescription;
 
+// The inline cache of a GET_ATTR / SET_ATTR instruction. It remembers the slot of `fieldName` in the struct type seen
+// last, so that repeated accesses on the same type skip the field lookup.
+typedef struct AttrCache {
+    // The identifier id of the accessed field.
+    uint32_t fieldName;
+    TypeId typeId;
+    uint16_t slot;
+} AttrCache;
+
+// No struct type is assigned this id, so an empty cache never hits.
+#define INVALID_ATTR_CACHE_TYPE_ID ((TypeId)MAX_CUSTOM_BASE_VALUE_TYPE)
+
 typedef struct FunctionProto {
     Chunk chunk;
+    AttrCache* attrCaches;
+    uint16_t attrCacheCount;
     ModuleId moduleId;
     uint8_t arity;
     uint8_t coarity;
@@ -559,6 +765,121 @@ static inline Value semiValueFunctionCreate(GC* gc, FunctionProto* function) {
     return o ? OBJECT_VALUE(o, VALUE_TYPE_COMPILED_FUNCTION) : INVALID_VALUE;
 }
 
+/*
+ │ Object Struct
+─┴───────────────────────────────────────────────────────────────────────────────────────────────*/
+
+// An instance of a struct type. The type id is stored in the value header, and the field values are stored inline in
+// slot order (see `StructType`).
+typedef struct ObjectStruct {
+    Object obj;
+
+    uint16_t fieldCount;
+    Value fields[];
+} ObjectStruct;
+
+// Struct instances and views of the rows of columnar lists share the base type of their struct type.
+#define STRUCT_VIEW_VARIANT       1
+#define STRUCT_VALUE_TYPE(typeId) ((ValueType)((typeId) | VALUE_HEADER_OBJECT_MASK))
+#define STRUCT_VIEW_VALUE_TYPE(typeId) \
+    ((ValueType)((typeId) | (STRUCT_VIEW_VARIANT << VALUE_HEADER_VARIANT_SHIFT) | VALUE_HEADER_OBJECT_MASK))
+
+ObjectStruct* semiObjectStructCreate(GC* gc, uint16_t fieldCount);
+static inline void semiObjectStructDestroy(GC* gc, ObjectStruct* o) {
+    semiFree(gc, o, sizeof(ObjectStruct) + sizeof(Value) * o->fieldCount);
+}
+static inline Value semiValueStructCreate(GC* gc, TypeId typeId, uint16_t fieldCount) {
+    ObjectStruct* o = semiObjectStructCreate(gc, fieldCount);
+    return o ? OBJECT_VALUE(o, STRUCT_VALUE_TYPE(typeId)) : INVALID_VALUE;
+}
+
+// Reads or writes the field at `slot` of a struct instance or a struct view.
+ErrorId semiStructGetField(const Value* object, uint16_t slot, Value* ret);
+ErrorId semiStructSetField(GC* gc, Value* object, uint16_t slot, Value value);
+
+/*
+ │ Columnar List
+─┴───────────────────────────────────────────────────────────────────────────────────────────────*/
+
+// A list of instances of one struct type, stored as one array per field. A column is packed (`IntValue` or
+// `FloatValue` per element) while the field has only held ints or only floats, and becomes an array of `Value`s once
+// it gets mixed. Scans that read a few fields only touch the columns of those fields.
+//
+// Elements are stored by value: adding a struct copies its fields into the columns. Indexing and iterating yield
+// struct views that read and write the columns in place.
+typedef struct ListColumn {
+    // A `ListElementKind`. Column data is allocated with the capacity of the list unless the kind is empty.
+    uint8_t kind;
+    union {
+        IntValue* ints;
+        FloatValue* floats;
+        Value* values;
+    } as;
+} ListColumn;
+
+typedef struct ObjectColumnarList {
+    Object obj;
+
+    TypeId typeId;
+    uint16_t columnCount;
+    uint32_t size;
+    uint32_t capacity;
+    ListColumn columns[];
+} ObjectColumnarList;
+
+ObjectColumnarList* semiObjectColumnarListCreate(GC* gc, TypeId typeId, uint16_t columnCount, uint32_t capacity);
+void semiObjectColumnarListDestroy(GC* gc, ObjectColumnarList* list);
+
+static inline Value semiValueColumnarListCreate(GC* gc, TypeId typeId, uint16_t columnCount, uint32_t capacity) {
+    ObjectColumnarList* o = semiObjectColumnarListCreate(gc, typeId, columnCount, capacity);
+    return o ? OBJECT_VALUE(o, VALUE_TYPE_COLUMNAR_LIST) : INVALID_VALUE;
+}
+
+static inline Value semiColumnarListGet(const ObjectColumnarList* list, uint32_t row, uint16_t column) {
+    const ListColumn* c = &list->columns[column];
+    switch (c->kind) {
+        case LIST_ELEMENT_KIND_INT:
+            return semiValueIntCreate(c->as.ints[row]);
+        case LIST_ELEMENT_KIND_FLOAT:
+            return semiValueFloatCreate(c->as.floats[row]);
+        default:
+            return c->as.values[row];
+    }
+}
+
+bool semiColumnarListSet(GC* gc, ObjectColumnarList* list, uint32_t row, uint16_t column, Value value);
+// Copies the fields of `item`, a struct instance or view of the struct type of `list`, into row `row`. `row` may be
+// `list->size` to append a row.
+ErrorId semiColumnarListSetRow(GC* gc, ObjectColumnarList* list, uint32_t row, const Value* item);
+ErrorId semiColumnarListAppend(GC* gc, ObjectColumnarList* list, const Value* item);
+void semiColumnarListRemove(GC* gc, ObjectColumnarList* list, uint32_t row);
+// Copies row `row` into a new struct instance.
+Value semiColumnarListMaterialize(GC* gc, const ObjectColumnarList* list, uint32_t row);
+// Returns the first row whose fields equal those of `item`, or -1. Rows are compared by value since the list stores
+// copies.
+IntValue semiColumnarListIndex(const ObjectColumnarList* list, const Value* item);
+// Copies rows `start`, `start + step`, ... before `end` into a new columnar list.
+ObjectColumnarList* semiColumnarListSlice(
+    GC* gc, const ObjectColumnarList* list, uint32_t start, uint32_t end, uint32_t step);
+
+// A row of a columnar list. Views are cheap to create and never copy the fields; they only become invalid when the
+// list shrinks below their row.
+typedef struct ObjectStructView {
+    Object obj;
+
+    ObjectColumnarList* list;
+    uint32_t row;
+} ObjectStructView;
+
+ObjectStructView* semiObjectStructViewCreate(GC* gc, ObjectColumnarList* list, uint32_t row);
+static inline void semiObjectStructViewDestroy(GC* gc, ObjectStructView* o) {
+    semiFree(gc, o, sizeof(ObjectStructView));
+}
+static inline Value semiValueStructViewCreate(GC* gc, ObjectColumnarList* list, uint32_t row) {
+    ObjectStructView* o = semiObjectStructViewCreate(gc, list, row);
+    return o ? OBJECT_VALUE(o, STRUCT_VIEW_VALUE_TYPE(list->typeId)) : INVALID_VALUE;
+}
+
 /*
  │ Object Class
 ─┴───────────────────────────────────────────────────────────────────────────────────────────────*/
@@ -587,6 +908,16 @@ static inline ValueHash semiHashString(const char* str, size_t length) {
     return hash;
 }
 
+// FNV-1a with 64 bits, for hashes that identify content instead of indexing a hash table.
+static inline uint64_t semiHashBytes64(const char* bytes, size_t length) {
+    uint64_t hash = 0xcbf29ce484222325;
+    for (size_t i = 0; i < length; i++) {
+        hash ^= (unsigned char)bytes[i];
+        hash *= 0x100000001b3;
+    }
+    return hash;
+}
+
 static inline ValueHash semiHash64Bits(uint64_t key) {
     // MurmurHash3's 64-bit finalizer
     key ^= (key >> 33);
@@ -13,6 +13,23 @@
 #include "semi/config.h"
 #include "semi/error.h"
 
+DEFINE_DARRAY(CachedDeclarationList, CachedDeclaration, uint32_t, UINT32_MAX)
+DEFINE_DARRAY(DeclarationDependencyList, DeclarationDependency, uint32_t, UINT32_MAX)
+
+void semiDeclarationCacheInit(DeclarationCache* cache) {
+    semiObjectStackDictInit(&cache->index);
+    CachedDeclarationListInit(&cache->declarations);
+    DeclarationDependencyListInit(&cache->dependencies);
+    cache->environmentFingerprint = 0;
+}
+
+void semiDeclarationCacheCleanup(GC* gc, DeclarationCache* cache) {
+    semiObjectStackDictCleanup(gc, &cache->index);
+    CachedDeclarationListCleanup(gc, &cache->declarations);
+    DeclarationDependencyListCleanup(gc, &cache->dependencies);
+    cache->environmentFingerprint = 0;
+}
+
 SemiModule* semiVMModuleCreate(GC* gc, ModuleId moduleId) {
     SemiModule* module = semiMalloc(gc, sizeof(SemiModule));
     if (module == NULL) {
@@ -24,7 +41,12 @@ SemiModule* semiVMModuleCreate(GC* gc, ModuleId moduleId) {
     semiObjectStackDictInit(&module->globals);
     semiObjectStackDictInit(&module->types);
     semiConstantTableInit(gc, &module->constantTable);
-    module->moduleInit = NULL;
+    module->moduleInit              = NULL;
+    module->peepholeRemovedCount    = 0;
+    module->inlinedCallCount        = 0;
+    module->hoistedInstructionCount = 0;
+    module->reusedFunctionCount     = 0;
+    semiDeclarationCacheInit(&module->declarationCache);
 
     return module;
 }
@@ -34,6 +56,7 @@ void semiVMModuleDestroy(GC* gc, SemiModule* module) {
     semiObjectStackDictCleanup(gc, &module->exports);
     semiObjectStackDictCleanup(gc, &module->globals);
     semiConstantTableCleanup(&module->constantTable);
+    semiDeclarationCacheCleanup(gc, &module->declarationCache);
     if (module->moduleInit != NULL) {
         semiFunctionProtoDestroy(gc, module->moduleInit);
     }
@@ -206,6 +229,7 @@ SEMI_EXPORT SemiVM* semiCreateVM(SemiVMConfig* inputConfig) {
 
     vm->globalConstants = NULL;
     GlobalIdentifierListInit(&vm->globalIdentifiers);
+    vm->compileCache = NULL;
 
     return vm;
 }
@@ -229,9 +253,6 @@ SEMI_EXPORT void semiDestroyVM(SemiVM* vm) {
     }
     semiObjectStackDictCleanup(&vm->gc, &vm->modules);
 
-    for (uint16_t i = MIN_CUSTOM_BASE_VALUE_TYPE; i < vm->classes.classCount; i++) {
-        semiFree(&vm->gc, &vm->classes.classMethods[i], sizeof(MagicMethodsTable));
-    }
     semiPrimitivesCleanupClassTable(&vm->gc, &vm->classes);
     semiSymbolTableCleanup(&vm->symbolTable);
 
@@ -391,6 +412,31 @@ static inline bool verifyChunk(Chunk* chunk) {
     return true;
 }
 
+// Resolves the slot of `fieldName` in the struct `object`, and fills `cache` with it if `cache` is not NULL.
+static ErrorId resolveAttrSlot(SemiVM* vm, Value* object, AttrCache* cache, IdentifierId fieldName, uint16_t* slot) {
+    if (!IS_STRUCT(object)) {
+        return SEMI_ERROR_UNEXPECTED_TYPE;
+    }
+
+    TypeId typeId          = (TypeId)BASE_TYPE(object);
+    StructType* structType = semiPrimitivesGetStructType(&vm->classes, typeId);
+    if (structType == NULL) {
+        return SEMI_ERROR_UNEXPECTED_TYPE;
+    }
+
+    uint16_t fieldSlot = semiStructTypeFindSlot(structType, fieldName);
+    if (fieldSlot == INVALID_STRUCT_FIELD_SLOT) {
+        return SEMI_ERROR_UNKNOWN_ATTRIBUTE;
+    }
+
+    if (cache != NULL) {
+        cache->typeId = typeId;
+        cache->slot   = fieldSlot;
+    }
+    *slot = fieldSlot;
+    return 0;
+}
+
 static void runMainLoop(SemiVM* vm) {
     register Frame* frame;
     register Value* stack;
@@ -437,6 +483,8 @@ static void runMainLoop(SemiVM* vm) {
     RECONCILE_STATE();
 
     Instruction instruction;
+    // The K operand of the current instruction, widened by a preceding EXTRA_ARG.
+    uint32_t operandK;
     for (;;) {
     start_of_vm_loop:
         instruction = *ip;
@@ -461,7 +509,30 @@ static void runMainLoop(SemiVM* vm) {
             }
 
             case OP_EXTRA_ARG: {
-                TRAP_ON_ERROR(vm, SEMI_ERROR_UNIMPLEMENTED_FEATURE, "OP_EXTRA_ARG is not implemented yet");
+                if (chunkEnd - ip <= 1) {
+                    TRAP_ON_ERROR(vm, SEMI_ERROR_INVALID_PC, "Program counter out of bounds");
+                }
+                uint32_t high = OPERAND_J_J(instruction);
+                instruction   = *++ip;
+                operandK      = (high << 16) | OPERAND_K_K(instruction);
+                switch (GET_OPCODE(instruction)) {
+                    case OP_C_JUMP:
+                        goto extended_c_jump;
+                    case OP_LOAD_CONSTANT:
+                        goto extended_load_constant;
+                    case OP_GET_MODULE_VAR:
+                        goto extended_get_module_var;
+                    case OP_SET_MODULE_VAR:
+                        goto extended_set_module_var;
+                    case OP_DEFER_CALL:
+                        goto extended_defer_call;
+                    case OP_RANGE_NEXT:
+                        goto extended_range_next;
+                    case OP_ITER_NEXT:
+                        goto extended_iter_next;
+                    default:
+                        TRAP_ON_ERROR(vm, SEMI_ERROR_INVALID_INSTRUCTION, "Invalid instruction after OP_EXTRA_ARG");
+                }
                 break;
             }
 
@@ -472,9 +543,11 @@ static void runMainLoop(SemiVM* vm) {
                 return;
             }
 
-            case OP_C_JUMP: {
+            case OP_C_JUMP:
+                operandK = OPERAND_K_K(instruction);
+            extended_c_jump: {
                 uint8_t a  = OPERAND_K_A(instruction);
-                uint16_t k = OPERAND_K_K(instruction);
+                uint32_t k = operandK;
                 bool i     = OPERAND_K_I(instruction);
                 bool s     = OPERAND_K_S(instruction);
 
@@ -494,9 +567,11 @@ static void runMainLoop(SemiVM* vm) {
                 break;
             }
 
-            case OP_LOAD_CONSTANT: {
+            case OP_LOAD_CONSTANT:
+                operandK = OPERAND_K_K(instruction);
+            extended_load_constant: {
                 uint8_t a  = OPERAND_K_A(instruction);
-                uint16_t k = OPERAND_K_K(instruction);
+                uint32_t k = operandK;
                 bool s     = OPERAND_K_S(instruction);
 
                 Value v;
@@ -567,9 +642,11 @@ static void runMainLoop(SemiVM* vm) {
                 break;
             }
 
-            case OP_GET_MODULE_VAR: {
+            case OP_GET_MODULE_VAR:
+                operandK = OPERAND_K_K(instruction);
+            extended_get_module_var: {
                 uint8_t a  = OPERAND_K_A(instruction);
-                uint16_t k = OPERAND_K_K(instruction);
+                uint32_t k = operandK;
                 bool s     = OPERAND_K_S(instruction);
 
                 ObjectDict* targetDict = s ? &module->exports : &module->globals;
@@ -580,9 +657,11 @@ static void runMainLoop(SemiVM* vm) {
                 stack[a] = targetDict->values[k];
                 break;
             }
-            case OP_SET_MODULE_VAR: {
+            case OP_SET_MODULE_VAR:
+                operandK = OPERAND_K_K(instruction);
+            extended_set_module_var: {
                 uint8_t a  = OPERAND_K_A(instruction);
-                uint16_t k = OPERAND_K_K(instruction);
+                uint32_t k = operandK;
                 bool s     = OPERAND_K_S(instruction);
 
                 ObjectDict* targetDict = s ? &module->exports : &module->globals;
@@ -592,8 +671,10 @@ static void runMainLoop(SemiVM* vm) {
                 targetDict->values[k] = stack[a];
                 break;
             }
-            case OP_DEFER_CALL: {
-                uint16_t k = OPERAND_K_K(instruction);
+            case OP_DEFER_CALL:
+                operandK = OPERAND_K_K(instruction);
+            extended_defer_call: {
+                uint32_t k = operandK;
 
                 Value v = semiConstantTableGet(&module->constantTable, k);
                 if (!IS_FUNCTION_PROTO(&v)) {
@@ -610,9 +691,11 @@ static void runMainLoop(SemiVM* vm) {
                 break;
             }
 
-            case OP_RANGE_NEXT: {
+            case OP_RANGE_NEXT:
+                operandK = OPERAND_K_K(instruction);
+            extended_range_next: {
                 uint8_t a  = OPERAND_K_A(instruction);
-                uint16_t k = OPERAND_K_K(instruction);
+                uint32_t k = operandK;
                 bool i     = OPERAND_K_I(instruction);
 
                 bool canProceed = false;
@@ -659,6 +742,43 @@ static void runMainLoop(SemiVM* vm) {
                 break;
             }
 
+            case OP_ITER_NEXT:
+                operandK = OPERAND_K_K(instruction);
+            extended_iter_next: {
+                uint8_t a  = OPERAND_K_A(instruction);
+                uint32_t k = operandK;
+                bool i     = OPERAND_K_I(instruction);
+
+                Value* iterable = &stack[a];
+                Value* cursor   = &stack[a + 1];
+                Value* item     = &stack[a + 3];
+
+                if (IS_LIST(iterable)) {
+                    ObjectList* list = AS_LIST(iterable);
+                    IntValue pos     = AS_INT(cursor);
+                    if (pos >= (IntValue)list->size) {
+                        MOVE_FORWARD(k);
+                    }
+                    *item        = list->values[pos];
+                    cursor->as.i = pos + 1;
+                } else {
+                    Value nextValue;
+                    MagicMethodsTable* table = semiVMGetMagicMethodsTable(vm, iterable);
+                    TRAP_ON_ERROR(
+                        vm, table->collectionMethods->next(&vm->gc, &nextValue, iterable, cursor), "Iteration failed");
+                    if (IS_INVALID(&nextValue)) {
+                        MOVE_FORWARD(k);
+                    }
+                    *item = nextValue;
+                }
+
+                if (i) {
+                    stack[a + 4] = stack[a + 2];
+                    stack[a + 2].as.i += 1;
+                }
+                break;
+            }
+
             /* T Type Instructions --------------------------------------------------- */
             case OP_MOVE: {
                 uint8_t a = OPERAND_T_A(instruction);
@@ -828,18 +948,21 @@ static void runMainLoop(SemiVM* vm) {
                 }
                 break;
             }
-            case OP_ITER_NEXT: {
-                Value *ra, *rb, *rc;
-
-                uint8_t a = OPERAND_T_A(instruction);
-                uint8_t b = OPERAND_T_B(instruction);
-                uint8_t c = OPERAND_T_C(instruction);
-
-                ra = a == INVALID_LOCAL_REGISTER_ID ? NULL : &stack[a];
-                rb = &stack[b];
-                rc = &stack[c];
-
-                closeUpvalues(vm, rb);
+            case OP_ITER_PREPARE: {
+                uint8_t a       = OPERAND_T_A(instruction);
+                Value* iterable = &stack[a];
+
+                // The iteration state lives in R[A+1] (cursor) and R[A+2] (counter), so built-in collections never
+                // allocate an iterator object.
+                if (IS_LIST(iterable)) {
+                    stack[a + 1] = semiValueIntCreate(0);
+                } else {
+                    MagicMethodsTable* table = semiVMGetMagicMethodsTable(vm, iterable);
+                    TRAP_ON_ERROR(vm,
+                                  table->collectionMethods->iter(&vm->gc, &stack[a + 1], iterable),
+                                  "Value is not iterable");
+                }
+                stack[a + 2] = semiValueIntCreate(0);
                 break;
             }
             case OP_BOOL_NOT: {
@@ -850,7 +973,37 @@ static void runMainLoop(SemiVM* vm) {
                 break;
             }
             case OP_GET_ATTR: {
-                TRAP_ON_ERROR(vm, SEMI_ERROR_UNIMPLEMENTED_FEATURE, "OP_GET_ATTR is not implemented yet");
+                Value* ra = &stack[OPERAND_T_A(instruction)];
+                Value* rb = &stack[OPERAND_T_B(instruction)];
+                uint8_t c = OPERAND_T_C(instruction);
+
+                uint16_t slot;
+                if (OPERAND_T_KC(instruction)) {
+                    FunctionProto* proto = frame->function->proto;
+                    if (SEMI_UNLIKELY(c >= proto->attrCacheCount)) {
+                        TRAP_ON_ERROR(vm, SEMI_ERROR_INVALID_INSTRUCTION, "Invalid attribute cache for GET_ATTR");
+                    }
+                    AttrCache* cache = &proto->attrCaches[c];
+                    if (SEMI_LIKELY((TypeId)BASE_TYPE(rb) == cache->typeId)) {
+                        slot = cache->slot;
+                    } else {
+                        TRAP_ON_ERROR(vm, resolveAttrSlot(vm, rb, cache, cache->fieldName, &slot), "GetAttr failed");
+                    }
+                } else {
+                    Value* rc = &stack[c];
+                    if (!IS_INT(rc)) {
+                        TRAP_ON_ERROR(vm, SEMI_ERROR_UNEXPECTED_TYPE, "Expected identifier id for GET_ATTR");
+                    }
+                    TRAP_ON_ERROR(vm, resolveAttrSlot(vm, rb, NULL, (IdentifierId)AS_INT(rc), &slot), "GetAttr failed");
+                }
+
+                if (SEMI_LIKELY(!IS_STRUCT_VIEW(rb))) {
+                    *ra = AS_STRUCT(rb)->fields[slot];
+                } else {
+                    Value field;
+                    TRAP_ON_ERROR(vm, semiStructGetField(rb, slot, &field), "GetAttr failed");
+                    *ra = field;
+                }
                 break;
             }
             case OP_NEW_COLLECTION: {
@@ -872,19 +1025,69 @@ static void runMainLoop(SemiVM* vm) {
                         *ra               = semiValueListCreate(&vm->gc, capacity);
                         break;
                     }
+                    case BASE_VALUE_TYPE_DEQUE: {
+                        uint32_t capacity = c == INVALID_LOCAL_REGISTER_ID ? 0 : (uint32_t)c;
+                        *ra               = semiValueDequeCreate(&vm->gc, capacity);
+                        break;
+                    }
                     case BASE_VALUE_TYPE_DICT: {
                         *ra = semiValueDictCreate(&vm->gc);
                         break;
                     }
+                    case BASE_VALUE_TYPE_SET: {
+                        *ra = semiValueSetCreate(&vm->gc);
+                        break;
+                    }
                     default: {
-                        TRAP_ON_ERROR(
-                            vm, SEMI_ERROR_UNIMPLEMENTED_FEATURE, "Unsupported collection type for NEW_COLLECTION");
+                        // Struct instances start with every field unset; the initializer assigns them afterward. With
+                        // `kc` set, this creates a columnar list of the struct type instead.
+                        StructType* structType = semiPrimitivesGetStructType(&vm->classes, b);
+                        if (structType == NULL) {
+                            TRAP_ON_ERROR(vm,
+                                          SEMI_ERROR_UNIMPLEMENTED_FEATURE,
+                                          "Unsupported collection type for NEW_COLLECTION");
+                        }
+                        if (OPERAND_T_KC(instruction)) {
+                            uint32_t capacity = c == INVALID_LOCAL_REGISTER_ID ? 0 : (uint32_t)c;
+                            *ra = semiValueColumnarListCreate(&vm->gc, b, (uint16_t)structType->fieldCount, capacity);
+                        } else {
+                            *ra = semiValueStructCreate(&vm->gc, b, (uint16_t)structType->fieldCount);
+                        }
+                        break;
                     }
                 }
                 break;
             }
             case OP_SET_ATTR: {
-                TRAP_ON_ERROR(vm, SEMI_ERROR_UNIMPLEMENTED_FEATURE, "OP_SET_ATTR is not implemented yet");
+                Value* ra = &stack[OPERAND_T_A(instruction)];
+                uint8_t b = OPERAND_T_B(instruction);
+                Value* rc = &stack[OPERAND_T_C(instruction)];
+
+                uint16_t slot;
+                if (OPERAND_T_KB(instruction)) {
+                    FunctionProto* proto = frame->function->proto;
+                    if (SEMI_UNLIKELY(b >= proto->attrCacheCount)) {
+                        TRAP_ON_ERROR(vm, SEMI_ERROR_INVALID_INSTRUCTION, "Invalid attribute cache for SET_ATTR");
+                    }
+                    AttrCache* cache = &proto->attrCaches[b];
+                    if (SEMI_LIKELY((TypeId)BASE_TYPE(ra) == cache->typeId)) {
+                        slot = cache->slot;
+                    } else {
+                        TRAP_ON_ERROR(vm, resolveAttrSlot(vm, ra, cache, cache->fieldName, &slot), "SetAttr failed");
+                    }
+                } else {
+                    Value* rb = &stack[b];
+                    if (!IS_INT(rb)) {
+                        TRAP_ON_ERROR(vm, SEMI_ERROR_UNEXPECTED_TYPE, "Expected identifier id for SET_ATTR");
+                    }
+                    TRAP_ON_ERROR(vm, resolveAttrSlot(vm, ra, NULL, (IdentifierId)AS_INT(rb), &slot), "SetAttr failed");
+                }
+
+                if (SEMI_LIKELY(!IS_STRUCT_VIEW(ra))) {
+                    AS_STRUCT(ra)->fields[slot] = *rc;
+                } else {
+                    TRAP_ON_ERROR(vm, semiStructSetField(&vm->gc, ra, slot, *rc), "SetAttr failed");
+                }
                 break;
             }
             case OP_GET_ITEM: {
@@ -16,6 +16,56 @@
 
 #define SEMI_MAX_MODULE_COUNT UINT16_MAX
 
+// A top-level function declaration from the last compilation of a module. The next compilation reuses its function
+// proto if the source of the declaration after the function name is unchanged, and so is everything the body was
+// compiled against.
+typedef struct CachedDeclaration {
+    IdentifierId identifierId;
+    uint32_t sourceLength;
+    uint64_t sourceHash;
+    // The number of newlines in the source, and the offset of the line after the last one.
+    uint32_t lineCount;
+    uint32_t lastLineOffset;
+    ConstantIndex protoIndex;
+    // The slice of `DeclarationCache.dependencies` recorded while compiling the body.
+    uint32_t dependencyStart;
+    uint32_t dependencyCount;
+} CachedDeclaration;
+
+typedef enum {
+    // A module constant folded into the body. `valueType` and `fingerprint` describe its value.
+    DECLARATION_DEPENDENCY_CONSTANT,
+    // A function proto inlined into the body.
+    DECLARATION_DEPENDENCY_INLINED_FUNCTION,
+    // A module variable the body resolved. `fingerprint` is 1 for an export and 0 for a global.
+    DECLARATION_DEPENDENCY_MODULE_VARIABLE,
+    // A parameter or local variable of the body, whose name must not be a module variable.
+    DECLARATION_DEPENDENCY_LOCAL_VARIABLE,
+} DeclarationDependencyKind;
+
+// A compile-time fact a cached declaration relied on.
+typedef struct DeclarationDependency {
+    IdentifierId identifierId;
+    DeclarationDependencyKind kind;
+    ValueType valueType;
+    uint64_t fingerprint;
+} DeclarationDependency;
+
+DECLARE_DARRAY(CachedDeclarationList, CachedDeclaration, uint32_t)
+DECLARE_DARRAY(DeclarationDependencyList, DeclarationDependency, uint32_t)
+
+typedef struct DeclarationCache {
+    // identifier id -> index in `declarations`.
+    ObjectDict index;
+    CachedDeclarationList declarations;
+    DeclarationDependencyList dependencies;
+    // Summarizes module-wide facts every declaration relied on, e.g. the set of reassigned identifiers.
+    uint64_t environmentFingerprint;
+} DeclarationCache;
+
+void semiDeclarationCacheInit(DeclarationCache* cache);
+void semiDeclarationCacheCleanup(GC* gc, DeclarationCache* cache);
+
 // A SemiModule represents a compiled self-contained executable unit.
 typedef struct SemiModule {
     ModuleId moduleId;
@@ -27,6 +77,22 @@ typedef struct SemiModule {
     // The function proto used to initialize this module. Once the module is initialized, this field
     // is freed and set to NULL.
     FunctionProto* moduleInit;
+
+    // The number of instructions removed by the peephole pass in the last compilation of this module.
+    uint32_t peepholeRemovedCount;
+
+    // The number of calls replaced by the body of the callee in the last compilation of this module.
+    uint32_t inlinedCallCount;
+
+    // The number of instructions moved out of loops in the last compilation of this module.
+    uint32_t hoistedInstructionCount;
+
+    // The top-level functions of the last successful compilation of this module.
+    DeclarationCache declarationCache;
+
+    // The number of top-level functions whose proto was reused from the previous compilation in the last compilation
+    // of this module.
+    uint32_t reusedFunctionCount;
 } SemiModule;
 
 SemiModule* semiVMModuleCreate(GC* gc, ModuleId moduleId);
@@ -106,6 +172,9 @@ typedef struct SemiVM {
 
     // IdentifierId to Constant index for global variables shared across all modules.
     GlobalIdentifierList globalIdentifiers;
+
+    // The cache compiled modules are looked up in and stored to. Not owned by the VM.
+    SemiCompileCache* compileCache;
 } SemiVM;
 
 ErrorId semiVMAddGlobalVariable(SemiVM* vm, const char* identifier, IdentifierLength identifierLength, Value value);
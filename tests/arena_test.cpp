@@ -0,0 +1,107 @@
+// Copyright (c) 2025 Ian Chen
+// SPDX-License-Identifier: MPL-2.0
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+
+#include "test_common.hpp"
+
+extern "C" {
+#include "../src/arena.h"
+}
+
+class ArenaTest : public ::testing::Test {
+   protected:
+    GC gc;
+    Arena arena;
+
+    void SetUp() override {
+        semiGCInit(&gc, defaultReallocFn, nullptr);
+        semiArenaInit(&arena);
+    }
+
+    void TearDown() override {
+        semiArenaCleanup(&gc, &arena);
+        EXPECT_EQ(gc.allocatedSize, 0);
+        semiGCCleanup(&gc);
+    }
+};
+
+TEST_F(ArenaTest, AllocationsAreAligned) {
+    for (size_t size = 1; size < 100; size += 7) {
+        void* ptr = semiArenaAlloc(&gc, &arena, size);
+        ASSERT_NE(ptr, nullptr);
+        EXPECT_EQ((uintptr_t)ptr % alignof(max_align_t), 0u);
+        memset(ptr, 0xAB, size);
+    }
+}
+
+TEST_F(ArenaTest, LastAllocationGrowsInPlace) {
+    char* ptr = (char*)semiArenaAlloc(&gc, &arena, 16);
+    memcpy(ptr, "arena", 6);
+    EXPECT_EQ(semiArenaRealloc(&gc, &arena, ptr, 16, 64), ptr);
+
+    // Another allocation is in the way now, so growing copies.
+    semiArenaAlloc(&gc, &arena, 8);
+    char* moved = (char*)semiArenaRealloc(&gc, &arena, ptr, 64, 128);
+    EXPECT_NE(moved, ptr);
+    EXPECT_STREQ(moved, "arena");
+}
+
+TEST_F(ArenaTest, LargeAllocationGetsItsOwnBlock) {
+    void* small = semiArenaAlloc(&gc, &arena, 32);
+    void* large = semiArenaAlloc(&gc, &arena, 1 << 20);
+    ASSERT_NE(small, nullptr);
+    ASSERT_NE(large, nullptr);
+    memset(large, 0, 1 << 20);
+}
+
+TEST_F(ArenaTest, ReleaseFreesAllocationsAfterMark) {
+    semiArenaAlloc(&gc, &arena, 64);
+    size_t allocatedSize = gc.allocatedSize;
+    ArenaMark mark       = semiArenaMark(&arena);
+
+    void* first = semiArenaAlloc(&gc, &arena, 64);
+    semiArenaAlloc(&gc, &arena, 1 << 20);
+    semiArenaRelease(&gc, &arena, mark);
+    EXPECT_EQ(gc.allocatedSize, allocatedSize);
+    EXPECT_EQ(semiArenaAlloc(&gc, &arena, 64), first);
+}
+
+TEST(CompilerArenaTest, CompiledChunksHaveNoSlack) {
+    SemiVM* vm = semiCreateVM(nullptr);
+    ASSERT_NE(vm, nullptr);
+
+    const char* source =
+        "fn add(a, b) {\n"
+        "    return a + b\n"
+        "}\n"
+        "r := add(1, 2)\n";
+    SemiModuleSource moduleSource = {
+        .source     = source,
+        .length     = (unsigned int)strlen(source),
+        .name       = "test_module",
+        .nameLength = (uint8_t)strlen("test_module"),
+    };
+    SemiModule* module = semiVMCompileModule(vm, &moduleSource);
+    ASSERT_NE(module, nullptr);
+    EXPECT_EQ(module->moduleInit->chunk.capacity, module->moduleInit->chunk.size);
+    for (ConstantIndex i = 0; i < semiConstantTableSize(&module->constantTable); i++) {
+        Value constant = semiConstantTableGet(&module->constantTable, i);
+        if (IS_FUNCTION_PROTO(&constant)) {
+            EXPECT_EQ(AS_FUNCTION_PROTO(&constant)->chunk.capacity, AS_FUNCTION_PROTO(&constant)->chunk.size);
+        }
+    }
+
+    // Aborting in a nested function leaves nothing of the compilation behind. The source only uses identifiers that
+    // are interned already.
+    size_t allocatedSize = vm->gc.allocatedSize;
+    const char* invalid  = "fn add(a, b) {\n    fn b() {\n        return )\n    }\n}\n";
+    moduleSource.source  = invalid;
+    moduleSource.length  = (unsigned int)strlen(invalid);
+    EXPECT_EQ(semiVMCompileModule(vm, &moduleSource), nullptr);
+    EXPECT_EQ(vm->gc.allocatedSize, allocatedSize);
+
+    semiDestroyVM(vm);
+}
@@ -0,0 +1,281 @@
+// Copyright (c) 2025 Ian Chen
+// SPDX-License-Identifier: MPL-2.0
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <map>
+#include <string>
+
+#include "test_common.hpp"
+
+extern "C" {
+#include "../src/compile_cache.h"
+}
+
+class CompileCacheTest : public ::testing::Test {
+   protected:
+    SemiCompileCache* cache = nullptr;
+    SemiVM* vms[3]          = {nullptr, nullptr, nullptr};
+
+    void SetUp() override {
+        cache = semiCreateCompileCache(nullptr);
+        ASSERT_NE(cache, nullptr);
+        for (SemiVM*& vm : vms) {
+            vm = semiCreateVM(nullptr);
+            ASSERT_NE(vm, nullptr);
+            semiVMSetCompileCache(vm, cache);
+        }
+    }
+
+    void TearDown() override {
+        for (SemiVM* vm : vms) {
+            semiDestroyVM(vm);
+        }
+        semiDestroyCompileCache(cache);
+    }
+
+    static SemiModule* Compile(SemiVM* vm, const char* source, const char* name = "test_module") {
+        SemiModuleSource moduleSource = {
+            .source     = source,
+            .length     = (unsigned int)strlen(source),
+            .name       = name,
+            .nameLength = (uint8_t)strlen(name),
+        };
+        return semiVMCompileModule(vm, &moduleSource);
+    }
+
+    static ErrorId Run(SemiVM* vm, const char* source) {
+        if (Compile(vm, source) == nullptr) {
+            return vm->error;
+        }
+        return semiRunModule(vm, "test_module", (uint8_t)strlen("test_module"));
+    }
+
+    static int64_t GetInt(SemiVM* vm, const char* name) {
+        Value moduleValue  = semiDictGet(&vm->modules,
+                                        semiValueIntCreate(semiSymbolTableGetId(
+                                            semiSymbolTableGet(&vm->symbolTable, "test_module", 11))));
+        SemiModule* module = AS_PTR(&moduleValue, SemiModule);
+
+        IdentifierId identifierId = semiSymbolTableGetId(semiSymbolTableGet(&vm->symbolTable, name, strlen(name)));
+        Value key                 = semiValueIntCreate(identifierId);
+        TupleId tupleId           = semiDictFindTupleId(&module->globals, key, semiHash64Bits(identifierId));
+        EXPECT_GE(tupleId, 0);
+        Value value = module->globals.values[tupleId];
+        EXPECT_TRUE(IS_INT(&value));
+        return AS_INT(&value);
+    }
+};
+
+TEST_F(CompileCacheTest, SameSourceIsCompiledOnce) {
+    const char* source =
+        "fn fib(n) {\n"
+        "    if n < 2 {\n"
+        "        return n\n"
+        "    }\n"
+        "    return fib(n - 1) + fib(n - 2)\n"
+        "}\n"
+        "name := \"compile cache\"\n"
+        "r := 0\n"
+        "for i in 0..10 {\n"
+        "    r = r + fib(i)\n"
+        "}\n";
+    ASSERT_EQ(Run(vms[0], source), 0);
+    EXPECT_EQ(cache->missCount, 1);
+    EXPECT_EQ(cache->hitCount, 0);
+
+    ASSERT_EQ(Run(vms[1], source), 0);
+    EXPECT_EQ(cache->hitCount, 1);
+    EXPECT_EQ(GetInt(vms[0], "r"), 88);
+    EXPECT_EQ(GetInt(vms[1], "r"), 88);
+}
+
+TEST_F(CompileCacheTest, DifferentSourceIsCompiled) {
+    ASSERT_EQ(Run(vms[0], "r := 1\n"), 0);
+    ASSERT_EQ(Run(vms[1], "r := 2\n"), 0);
+    EXPECT_EQ(cache->hitCount, 0);
+    EXPECT_EQ(cache->missCount, 2);
+    EXPECT_EQ(GetInt(vms[1], "r"), 2);
+}
+
+TEST_F(CompileCacheTest, DifferentEnvironmentIsCompiled) {
+    ASSERT_EQ(semiVMAddGlobalVariable(vms[1], "limit", 5, semiValueIntCreate(3)), 0);
+    ASSERT_EQ(Run(vms[0], "limit := 1\nr := limit\n"), 0);
+    ASSERT_EQ(Run(vms[1], "limit := 1\nr := limit\n"), SEMI_ERROR_VARIABLE_ALREADY_DEFINED);
+    EXPECT_EQ(cache->hitCount, 0);
+}
+
+TEST_F(CompileCacheTest, StructTypesAreRegistered) {
+    const char* source =
+        "struct Point { y, x }\n"
+        "p := Point{x: 1, y: 2}\n"
+        "r := p.x * 10 + p.y\n";
+    ASSERT_EQ(Run(vms[0], source), 0);
+    ASSERT_EQ(Run(vms[1], source), 0);
+    ASSERT_EQ(cache->hitCount, 1);
+    EXPECT_EQ(GetInt(vms[1], "r"), 12);
+    EXPECT_EQ(vms[1]->classes.classCount, vms[0]->classes.classCount);
+    EXPECT_EQ(vms[1]->symbolTable.nextId, vms[0]->symbolTable.nextId);
+}
+
+TEST_F(CompileCacheTest, ModulesAreLoadedInOrder) {
+    for (int i = 0; i < 2; i++) {
+        ASSERT_NE(Compile(vms[i], "a := 1\n", "first"), nullptr);
+        ASSERT_NE(Compile(vms[i], "b := 2\n", "second"), nullptr);
+    }
+    EXPECT_EQ(cache->hitCount, 2);
+
+    // The second module was compiled after the first one, which the third VM doesn't have.
+    ASSERT_NE(Compile(vms[2], "b := 2\n", "second"), nullptr);
+    EXPECT_EQ(cache->hitCount, 2);
+}
+
+TEST_F(CompileCacheTest, ExistingModuleIsRecompiled) {
+    ASSERT_EQ(Run(vms[0], "r := 1\n"), 0);
+    ASSERT_EQ(Run(vms[0], "r := 1\n"), 0);
+    EXPECT_EQ(cache->hitCount, 0);
+    EXPECT_EQ(GetInt(vms[0], "r"), 1);
+}
+
+// A storage backed by a map, which returns the last stored bytes for every key when `collide` is set.
+struct MapStorage {
+    std::map<uint64_t, std::string> entries;
+    std::string last;
+    bool collide     = false;
+    size_t loadCount = 0;
+
+    static size_t Load(uint64_t key, const void** data, void* userData) {
+        MapStorage* storage = static_cast<MapStorage*>(userData);
+        storage->loadCount++;
+        auto it             = storage->entries.find(key);
+        const std::string* bytes =
+            storage->collide ? &storage->last : (it != storage->entries.end() ? &it->second : nullptr);
+        if (bytes == nullptr || bytes->empty()) {
+            return 0;
+        }
+        *data = bytes->data();
+        return bytes->size();
+    }
+
+    static void Store(uint64_t key, const void* data, size_t size, void* userData) {
+        MapStorage* storage   = static_cast<MapStorage*>(userData);
+        storage->entries[key] = std::string(static_cast<const char*>(data), size);
+        storage->last         = storage->entries[key];
+    }
+
+    SemiCompileCacheStorage Get() { return SemiCompileCacheStorage{&Load, &Store, this}; }
+};
+
+TEST_F(CompileCacheTest, ModuleIsLoadedFromStorage) {
+    MapStorage mapStorage;
+    SemiCompileCacheStorage storage = mapStorage.Get();
+    semiCompileCacheSetStorage(cache, &storage);
+    const char* source =
+        "fn twice(n) {\n"
+        "    return n * 2\n"
+        "}\n"
+        "name := \"storage\"\n"
+        "r := 0\n"
+        "for i in 0..4 {\n"
+        "    r = r + twice(i)\n"
+        "}\n";
+    ASSERT_EQ(Run(vms[0], source), 0);
+    ASSERT_EQ(mapStorage.entries.size(), 1u);
+
+    // A new cache starts empty, so the module can only come from the storage.
+    SemiCompileCache* otherCache = semiCreateCompileCache(nullptr);
+    ASSERT_NE(otherCache, nullptr);
+    semiCompileCacheSetStorage(otherCache, &storage);
+    semiVMSetCompileCache(vms[1], otherCache);
+    ASSERT_EQ(Run(vms[1], source), 0);
+    EXPECT_EQ(otherCache->hitCount, 1);
+    EXPECT_EQ(GetInt(vms[1], "r"), 12);
+    semiVMSetCompileCache(vms[1], nullptr);
+    semiDestroyCompileCache(otherCache);
+}
+
+TEST_F(CompileCacheTest, ExistingModuleDoesNotReadStorage) {
+    MapStorage mapStorage;
+    SemiCompileCacheStorage storage = mapStorage.Get();
+    semiCompileCacheSetStorage(cache, &storage);
+    ASSERT_EQ(Run(vms[0], "r := 1\n"), 0);
+    ASSERT_EQ(mapStorage.loadCount, 1u);
+
+    ASSERT_EQ(Run(vms[0], "r := 2\n"), 0);
+    EXPECT_EQ(mapStorage.loadCount, 1u);
+    EXPECT_EQ(mapStorage.entries.size(), 1u);
+    EXPECT_EQ(cache->missCount, 2);
+    EXPECT_EQ(GetInt(vms[0], "r"), 2);
+}
+
+TEST_F(CompileCacheTest, CollidingKeyIsCompiled) {
+    MapStorage mapStorage;
+    mapStorage.collide              = true;
+    SemiCompileCacheStorage storage = mapStorage.Get();
+    semiCompileCacheSetStorage(cache, &storage);
+    ASSERT_EQ(Run(vms[0], "r := 1\n"), 0);
+
+    // The storage returns the module of another source, which must not be loaded.
+    ASSERT_EQ(Run(vms[1], "r := 2\n"), 0);
+    EXPECT_EQ(cache->hitCount, 0);
+    EXPECT_EQ(GetInt(vms[1], "r"), 2);
+}
+
+TEST_F(CompileCacheTest, UnreadableStorageIsIgnored) {
+    MapStorage mapStorage;
+    mapStorage.collide              = true;
+    mapStorage.last                 = "not a module";
+    SemiCompileCacheStorage storage = mapStorage.Get();
+    storage.storeFn                 = nullptr;
+    semiCompileCacheSetStorage(cache, &storage);
+    ASSERT_EQ(Run(vms[0], "r := 3\n"), 0);
+    EXPECT_EQ(cache->hitCount, 0);
+    EXPECT_EQ(GetInt(vms[0], "r"), 3);
+}
+
+TEST_F(CompileCacheTest, CorruptedStorageIsIgnored) {
+    MapStorage mapStorage;
+    SemiCompileCacheStorage storage = mapStorage.Get();
+    semiCompileCacheSetStorage(cache, &storage);
+    const char* source =
+        "struct P { x, y }\n"
+        "p := P{x: 1, y: 2}\n"
+        "r := p.x + p.y\n";
+    ASSERT_EQ(Run(vms[0], source), 0);
+    ASSERT_EQ(mapStorage.entries.size(), 1u);
+    const std::string stored = mapStorage.last;
+
+    // The identifiers follow the header, the name and the source. The struct types follow the identifiers.
+    size_t identifiersOffset = 4 + 4 + sizeof(CompileEnvironment) + 4 + 1 + strlen("test_module") + 4 + strlen(source);
+    uint32_t identifiersSize;
+    memcpy(&identifiersSize, stored.data() + identifiersOffset, sizeof(identifiersSize));
+    ASSERT_GT(identifiersSize, 0u);
+    size_t fieldCountOffset = identifiersOffset + 4 + identifiersSize + 4 + sizeof(IdentifierId);
+
+    std::string badIdentifier            = stored;
+    badIdentifier[identifiersOffset + 4] = (char)UINT8_MAX;
+    std::string badFieldCount            = stored;
+    IdentifierId fieldCount              = 5000;
+    memcpy(&badFieldCount[fieldCountOffset], &fieldCount, sizeof(fieldCount));
+
+    SemiVM** vm = &vms[1];
+    for (const std::string& corrupted : {badIdentifier, badFieldCount}) {
+        MapStorage corruptedStorage;
+        corruptedStorage.collide         = true;
+        corruptedStorage.last            = corrupted;
+        SemiCompileCacheStorage readOnly = corruptedStorage.Get();
+        readOnly.storeFn                 = nullptr;
+        SemiCompileCache* otherCache     = semiCreateCompileCache(nullptr);
+        ASSERT_NE(otherCache, nullptr);
+        semiCompileCacheSetStorage(otherCache, &readOnly);
+        semiVMSetCompileCache(*vm, otherCache);
+
+        EXPECT_EQ(Run(*vm, source), 0);
+        EXPECT_EQ(otherCache->hitCount, 0u);
+        EXPECT_EQ(GetInt(*vm, "r"), 3);
+        semiVMSetCompileCache(*vm, nullptr);
+        semiDestroyCompileCache(otherCache);
+        vm++;
+    }
+}
@@ -0,0 +1,158 @@
+// Copyright (c) 2025 Ian Chen
+// SPDX-License-Identifier: MPL-2.0
+
+#include <gtest/gtest.h>
+
+#include "instruction_verifier.hpp"
+#include "test_common.hpp"
+
+using namespace InstructionVerifier;
+
+using CompilerConstantPropagationTest = OptimizedCompilerTest<&Compiler::enableConstantPropagation>;
+
+TEST_F(CompilerConstantPropagationTest, ModuleConstantsFoldIntoLaterStatements) {
+    ErrorId result = ParseModule("limit := 100\nx := limit * 2\ny := x + limit");
+    ASSERT_EQ(result, 0);
+
+    VerifyModule(module, R"(
+[Instructions]
+0: OP_LOAD_INLINE_INTEGER   A=0x00 K=0x0064 i=T s=T
+1: OP_SET_MODULE_VAR        A=0x00 K=0x0000 i=F s=F
+2: OP_LOAD_INLINE_INTEGER   A=0x00 K=0x00C8 i=T s=T
+3: OP_SET_MODULE_VAR        A=0x00 K=0x0001 i=F s=F
+4: OP_LOAD_INLINE_INTEGER   A=0x00 K=0x012C i=T s=T
+5: OP_SET_MODULE_VAR        A=0x00 K=0x0002 i=F s=F
+6: OP_RETURN                A=0xFF B=0x00 C=0x00 kb=F kc=F
+)");
+}
+
+TEST_F(CompilerConstantPropagationTest, StringConcatenationFolds) {
+    ErrorId result = ParseModule("greeting := \"hello\"\nmessage := greeting + \" world\"");
+    ASSERT_EQ(result, 0);
+
+    VerifyModule(module, R"(
+[Instructions]
+0: OP_LOAD_CONSTANT         A=0x00 K=0x0000 i=F s=F
+1: OP_SET_MODULE_VAR        A=0x00 K=0x0000 i=F s=F
+2: OP_LOAD_CONSTANT         A=0x00 K=0x0001 i=F s=F
+3: OP_SET_MODULE_VAR        A=0x00 K=0x0001 i=F s=F
+4: OP_RETURN                A=0xFF B=0x00 C=0x00 kb=F kc=F
+
+[Constants]
+K[0]: String "hello" length=5
+K[1]: String "hello world" length=11
+)");
+}
+
+TEST_F(CompilerConstantPropagationTest, ReassignedBindingsAreReadAtRuntime) {
+    // `counter` is assigned inside `bump`, which may run at any point after it is defined, so every read of it stays a
+    // module variable access. `step` is never assigned and folds into `bump`.
+    ErrorId result = ParseModule(
+        "counter := 0\n"
+        "step := 2\n"
+        "fn bump() { counter = counter + step }\n"
+        "x := counter");
+    ASSERT_EQ(result, 0);
+
+    VerifyModule(module, R"(
+[Instructions]
+0: OP_LOAD_INLINE_INTEGER   A=0x00 K=0x0000 i=T s=T
+1: OP_SET_MODULE_VAR        A=0x00 K=0x0000 i=F s=F
+2: OP_LOAD_INLINE_INTEGER   A=0x00 K=0x0002 i=T s=T
+3: OP_SET_MODULE_VAR        A=0x00 K=0x0001 i=F s=F
+4: OP_LOAD_CONSTANT         A=0x00 K=0x0000 i=F s=F
+5: OP_SET_MODULE_VAR        A=0x00 K=0x0002 i=F s=F
+6: OP_GET_MODULE_VAR        A=0x00 K=0x0000 i=F s=F
+7: OP_SET_MODULE_VAR        A=0x00 K=0x0003 i=F s=F
+8: OP_RETURN                A=0xFF B=0x00 C=0x00 kb=F kc=F
+
+[Constants]
+K[0]: FunctionProto arity=0 coarity=0 maxStackSize=2 -> @bump
+
+[Instructions:bump]
+0: OP_GET_MODULE_VAR        A=0x00 K=0x0000 i=F s=F
+1: OP_ADD                   A=0x00 B=0x00 C=0x82 kb=F kc=T
+2: OP_SET_MODULE_VAR        A=0x00 K=0x0000 i=F s=F
+3: OP_RETURN                A=0xFF B=0x00 C=0x00 kb=F kc=F
+)");
+}
+
+TEST_F(CompilerConstantPropagationTest, LocalsAndCapturedConstantsFold) {
+    // `k` folds into `g` without being captured; `m` is not a constant and is still read through an upvalue.
+    ErrorId result = ParseModule(
+        "fn f(a) {\n"
+        "  k := 3\n"
+        "  m := a\n"
+        "  fn g(b) { return b * k + m }\n"
+        "  return g(k)\n"
+        "}");
+    ASSERT_EQ(result, 0);
+
+    VerifyModule(module, R"(
+[Instructions]
+0: OP_LOAD_CONSTANT         A=0x00 K=0x0001 i=F s=F
+1: OP_SET_MODULE_VAR        A=0x00 K=0x0000 i=F s=F
+2: OP_RETURN                A=0xFF B=0x00 C=0x00 kb=F kc=F
+
+[Constants]
+K[0]: FunctionProto arity=1 coarity=1 maxStackSize=3 -> @g
+K[1]: FunctionProto arity=1 coarity=1 maxStackSize=6 -> @f
+
+[Instructions:g]
+0: OP_MULTIPLY              A=0x01 B=0x00 C=0x83 kb=F kc=T
+1: OP_GET_UPVALUE           A=0x02 B=0x00 C=0x00 kb=F kc=F
+2: OP_ADD                   A=0x01 B=0x01 C=0x02 kb=F kc=F
+3: OP_RETURN                A=0x01 B=0x00 C=0x00 kb=F kc=F
+
+[Instructions:f]
+0: OP_LOAD_INLINE_INTEGER   A=0x01 K=0x0003 i=T s=T
+1: OP_MOVE                  A=0x02 B=0x00 C=0x00 kb=F kc=F
+2: OP_LOAD_CONSTANT         A=0x03 K=0x0000 i=F s=F
+3: OP_MOVE                  A=0x04 B=0x03 C=0x00 kb=F kc=F
+4: OP_LOAD_INLINE_INTEGER   A=0x05 K=0x0003 i=T s=T
+5: OP_CALL                  A=0x04 B=0x01 C=0x00 kb=F kc=F
+6: OP_RETURN                A=0x04 B=0x00 C=0x00 kb=F kc=F
+)");
+}
+
+TEST_F(CompilerConstantPropagationTest, PropagatedConditionsDropDeadBranches) {
+    ErrorId result = ParseModule(
+        "debug := false\n"
+        "fn f(a) {\n"
+        "  if debug { return 0 }\n"
+        "  return a\n"
+        "}");
+    ASSERT_EQ(result, 0);
+
+    VerifyModule(module, R"(
+[Instructions]
+0: OP_LOAD_BOOL             A=0x00 K=0x0000 i=F s=F
+1: OP_SET_MODULE_VAR        A=0x00 K=0x0000 i=F s=F
+2: OP_LOAD_CONSTANT         A=0x00 K=0x0000 i=F s=F
+3: OP_SET_MODULE_VAR        A=0x00 K=0x0001 i=F s=F
+4: OP_RETURN                A=0xFF B=0x00 C=0x00 kb=F kc=F
+
+[Instructions:f]
+0: OP_CLOSE_UPVALUES        A=0x01 B=0x00 C=0x00 kb=F kc=F
+1: OP_RETURN                A=0x00 B=0x00 C=0x00 kb=F kc=F
+)");
+}
+
+TEST_F(CompilerConstantPropagationTest, AssignmentsInStringsAndCommentsAreIgnored) {
+    ErrorId result = ParseModule(
+        "limit := 10  # limit = 20\n"
+        "label := \"limit = 30\"\n"
+        "x := limit + 1");
+    ASSERT_EQ(result, 0);
+
+    VerifyModule(module, R"(
+[Instructions]
+0: OP_LOAD_INLINE_INTEGER   A=0x00 K=0x000A i=T s=T
+1: OP_SET_MODULE_VAR        A=0x00 K=0x0000 i=F s=F
+2: OP_LOAD_CONSTANT         A=0x00 K=0x0000 i=F s=F
+3: OP_SET_MODULE_VAR        A=0x00 K=0x0001 i=F s=F
+4: OP_LOAD_INLINE_INTEGER   A=0x00 K=0x000B i=T s=T
+5: OP_SET_MODULE_VAR        A=0x00 K=0x0002 i=F s=F
+6: OP_RETURN                A=0xFF B=0x00 C=0x00 kb=F kc=F
+)");
+}
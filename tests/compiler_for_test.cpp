@@ -25,7 +25,6 @@ TEST_F(CompilerForTest, SimpleForLoopWithRange) {
 0: OP_LOAD_CONSTANT   A=0x00 K=0x0000 i=F s=F
 1: OP_RANGE_NEXT      A=0x00 K=0x0002 i=F s=F
 2: OP_JUMP            J=0x000001 s=F
-3: OP_CLOSE_UPVALUES  A=0x00 B=0x00 C=0x00 kb=F kc=F
 
 [Constants]
 K[0]: Range start=0 end=10 step=1
@@ -43,7 +42,6 @@ TEST_F(CompilerForTest, ForLoopWithExplicitStep) {
 0: OP_LOAD_CONSTANT   A=0x00 K=0x0000 i=F s=F
 1: OP_RANGE_NEXT      A=0x00 K=0x0002 i=F s=F
 2: OP_JUMP            J=0x000001 s=F
-3: OP_CLOSE_UPVALUES  A=0x00 B=0x00 C=0x00 kb=F kc=F
 
 [Constants]
 K[0]: Range start=0 end=10 step=2
@@ -64,7 +62,6 @@ TEST_F(CompilerForTest, ForLoopWithIndexAndItem) {
 3: OP_MOVE                 A=0x04 B=0x03 C=0x00 kb=F kc=F
 4: OP_MOVE                 A=0x05 B=0x02 C=0x00 kb=F kc=F
 5: OP_JUMP                 J=0x000003 s=F
-6: OP_CLOSE_UPVALUES       A=0x00 B=0x00 C=0x00 kb=F kc=F
 
 [Constants]
 K[0]: Range start=0 end=5 step=1
@@ -85,7 +82,23 @@ TEST_F(CompilerForTest, ForLoopWithVariableInRange) {
 1: OP_MAKE_RANGE     A=0x02 B=0x01 C=0x81 kb=F kc=T
 2: OP_RANGE_NEXT     A=0x02 K=0x0002 i=F s=F
 3: OP_JUMP           J=0x000001 s=F
-4: OP_CLOSE_UPVALUES A=0x02 B=0x00 C=0x00 kb=F kc=F
+)");
+}
+
+TEST_F(CompilerForTest, ForLoopOverIterable) {
+    InitializeVariable("items");
+    const char* source = "for i, item in items { curr := item }";
+
+    ErrorId(result) = ParseStatement(source, false);
+    EXPECT_EQ(result, 0) << "For loop over an iterable should parse successfully";
+
+    VerifyCompiler(&compiler, R"(
+[Instructions]
+0: OP_MOVE           A=0x01 B=0x00 C=0x00 kb=F kc=F
+1: OP_ITER_PREPARE   A=0x01 B=0x01 C=0x00 kb=F kc=F
+2: OP_ITER_NEXT      A=0x01 K=0x0003 i=T s=F
+3: OP_MOVE           A=0x06 B=0x04 C=0x00 kb=F kc=F
+4: OP_JUMP           J=0x000002 s=F
 )");
 }
 
@@ -98,13 +111,11 @@ TEST_F(CompilerForTest, NestedForLoops) {
     VerifyCompiler(&compiler, R"(
 [Instructions]
 0: OP_LOAD_CONSTANT   A=0x00 K=0x0000 i=F s=F
-1: OP_RANGE_NEXT      A=0x00 K=0x0006 i=F s=F
+1: OP_RANGE_NEXT      A=0x00 K=0x0005 i=F s=F
 2: OP_LOAD_CONSTANT   A=0x02 K=0x0001 i=F s=F
 3: OP_RANGE_NEXT      A=0x02 K=0x0002 i=F s=F
 4: OP_JUMP            J=0x000001 s=F
-5: OP_CLOSE_UPVALUES  A=0x02 B=0x00 C=0x00 kb=F kc=F
-6: OP_JUMP            J=0x000005 s=F
-7: OP_CLOSE_UPVALUES  A=0x00 B=0x00 C=0x00 kb=F kc=F
+5: OP_JUMP            J=0x000004 s=F
 
 [Constants]
 K[0]: Range start=0 end=3 step=1
@@ -124,7 +135,6 @@ TEST_F(CompilerForTest, NegativeRangeStep) {
 0: OP_LOAD_CONSTANT   A=0x00 K=0x0000 i=F s=F
 1: OP_RANGE_NEXT      A=0x00 K=0x0002 i=F s=F
 2: OP_JUMP            J=0x000001 s=F
-3: OP_CLOSE_UPVALUES  A=0x00 B=0x00 C=0x00 kb=F kc=F
 
 [Constants]
 K[0]: Range start=10 end=0 step=-1
@@ -145,7 +155,6 @@ TEST_F(CompilerForTest, ExpressionInRange) {
 4: OP_MAKE_RANGE     A=0x01 B=0x02 C=0x81 kb=F kc=T
 5: OP_RANGE_NEXT     A=0x01 K=0x0002 i=F s=F
 6: OP_JUMP           J=0x000001 s=F
-7: OP_CLOSE_UPVALUES A=0x01 B=0x00 C=0x00 kb=F kc=F
 )");
 }
 
@@ -159,10 +168,8 @@ TEST_F(CompilerForTest, ForLoopWithBreak) {
     VerifyCompiler(&compiler, R"(
 [Instructions]
 0: OP_LOAD_CONSTANT   A=0x00 K=0x0000 i=F s=F
-1: OP_RANGE_NEXT      A=0x00 K=0x0003 i=F s=F
-3: OP_JUMP            J=0x000002 s=T
-4: OP_JUMP            J=0x000002 s=F
-5: OP_CLOSE_UPVALUES  A=0x00 B=0x00 C=0x00 kb=F kc=F
+1: OP_RANGE_NEXT      A=0x00 K=0x0002 i=F s=F
+2: OP_JUMP            J=0x000001 s=T
 
 [Constants]
 K[0]: Range start=0 end=10 step=1
@@ -178,10 +185,8 @@ TEST_F(CompilerForTest, ForLoopWithContinue) {
     VerifyCompiler(&compiler, R"(
 [Instructions]
 0: OP_LOAD_CONSTANT   A=0x00 K=0x0000 i=F s=F
-1: OP_RANGE_NEXT      A=0x00 K=0x0003 i=F s=F
-3: OP_JUMP            J=0x000001 s=F
-4: OP_JUMP            J=0x000002 s=F
-5: OP_CLOSE_UPVALUES  A=0x00 B=0x00 C=0x00 kb=F kc=F
+1: OP_RANGE_NEXT      A=0x00 K=0x0002 i=F s=F
+2: OP_JUMP            J=0x000001 s=F
 
 [Constants]
 K[0]: Range start=0 end=10 step=1
@@ -196,18 +201,15 @@ TEST_F(CompilerForTest, ForLoopWithBreakAndContinue) {
 
     VerifyCompiler(&compiler, R"(
 [Instructions]
-0:  OP_LOAD_CONSTANT   A=0x00 K=0x0000 i=F s=F
-1:  OP_RANGE_NEXT      A=0x00 K=0x000A i=F s=F
-2:  OP_EQ              A=0x02 B=0x01 C=0x82 kb=F kc=T
-3:  OP_C_JUMP          A=0x02 K=0x0002 i=F s=T
-4:  OP_JUMP            J=0x000003 s=F
-5:  OP_CLOSE_UPVALUES  A=0x02 B=0x00 C=0x00 kb=F kc=F
-6:  OP_EQ              A=0x02 B=0x01 C=0x84 kb=F kc=T
-7:  OP_C_JUMP          A=0x02 K=0x0002 i=F s=T
-8:  OP_JUMP            J=0x000003 s=T
-9:  OP_CLOSE_UPVALUES  A=0x02 B=0x00 C=0x00 kb=F kc=F
-10: OP_JUMP            J=0x000009 s=F
-11: OP_CLOSE_UPVALUES  A=0x00 B=0x00 C=0x00 kb=F kc=F
+0: OP_LOAD_CONSTANT   A=0x00 K=0x0000 i=F s=F
+1: OP_RANGE_NEXT      A=0x00 K=0x0008 i=F s=F
+2: OP_EQ              A=0x02 B=0x01 C=0x82 kb=F kc=T
+3: OP_C_JUMP          A=0x02 K=0x0002 i=F s=T
+4: OP_JUMP            J=0x000003 s=F
+5: OP_EQ              A=0x02 B=0x01 C=0x84 kb=F kc=T
+6: OP_C_JUMP          A=0x02 K=0x0002 i=F s=T
+7: OP_JUMP            J=0x000002 s=T
+8: OP_JUMP            J=0x000007 s=F
 
 [Constants]
 K[0]: Range start=0 end=5 step=1
@@ -223,21 +225,17 @@ TEST_F(CompilerForTest, NestedForLoopsWithBreakAndContinue) {
     VerifyCompiler(&compiler, R"(
 [Instructions]
 0:  OP_LOAD_CONSTANT   A=0x00 K=0x0000 i=F s=F
-1:  OP_RANGE_NEXT      A=0x00 K=0x000E i=F s=F
+1:  OP_RANGE_NEXT      A=0x00 K=0x000B i=F s=F
 2:  OP_LOAD_CONSTANT   A=0x02 K=0x0001 i=F s=F
-3:  OP_RANGE_NEXT      A=0x02 K=0x000A i=F s=F
+3:  OP_RANGE_NEXT      A=0x02 K=0x0008 i=F s=F
 4:  OP_EQ              A=0x04 B=0x03 C=0x81 kb=F kc=T
 5:  OP_C_JUMP          A=0x04 K=0x0002 i=F s=T
 6:  OP_JUMP            J=0x000003 s=F
-7:  OP_CLOSE_UPVALUES  A=0x04 B=0x00 C=0x00 kb=F kc=F
-8:  OP_EQ              A=0x04 B=0x01 C=0x82 kb=F kc=T
-9:  OP_C_JUMP          A=0x04 K=0x0002 i=F s=T
-10: OP_JUMP            J=0x000003 s=T
-11: OP_CLOSE_UPVALUES  A=0x04 B=0x00 C=0x00 kb=F kc=F
-12: OP_JUMP            J=0x000009 s=F
-13: OP_CLOSE_UPVALUES  A=0x02 B=0x00 C=0x00 kb=F kc=F
-14: OP_JUMP            J=0x00000D s=F
-15: OP_CLOSE_UPVALUES  A=0x00 B=0x00 C=0x00 kb=F kc=F
+7:  OP_EQ              A=0x04 B=0x01 C=0x82 kb=F kc=T
+8:  OP_C_JUMP          A=0x04 K=0x0002 i=F s=T
+9:  OP_JUMP            J=0x000002 s=T
+10: OP_JUMP            J=0x000007 s=F
+11: OP_JUMP            J=0x00000A s=F
 
 [Constants]
 K[0]: Range start=0 end=3 step=1
@@ -245,6 +243,28 @@ K[1]: Range start=0 end=2 step=1
 )");
 }
 
+TEST_F(CompilerForTest, CapturedVariableIsClosedAfterBreak) {
+    const char* source = "for i in 0..3 { if i == 1 { x := i\n fn g() { return x }\n break } }";
+
+    ErrorId(result) = ParseStatement(source, false);
+    EXPECT_EQ(result, 0) << "For loop with a closure should parse successfully";
+
+    // The break skips the CLOSE_UPVALUES of the if-block, so the loop closes the captured variable too.
+    VerifyCompiler(&compiler, R"(
+[Instructions]
+0:  OP_LOAD_CONSTANT   A=0x00 K=0x0000 i=F s=F
+1:  OP_RANGE_NEXT      A=0x00 K=0x0008 i=F s=F
+2:  OP_EQ              A=0x02 B=0x01 C=0x81 kb=F kc=T
+3:  OP_C_JUMP          A=0x02 K=0x0004 i=F s=T
+4:  OP_MOVE            A=0x02 B=0x01 C=0x00 kb=F kc=F
+5:  OP_LOAD_CONSTANT   A=0x03 K=0x0001 i=F s=F
+6:  OP_JUMP            J=0x000003 s=T
+7:  OP_CLOSE_UPVALUES  A=0x02 B=0x00 C=0x00 kb=F kc=F
+8:  OP_JUMP            J=0x000007 s=F
+9:  OP_CLOSE_UPVALUES  A=0x00 B=0x00 C=0x00 kb=F kc=F
+)");
+}
+
 // Error Cases
 TEST_F(CompilerForTest, MissingInKeyword) {
     const char* source = "for i 0..10 { }";
@@ -281,6 +301,32 @@ TEST_F(CompilerForTest, TooManyVariables) {
     EXPECT_NE(result, 0) << "Too many variables should cause parse error";
 }
 
+TEST_F(CompilerForTest, LongLoopBodyUsesExtraArg) {
+    std::string source = "{ x := 0\nfor i in 0..10 {\n";
+    for (int i = 0; i < 70000; i++) {
+        source += "x = x + i\n";
+    }
+    source += "} }";
+
+    ErrorId(result) = ParseStatement(source.c_str(), false);
+    ASSERT_EQ(result, 0) << "Loop bodies longer than K should parse successfully";
+
+    // The loop header is prefixed, and the back jump targets the prefix so that the header is re-decoded.
+    Instruction prefix = GetInstruction(2);
+    Instruction header = GetInstruction(3);
+    ASSERT_EQ(GET_OPCODE(prefix), OP_EXTRA_ARG);
+    ASSERT_EQ(GET_OPCODE(header), OP_RANGE_NEXT);
+
+    uint32_t offset = (OPERAND_J_J(prefix) << 16) | OPERAND_K_K(header);
+    EXPECT_GT(offset, (uint32_t)MAX_OPERAND_K);
+    EXPECT_EQ(3 + offset, GetCodeSize()) << "Loop exit should land right after the back jump";
+
+    Instruction backJump = GetInstruction(GetCodeSize() - 1);
+    ASSERT_EQ(GET_OPCODE(backJump), OP_JUMP);
+    EXPECT_FALSE(OPERAND_J_S(backJump));
+    EXPECT_EQ(OPERAND_J_J(backJump), GetCodeSize() - 1 - 2);
+}
+
 // Error Cases for Break and Continue
 TEST_F(CompilerForTest, BreakOutsideLoop) {
     const char* source = "break;";
@@ -295,3 +341,45 @@ TEST_F(CompilerForTest, ContinueOutsideLoop) {
     ErrorId(result) = ParseStatement(source, false);
     EXPECT_NE(result, 0) << "Continue outside of loop should cause parse error";
 }
+
+// Dead Code Elimination
+TEST_F(CompilerForTest, CodeAfterBreakIsDiscarded) {
+    const char* source = "for i in 0..10 { break\ni = 1\nfor j in 0..2 { break } }";
+
+    ErrorId(result) = ParseStatement(source, false);
+    EXPECT_EQ(result, 0);
+
+    VerifyCompiler(&compiler, R"(
+[Instructions]
+0: OP_LOAD_CONSTANT   A=0x00 K=0x0000 i=F s=F
+1: OP_RANGE_NEXT      A=0x00 K=0x0002 i=F s=F
+2: OP_JUMP            J=0x000001 s=T
+)");
+}
+
+TEST_F(CompilerForTest, EmptyConstantRangeIsDiscarded) {
+    const char* source = "{ x := 0\nfor i in 5..5 { x = i }\nfor i in 0..3 by -1 { x = i }\nx = 1 }";
+
+    ErrorId(result) = ParseStatement(source, false);
+    EXPECT_EQ(result, 0);
+
+    VerifyCompiler(&compiler, R"(
+[Instructions]
+0: OP_LOAD_INLINE_INTEGER  A=0x00 K=0x0000 i=T s=T
+1: OP_LOAD_INLINE_INTEGER  A=0x00 K=0x0001 i=T s=T
+)");
+}
+
+TEST_F(CompilerForTest, CodeAfterInfiniteLoopIsDiscarded) {
+    const char* source = "{ x := 0\nfor { x = x + 1 }\nx = 2 }";
+
+    ErrorId(result) = ParseStatement(source, false);
+    EXPECT_EQ(result, 0);
+
+    VerifyCompiler(&compiler, R"(
+[Instructions]
+0: OP_LOAD_INLINE_INTEGER  A=0x00 K=0x0000 i=T s=T
+1: OP_ADD                  A=0x00 B=0x00 C=0x81 kb=F kc=T
+2: OP_JUMP                 J=0x000001 s=F
+)");
+}
@@ -15,66 +15,60 @@ class CompilerIfTest : public CompilerTest {};
 
 // Basic If Statement Variations
 TEST_F(CompilerIfTest, SimpleIfStatement) {
-    const char* source = "if true { }";
+    InitializeVariable("c");
+    const char* source = "if c { }";
 
     ErrorId result = ParseStatement(source, false);
     EXPECT_EQ(result, 0) << "Simple if statement should parse successfully";
 
     VerifyCompiler(&compiler, R"(
 [Instructions]
-0: OP_LOAD_BOOL         A=0x00 K=0x0000 i=T s=F
-1: OP_C_JUMP            A=0x00 K=0x0001 i=F s=T
-2: OP_CLOSE_UPVALUES    A=0x00 B=0x00 C=0x00 kb=F kc=F
+0: OP_C_JUMP            A=0x00 K=0x0001 i=F s=T
 )");
 }
 
 TEST_F(CompilerIfTest, IfElseStatement) {
-    const char* source = "if true { } else { }";
+    InitializeVariable("c");
+    const char* source = "if c { } else { }";
 
     ErrorId result = ParseStatement(source, false);
     EXPECT_EQ(result, 0) << "If-else statement should parse successfully";
 
     VerifyCompiler(&compiler, R"(
 [Instructions]
-0: OP_LOAD_BOOL         A=0x00 K=0x0000 i=T s=F
-1: OP_C_JUMP            A=0x00 K=0x0002 i=F s=T
-2: OP_JUMP              J=0x000001 s=T
-3: OP_CLOSE_UPVALUES    A=0x00 B=0x00 C=0x00 kb=F kc=F
+0: OP_C_JUMP            A=0x00 K=0x0002 i=F s=T
+1: OP_JUMP              J=0x000001 s=T
 )");
 }
 
 TEST_F(CompilerIfTest, IfElifStatement) {
-    const char* source = "if false { } elif true { }";
+    InitializeVariable("c");
+    const char* source = "if c { } elif c { }";
 
     ErrorId result = ParseStatement(source, false);
     EXPECT_EQ(result, 0) << "If-elif statement should parse successfully";
 
     VerifyCompiler(&compiler, R"(
 [Instructions]
-0: OP_LOAD_BOOL         A=0x00 K=0x0000 i=F s=F
-1: OP_C_JUMP            A=0x00 K=0x0002 i=F s=T
-2: OP_JUMP              J=0x000003 s=T
-3: OP_LOAD_BOOL         A=0x00 K=0x0000 i=T s=F
-4: OP_C_JUMP            A=0x00 K=0x0001 i=F s=T
-5: OP_CLOSE_UPVALUES    A=0x00 B=0x00 C=0x00 kb=F kc=F
+0: OP_C_JUMP            A=0x00 K=0x0002 i=F s=T
+1: OP_JUMP              J=0x000002 s=T
+2: OP_C_JUMP            A=0x00 K=0x0001 i=F s=T
 )");
 }
 
 TEST_F(CompilerIfTest, IfElifElseStatement) {
-    const char* source = "if false { } elif false { } else { }";
+    InitializeVariable("c");
+    const char* source = "if c { } elif c { } else { }";
 
     ErrorId result = ParseStatement(source, false);
     EXPECT_EQ(result, 0) << "If-elif-else statement should parse successfully";
 
     VerifyCompiler(&compiler, R"(
 [Instructions]
-0: OP_LOAD_BOOL         A=0x00 K=0x0000 i=F s=F
-1: OP_C_JUMP            A=0x00 K=0x0002 i=F s=T
-2: OP_JUMP              J=0x000004 s=T
-3: OP_LOAD_BOOL         A=0x00 K=0x0000 i=F s=F
-4: OP_C_JUMP            A=0x00 K=0x0002 i=F s=T
-5: OP_JUMP              J=0x000001 s=T
-6: OP_CLOSE_UPVALUES    A=0x00 B=0x00 C=0x00 kb=F kc=F
+0: OP_C_JUMP            A=0x00 K=0x0002 i=F s=T
+1: OP_JUMP              J=0x000003 s=T
+2: OP_C_JUMP            A=0x00 K=0x0002 i=F s=T
+3: OP_JUMP              J=0x000001 s=T
 )");
 }
 
@@ -87,10 +81,7 @@ TEST_F(CompilerIfTest, ConstantTrueCondition) {
 
     VerifyCompiler(&compiler, R"(
 [Instructions]
-0: OP_LOAD_BOOL              A=0x00 K=0x0000 i=T s=F
-1: OP_C_JUMP                 A=0x00 K=0x0002 i=F s=T
-2: OP_LOAD_INLINE_INTEGER    A=0x00 K=0x0005 i=T s=T
-3: OP_CLOSE_UPVALUES         A=0x00 B=0x00 C=0x00 kb=F kc=F
+0: OP_LOAD_INLINE_INTEGER    A=0x00 K=0x0005 i=T s=T
 )");
 }
 
@@ -102,13 +93,26 @@ TEST_F(CompilerIfTest, ConstantFalseCondition) {
 
     VerifyCompiler(&compiler, R"(
 [Instructions]
-0: OP_LOAD_BOOL              A=0x00 K=0x0000 i=F s=F
-1: OP_C_JUMP                 A=0x00 K=0x0002 i=F s=T
+0: OP_LOAD_INLINE_INTEGER    A=0x00 K=0x000A i=T s=T
+)");
+}
+
+TEST_F(CompilerIfTest, ConstantConditionsDropDeadBranches) {
+    InitializeVariable("c");
+    const char* source = "if false { x := 1 } elif c { x := 2 } elif true { x := 3 } else { x := 4 }";
+
+    ErrorId result = ParseStatement(source, false);
+    EXPECT_EQ(result, 0);
+
+    VerifyCompiler(&compiler, R"(
+[Instructions]
+0: OP_C_JUMP                 A=0x00 K=0x0003 i=F s=T
+1: OP_LOAD_INLINE_INTEGER    A=0x01 K=0x0002 i=T s=T
 2: OP_JUMP                   J=0x000002 s=T
-3: OP_LOAD_INLINE_INTEGER    A=0x00 K=0x000A i=T s=T
-4: OP_CLOSE_UPVALUES         A=0x00 B=0x00 C=0x00 kb=F kc=F
+3: OP_LOAD_INLINE_INTEGER    A=0x01 K=0x0003 i=T s=T
 )");
 }
+
 TEST_F(CompilerIfTest, VariableCondition) {
     InitializeVariable("x");
     const char* source = "if x { }";
@@ -119,7 +123,6 @@ TEST_F(CompilerIfTest, VariableCondition) {
     VerifyCompiler(&compiler, R"(
 [Instructions]
 0: OP_C_JUMP            A=0x00 K=0x0001 i=F s=T
-1: OP_CLOSE_UPVALUES    A=0x01 B=0x00 C=0x00 kb=F kc=F
 )");
 }
 
@@ -134,25 +137,22 @@ TEST_F(CompilerIfTest, ComplexExpressionCondition) {
 [Instructions]
 0: OP_GT                A=0x01 B=0x00 C=0x85 kb=F kc=T
 1: OP_C_JUMP            A=0x01 K=0x0001 i=F s=T
-2: OP_CLOSE_UPVALUES    A=0x01 B=0x00 C=0x00 kb=F kc=F
 )");
 }
 
 TEST_F(CompilerIfTest, VariableBindingInElifBlock) {
-    const char* source = "if false { } elif true { z := 15 }";
+    InitializeVariable("c");
+    const char* source = "if c { } elif c { z := 15 }";
 
     ErrorId result = ParseStatement(source, false);
     EXPECT_EQ(result, 0) << "Variable binding in elif block should succeed";
 
     VerifyCompiler(&compiler, R"(
 [Instructions]
-0: OP_LOAD_BOOL              A=0x00 K=0x0000 i=F s=F
-1: OP_C_JUMP                 A=0x00 K=0x0002 i=F s=T
-2: OP_JUMP                   J=0x000004 s=T
-3: OP_LOAD_BOOL              A=0x00 K=0x0000 i=T s=F
-4: OP_C_JUMP                 A=0x00 K=0x0002 i=F s=T
-5: OP_LOAD_INLINE_INTEGER    A=0x00 K=0x000F i=T s=T
-6: OP_CLOSE_UPVALUES         A=0x00 B=0x00 C=0x00 kb=F kc=F
+0: OP_C_JUMP                 A=0x00 K=0x0002 i=F s=T
+1: OP_JUMP                   J=0x000003 s=T
+2: OP_C_JUMP                 A=0x00 K=0x0002 i=F s=T
+3: OP_LOAD_INLINE_INTEGER    A=0x01 K=0x000F i=T s=T
 )");
 }
 
@@ -176,39 +176,36 @@ TEST_F(CompilerIfTest, SiblingScopeIsolation) {
 1: OP_LOAD_INLINE_INTEGER    A=0x01 K=0x0005 i=T s=T
 2: OP_JUMP                   J=0x000002 s=T
 3: OP_LOAD_INLINE_INTEGER    A=0x01 K=0x000A i=T s=T
-4: OP_CLOSE_UPVALUES         A=0x01 B=0x00 C=0x00 kb=F kc=F
 )");
 }
 
 TEST_F(CompilerIfTest, VariableAccessFromParentScope) {
-    const char* source = "{ x := 5\nif true { y := x } }";
+    InitializeVariable("c");
+    const char* source = "{ x := 5\nif c { y := x } }";
 
     ErrorId result = ParseStatement(source, false);
     EXPECT_EQ(result, 0) << "Variable access from parent scope should work";
 
     VerifyCompiler(&compiler, R"(
 [Instructions]
-0: OP_LOAD_INLINE_INTEGER    A=0x00 K=0x0005 i=T s=T
-1: OP_LOAD_BOOL              A=0x01 K=0x0000 i=T s=F
-2: OP_C_JUMP                 A=0x01 K=0x0002 i=F s=T
-3: OP_MOVE                   A=0x01 B=0x00 C=0x00 kb=F kc=F
-4: OP_CLOSE_UPVALUES         A=0x01 B=0x00 C=0x00 kb=F kc=F
+0: OP_LOAD_INLINE_INTEGER    A=0x01 K=0x0005 i=T s=T
+1: OP_C_JUMP                 A=0x00 K=0x0002 i=F s=T
+2: OP_MOVE                   A=0x02 B=0x01 C=0x00 kb=F kc=F
 )");
 }
 
 TEST_F(CompilerIfTest, VariableAssignmentInBlocks) {
-    const char* source = "{ x := 5\nif true { x = 10 } }";
+    InitializeVariable("c");
+    const char* source = "{ x := 5\nif c { x = 10 } }";
 
     ErrorId result = ParseStatement(source, false);
     EXPECT_EQ(result, 0) << "Variable assignment in blocks should work";
 
     VerifyCompiler(&compiler, R"(
 [Instructions]
-0: OP_LOAD_INLINE_INTEGER    A=0x00 K=0x0005 i=T s=T
-1: OP_LOAD_BOOL              A=0x01 K=0x0000 i=T s=F
-2: OP_C_JUMP                 A=0x01 K=0x0002 i=F s=T
-3: OP_LOAD_INLINE_INTEGER    A=0x00 K=0x000A i=T s=T
-4: OP_CLOSE_UPVALUES         A=0x01 B=0x00 C=0x00 kb=F kc=F
+0: OP_LOAD_INLINE_INTEGER    A=0x01 K=0x0005 i=T s=T
+1: OP_C_JUMP                 A=0x00 K=0x0002 i=F s=T
+2: OP_LOAD_INLINE_INTEGER    A=0x01 K=0x000A i=T s=T
 )");
 }
 
@@ -221,35 +218,33 @@ TEST_F(CompilerIfTest, VariableOutOfScopeAssignment) {
 }
 
 TEST_F(CompilerIfTest, UnbindVariableAfterScope) {
-    const char* source = "{ if true { x := 2 }\nx := 3 }";
+    InitializeVariable("c");
+    const char* source = "{ if c { x := 2 }\nx := 3 }";
 
     ErrorId result = ParseStatement(source, false);
     EXPECT_EQ(result, 0) << "Variable binding after scope should work (variables in different scopes)";
 
     VerifyCompiler(&compiler, R"(
 [Instructions]
-0: OP_LOAD_BOOL              A=0x00 K=0x0000 i=T s=F
-1: OP_C_JUMP                 A=0x00 K=0x0002 i=F s=T
-2: OP_LOAD_INLINE_INTEGER    A=0x00 K=0x0002 i=T s=T
-3: OP_CLOSE_UPVALUES         A=0x00 B=0x00 C=0x00 kb=F kc=F
-4: OP_LOAD_INLINE_INTEGER    A=0x00 K=0x0003 i=T s=T
+0: OP_C_JUMP                 A=0x00 K=0x0002 i=F s=T
+1: OP_LOAD_INLINE_INTEGER    A=0x01 K=0x0002 i=T s=T
+2: OP_LOAD_INLINE_INTEGER    A=0x01 K=0x0003 i=T s=T
 )");
 }
 
 TEST_F(CompilerIfTest, UnbindVariableAfterElseScope) {
-    const char* source = "{ if false { } else { y := 10 }\ny := 20 }";
+    InitializeVariable("c");
+    const char* source = "{ if c { } else { y := 10 }\ny := 20 }";
 
     ErrorId result = ParseStatement(source, false);
     EXPECT_EQ(result, 0) << "Variable binding after else scope should work (variables in different scopes)";
 
     VerifyCompiler(&compiler, R"(
 [Instructions]
-0: OP_LOAD_BOOL              A=0x00 K=0x0000 i=F s=F
-1: OP_C_JUMP                 A=0x00 K=0x0002 i=F s=T
-2: OP_JUMP                   J=0x000002 s=T
-3: OP_LOAD_INLINE_INTEGER    A=0x00 K=0x000A i=T s=T
-4: OP_CLOSE_UPVALUES         A=0x00 B=0x00 C=0x00 kb=F kc=F
-5: OP_LOAD_INLINE_INTEGER    A=0x00 K=0x0014 i=T s=T
+0: OP_C_JUMP                 A=0x00 K=0x0002 i=F s=T
+1: OP_JUMP                   J=0x000002 s=T
+2: OP_LOAD_INLINE_INTEGER    A=0x01 K=0x000A i=T s=T
+3: OP_LOAD_INLINE_INTEGER    A=0x01 K=0x0014 i=T s=T
 )");
 }
 
@@ -289,50 +284,74 @@ TEST_F(CompilerIfTest, VariableAlreadyDefinedInSameScope) {
 
 // Instruction Generation Verification
 TEST_F(CompilerIfTest, JumpInstructionVerification) {
-    const char* source = "if false { } else { }";
+    InitializeVariable("c");
+    const char* source = "if c { } else { }";
 
     ErrorId result = ParseStatement(source, false);
     EXPECT_EQ(result, 0) << "Should parse successfully";
 
     VerifyCompiler(&compiler, R"(
 [Instructions]
-0: OP_LOAD_BOOL         A=0x00 K=0x0000 i=F s=F
-1: OP_C_JUMP            A=0x00 K=0x0002 i=F s=T
-2: OP_JUMP              J=0x000001 s=T
-3: OP_CLOSE_UPVALUES    A=0x00 B=0x00 C=0x00 kb=F kc=F
+0: OP_C_JUMP            A=0x00 K=0x0002 i=F s=T
+1: OP_JUMP              J=0x000001 s=T
 )");
 }
 
 TEST_F(CompilerIfTest, CloseUpvaluesInstruction) {
-    const char* source = "if true { }";
+    InitializeVariable("c");
+    const char* source = "if c { x := 1\n fn g() { return x } } else { y := 2 }";
 
     ErrorId result = ParseStatement(source, false);
     EXPECT_EQ(result, 0) << "Should parse successfully";
 
+    // Only chains declaring a captured variable close upvalues.
     VerifyCompiler(&compiler, R"(
 [Instructions]
-0: OP_LOAD_BOOL         A=0x00 K=0x0000 i=T s=F
-1: OP_C_JUMP            A=0x00 K=0x0001 i=F s=T
-2: OP_CLOSE_UPVALUES    A=0x00 B=0x00 C=0x00 kb=F kc=F
+0: OP_C_JUMP                 A=0x00 K=0x0004 i=F s=T
+1: OP_LOAD_INLINE_INTEGER    A=0x01 K=0x0001 i=T s=T
+2: OP_LOAD_CONSTANT          A=0x02 K=0x0000 i=F s=F
+3: OP_JUMP                   J=0x000002 s=T
+4: OP_LOAD_INLINE_INTEGER    A=0x01 K=0x0002 i=T s=T
+5: OP_CLOSE_UPVALUES         A=0x01 B=0x00 C=0x00 kb=F kc=F
 )");
 }
 
+TEST_F(CompilerIfTest, LongBranchUsesExtraArg) {
+    InitializeVariable("c");
+    std::string source = "if c { x := 0\n";
+    for (int i = 0; i < 70000; i++) {
+        source += "x = x + 1\n";
+    }
+    source += "}";
+
+    ErrorId result = ParseStatement(source.c_str(), false);
+    ASSERT_EQ(result, 0) << "Branches longer than K should parse successfully";
+
+    // The skipped body is longer than K, so the conditional jump carries its high bits in a prefix.
+    Instruction prefix = GetInstruction(0);
+    Instruction jump   = GetInstruction(1);
+    ASSERT_EQ(GET_OPCODE(prefix), OP_EXTRA_ARG);
+    ASSERT_EQ(GET_OPCODE(jump), OP_C_JUMP);
+    EXPECT_TRUE(OPERAND_K_S(jump));
+
+    uint32_t offset = (OPERAND_J_J(prefix) << 16) | OPERAND_K_K(jump);
+    EXPECT_GT(offset, (uint32_t)MAX_OPERAND_K);
+    EXPECT_EQ(1 + offset, GetCodeSize()) << "Conditional jump should land right after the branch";
+}
+
 // Complex Nested Cases
 TEST_F(CompilerIfTest, NestedIfStatements) {
-    const char* source = "if true { if true { x := 5 } }";
+    InitializeVariable("c");
+    const char* source = "if c { if c { x := 5 } }";
 
     ErrorId result = ParseStatement(source, false);
     EXPECT_EQ(result, 0) << "Nested if statements should parse successfully";
 
     VerifyCompiler(&compiler, R"(
 [Instructions]
-0: OP_LOAD_BOOL              A=0x00 K=0x0000 i=T s=F
-1: OP_C_JUMP                 A=0x00 K=0x0005 i=F s=T
-2: OP_LOAD_BOOL              A=0x00 K=0x0000 i=T s=F
-3: OP_C_JUMP                 A=0x00 K=0x0002 i=F s=T
-4: OP_LOAD_INLINE_INTEGER    A=0x00 K=0x0005 i=T s=T
-5: OP_CLOSE_UPVALUES         A=0x00 B=0x00 C=0x00 kb=F kc=F
-6: OP_CLOSE_UPVALUES         A=0x00 B=0x00 C=0x00 kb=F kc=F
+0: OP_C_JUMP                 A=0x00 K=0x0003 i=F s=T
+1: OP_C_JUMP                 A=0x00 K=0x0002 i=F s=T
+2: OP_LOAD_INLINE_INTEGER    A=0x01 K=0x0005 i=T s=T
 )");
 }
 
@@ -347,10 +366,11 @@ TEST_F(CompilerIfTest, EmptyBlocks) {
 }
 
 TEST_F(CompilerIfTest, LongElifChainsWithinLimits) {
+    InitializeVariable("c");
     // Create a source with 10 elif statements (within limits)
-    std::string source = "if false { }";
+    std::string source = "if c { }";
     for (int i = 0; i < 10; i++) {
-        source += " elif false { }";
+        source += " elif c { }";
     }
     source += " else { x := 1 }";
 
@@ -359,40 +379,28 @@ TEST_F(CompilerIfTest, LongElifChainsWithinLimits) {
 
     VerifyCompiler(&compiler, R"(
 [Instructions]
-0:  OP_LOAD_BOOL              A=0x00 K=0x0000 i=F s=F
-1:  OP_C_JUMP                 A=0x00 K=0x0002 i=F s=T
-2:  OP_JUMP                   J=0x000020 s=T
-3:  OP_LOAD_BOOL              A=0x00 K=0x0000 i=F s=F
+0:  OP_C_JUMP                 A=0x00 K=0x0002 i=F s=T
+1:  OP_JUMP                   J=0x000016 s=T
+2:  OP_C_JUMP                 A=0x00 K=0x0002 i=F s=T
+3:  OP_JUMP                   J=0x000014 s=T
 4:  OP_C_JUMP                 A=0x00 K=0x0002 i=F s=T
-5:  OP_JUMP                   J=0x00001D s=T
-6:  OP_LOAD_BOOL              A=0x00 K=0x0000 i=F s=F
-7:  OP_C_JUMP                 A=0x00 K=0x0002 i=F s=T
-8:  OP_JUMP                   J=0x00001A s=T
-9:  OP_LOAD_BOOL              A=0x00 K=0x0000 i=F s=F
+5:  OP_JUMP                   J=0x000012 s=T
+6:  OP_C_JUMP                 A=0x00 K=0x0002 i=F s=T
+7:  OP_JUMP                   J=0x000010 s=T
+8:  OP_C_JUMP                 A=0x00 K=0x0002 i=F s=T
+9:  OP_JUMP                   J=0x00000E s=T
 10: OP_C_JUMP                 A=0x00 K=0x0002 i=F s=T
-11: OP_JUMP                   J=0x000017 s=T
-12: OP_LOAD_BOOL              A=0x00 K=0x0000 i=F s=F
-13: OP_C_JUMP                 A=0x00 K=0x0002 i=F s=T
-14: OP_JUMP                   J=0x000014 s=T
-15: OP_LOAD_BOOL              A=0x00 K=0x0000 i=F s=F
+11: OP_JUMP                   J=0x00000C s=T
+12: OP_C_JUMP                 A=0x00 K=0x0002 i=F s=T
+13: OP_JUMP                   J=0x00000A s=T
+14: OP_C_JUMP                 A=0x00 K=0x0002 i=F s=T
+15: OP_JUMP                   J=0x000008 s=T
 16: OP_C_JUMP                 A=0x00 K=0x0002 i=F s=T
-17: OP_JUMP                   J=0x000011 s=T
-18: OP_LOAD_BOOL              A=0x00 K=0x0000 i=F s=F
-19: OP_C_JUMP                 A=0x00 K=0x0002 i=F s=T
-20: OP_JUMP                   J=0x00000E s=T
-21: OP_LOAD_BOOL              A=0x00 K=0x0000 i=F s=F
-22: OP_C_JUMP                 A=0x00 K=0x0002 i=F s=T
-23: OP_JUMP                   J=0x00000B s=T
-24: OP_LOAD_BOOL              A=0x00 K=0x0000 i=F s=F
-25: OP_C_JUMP                 A=0x00 K=0x0002 i=F s=T
-26: OP_JUMP                   J=0x000008 s=T
-27: OP_LOAD_BOOL              A=0x00 K=0x0000 i=F s=F
-28: OP_C_JUMP                 A=0x00 K=0x0002 i=F s=T
-29: OP_JUMP                   J=0x000005 s=T
-30: OP_LOAD_BOOL              A=0x00 K=0x0000 i=F s=F
-31: OP_C_JUMP                 A=0x00 K=0x0002 i=F s=T
-32: OP_JUMP                   J=0x000002 s=T
-33: OP_LOAD_INLINE_INTEGER    A=0x00 K=0x0001 i=T s=T
-34: OP_CLOSE_UPVALUES         A=0x00 B=0x00 C=0x00 kb=F kc=F
+17: OP_JUMP                   J=0x000006 s=T
+18: OP_C_JUMP                 A=0x00 K=0x0002 i=F s=T
+19: OP_JUMP                   J=0x000004 s=T
+20: OP_C_JUMP                 A=0x00 K=0x0002 i=F s=T
+21: OP_JUMP                   J=0x000002 s=T
+22: OP_LOAD_INLINE_INTEGER    A=0x01 K=0x0001 i=T s=T
 )");
 }
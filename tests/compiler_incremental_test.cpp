@@ -0,0 +1,410 @@
+// Copyright (c) 2025 Ian Chen
+// SPDX-License-Identifier: MPL-2.0
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+
+extern "C" {
+#include "../src/compiler.h"
+#include "../src/const_table.h"
+#include "../src/value.h"
+#include "../src/vm.h"
+#include "semi/error.h"
+}
+
+#include "test_common.hpp"
+
+class CompilerIncrementalTest : public VMTest {
+   protected:
+    SemiModule* module = nullptr;
+
+    SemiModule* Compile(const char* source, const char* name = "test_module") {
+        SemiModuleSource moduleSource = {
+            .source     = source,
+            .length     = (unsigned int)strlen(source),
+            .name       = name,
+            .nameLength = (uint8_t)strlen(name),
+        };
+        module = semiVMCompileModule(vm, &moduleSource);
+        return module;
+    }
+
+    ErrorId Run(const char* source) {
+        if (Compile(source) == nullptr) {
+            return vm->error;
+        }
+        return semiRunModule(vm, "test_module", (uint8_t)strlen("test_module"));
+    }
+
+    IdentifierId Identifier(const char* name) {
+        InternedChar* identifier = semiSymbolTableGet(&vm->symbolTable, name, strlen(name));
+        EXPECT_NE(identifier, nullptr);
+        return semiSymbolTableGetId(identifier);
+    }
+
+    FunctionProto* CachedProto(const char* name) {
+        DeclarationCache* cache = &module->declarationCache;
+        Value index             = semiDictGet(&cache->index, semiValueIntCreate(Identifier(name)));
+        if (IS_INVALID(&index)) {
+            return nullptr;
+        }
+        Value fn = semiConstantTableGet(&module->constantTable, cache->declarations.data[AS_INT(&index)].protoIndex);
+        return AS_FUNCTION_PROTO(&fn);
+    }
+
+    Value GetModuleVariable(const char* name) {
+        IdentifierId identifierId = Identifier(name);
+        Value key                 = semiValueIntCreate(identifierId);
+        TupleId tupleId           = semiDictFindTupleId(&module->globals, key, semiHash64Bits(identifierId));
+        EXPECT_GE(tupleId, 0);
+        return module->globals.values[tupleId];
+    }
+
+    int64_t GetInt(const char* name) {
+        Value value = GetModuleVariable(name);
+        EXPECT_TRUE(IS_INT(&value));
+        return AS_INT(&value);
+    }
+};
+
+TEST_F(CompilerIncrementalTest, UnchangedFunctionsAreReused) {
+    const char* source =
+        "fn add(a, b) {\n"
+        "    return a + b\n"
+        "}\n"
+        "fn mul(a, b) { return a * b }\n";
+    ASSERT_NE(Compile(source), nullptr);
+    EXPECT_EQ(module->reusedFunctionCount, 0);
+    FunctionProto* add = CachedProto("add");
+    FunctionProto* mul = CachedProto("mul");
+    ASSERT_NE(add, nullptr);
+    ASSERT_NE(mul, nullptr);
+
+    ASSERT_NE(Compile(source), nullptr);
+    EXPECT_EQ(module->reusedFunctionCount, 2);
+    EXPECT_EQ(CachedProto("add"), add);
+    EXPECT_EQ(CachedProto("mul"), mul);
+}
+
+TEST_F(CompilerIncrementalTest, ChangedFunctionIsRecompiled) {
+    ASSERT_EQ(Run("fn add(a, b) { return a + b }\n"
+                  "fn mul(a, b) { return a * b }\n"
+                  "r := mul(add(1, 2), 4)\n"),
+              0);
+    FunctionProto* add = CachedProto("add");
+    FunctionProto* mul = CachedProto("mul");
+    ASSERT_EQ(GetInt("r"), 12);
+
+    // The function moves to another position, which doesn't prevent reuse.
+    ASSERT_EQ(Run("# Helpers\n"
+                  "\n"
+                  "fn add(a, b) { return a + b }\n"
+                  "fn mul(a, b) { return a * b + 1 }\n"
+                  "r := mul(add(1, 2), 4)\n"),
+              0);
+    EXPECT_EQ(module->reusedFunctionCount, 1);
+    EXPECT_EQ(CachedProto("add"), add);
+    EXPECT_NE(CachedProto("mul"), mul);
+    EXPECT_EQ(GetInt("r"), 13);
+}
+
+TEST_F(CompilerIncrementalTest, CallerOfChangedInlinedFunctionIsRecompiled) {
+    ASSERT_EQ(Run("fn inc(x) { return x + 1 }\n"
+                  "fn twice(x) { return inc(inc(x)) }\n"
+                  "r := twice(1)\n"),
+              0);
+    ASSERT_GT(module->inlinedCallCount, 0);
+    ASSERT_EQ(GetInt("r"), 3);
+
+    ASSERT_EQ(Run("fn inc(x) { return x + 2 }\n"
+                  "fn twice(x) { return inc(inc(x)) }\n"
+                  "r := twice(1)\n"),
+              0);
+    EXPECT_EQ(module->reusedFunctionCount, 0);
+    EXPECT_EQ(GetInt("r"), 5);
+
+    // Both functions are unchanged now. The proto of `inc` is reused, so `twice` can be reused too.
+    ASSERT_EQ(Run("fn inc(x) { return x + 2 }\n"
+                  "fn twice(x) { return inc(inc(x)) }\n"
+                  "r := twice(2)\n"),
+              0);
+    EXPECT_EQ(module->reusedFunctionCount, 2);
+    EXPECT_EQ(GetInt("r"), 6);
+}
+
+TEST_F(CompilerIncrementalTest, FunctionUsingChangedConstantIsRecompiled) {
+    ASSERT_EQ(Run("limit_value := 10\n"
+                  "name_value := \"semi\"\n"
+                  "fn limit() { return limit_value }\n"
+                  "fn name() { return name_value }\n"
+                  "r := limit()\n"),
+              0);
+    ASSERT_EQ(GetInt("r"), 10);
+
+    ASSERT_EQ(Run("limit_value := 20\n"
+                  "name_value := \"semi\"\n"
+                  "fn limit() { return limit_value }\n"
+                  "fn name() { return name_value }\n"
+                  "r := limit()\n"),
+              0);
+    EXPECT_EQ(module->reusedFunctionCount, 1);
+    EXPECT_EQ(GetInt("r"), 20);
+}
+
+TEST_F(CompilerIncrementalTest, NewReassignmentPreventsReuse) {
+    ASSERT_NE(Compile("x := 1\n"
+                      "fn get() { return x }\n"),
+              nullptr);
+
+    ASSERT_NE(Compile("x := 1\n"
+                      "fn get() { return x }\n"
+                      "x = 2\n"),
+              nullptr);
+    EXPECT_EQ(module->reusedFunctionCount, 0);
+}
+
+TEST_F(CompilerIncrementalTest, ErrorAfterReusedFunctionHasSameLocation) {
+    const char* valid =
+        "fn f(a) {\n"
+        "    # Comment\n"
+        "    return a\n"
+        "}\n";
+    const char* invalid =
+        "fn f(a) {\n"
+        "    # Comment\n"
+        "    return a\n"
+        "}\n"
+        "x := )\n";
+    ASSERT_NE(Compile(valid), nullptr);
+
+    ASSERT_EQ(Compile(invalid), nullptr);
+    SemiCompileErrorDetails reused = vm->errorDetails.compileError;
+    ASSERT_EQ(Compile(invalid, "other_module"), nullptr);
+    SemiCompileErrorDetails fresh = vm->errorDetails.compileError;
+    EXPECT_EQ(reused.line, 5);
+    EXPECT_EQ(reused.line, fresh.line);
+    EXPECT_EQ(reused.column, fresh.column);
+}
+
+TEST_F(CompilerIncrementalTest, FailedCompilationKeepsCache) {
+    ASSERT_NE(Compile("fn f() { return 1 }\n"), nullptr);
+    FunctionProto* f = CachedProto("f");
+
+    ASSERT_EQ(Compile("fn f() { return 1 }\n"
+                      "fn g( {\n"),
+              nullptr);
+
+    ASSERT_NE(Compile("fn f() { return 1 }\n"), nullptr);
+    EXPECT_EQ(module->reusedFunctionCount, 1);
+    EXPECT_EQ(CachedProto("f"), f);
+}
+
+TEST_F(CompilerIncrementalTest, RecompilationRebindsModuleVariables) {
+    ASSERT_EQ(Run("x := 1\n"
+                  "export y := 2\n"),
+              0);
+    ASSERT_EQ(Run("x := 3\n"
+                  "export y := x + 1\n"),
+              0);
+    EXPECT_EQ(GetInt("x"), 3);
+
+    // Variables of the last compilation are not visible before they are defined again.
+    ASSERT_EQ(Compile("z := x\n"
+                      "x := 1\n"),
+              nullptr);
+    EXPECT_EQ(vm->error, SEMI_ERROR_UNINITIALIZED_VARIABLE);
+
+    ASSERT_EQ(Compile("x := 1\n"
+                      "x := 2\n"),
+              nullptr);
+    EXPECT_EQ(vm->error, SEMI_ERROR_VARIABLE_ALREADY_DEFINED);
+
+    ASSERT_EQ(Compile("x := 1\n"
+                      "export x := 2\n"),
+              nullptr);
+    EXPECT_EQ(vm->error, SEMI_ERROR_VARIABLE_ALREADY_DEFINED);
+}
+
+TEST_F(CompilerIncrementalTest, VariableCanTurnIntoExportAndBack) {
+    const char* exported =
+        "export fn f() { return 1 }\n"
+        "fn g() { return f }\n"
+        "r := g()\n";
+    ASSERT_EQ(Run("fn f() { return 1 }\n"
+                  "fn g() { return f }\n"
+                  "r := g()\n"),
+              0);
+    Value f = semiValueIntCreate(Identifier("f"));
+    EXPECT_TRUE(semiDictHas(&module->globals, f));
+
+    // `g` resolved `f` as a global, so only `f` is reused.
+    ASSERT_EQ(Run(exported), 0);
+    EXPECT_EQ(module->reusedFunctionCount, 1);
+    EXPECT_TRUE(semiDictHas(&module->exports, f));
+    Value r = GetModuleVariable("r");
+    EXPECT_TRUE(IS_COMPILED_FUNCTION(&r));
+
+    // The old slot is dropped once the old `g` is no longer bound.
+    ASSERT_EQ(Run(exported), 0);
+    EXPECT_EQ(module->reusedFunctionCount, 2);
+    EXPECT_FALSE(semiDictHas(&module->globals, f));
+
+    ASSERT_EQ(Run("fn f() { return 2 }\n"
+                  "fn g() { return f() }\n"
+                  "r := g()\n"),
+              0);
+    EXPECT_TRUE(semiDictHas(&module->globals, f));
+    EXPECT_EQ(GetInt("r"), 2);
+}
+
+TEST_F(CompilerIncrementalTest, StructCanBeDeclaredAgain) {
+    const char* source =
+        "struct P { a, b }\n"
+        "fn f() { return P{a: 1, b: 2}.b }\n"
+        "r := f()\n";
+    ASSERT_EQ(Run(source), 0);
+    uint16_t classCount = vm->classes.classCount;
+
+    ASSERT_EQ(Run(source), 0);
+    EXPECT_EQ(module->reusedFunctionCount, 1);
+    EXPECT_EQ(GetInt("r"), 2);
+
+    ASSERT_EQ(Run("struct P { b, a }\n"
+                  "r := P{a: 3, b: 4}.a\n"),
+              0);
+    EXPECT_EQ(GetInt("r"), 3);
+    EXPECT_EQ(vm->classes.classCount, classCount);
+
+    // Instances of `P` can't change their layout.
+    ASSERT_EQ(Compile("struct P { a, c }\n"), nullptr);
+    EXPECT_EQ(vm->error, SEMI_ERROR_DUPLICATE_NAME);
+    ASSERT_EQ(Compile("struct P { a, b }\n"
+                      "struct P { a, b }\n"),
+              nullptr);
+    EXPECT_EQ(vm->error, SEMI_ERROR_DUPLICATE_NAME);
+}
+
+TEST_F(CompilerIncrementalTest, FunctionWithMovedModuleVariableIsRecompiled) {
+    ASSERT_EQ(Run("x := 5\n"
+                  "x = 6\n"
+                  "fn f() { return x }\n"
+                  "r := f()\n"),
+              0);
+    ASSERT_EQ(GetInt("r"), 6);
+
+    // `x` is only defined after the function now, so a fresh compilation of `f` fails.
+    ASSERT_EQ(Compile("fn f() { return x }\n"
+                      "r := f()\n"
+                      "x := 7\n"
+                      "x = 8\n"),
+              nullptr);
+    EXPECT_EQ(vm->error, SEMI_ERROR_UNINITIALIZED_VARIABLE);
+}
+
+TEST_F(CompilerIncrementalTest, FunctionWithDeletedModuleVariableIsRecompiled) {
+    ASSERT_EQ(Run("x := 5\n"
+                  "x = 6\n"
+                  "fn f() { return x }\n"
+                  "r := f()\n"),
+              0);
+
+    ASSERT_EQ(Compile("struct Point { x }\n"
+                      "p := Point{x: 1}\n"
+                      "p.x = 2\n"
+                      "fn f() { return x }\n"
+                      "r := f()\n"),
+              nullptr);
+    EXPECT_EQ(vm->error, SEMI_ERROR_UNINITIALIZED_VARIABLE);
+}
+
+TEST_F(CompilerIncrementalTest, FunctionWithLocalShadowingNewModuleVariableIsRecompiled) {
+    ASSERT_EQ(Run("fn f(x) { y := x\n return y }\n"
+                  "r := f(1)\n"),
+              0);
+
+    ASSERT_EQ(Compile("x := 1\n"
+                      "fn f(x) { y := x\n return y }\n"),
+              nullptr);
+    EXPECT_EQ(vm->error, SEMI_ERROR_VARIABLE_ALREADY_DEFINED);
+
+    ASSERT_EQ(Compile("y := 1\n"
+                      "fn f(x) { y := x\n return y }\n"),
+              nullptr);
+    EXPECT_EQ(vm->error, SEMI_ERROR_VARIABLE_ALREADY_DEFINED);
+}
+
+TEST_F(CompilerIncrementalTest, FunctionWithUnchangedModuleVariablesIsReused) {
+    const char* source =
+        "x := 5\n"
+        "x = 6\n"
+        "fn f() { return x }\n"
+        "fn g() { return g }\n"
+        "r := f()\n";
+    ASSERT_EQ(Run(source), 0);
+    FunctionProto* f = CachedProto("f");
+    FunctionProto* g = CachedProto("g");
+
+    ASSERT_EQ(Run(source), 0);
+    EXPECT_EQ(module->reusedFunctionCount, 2);
+    EXPECT_EQ(CachedProto("f"), f);
+    EXPECT_EQ(CachedProto("g"), g);
+    EXPECT_EQ(GetInt("r"), 6);
+}
+
+TEST_F(CompilerIncrementalTest, ReloadLoopKeepsModuleBounded) {
+    size_t constantCount = 0;
+    uint32_t globalCount = 0;
+    for (int i = 0; i < 10; i++) {
+        char source[256];
+        snprintf(source,
+                 sizeof(source),
+                 "fn f() { return %d }\n"
+                 "fn g(s) { return s + \"%d\" }\n"
+                 "fn h() { return 1.5 }\n"
+                 "r := f()\n"
+                 "v%d := %d\n",
+                 100000 + i,
+                 i,
+                 i,
+                 i);
+        ASSERT_EQ(Run(source), 0);
+        EXPECT_EQ(GetInt("r"), 100000 + i);
+        char name[8];
+        snprintf(name, sizeof(name), "v%d", i);
+        EXPECT_EQ(GetInt(name), i);
+
+        // The functions of the last run are still bound to the module variables when the next one is compiled.
+        if (i == 1) {
+            constantCount = semiConstantTableSize(&module->constantTable);
+            globalCount   = semiDictLen(&module->globals);
+        } else if (i > 1) {
+            EXPECT_EQ(module->reusedFunctionCount, 1);
+            EXPECT_EQ(semiConstantTableSize(&module->constantTable), constantCount);
+            EXPECT_EQ(semiDictLen(&module->globals), globalCount);
+        }
+    }
+}
+
+TEST_F(CompilerIncrementalTest, ReachableFunctionOfLastCompilationIsKept) {
+    ASSERT_EQ(Run("x := 100000\n"
+                  "x = 100001\n"
+                  "fn f() { return x }\n"
+                  "export keep := List[f]\n"),
+              0);
+    FunctionProto* f = CachedProto("f");
+
+    // `keep` still holds `f` until the new module is run, so `f` and the variable it reads are kept, while the
+    // constants only the last module initializer loaded are dropped.
+    ASSERT_NE(Compile("export keep := 1\n"), nullptr);
+    ASSERT_EQ(semiConstantTableSize(&module->constantTable), 1);
+    Value kept = semiConstantTableGet(&module->constantTable, 0);
+    EXPECT_EQ(AS_FUNCTION_PROTO(&kept), f);
+    EXPECT_EQ(GetInt("x"), 100001);
+
+    ASSERT_EQ(semiRunModule(vm, "test_module", (uint8_t)strlen("test_module")), 0);
+    ASSERT_NE(Compile("export keep := 1\n"), nullptr);
+    EXPECT_EQ(semiConstantTableSize(&module->constantTable), 0);
+    EXPECT_EQ(semiDictLen(&module->globals), 0);
+    EXPECT_EQ(semiDictLen(&module->exports), 1);
+}
@@ -0,0 +1,115 @@
+// Copyright (c) 2025 Ian Chen
+// SPDX-License-Identifier: MPL-2.0
+
+#include <gtest/gtest.h>
+
+#include "instruction_verifier.hpp"
+#include "test_common.hpp"
+
+using namespace InstructionVerifier;
+
+using CompilerInlineTest = OptimizedCompilerTest<&Compiler::enableInlining>;
+
+TEST_F(CompilerInlineTest, CallIsReplacedByTheBody) {
+    ErrorId result = ParseModule("fn sq(x) { return x * x }\ny := sq(3)");
+    ASSERT_EQ(result, 0);
+
+    VerifyModule(module, R"(
+[Instructions]
+0: OP_LOAD_CONSTANT         A=0x00 K=0x0000 i=F s=F
+1: OP_SET_MODULE_VAR        A=0x00 K=0x0000 i=F s=F
+2: OP_LOAD_INLINE_INTEGER   A=0x01 K=0x0003 i=T s=T
+3: OP_MULTIPLY              A=0x02 B=0x01 C=0x01 kb=F kc=F
+4: OP_MOVE                  A=0x00 B=0x02 C=0x00 kb=F kc=F
+5: OP_SET_MODULE_VAR        A=0x00 K=0x0001 i=F s=F
+6: OP_RETURN                A=0xFF B=0x00 C=0x00 kb=F kc=F
+)");
+    EXPECT_EQ(module->inlinedCallCount, 1u);
+}
+
+TEST_F(CompilerInlineTest, EarlyReturnsJumpToTheEndOfTheBody) {
+    ErrorId result = ParseModule(
+        "fn pick(c, a, b) {\n"
+        "  if c { return a }\n"
+        "  return b\n"
+        "}\n"
+        "y := pick(true, 1, 2)");
+    ASSERT_EQ(result, 0);
+
+    VerifyModule(module, R"(
+[Instructions]
+0:  OP_LOAD_CONSTANT         A=0x00 K=0x0000 i=F s=F
+1:  OP_SET_MODULE_VAR        A=0x00 K=0x0000 i=F s=F
+2:  OP_LOAD_BOOL             A=0x01 K=0x0000 i=T s=F
+3:  OP_LOAD_INLINE_INTEGER   A=0x02 K=0x0001 i=T s=T
+4:  OP_LOAD_INLINE_INTEGER   A=0x03 K=0x0002 i=T s=T
+5:  OP_C_JUMP                A=0x01 K=0x0003 i=F s=T
+6:  OP_MOVE                  A=0x00 B=0x02 C=0x00 kb=F kc=F
+7:  OP_JUMP                  J=0x000002 s=T
+8:  OP_MOVE                  A=0x00 B=0x03 C=0x00 kb=F kc=F
+9:  OP_SET_MODULE_VAR        A=0x00 K=0x0001 i=F s=F
+10: OP_RETURN                A=0xFF B=0x00 C=0x00 kb=F kc=F
+)");
+}
+
+TEST_F(CompilerInlineTest, AttributeCachesAreCopiedToTheCaller) {
+    ErrorId result = ParseModule(
+        "struct Point { x, y }\n"
+        "fn px(p) { return p.x }\n"
+        "fn f(p) { return px(p) + px(p) }");
+    ASSERT_EQ(result, 0);
+
+    VerifyModule(module, R"(
+[Instructions]
+0: OP_LOAD_CONSTANT         A=0x00 K=0x0000 i=F s=F
+1: OP_SET_MODULE_VAR        A=0x00 K=0x0000 i=F s=F
+2: OP_LOAD_CONSTANT         A=0x00 K=0x0001 i=F s=F
+3: OP_SET_MODULE_VAR        A=0x00 K=0x0001 i=F s=F
+4: OP_RETURN                A=0xFF B=0x00 C=0x00 kb=F kc=F
+
+[Constants]
+K[0]: FunctionProto arity=1 coarity=1 maxStackSize=2 -> @px
+K[1]: FunctionProto arity=1 coarity=1 maxStackSize=5 -> @f
+
+[Instructions:px]
+0: OP_GET_ATTR              A=0x01 B=0x00 C=0x00 kb=F kc=T
+1: OP_RETURN                A=0x01 B=0x00 C=0x00 kb=F kc=F
+
+[Instructions:f]
+0: OP_MOVE                  A=0x02 B=0x00 C=0x00 kb=F kc=F
+1: OP_GET_ATTR              A=0x03 B=0x02 C=0x00 kb=F kc=T
+2: OP_MOVE                  A=0x01 B=0x03 C=0x00 kb=F kc=F
+3: OP_MOVE                  A=0x03 B=0x00 C=0x00 kb=F kc=F
+4: OP_GET_ATTR              A=0x04 B=0x03 C=0x01 kb=F kc=T
+5: OP_MOVE                  A=0x02 B=0x04 C=0x00 kb=F kc=F
+6: OP_ADD                   A=0x01 B=0x01 C=0x02 kb=F kc=F
+7: OP_RETURN                A=0x01 B=0x00 C=0x00 kb=F kc=F
+)");
+
+    Value fValue      = semiConstantTableGet(&module->constantTable, 1);
+    FunctionProto* fn = AS_FUNCTION_PROTO(&fValue);
+    ASSERT_EQ(fn->attrCacheCount, 2);
+    EXPECT_EQ(fn->attrCaches[0].fieldName, fn->attrCaches[1].fieldName);
+}
+
+TEST_F(CompilerInlineTest, UnsuitableCallsAreKept) {
+    const char* sources[] = {
+        // Defers need a frame of their own.
+        "fn f(x) {\n  defer { a := 1 }\n  return x\n}\ny := f(1)",
+        // Closures capture the registers of the callee.
+        "fn f(x) {\n  fn g() { return x }\n  return g()\n}\ny := f(1)",
+        // The name may be bound to another function at runtime.
+        "fn f(x) { return x }\nf = 1\ny := f(1)",
+        // The VM reports the arity mismatch.
+        "fn f(x) { return x }\ny := f(1, 2)",
+        // A call of a function without a return value still yields a value.
+        "fn f(x) { x + 1 }\ny := f(1)",
+    };
+    for (const char* source : sources) {
+        TearDown();
+        SetUp();
+        ErrorId result = ParseModule(source);
+        ASSERT_EQ(result, 0) << source;
+        EXPECT_EQ(module->inlinedCallCount, 0u) << source;
+    }
+}
@@ -0,0 +1,92 @@
+// Copyright (c) 2025 Ian Chen
+// SPDX-License-Identifier: MPL-2.0
+
+#include <gtest/gtest.h>
+
+#include "instruction_verifier.hpp"
+#include "test_common.hpp"
+
+using namespace InstructionVerifier;
+
+using CompilerLoopInvariantTest = OptimizedCompilerTest<&Compiler::enableLoopInvariantCodeMotion>;
+
+TEST_F(CompilerLoopInvariantTest, InvariantArithmeticIsHoisted) {
+    ErrorId result = ParseModule("fn f(n, k) {\n  s := 0\n  for i in 0..n {\n    s = s + k * 2\n  }\n  return s\n}");
+    ASSERT_EQ(result, 0);
+
+    // The multiplication may fail, so it runs behind a copy of the loop header that skips it for empty ranges.
+    VerifyModule(module, R"(
+[Instructions]
+0: OP_LOAD_CONSTANT         A=0x00 K=0x0000 i=F s=F
+1: OP_SET_MODULE_VAR        A=0x00 K=0x0000 i=F s=F
+2: OP_RETURN                A=0xFF B=0x00 C=0x00 kb=F kc=F
+
+[Constants]
+K[0]: FunctionProto arity=2 coarity=1 maxStackSize=7 -> @f
+
+[Instructions:f]
+0:  OP_LOAD_INLINE_INTEGER   A=0x02 K=0x0000 i=T s=T
+1:  OP_LOAD_INLINE_INTEGER   A=0x04 K=0x0000 i=T s=T
+2:  OP_MAKE_RANGE            A=0x04 B=0x00 C=0x81 kb=F kc=T
+3:  OP_RANGE_NEXT            A=0x04 K=0x0007 i=F s=F
+4:  OP_MULTIPLY              A=0x03 B=0x01 C=0x82 kb=F kc=T
+5:  OP_JUMP                  J=0x000002 s=T
+6:  OP_RANGE_NEXT            A=0x04 K=0x0004 i=F s=F
+7:  OP_MOVE                  A=0x06 B=0x03 C=0x00 kb=F kc=F
+8:  OP_ADD                   A=0x02 B=0x02 C=0x06 kb=F kc=F
+9:  OP_JUMP                  J=0x000003 s=F
+10: OP_RETURN                A=0x02 B=0x00 C=0x00 kb=F kc=F
+)");
+    EXPECT_EQ(module->hoistedInstructionCount, 1u);
+}
+
+TEST_F(CompilerLoopInvariantTest, ModuleVariableReadsAreHoisted) {
+    ErrorId result = ParseModule("table := List[1, 2]\nfor i in 0..3 {\n  x := table[1]\n  y := table\n}");
+    ASSERT_EQ(result, 0);
+
+    // A lone load is left in place, since hoisting it would leave an equally cheap move behind.
+    VerifyModule(module, R"(
+[Instructions]
+0:  OP_NEW_COLLECTION        A=0x00 B=0x06 C=0x02 kb=T kc=F
+1:  OP_LOAD_INLINE_INTEGER   A=0x01 K=0x0001 i=T s=T
+2:  OP_LOAD_INLINE_INTEGER   A=0x02 K=0x0002 i=T s=T
+3:  OP_APPEND_LIST           A=0x00 B=0x01 C=0x02 kb=F kc=F
+4:  OP_SET_MODULE_VAR        A=0x00 K=0x0000 i=F s=F
+5:  OP_LOAD_CONSTANT         A=0x02 K=0x0000 i=F s=F
+6:  OP_RANGE_NEXT            A=0x02 K=0x0009 i=F s=F
+7:  OP_GET_MODULE_VAR        A=0x00 K=0x0000 i=F s=F
+8:  OP_GET_ITEM              A=0x01 B=0x00 C=0x81 kb=F kc=T
+9:  OP_JUMP                  J=0x000002 s=T
+10: OP_RANGE_NEXT            A=0x02 K=0x0005 i=F s=F
+11: OP_MOVE                  A=0x04 B=0x00 C=0x00 kb=F kc=F
+12: OP_MOVE                  A=0x04 B=0x01 C=0x00 kb=F kc=F
+13: OP_GET_MODULE_VAR        A=0x05 K=0x0000 i=F s=F
+14: OP_JUMP                  J=0x000004 s=F
+15: OP_RETURN                A=0xFF B=0x00 C=0x00 kb=F kc=F
+)");
+    EXPECT_EQ(module->hoistedInstructionCount, 2u);
+}
+
+TEST_F(CompilerLoopInvariantTest, VariantInstructionsAreKept) {
+    const char* sources[] = {
+        // The operand changes on every iteration.
+        "fn f(n, k) {\n  s := 0\n  for i in 0..n {\n    s = s + i * k\n  }\n  return s\n}",
+        // The list is written inside the loop.
+        "fn f(n, xs) {\n  for i in 0..n {\n    xs[0] = xs[1] + 1\n  }\n}",
+        // The division only runs on some iterations.
+        "fn f(n, k) {\n  s := 0\n  for i in 0..n {\n    if i > 2 { s = s + k / 2 }\n  }\n  return s\n}",
+        // The called function may rebind the module variable.
+        "limit := 3\nfn g() { limit = 4 }\nfor i in 0..2 {\n  x := limit * 2\n  g()\n}",
+        // Closures capture registers that would move.
+        "fn f(n, k) {\n  for i in 0..n {\n    x := k * 2\n    fn g() { return x }\n  }\n}",
+        // A loop without a header has no place to put hoisted instructions.
+        "fn f(k) {\n  for {\n    x := k * 2\n    break\n  }\n}",
+    };
+    for (const char* source : sources) {
+        TearDown();
+        SetUp();
+        ErrorId result = ParseModule(source);
+        ASSERT_EQ(result, 0) << source;
+        EXPECT_EQ(module->hoistedInstructionCount, 0u) << source;
+    }
+}
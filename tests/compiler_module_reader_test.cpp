@@ -0,0 +1,157 @@
+// Copyright (c) 2025 Ian Chen
+// SPDX-License-Identifier: MPL-2.0
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+
+#include "test_common.hpp"
+
+namespace {
+
+struct ChunkedSource {
+    const char* source;
+    size_t length;
+    size_t offset;
+    size_t chunkSize;
+    size_t failAt;
+    size_t maxCapacity;
+};
+
+size_t readChunk(char* buffer, size_t capacity, void* readUserData) {
+    ChunkedSource* chunked = (ChunkedSource*)readUserData;
+    chunked->maxCapacity   = capacity > chunked->maxCapacity ? capacity : chunked->maxCapacity;
+    if (chunked->offset >= chunked->failAt) {
+        return SEMI_SOURCE_READ_FAILURE;
+    }
+
+    size_t length = chunked->length - chunked->offset;
+    length        = length < chunked->chunkSize ? length : chunked->chunkSize;
+    length        = length < capacity ? length : capacity;
+    memcpy(buffer, chunked->source + chunked->offset, length);
+    chunked->offset += length;
+    return length;
+}
+
+}  // namespace
+
+class CompilerModuleReaderTest : public VMTest {
+   protected:
+    ErrorId Add(const char* source, size_t chunkSize, size_t failAt = SIZE_MAX) {
+        ChunkedSource chunked = {source, strlen(source), 0, chunkSize, failAt, 0};
+        SemiModuleReader reader = {
+            .readFn       = readChunk,
+            .readUserData = &chunked,
+            .name         = "test_module",
+            .nameLength   = (uint8_t)strlen("test_module"),
+        };
+        return semiVMAddModuleFromReader(vm, reader, false);
+    }
+
+    int64_t GetInt(const char* name) {
+        InternedChar* moduleName = semiSymbolTableGet(&vm->symbolTable, "test_module", strlen("test_module"));
+        Value moduleValue        = semiDictGet(&vm->modules, semiValueIntCreate(semiSymbolTableGetId(moduleName)));
+        SemiModule* module       = AS_PTR(&moduleValue, SemiModule);
+
+        IdentifierId identifierId = semiSymbolTableGetId(semiSymbolTableGet(&vm->symbolTable, name, strlen(name)));
+        Value key                 = semiValueIntCreate(identifierId);
+        TupleId tupleId           = semiDictFindTupleId(&module->globals, key, semiHash64Bits(identifierId));
+        EXPECT_GE(tupleId, 0);
+        Value value = module->globals.values[tupleId];
+        EXPECT_TRUE(IS_INT(&value));
+        return AS_INT(&value);
+    }
+};
+
+TEST_F(CompilerModuleReaderTest, TokensSplitAcrossChunksAreCompiled) {
+    const char* source =
+        "# Doubles a number\n"
+        "fn twice(n) {\n"
+        "    return n * 2\n"
+        "}\n"
+        "greeting := \"héllo wörld\"\n"
+        "total := twice(21) + 0x10\n"
+        "big_number := 1_000_000\n";
+    for (size_t chunkSize : {(size_t)1, (size_t)3, (size_t)7, (size_t)4096, (size_t)10000}) {
+        ASSERT_EQ(Add(source, chunkSize), 0) << "chunk size " << chunkSize;
+        ASSERT_EQ(semiRunModule(vm, "test_module", (uint8_t)strlen("test_module")), 0);
+        EXPECT_EQ(GetInt("total"), 58);
+        EXPECT_EQ(GetInt("big_number"), 1000000);
+    }
+}
+
+TEST_F(CompilerModuleReaderTest, SourceLargerThanBufferIsRead) {
+    std::string source = "x := 0\n";
+    for (int i = 0; i < 2000; i++) {
+        source += "x = x + 1\n";
+    }
+    ASSERT_EQ(Add(source.c_str(), 1000), 0);
+    ASSERT_EQ(semiRunModule(vm, "test_module", (uint8_t)strlen("test_module")), 0);
+    EXPECT_EQ(GetInt("x"), 2000);
+}
+
+TEST_F(CompilerModuleReaderTest, ReadFailureAbortsCompilation) {
+    EXPECT_EQ(Add("x := 1\ny := 2\n", 4, 8), SEMI_ERROR_SOURCE_READ_FAILURE);
+    InternedChar* moduleName = semiSymbolTableGet(&vm->symbolTable, "test_module", strlen("test_module"));
+    EXPECT_TRUE(moduleName == nullptr ||
+                !semiDictHas(&vm->modules, semiValueIntCreate(semiSymbolTableGetId(moduleName))));
+}
+
+TEST_F(CompilerModuleReaderTest, SourceIsCompiledAsItIsRead) {
+    std::string source = "x := 1\ny := )\n";
+    for (int i = 0; i < 10000; i++) {
+        source += "x = x + 1\n";
+    }
+    ChunkedSource chunked   = {source.c_str(), source.size(), 0, 64, SIZE_MAX, 0};
+    SemiModuleReader reader = {
+        .readFn       = readChunk,
+        .readUserData = &chunked,
+        .name         = "test_module",
+        .nameLength   = (uint8_t)strlen("test_module"),
+    };
+    EXPECT_EQ(semiVMAddModuleFromReader(vm, reader, false), SEMI_ERROR_UNEXPECTED_TOKEN);
+    EXPECT_EQ(vm->errorDetails.compileError.line, 2u);
+
+    // The error stops the compilation before the rest of the source is read.
+    EXPECT_LT(chunked.offset, (size_t)10000);
+}
+
+TEST_F(CompilerModuleReaderTest, LineLongerThanWindowIsRead) {
+    std::string source = "x := 1 # " + std::string(20000, 'c') + "\n";
+    source += "y := x + 1\n";
+    for (size_t chunkSize : {(size_t)5, (size_t)4096}) {
+        ASSERT_EQ(Add(source.c_str(), chunkSize), 0) << "chunk size " << chunkSize;
+        ASSERT_EQ(semiRunModule(vm, "test_module", (uint8_t)strlen("test_module")), 0);
+        EXPECT_EQ(GetInt("y"), 2);
+    }
+}
+
+TEST_F(CompilerModuleReaderTest, ErrorLocationIsInStreamedLine) {
+    std::string source = "x := 0\n";
+    for (int i = 0; i < 1000; i++) {
+        source += "x = 1\n";
+    }
+    source += "y := x x\n";
+    EXPECT_EQ(Add(source.c_str(), 7), SEMI_ERROR_UNEXPECTED_TOKEN);
+    EXPECT_EQ(vm->errorDetails.compileError.line, 1002u);
+}
+
+TEST_F(CompilerModuleReaderTest, WindowIsBoundedWithoutIdentifiers) {
+    std::string source = "x := List[\n";
+    for (int i = 0; i < 50000; i++) {
+        source += "    1234567,\n";
+    }
+    source += "]\nn := 1\n";
+    ChunkedSource chunked   = {source.c_str(), source.size(), 0, SIZE_MAX, SIZE_MAX, 0};
+    SemiModuleReader reader = {
+        .readFn       = readChunk,
+        .readUserData = &chunked,
+        .name         = "test_module",
+        .nameLength   = (uint8_t)strlen("test_module"),
+    };
+    ASSERT_EQ(semiVMAddModuleFromReader(vm, reader, false), 0);
+    EXPECT_EQ(chunked.offset, source.size());
+
+    // The window never grows past its initial size, as no line is longer than a read.
+    EXPECT_LE(chunked.maxCapacity, (size_t)8192);
+}
@@ -0,0 +1,104 @@
+// Copyright (c) 2025 Ian Chen
+// SPDX-License-Identifier: MPL-2.0
+
+#include <gtest/gtest.h>
+
+extern "C" {
+#include "../src/const_table.h"
+}
+
+#include "instruction_verifier.hpp"
+#include "test_common.hpp"
+
+using namespace InstructionVerifier;
+
+using CompilerPeepholeTest = OptimizedCompilerTest<&Compiler::enablePeephole>;
+
+// The optimizer tests turn on one optimization each with `OptimizedCompilerTest`. A plain CompilerTest runs none.
+TEST_F(CompilerTest, OptimizationsAreDisabledByDefault) {
+    EXPECT_FALSE(compiler.enablePeephole);
+    EXPECT_FALSE(compiler.enableConstantPropagation);
+    EXPECT_FALSE(compiler.enableInlining);
+    EXPECT_FALSE(compiler.enableLoopInvariantCodeMotion);
+
+    ErrorId result = ParseModule("fn f(a) {\n  b := 1\n  b = a\n  return b\n}");
+    ASSERT_EQ(result, 0);
+    EXPECT_EQ(module->peepholeRemovedCount, 0u);
+
+    VerifyModule(module, R"(
+[Instructions:f]
+0: OP_LOAD_INLINE_INTEGER   A=0x01 K=0x0001 i=T s=T
+1: OP_MOVE                  A=0x01 B=0x00 C=0x00 kb=F kc=F
+2: OP_RETURN                A=0x01 B=0x00 C=0x00 kb=F kc=F
+)");
+}
+
+TEST_F(CompilerPeepholeTest, RemovesDeadStoresAndPropagatesCopies) {
+    ErrorId result = ParseModule("fn f(a) {\n  b := 1\n  b = a\n  c := b\n  return !c\n}");
+    ASSERT_EQ(result, 0);
+    ASSERT_EQ(module->peepholeRemovedCount, 2u);
+
+    VerifyModule(module, R"(
+[Instructions:f]
+0: OP_MOVE                  A=0x01 B=0x00 C=0x00 kb=F kc=F
+1: OP_MOVE                  A=0x02 B=0x00 C=0x00 kb=F kc=F
+2: OP_BOOL_NOT              A=0x03 B=0x00 C=0x00 kb=F kc=F
+3: OP_RETURN                A=0x03 B=0x00 C=0x00 kb=F kc=F
+)");
+}
+
+TEST_F(CompilerPeepholeTest, ThreadsJumpsAndKeepsTargetsInBounds) {
+    ErrorId result = ParseModule(
+        "fn f(a) {\n"
+        "  for i in 0..3 {\n"
+        "    if a > i { a = 1 } else { a = 2 }\n"
+        "  }\n"
+        "  return a\n"
+        "}");
+    ASSERT_EQ(result, 0);
+
+    VerifyModule(module, R"(
+[Instructions:f]
+0: OP_LOAD_CONSTANT         A=0x01 K=0x0000 i=F s=F
+1: OP_RANGE_NEXT            A=0x01 K=0x0007 i=F s=F
+2: OP_GT                    A=0x03 B=0x00 C=0x02 kb=F kc=F
+3: OP_C_JUMP                A=0x03 K=0x0003 i=F s=T
+4: OP_LOAD_INLINE_INTEGER   A=0x00 K=0x0001 i=T s=T
+5: OP_JUMP                  J=0x000004 s=F
+6: OP_LOAD_INLINE_INTEGER   A=0x00 K=0x0002 i=T s=T
+7: OP_JUMP                  J=0x000006 s=F
+8: OP_RETURN                A=0x00 B=0x00 C=0x00 kb=F kc=F
+)");
+}
+
+TEST_F(CompilerPeepholeTest, ClosesOnlyCapturedUpvalues) {
+    ErrorId result = ParseModule(
+        "fn f() {\n"
+        "  for j in 0..3 { y := j }\n"
+        "}\n"
+        "fn g() {\n"
+        "  for i in 0..3 {\n"
+        "    x := i\n"
+        "    fn h() { return x }\n"
+        "  }\n"
+        "}");
+    ASSERT_EQ(result, 0);
+
+    VerifyModule(module, R"(
+[Instructions:f]
+0: OP_LOAD_CONSTANT         A=0x00 K=0x0000 i=F s=F
+1: OP_RANGE_NEXT            A=0x00 K=0x0003 i=F s=F
+2: OP_MOVE                  A=0x02 B=0x01 C=0x00 kb=F kc=F
+3: OP_JUMP                  J=0x000002 s=F
+4: OP_RETURN                A=0xFF B=0x00 C=0x00 kb=F kc=F
+
+[Instructions:g]
+0: OP_LOAD_CONSTANT         A=0x00 K=0x0000 i=F s=F
+1: OP_RANGE_NEXT            A=0x00 K=0x0004 i=F s=F
+2: OP_MOVE                  A=0x02 B=0x01 C=0x00 kb=F kc=F
+3: OP_LOAD_CONSTANT         A=0x03 K=0x0002 i=F s=F
+4: OP_JUMP                  J=0x000003 s=F
+5: OP_CLOSE_UPVALUES        A=0x00 B=0x00 C=0x00 kb=F kc=F
+6: OP_RETURN                A=0xFF B=0x00 C=0x00 kb=F kc=F
+)");
+}
@@ -67,8 +67,8 @@ K[0]: FunctionProto arity=0 coarity=1 maxStackSize=1 -> @test
 // Test Case 3: Previously returns 0 values, now returns 0 values (consistent)
 TEST_F(CompilerReturnTest, ConsistentZeroValueReturns) {
     const char* source = R"(
-        fn test() {
-            if true {
+        fn test(c) {
+            if c {
                 return
             }
             return
@@ -85,22 +85,20 @@ TEST_F(CompilerReturnTest, ConsistentZeroValueReturns) {
 2: OP_RETURN                A=0xFF B=0x00 C=0x00 kb=F kc=F
 
 [Constants]
-K[0]: FunctionProto arity=0 coarity=0 maxStackSize=1 -> @test
+K[0]: FunctionProto arity=1 coarity=0 maxStackSize=2 -> @test
 
 [Instructions:test]
-0: OP_LOAD_BOOL             A=0x00 K=0x0000 i=T s=F
-1: OP_C_JUMP                A=0x00 K=0x0002 i=F s=T
+0: OP_C_JUMP                A=0x00 K=0x0002 i=F s=T
+1: OP_RETURN                A=0xFF B=0x00 C=0x00 kb=F kc=F
 2: OP_RETURN                A=0xFF B=0x00 C=0x00 kb=F kc=F
-3: OP_CLOSE_UPVALUES        A=0x00 B=0x00 C=0x00 kb=F kc=F
-4: OP_RETURN                A=0xFF B=0x00 C=0x00 kb=F kc=F
 )");
 }
 
 // Test Case 4: Previously returns 1 value, now returns 1 value (consistent)
 TEST_F(CompilerReturnTest, ConsistentOneValueReturns) {
     const char* source = R"(
-        fn test() {
-            if true {
+        fn test(c) {
+            if c {
                 return 42
             }
             return 24
@@ -117,16 +115,14 @@ TEST_F(CompilerReturnTest, ConsistentOneValueReturns) {
 2: OP_RETURN                A=0xFF B=0x00 C=0x00 kb=F kc=F
 
 [Constants]
-K[0]: FunctionProto arity=0 coarity=1 maxStackSize=1 -> @test
+K[0]: FunctionProto arity=1 coarity=1 maxStackSize=2 -> @test
 
 [Instructions:test]
-0: OP_LOAD_BOOL             A=0x00 K=0x0000 i=T s=F
-1: OP_C_JUMP                A=0x00 K=0x0003 i=F s=T
-2: OP_LOAD_INLINE_INTEGER   A=0x00 K=0x002A i=T s=T
-3: OP_RETURN                A=0x00 B=0x00 C=0x00 kb=F kc=F
-4: OP_CLOSE_UPVALUES        A=0x00 B=0x00 C=0x00 kb=F kc=F
-5: OP_LOAD_INLINE_INTEGER   A=0x00 K=0x0018 i=T s=T
-6: OP_RETURN                A=0x00 B=0x00 C=0x00 kb=F kc=F
+0: OP_C_JUMP                A=0x00 K=0x0003 i=F s=T
+1: OP_LOAD_INLINE_INTEGER   A=0x01 K=0x002A i=T s=T
+2: OP_RETURN                A=0x01 B=0x00 C=0x00 kb=F kc=F
+3: OP_LOAD_INLINE_INTEGER   A=0x01 K=0x0018 i=T s=T
+4: OP_RETURN                A=0x01 B=0x00 C=0x00 kb=F kc=F
 )");
 }
 
@@ -229,8 +225,8 @@ TEST_F(CompilerReturnTest, ComplexControlFlowInconsistentReturns) {
 // Test Case: Return with different expression types
 TEST_F(CompilerReturnTest, ReturnWithDifferentExpressionTypes) {
     const char* source = R"(
-        fn test() {
-            if true {
+        fn test(c) {
+            if c {
                 return "hello"
             }
             return 3.14
@@ -249,16 +245,14 @@ TEST_F(CompilerReturnTest, ReturnWithDifferentExpressionTypes) {
 [Constants]
 K[0]: String "hello" length=5
 K[1]: Float 3.14
-K[2]: FunctionProto arity=0 coarity=1 maxStackSize=1 -> @test
+K[2]: FunctionProto arity=1 coarity=1 maxStackSize=2 -> @test
 
 [Instructions:test]
-0: OP_LOAD_BOOL             A=0x00 K=0x0000 i=T s=F
-1: OP_C_JUMP                A=0x00 K=0x0003 i=F s=T
-2: OP_LOAD_CONSTANT         A=0x00 K=0x0000 i=F s=F
-3: OP_RETURN                A=0x00 B=0x00 C=0x00 kb=F kc=F
-4: OP_CLOSE_UPVALUES        A=0x00 B=0x00 C=0x00 kb=F kc=F
-5: OP_LOAD_CONSTANT         A=0x00 K=0x0001 i=F s=F
-6: OP_RETURN                A=0x00 B=0x00 C=0x00 kb=F kc=F
+0: OP_C_JUMP                A=0x00 K=0x0003 i=F s=T
+1: OP_LOAD_CONSTANT         A=0x01 K=0x0000 i=F s=F
+2: OP_RETURN                A=0x01 B=0x00 C=0x00 kb=F kc=F
+3: OP_LOAD_CONSTANT         A=0x01 K=0x0001 i=F s=F
+4: OP_RETURN                A=0x01 B=0x00 C=0x00 kb=F kc=F
 )");
 }
 
@@ -289,16 +283,14 @@ K[0]: Range start=1 end=10 step=1
 K[1]: FunctionProto arity=0 coarity=1 maxStackSize=3 -> @test
 
 [Instructions:test]
-0:  OP_LOAD_CONSTANT         A=0x00 K=0x0000 i=F s=F
-1:  OP_RANGE_NEXT            A=0x00 K=0x0006 i=F s=F
-3:  OP_EQ                    A=0x02 B=0x01 C=0x85 kb=F kc=T
-4:  OP_C_JUMP                A=0x02 K=0x0002 i=F s=T
-5:  OP_RETURN                A=0x01 B=0x00 C=0x00 kb=F kc=F
-6:  OP_CLOSE_UPVALUES        A=0x02 B=0x00 C=0x00 kb=F kc=F
-7:  OP_JUMP                  J=0x000005 s=F
-8:  OP_CLOSE_UPVALUES        A=0x00 B=0x00 C=0x00 kb=F kc=F
-9:  OP_LOAD_INLINE_INTEGER   A=0x00 K=0x0000 i=T s=T
-10: OP_RETURN                A=0x00 B=0x00 C=0x00 kb=F kc=F
+0: OP_LOAD_CONSTANT         A=0x00 K=0x0000 i=F s=F
+1: OP_RANGE_NEXT            A=0x00 K=0x0005 i=F s=F
+2: OP_EQ                    A=0x02 B=0x01 C=0x85 kb=F kc=T
+3: OP_C_JUMP                A=0x02 K=0x0002 i=F s=T
+4: OP_RETURN                A=0x01 B=0x00 C=0x00 kb=F kc=F
+5: OP_JUMP                  J=0x000004 s=F
+6: OP_LOAD_INLINE_INTEGER   A=0x00 K=0x0000 i=T s=T
+7: OP_RETURN                A=0x00 B=0x00 C=0x00 kb=F kc=F
 )");
 }
 
@@ -395,4 +387,50 @@ K[0]: FunctionProto arity=0 coarity=0 maxStackSize=1 -> @test
 0: OP_LOAD_INLINE_INTEGER   A=0x00 K=0x002A i=T s=T
 1: OP_RETURN                A=0xFF B=0x00 C=0x00 kb=F kc=F
 )");
-}
\ No newline at end of file
+}
+
+TEST_F(CompilerReturnTest, CodeAfterTerminalStatementsIsDiscarded) {
+    const char* source = R"(
+        fn test(c) {
+            if c {
+                return 1
+            } else {
+                return 2
+            }
+            c = 3
+            return c
+        }
+    )";
+
+    ErrorId result = ParseModule(source);
+    EXPECT_EQ(result, 0);
+
+    VerifyModule(module, R"(
+[Instructions:test]
+0: OP_C_JUMP                A=0x00 K=0x0003 i=F s=T
+1: OP_LOAD_INLINE_INTEGER   A=0x01 K=0x0001 i=T s=T
+2: OP_RETURN                A=0x01 B=0x00 C=0x00 kb=F kc=F
+3: OP_LOAD_INLINE_INTEGER   A=0x01 K=0x0002 i=T s=T
+4: OP_RETURN                A=0x01 B=0x00 C=0x00 kb=F kc=F
+)");
+}
+
+TEST_F(CompilerReturnTest, FunctionEndingWithInfiniteLoopStillEndsWithReturn) {
+    const char* source = R"(
+        fn test(c) {
+            for {
+                return c
+            }
+            return 0
+        }
+    )";
+
+    ErrorId result = ParseModule(source);
+    EXPECT_EQ(result, 0);
+
+    VerifyModule(module, R"(
+[Instructions:test]
+0: OP_RETURN                A=0x00 B=0x00 C=0x00 kb=F kc=F
+1: OP_RETURN                A=0xFF B=0x00 C=0x00 kb=F kc=F
+)");
+}
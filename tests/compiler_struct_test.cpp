@@ -0,0 +1,128 @@
+// Copyright (c) 2025 Ian Chen
+// SPDX-License-Identifier: MPL-2.0
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+
+extern "C" {
+#include "../src/const_table.h"
+}
+
+#include "instruction_verifier.hpp"
+#include "test_common.hpp"
+
+using namespace InstructionVerifier;
+
+class CompilerStructTest : public CompilerTest {
+   protected:
+    TypeId GetTypeId(const char* name) {
+        InternedChar* identifier = semiSymbolTableGet(compiler.symbolTable, name, strlen(name));
+        EXPECT_NE(identifier, nullptr);
+        Value typeId = semiDictGet(&module->types, semiValueIntCreate(semiSymbolTableGetId(identifier)));
+        EXPECT_TRUE(IS_INT(&typeId));
+        return (TypeId)AS_INT(&typeId);
+    }
+
+    IdentifierId GetIdentifierId(const char* name) {
+        InternedChar* identifier = semiSymbolTableGet(compiler.symbolTable, name, strlen(name));
+        EXPECT_NE(identifier, nullptr);
+        return semiSymbolTableGetId(identifier);
+    }
+};
+
+TEST_F(CompilerStructTest, DeclarationRegistersSortedFields) {
+    ErrorId result = ParseModule("struct Point { y, x\n z }");
+    ASSERT_EQ(result, 0);
+
+    TypeId typeId = GetTypeId("Point");
+    ASSERT_EQ(typeId, MIN_CUSTOM_BASE_VALUE_TYPE);
+
+    StructType* structType = semiPrimitivesGetStructType(compiler.classes, typeId);
+    ASSERT_NE(structType, nullptr);
+    ASSERT_EQ(structType->fieldCount, 3);
+    ASSERT_EQ(semiStructTypeFindSlot(structType, GetIdentifierId("y")), 0);
+    ASSERT_EQ(semiStructTypeFindSlot(structType, GetIdentifierId("x")), 1);
+    ASSERT_EQ(semiStructTypeFindSlot(structType, GetIdentifierId("z")), 2);
+}
+
+TEST_F(CompilerStructTest, InitializerAndAccessUseSeededCaches) {
+    ErrorId result = ParseModule(
+        "struct Point { x, y }\n"
+        "fn f() {\n"
+        "  p := Point{y: 2, x: 1}\n"
+        "  p.x = p.y\n"
+        "}");
+    ASSERT_EQ(result, 0);
+
+    VerifyModule(module, R"(
+[Instructions]
+0: OP_LOAD_CONSTANT         A=0x00 K=0x0000 i=F s=F
+1: OP_SET_MODULE_VAR        A=0x00 K=0x0000 i=F s=F
+2: OP_RETURN                A=0xFF B=0x00 C=0x00 kb=F kc=F
+
+[Constants]
+K[0]: FunctionProto arity=0 coarity=0 maxStackSize=3 -> @f
+
+[Instructions:f]
+0: OP_LOAD_INLINE_INTEGER   A=0x01 K=0x0002 i=T s=T
+1: OP_LOAD_INLINE_INTEGER   A=0x02 K=0x0001 i=T s=T
+2: OP_NEW_COLLECTION        A=0x00 B=0x0E C=0x00 kb=T kc=F
+3: OP_SET_ATTR              A=0x00 B=0x00 C=0x01 kb=T kc=F
+4: OP_SET_ATTR              A=0x00 B=0x01 C=0x02 kb=T kc=F
+5: OP_MOVE                  A=0x01 B=0x00 C=0x00 kb=F kc=F
+6: OP_GET_ATTR              A=0x02 B=0x00 C=0x02 kb=F kc=T
+7: OP_SET_ATTR              A=0x01 B=0x03 C=0x02 kb=T kc=F
+8: OP_RETURN                A=0xFF B=0x00 C=0x00 kb=F kc=F
+)");
+
+    Value fnValue      = semiConstantTableGet(&module->constantTable, 0);
+    FunctionProto* fn  = AS_FUNCTION_PROTO(&fnValue);
+    TypeId pointTypeId = GetTypeId("Point");
+    ASSERT_EQ(fn->attrCacheCount, 4);
+    ASSERT_EQ(fn->attrCaches[0].fieldName, GetIdentifierId("y"));
+    ASSERT_EQ(fn->attrCaches[1].fieldName, GetIdentifierId("x"));
+    ASSERT_EQ(fn->attrCaches[2].fieldName, GetIdentifierId("y"));
+    ASSERT_EQ(fn->attrCaches[3].fieldName, GetIdentifierId("x"));
+    for (uint16_t i = 0; i < fn->attrCacheCount; i++) {
+        ASSERT_EQ(fn->attrCaches[i].typeId, pointTypeId);
+    }
+    ASSERT_EQ(fn->attrCaches[0].slot, 1);
+    ASSERT_EQ(fn->attrCaches[1].slot, 0);
+}
+
+TEST_F(CompilerStructTest, AccessWithoutKnownTypeLeavesCacheEmpty) {
+    ErrorId result = ParseModule("fn f(o) {\n  return o.a\n}");
+    ASSERT_EQ(result, 0);
+
+    Value fnValue     = semiConstantTableGet(&module->constantTable, 0);
+    FunctionProto* fn = AS_FUNCTION_PROTO(&fnValue);
+    ASSERT_EQ(fn->attrCacheCount, 1);
+    ASSERT_EQ(fn->attrCaches[0].fieldName, GetIdentifierId("a"));
+    ASSERT_EQ(fn->attrCaches[0].typeId, INVALID_ATTR_CACHE_TYPE_ID);
+}
+
+TEST_F(CompilerStructTest, Errors) {
+    struct {
+        const char* source;
+        ErrorId expected;
+    } cases[] = {
+        {                     "struct P { a, a }",        SEMI_ERROR_DUPLICATE_NAME},
+        {             "struct P { a }\nstruct P { b }",        SEMI_ERROR_DUPLICATE_NAME},
+        {                      "struct Int { a }",        SEMI_ERROR_DUPLICATE_NAME},
+        {                       "struct P { a, }",                                0},
+        {            "struct P { a }\nx := P{}",         SEMI_ERROR_MISSING_FIELD},
+        {"struct P { a }\nx := P{a: 1, b: 2}",         SEMI_ERROR_UNKNOWN_FIELD},
+        {"struct P { a }\nx := P{a: 1, a: 2}",        SEMI_ERROR_DUPLICATE_NAME},
+        {                            "x := Int{}", SEMI_ERROR_UNIMPLEMENTED_FEATURE},
+        {             "fn f() { struct P { a } }",      SEMI_ERROR_UNEXPECTED_TOKEN},
+        {                        "struct p { a }",      SEMI_ERROR_UNEXPECTED_TOKEN},
+        {          "struct P { a }\nx := P[1: 2]",      SEMI_ERROR_UNEXPECTED_TOKEN},
+    };
+
+    for (const auto& testCase : cases) {
+        TearDown();
+        SetUp();
+        ASSERT_EQ(ParseModule(testCase.source), testCase.expected) << testCase.source;
+    }
+}
@@ -171,6 +171,18 @@ static void printValue(Value v) {
             std::cout << " ]";
             break;
         }
+        case VALUE_TYPE_DEQUE: {
+            ObjectDeque* deque = AS_DEQUE(value);
+            std::cout << "Deque[";
+            for (uint32_t j = 0; j < deque->size; j++) {
+                printValue(*semiDequeAt(deque, j));
+                if (j + 1 < deque->size) {
+                    std::cout << ", ";
+                }
+            }
+            std::cout << " ]";
+            break;
+        }
         case VALUE_TYPE_DICT: {
             ObjectDict* dict = AS_DICT(value);
             if (dict->len == 0) {
@@ -179,19 +191,31 @@ static void printValue(Value v) {
             }
 
             std::cout << "Dict[ ";
-            uint32_t j = 0;
-            for (;;) {
-                if (IS_VALID(&dict->keys[j].key)) {
-                    printValue(dict->keys[j].key);
-                    std::cout << ": ";
-                    printValue(dict->values[j]);
-                }
-                j++;
-                if (j < dict->len) {
+            uint32_t cursor = 0;
+            TupleId tid;
+            for (uint32_t j = 0; (tid = semiDictNextTupleId(dict, &cursor)) >= 0; j++) {
+                if (j > 0) {
                     std::cout << ", ";
-                } else {
-                    break;
                 }
+                printValue(dict->keys[tid].key);
+                std::cout << ": ";
+                printValue(dict->values[tid]);
+            }
+            std::cout << " ]";
+            break;
+        }
+        case VALUE_TYPE_SET: {
+            ObjectSet* set = AS_SET(value);
+            if (set->len == 0) {
+                std::cout << "Set[]";
+                break;
+            }
+            std::cout << "Set[";
+            uint32_t cursor = 0;
+            TupleId tid;
+            for (uint32_t j = 0; (tid = semiDictNextTupleId(set, &cursor)) >= 0; j++) {
+                std::cout << (j > 0 ? ", " : " ");
+                printValue(set->keys[tid].key);
             }
             std::cout << " ]";
             break;
@@ -351,7 +351,9 @@ TEST_F(ExprParserNudTest, TypeIdentifierNud) {
         { "Float",  BASE_VALUE_TYPE_FLOAT},
         {"String", BASE_VALUE_TYPE_STRING},
         {  "List",   BASE_VALUE_TYPE_LIST},
+        { "Deque",  BASE_VALUE_TYPE_DEQUE},
         {  "Dict",   BASE_VALUE_TYPE_DICT},
+        {   "Set",    BASE_VALUE_TYPE_SET},
     };
 
     for (size_t i = 0; i < sizeof(test_cases) / sizeof(test_cases[0]); i++) {
@@ -166,10 +166,21 @@ TEST_F(IdentifierParsingTest, IdentifierTooLong) {
     EXPECT_EQ(compiler.errorJmpBuf.errorId, SEMI_ERROR_IDENTIFIER_TOO_LONG);
 }
 
+TEST_F(IdentifierParsingTest, IdentifierAtMaximumLength) {
+    std::string longest(255, 'a');
+    std::string source = longest + "+" + std::string(256, 'b');
+    InitLexer(source.c_str());
+
+    ExpectIdentifier(longest.c_str());
+    EXPECT_EQ(NextToken(), TK_PLUS);
+    EXPECT_EQ(NextToken(), TK_EOF);
+    EXPECT_EQ(compiler.errorJmpBuf.errorId, SEMI_ERROR_IDENTIFIER_TOO_LONG);
+}
+
 TEST_F(IdentifierParsingTest, AllKeywords) {
     InitLexer(
         "and or in is if elif else for import export as defer fn return raise break by struct "
-        "true false");
+        "true false continue unset");
 
     EXPECT_EQ(NextToken(), TK_AND);
     EXPECT_EQ(NextToken(), TK_OR);
@@ -191,6 +202,21 @@ TEST_F(IdentifierParsingTest, AllKeywords) {
     EXPECT_EQ(NextToken(), TK_STRUCT);
     EXPECT_EQ(NextToken(), TK_TRUE);
     EXPECT_EQ(NextToken(), TK_FALSE);
+    EXPECT_EQ(NextToken(), TK_CONTINUE);
+    EXPECT_EQ(NextToken(), TK_UNSET);
+    EXPECT_EQ(NextToken(), TK_EOF);
+}
+
+TEST_F(IdentifierParsingTest, KeywordHashLookalikes) {
+    // Same first character, last character and length as a keyword, so they land in the slot of that keyword.
+    InitLexer("aid fur trie bleak expect conclude");
+
+    ExpectIdentifier("aid");
+    ExpectIdentifier("fur");
+    ExpectIdentifier("trie");
+    ExpectIdentifier("bleak");
+    ExpectIdentifier("expect");
+    ExpectIdentifier("conclude");
     EXPECT_EQ(NextToken(), TK_EOF);
 }
 
@@ -59,6 +59,19 @@ TEST_F(StringParsingTest, UTF8Strings) {
     EXPECT_EQ(NextToken(), TK_EOF);
 }
 
+TEST_F(StringParsingTest, LongStringWithEscapesAndUTF8) {
+    // Runs longer than a vector of bytes on both sides of an escape and a multi-byte character.
+    InitLexer(u8"\"abcdefghijklmnopqrstuvwxyz0123456789\\tABCDEFGHIJKLMNOPQRSTU世界abcdefghijklmnopqrstu\" x");
+
+    const char* expected = u8"abcdefghijklmnopqrstuvwxyz0123456789\tABCDEFGHIJKLMNOPQRSTU世界abcdefghijklmnopqrstu";
+    EXPECT_EQ(NextToken(), TK_STRING);
+    ObjectString* str = AS_OBJECT_STRING(&compiler.lexer.tokenValue.constant);
+    ASSERT_EQ(str->length, strlen(expected));
+    EXPECT_EQ(memcmp(str->str, expected, strlen(expected)), 0);
+    EXPECT_EQ(NextToken(), TK_IDENTIFIER);
+    EXPECT_EQ(NextToken(), TK_EOF);
+}
+
 TEST_F(StringParsingTest, StringsWithNumbers) {
     InitLexer("\"123\" \"3.14\" \"0xFF\"");
 
@@ -183,6 +183,19 @@ TEST_F(WhitespaceCommentsTest, LineCountingWithComments) {
     EXPECT_EQ(NextToken(), TK_EOF);
 }
 
+TEST_F(WhitespaceCommentsTest, LongWhitespaceAndCommentRuns) {
+    std::string source = std::string(40, ' ') + "a" + std::string(20, '\t') + std::string(20, ' ') +
+                         u8"# a comment that is longer than a vector with 世界 in the middle of it\n" +
+                         std::string(33, ' ') + "b";
+    InitLexer(source.c_str());
+
+    EXPECT_EQ(NextToken(), TK_IDENTIFIER);
+    EXPECT_EQ(NextToken(), TK_SEPARATOR);
+    EXPECT_EQ(compiler.lexer.line, 1);
+    EXPECT_EQ(NextToken(), TK_IDENTIFIER);
+    EXPECT_EQ(NextToken(), TK_EOF);
+}
+
 TEST_F(WhitespaceCommentsTest, EmptyComments) {
     InitLexer("a #\nb");
 
@@ -0,0 +1,150 @@
+// Copyright (c) 2025 Ian Chen
+// SPDX-License-Identifier: MPL-2.0
+
+#include <gtest/gtest.h>
+
+extern "C" {
+#include "../src/gc.h"
+#include "../src/value.h"
+#include "semi/error.h"
+}
+
+#include "test_common.hpp"
+
+class ObjectValueColumnarListTest : public ::testing::Test {
+   protected:
+    static constexpr TypeId POINT_TYPE_ID = MIN_CUSTOM_BASE_VALUE_TYPE;
+
+    GC gc;
+
+    void SetUp() override {
+        semiGCInit(&gc, defaultReallocFn, NULL);
+    }
+
+    void TearDown() override {
+        semiGCCleanup(&gc);
+    }
+
+    ObjectColumnarList* createList(uint32_t capacity = 0) {
+        Value listValue = semiValueColumnarListCreate(&gc, POINT_TYPE_ID, 2, capacity);
+        return AS_COLUMNAR_LIST(&listValue);
+    }
+
+    Value createPoint(Value x, Value y, TypeId typeId = POINT_TYPE_ID) {
+        Value point                  = semiValueStructCreate(&gc, typeId, 2);
+        AS_STRUCT(&point)->fields[0] = x;
+        AS_STRUCT(&point)->fields[1] = y;
+        return point;
+    }
+};
+
+TEST_F(ObjectValueColumnarListTest, PacksHomogeneousColumns) {
+    ObjectColumnarList* list = createList();
+    ASSERT_EQ(list->columns[0].kind, LIST_ELEMENT_KIND_EMPTY);
+
+    for (int i = 0; i < 5; i++) {
+        Value point = createPoint(semiValueIntCreate(i), semiValueFloatCreate(i * 0.5));
+        ASSERT_EQ(semiColumnarListAppend(&gc, list, &point), 0);
+    }
+
+    ASSERT_EQ(list->size, 5u);
+    ASSERT_GE(list->capacity, 5u);
+    ASSERT_EQ(list->columns[0].kind, LIST_ELEMENT_KIND_INT);
+    ASSERT_EQ(list->columns[1].kind, LIST_ELEMENT_KIND_FLOAT);
+    for (int i = 0; i < 5; i++) {
+        ASSERT_EQ(list->columns[0].as.ints[i], i);
+        ASSERT_DOUBLE_EQ(list->columns[1].as.floats[i], i * 0.5);
+    }
+
+    Value y = semiColumnarListGet(list, 3, 1);
+    ASSERT_TRUE(IS_FLOAT(&y));
+    ASSERT_DOUBLE_EQ(AS_FLOAT(&y), 1.5);
+}
+
+TEST_F(ObjectValueColumnarListTest, WidensMixedColumnsOnly) {
+    ObjectColumnarList* list = createList(2);
+    Value first              = createPoint(semiValueIntCreate(1), semiValueIntCreate(10));
+    Value second             = createPoint(semiValueFloatCreate(2.5), semiValueIntCreate(20));
+    ASSERT_EQ(semiColumnarListAppend(&gc, list, &first), 0);
+    ASSERT_EQ(semiColumnarListAppend(&gc, list, &second), 0);
+
+    ASSERT_EQ(list->columns[0].kind, LIST_ELEMENT_KIND_MIXED);
+    ASSERT_EQ(list->columns[1].kind, LIST_ELEMENT_KIND_INT);
+
+    Value x = semiColumnarListGet(list, 0, 0);
+    ASSERT_TRUE(IS_INT(&x));
+    ASSERT_EQ(AS_INT(&x), 1);
+    x = semiColumnarListGet(list, 1, 0);
+    ASSERT_TRUE(IS_FLOAT(&x));
+    ASSERT_DOUBLE_EQ(AS_FLOAT(&x), 2.5);
+}
+
+TEST_F(ObjectValueColumnarListTest, RemoveShiftsRowsAndRepacksWhenEmpty) {
+    ObjectColumnarList* list = createList();
+    for (int i = 0; i < 3; i++) {
+        Value point = createPoint(semiValueIntCreate(i), semiValueBoolCreate(i % 2 == 0));
+        ASSERT_EQ(semiColumnarListAppend(&gc, list, &point), 0);
+    }
+
+    semiColumnarListRemove(&gc, list, 0);
+    ASSERT_EQ(list->size, 2u);
+    ASSERT_EQ(list->columns[0].as.ints[0], 1);
+    ASSERT_EQ(list->columns[0].as.ints[1], 2);
+    ASSERT_TRUE(AS_BOOL(&list->columns[1].as.values[1]));
+
+    Value point = semiColumnarListMaterialize(&gc, list, 1);
+    ASSERT_TRUE(IS_STRUCT(&point));
+    ASSERT_FALSE(IS_STRUCT_VIEW(&point));
+    ASSERT_EQ(AS_INT(&AS_STRUCT(&point)->fields[0]), 2);
+
+    semiColumnarListRemove(&gc, list, 1);
+    semiColumnarListRemove(&gc, list, 0);
+    ASSERT_EQ(list->size, 0u);
+    ASSERT_EQ(list->columns[0].kind, LIST_ELEMENT_KIND_EMPTY);
+    ASSERT_EQ(list->columns[1].kind, LIST_ELEMENT_KIND_EMPTY);
+
+    point = createPoint(semiValueFloatCreate(1.0), semiValueIntCreate(1));
+    ASSERT_EQ(semiColumnarListAppend(&gc, list, &point), 0);
+    ASSERT_EQ(list->columns[0].kind, LIST_ELEMENT_KIND_FLOAT);
+    ASSERT_EQ(list->columns[1].kind, LIST_ELEMENT_KIND_INT);
+}
+
+TEST_F(ObjectValueColumnarListTest, RejectsOtherTypes) {
+    ObjectColumnarList* list = createList();
+    Value notStruct          = semiValueIntCreate(1);
+    Value otherStruct =
+        createPoint(semiValueIntCreate(1), semiValueIntCreate(2), (TypeId)(MIN_CUSTOM_BASE_VALUE_TYPE + 1));
+
+    ASSERT_EQ(semiColumnarListAppend(&gc, list, &notStruct), SEMI_ERROR_UNEXPECTED_TYPE);
+    ASSERT_EQ(semiColumnarListAppend(&gc, list, &otherStruct), SEMI_ERROR_UNEXPECTED_TYPE);
+    ASSERT_EQ(list->size, 0u);
+}
+
+TEST_F(ObjectValueColumnarListTest, ViewsReadAndWriteInPlace) {
+    ObjectColumnarList* list = createList();
+    Value point              = createPoint(semiValueIntCreate(1), semiValueIntCreate(2));
+    ASSERT_EQ(semiColumnarListAppend(&gc, list, &point), 0);
+    ASSERT_EQ(semiColumnarListAppend(&gc, list, &point), 0);
+
+    Value view = semiValueStructViewCreate(&gc, list, 1);
+    ASSERT_TRUE(IS_STRUCT(&view));
+    ASSERT_TRUE(IS_STRUCT_VIEW(&view));
+    ASSERT_EQ(BASE_TYPE(&view), POINT_TYPE_ID);
+
+    ASSERT_EQ(semiStructSetField(&gc, &view, 0, semiValueIntCreate(42)), 0);
+    ASSERT_EQ(list->columns[0].as.ints[0], 1);
+    ASSERT_EQ(list->columns[0].as.ints[1], 42);
+
+    Value field;
+    ASSERT_EQ(semiStructGetField(&view, 0, &field), 0);
+    ASSERT_EQ(AS_INT(&field), 42);
+
+    // Appending a view copies its row.
+    ASSERT_EQ(semiColumnarListAppend(&gc, list, &view), 0);
+    ASSERT_EQ(list->columns[0].as.ints[2], 42);
+
+    semiColumnarListRemove(&gc, list, 2);
+    semiColumnarListRemove(&gc, list, 1);
+    ASSERT_EQ(semiStructGetField(&view, 0, &field), SEMI_ERROR_INDEX_OOB);
+    ASSERT_EQ(semiStructSetField(&gc, &view, 0, semiValueIntCreate(1)), SEMI_ERROR_INDEX_OOB);
+}
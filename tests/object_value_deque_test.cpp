@@ -0,0 +1,91 @@
+// Copyright (c) 2025 Ian Chen
+// SPDX-License-Identifier: MPL-2.0
+
+#include <gtest/gtest.h>
+
+extern "C" {
+#include "../src/gc.h"
+#include "../src/value.h"
+}
+
+#include "test_common.hpp"
+
+class ObjectValueDequeTest : public ::testing::Test {
+   protected:
+    GC gc;
+
+    void SetUp() override {
+        semiGCInit(&gc, defaultReallocFn, NULL);
+    }
+
+    void TearDown() override {
+        semiGCCleanup(&gc);
+    }
+
+    ObjectDeque* createDeque(uint32_t capacity = 0) {
+        Value dequeValue = semiValueDequeCreate(&gc, capacity);
+        return AS_DEQUE(&dequeValue);
+    }
+};
+
+TEST_F(ObjectValueDequeTest, PushAndPopBothEnds) {
+    ObjectDeque* deque = createDeque();
+    ASSERT_EQ(deque->size, 0);
+
+    semiDequePushBack(&gc, deque, semiValueIntCreate(2));
+    semiDequePushBack(&gc, deque, semiValueIntCreate(3));
+    semiDequePushFront(&gc, deque, semiValueIntCreate(1));
+    semiDequePushFront(&gc, deque, semiValueIntCreate(0));
+    ASSERT_EQ(deque->size, 4);
+    for (uint32_t i = 0; i < deque->size; i++) {
+        ASSERT_EQ(AS_INT(semiDequeAt(deque, i)), (IntValue)i);
+    }
+
+    Value v;
+    ASSERT_TRUE(semiDequePopFront(deque, &v));
+    ASSERT_EQ(AS_INT(&v), 0);
+    ASSERT_TRUE(semiDequePopBack(deque, &v));
+    ASSERT_EQ(AS_INT(&v), 3);
+    ASSERT_TRUE(semiDequePopBack(deque, &v));
+    ASSERT_TRUE(semiDequePopBack(deque, &v));
+    ASSERT_EQ(AS_INT(&v), 1);
+    ASSERT_FALSE(semiDequePopBack(deque, &v));
+    ASSERT_FALSE(semiDequePopFront(deque, &v));
+}
+
+TEST_F(ObjectValueDequeTest, GrowsAcrossWrapAround) {
+    ObjectDeque* deque = createDeque(8);
+    ASSERT_EQ(deque->capacity, 8);
+
+    // Move the head forward so that the contents wrap around the end of the buffer.
+    Value v;
+    for (IntValue i = 0; i < 6; i++) {
+        semiDequePushBack(&gc, deque, semiValueIntCreate(-1));
+        ASSERT_TRUE(semiDequePopFront(deque, &v));
+    }
+    for (IntValue i = 0; i < 20; i++) {
+        semiDequePushBack(&gc, deque, semiValueIntCreate(i));
+    }
+
+    ASSERT_EQ(deque->size, 20);
+    ASSERT_GE(deque->capacity, 20);
+    ASSERT_EQ(deque->capacity & (deque->capacity - 1), 0);
+    for (uint32_t i = 0; i < deque->size; i++) {
+        ASSERT_EQ(AS_INT(semiDequeAt(deque, i)), (IntValue)i);
+    }
+}
+
+TEST_F(ObjectValueDequeTest, RemoveAtShiftsShorterSide) {
+    ObjectDeque* deque = createDeque();
+    for (IntValue i = 0; i < 10; i++) {
+        semiDequePushBack(&gc, deque, semiValueIntCreate(i));
+    }
+
+    semiDequeRemoveAt(deque, 1);
+    semiDequeRemoveAt(deque, 7);
+    IntValue expected[] = {0, 2, 3, 4, 5, 6, 7, 9};
+    ASSERT_EQ(deque->size, 8);
+    for (uint32_t i = 0; i < deque->size; i++) {
+        ASSERT_EQ(AS_INT(semiDequeAt(deque, i)), expected[i]);
+    }
+}
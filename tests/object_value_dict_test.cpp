@@ -4,6 +4,8 @@
 #include <gtest/gtest.h>
 
 #include <cstring>
+#include <string>
+#include <vector>
 
 extern "C" {
 #include "../src/gc.h"
@@ -351,3 +353,141 @@ TEST_F(ObjectValueDictTest, MixedOperationsScenario) {
     Value retrieved = semiDictGet(dict, k1);
     ASSERT_TRUE(semiBuiltInEquals(retrieved, new_v1));
 }
+
+TEST_F(ObjectValueDictTest, DeleteReinsertChurn) {
+    Value dict_val   = semiValueDictCreate(&gc);
+    ObjectDict* dict = AS_DICT(&dict_val);
+
+    for (int64_t i = 0; i < 64; i++) {
+        ASSERT_TRUE(semiDictSet(&gc, dict, semiValueIntCreate(i), semiValueIntCreate(i * 2)));
+    }
+    for (int64_t round = 0; round < 32; round++) {
+        for (int64_t i = round % 2; i < 64; i += 2) {
+            Value deleted = semiDictDelete(&gc, dict, semiValueIntCreate(i));
+            ASSERT_FALSE(IS_INVALID(&deleted));
+        }
+        ASSERT_EQ(semiDictLen(dict), 32);
+        for (int64_t i = round % 2; i < 64; i += 2) {
+            ASSERT_FALSE(semiDictHas(dict, semiValueIntCreate(i)));
+            ASSERT_TRUE(semiDictSet(&gc, dict, semiValueIntCreate(i), semiValueIntCreate(i * 2 + round)));
+        }
+        ASSERT_EQ(semiDictLen(dict), 64);
+    }
+
+    for (int64_t i = 0; i < 64; i++) {
+        Value retrieved = semiDictGet(dict, semiValueIntCreate(i));
+        ASSERT_TRUE(IS_INT(&retrieved));
+        ASSERT_EQ(AS_INT(&retrieved), i * 2 + (i % 2 == 0 ? 30 : 31));
+    }
+}
+
+TEST_F(ObjectValueDictTest, LookupAcrossGroups) {
+    Value dict_val   = semiValueDictCreate(&gc);
+    ObjectDict* dict = AS_DICT(&dict_val);
+
+    for (int64_t i = 0; i < 5000; i++) {
+        ASSERT_TRUE(semiDictSet(&gc, dict, semiValueIntCreate(i * 7919), semiValueIntCreate(i)));
+    }
+    ASSERT_EQ(dict->indexSize % OBJECT_DICT_GROUP_WIDTH, 0);
+    for (int64_t i = 0; i < 5000; i++) {
+        Value retrieved = semiDictGet(dict, semiValueIntCreate(i * 7919));
+        ASSERT_TRUE(IS_INT(&retrieved));
+        ASSERT_EQ(AS_INT(&retrieved), i);
+        ASSERT_FALSE(semiDictHas(dict, semiValueIntCreate(i * 7919 + 1)));
+    }
+}
+
+TEST_F(ObjectValueDictTest, IndexWidthTransitions) {
+    Value dict_val   = semiValueDictCreate(&gc);
+    ObjectDict* dict = AS_DICT(&dict_val);
+
+    int64_t count         = 0;
+    const int64_t steps[] = {100, 30000, 60000};
+    const int widths[]    = {1, 2, 4};
+    for (int s = 0; s < 3; s++) {
+        for (; count < steps[s]; count++) {
+            ASSERT_TRUE(semiDictSet(&gc, dict, semiValueIntCreate(count), semiValueIntCreate(-count)));
+        }
+        ASSERT_EQ(OBJECT_DICT_TID_WIDTH(dict->indexSize), widths[s]);
+        for (int64_t i = 0; i < count; i++) {
+            Value retrieved = semiDictGet(dict, semiValueIntCreate(i));
+            ASSERT_TRUE(IS_INT(&retrieved));
+            ASSERT_EQ(AS_INT(&retrieved), -i);
+        }
+    }
+}
+
+TEST_F(ObjectValueDictTest, DeletedEntriesAreCompacted) {
+    Value dict_val   = semiValueDictCreate(&gc);
+    ObjectDict* dict = AS_DICT(&dict_val);
+
+    // Fill the smallest table, then churn it without ever growing `len`.
+    for (int64_t i = 0; i < 5; i++) {
+        ASSERT_TRUE(semiDictSet(&gc, dict, semiValueIntCreate(i), semiValueIntCreate(i)));
+    }
+    for (int64_t i = 5; i < 1000; i++) {
+        Value deleted = semiDictDelete(&gc, dict, semiValueIntCreate(i - 5));
+        ASSERT_FALSE(IS_INVALID(&deleted));
+        ASSERT_TRUE(semiDictSet(&gc, dict, semiValueIntCreate(i), semiValueIntCreate(i)));
+        ASSERT_LE(dict->used, OBJECT_DICT_MAX_INDEX_LOAD(dict->indexSize));
+    }
+    ASSERT_LE(dict->indexSize, 2 * OBJECT_DICT_MIN_INDEX_SIZE);
+
+    // A large dict that loses most of its entries keeps scans proportional to what is left.
+    for (int64_t i = 0; i < 200; i++) {
+        ASSERT_TRUE(semiDictSet(&gc, dict, semiValueIntCreate(10000 + i), semiValueIntCreate(i)));
+    }
+    for (int64_t i = 0; i < 150; i++) {
+        semiDictDelete(&gc, dict, semiValueIntCreate(10000 + i));
+    }
+    ASSERT_LE(dict->used - dict->len, dict->len);
+
+    uint32_t cursor = 0;
+    TupleId tid;
+    std::vector<int64_t> keys;
+    while ((tid = semiDictNextTupleId(dict, &cursor)) >= 0) {
+        keys.push_back(AS_INT(&dict->keys[tid].key));
+    }
+    ASSERT_EQ(keys.size(), dict->len);
+    for (size_t i = 0; i < 5; i++) {
+        ASSERT_EQ(keys[i], 995 + (int64_t)i);
+    }
+    for (size_t i = 5; i < keys.size(); i++) {
+        ASSERT_EQ(keys[i], 10000 + 150 + (int64_t)(i - 5));
+    }
+}
+
+TEST_F(ObjectValueDictTest, KeyKindTracking) {
+    Value dict_val   = semiValueDictCreate(&gc);
+    ObjectDict* dict = AS_DICT(&dict_val);
+    ASSERT_EQ(dict->keyKind, OBJECT_DICT_KEYS_NONE);
+
+    ASSERT_TRUE(semiDictSet(&gc, dict, semiValueIntCreate(1), semiValueIntCreate(10)));
+    ASSERT_TRUE(semiDictSet(&gc, dict, semiValueIntCreate(1LL << 40), semiValueIntCreate(20)));
+    ASSERT_EQ(dict->keyKind, OBJECT_DICT_KEYS_INT);
+    ASSERT_FALSE(semiDictHas(dict, semiValueFloatCreate(1.0)));
+    ASSERT_FALSE(semiDictHas(dict, createStringValue("a")));
+    ASSERT_TRUE(semiDictHas(dict, semiValueIntCreate(1LL << 40)));
+
+    ASSERT_TRUE(semiDictSet(&gc, dict, createStringValue("a"), semiValueIntCreate(30)));
+    ASSERT_EQ(dict->keyKind, OBJECT_DICT_KEYS_MIXED);
+    ASSERT_TRUE(semiDictHas(dict, semiValueIntCreate(1)));
+    ASSERT_TRUE(semiDictHas(dict, createStringValue("a")));
+
+    // Compaction recomputes the kind from the surviving keys.
+    semiDictDelete(&gc, dict, semiValueIntCreate(1));
+    semiDictDelete(&gc, dict, semiValueIntCreate(1LL << 40));
+    for (int i = 0; i < 40; i++) {
+        std::string key = "key" + std::to_string(i);
+        ASSERT_TRUE(semiDictSet(&gc, dict, createStringValue(key.c_str()), semiValueIntCreate(i)));
+    }
+    ASSERT_EQ(dict->keyKind, OBJECT_DICT_KEYS_STRING);
+    for (int i = 0; i < 40; i++) {
+        std::string key = "key" + std::to_string(i);
+        Value retrieved = semiDictGet(dict, createStringValue(key.c_str()));
+        ASSERT_TRUE(IS_INT(&retrieved));
+        ASSERT_EQ(AS_INT(&retrieved), i);
+    }
+    ASSERT_FALSE(semiDictHas(dict, createStringValue("key40")));
+    ASSERT_FALSE(semiDictHas(dict, semiValueIntCreate(1)));
+}
@@ -0,0 +1,257 @@
+// Copyright (c) 2025 Ian Chen
+// SPDX-License-Identifier: MPL-2.0
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+#include <string>
+#include <vector>
+
+extern "C" {
+#include "../src/gc.h"
+#include "../src/primitives.h"
+#include "../src/value.h"
+}
+
+#include "test_common.hpp"
+
+class ObjectValueListTest : public ::testing::Test {
+   protected:
+    GC gc;
+
+    void SetUp() override {
+        semiGCInit(&gc, defaultReallocFn, NULL);
+    }
+
+    void TearDown() override {
+        semiGCCleanup(&gc);
+    }
+
+    ObjectList* createList(uint32_t capacity = 4) {
+        Value listValue = semiValueListCreate(&gc, capacity);
+        return AS_LIST(&listValue);
+    }
+};
+
+TEST_F(ObjectValueListTest, ElementKindTracksHomogeneity) {
+    ObjectList* list = createList();
+    ASSERT_EQ(list->elementKind, LIST_ELEMENT_KIND_EMPTY);
+
+    semiListAppend(&gc, list, semiValueIntCreate(1));
+    semiListAppend(&gc, list, semiValueIntCreate(2));
+    ASSERT_EQ(list->elementKind, LIST_ELEMENT_KIND_INT);
+
+    semiListInsert(&gc, list, 0, semiValueFloatCreate(1.5));
+    ASSERT_EQ(list->elementKind, LIST_ELEMENT_KIND_MIXED);
+
+    while (semiListPop(&gc, list)) {
+    }
+    ASSERT_EQ(list->elementKind, LIST_ELEMENT_KIND_EMPTY);
+
+    semiListAppend(&gc, list, semiValueFloatCreate(0.5));
+    ASSERT_EQ(list->elementKind, LIST_ELEMENT_KIND_FLOAT);
+
+    semiListAppend(&gc, list, semiValueBoolCreate(true));
+    ASSERT_EQ(list->elementKind, LIST_ELEMENT_KIND_MIXED);
+}
+
+TEST_F(ObjectValueListTest, IntKernels) {
+    ObjectList* list = createList();
+    IntValue expectedSum = 0;
+    for (IntValue i = 0; i < 103; i++) {
+        IntValue v = (i * 37) % 101 - 50;
+        semiListAppend(&gc, list, semiValueIntCreate(v));
+        expectedSum += v;
+    }
+
+    Value ret;
+    ASSERT_TRUE(semiListSum(list, &ret));
+    ASSERT_TRUE(IS_INT(&ret));
+    ASSERT_EQ(AS_INT(&ret), expectedSum);
+
+    ASSERT_TRUE(semiListMin(list, &ret));
+    ASSERT_EQ(AS_INT(&ret), -50);
+    ASSERT_TRUE(semiListMax(list, &ret));
+    ASSERT_EQ(AS_INT(&ret), 50);
+
+    ASSERT_TRUE(semiListDot(list, list, &ret));
+    IntValue expectedDot = 0;
+    for (uint32_t i = 0; i < list->size; i++) {
+        expectedDot += AS_INT(&list->values[i]) * AS_INT(&list->values[i]);
+    }
+    ASSERT_EQ(AS_INT(&ret), expectedDot);
+
+    ASSERT_EQ(semiListIndex(&gc, list, semiValueIntCreate(list->values[7].as.i)), 7);
+    ASSERT_EQ(semiListIndex(&gc, list, semiValueIntCreate(1000)), -1);
+    ASSERT_TRUE(semiListHas(&gc, list, semiValueIntCreate(0)));
+}
+
+TEST_F(ObjectValueListTest, FloatKernels) {
+    ObjectList* list = createList();
+    semiListAppend(&gc, list, semiValueFloatCreate(1.5));
+    semiListAppend(&gc, list, semiValueFloatCreate(-2.0));
+    semiListAppend(&gc, list, semiValueFloatCreate(4.25));
+
+    Value ret;
+    ASSERT_TRUE(semiListSum(list, &ret));
+    ASSERT_TRUE(IS_FLOAT(&ret));
+    ASSERT_DOUBLE_EQ(AS_FLOAT(&ret), 3.75);
+
+    ASSERT_TRUE(semiListMin(list, &ret));
+    ASSERT_DOUBLE_EQ(AS_FLOAT(&ret), -2.0);
+    ASSERT_TRUE(semiListMax(list, &ret));
+    ASSERT_DOUBLE_EQ(AS_FLOAT(&ret), 4.25);
+
+    ASSERT_EQ(semiListIndex(&gc, list, semiValueFloatCreate(4.25)), 2);
+}
+
+TEST_F(ObjectValueListTest, KernelsRejectMixedLists) {
+    ObjectList* list = createList();
+    semiListAppend(&gc, list, semiValueIntCreate(1));
+    semiListAppend(&gc, list, semiValueFloatCreate(2.0));
+
+    Value ret;
+    ASSERT_FALSE(semiListSum(list, &ret));
+    ASSERT_FALSE(semiListMin(list, &ret));
+    ASSERT_FALSE(semiListMax(list, &ret));
+    ASSERT_FALSE(semiListDot(list, list, &ret));
+
+    // Mixed int/float equality still goes through the general comparison path.
+    ASSERT_EQ(semiListIndex(&gc, list, semiValueFloatCreate(2.0)), 1);
+}
+
+TEST_F(ObjectValueListTest, SliceSharesBufferUntilMutation) {
+    ObjectList* list = createList();
+    for (IntValue i = 0; i < 6; i++) {
+        semiListAppend(&gc, list, semiValueIntCreate(i));
+    }
+
+    ObjectList* slice = semiListSlice(&gc, list, 1, 4);
+    ASSERT_NE(slice, nullptr);
+    ASSERT_EQ(slice->size, 3);
+    ASSERT_EQ(slice->values, list->values + 1);
+    ASSERT_EQ(slice->elementKind, LIST_ELEMENT_KIND_INT);
+    ASSERT_EQ(slice->storage, list->storage);
+    ASSERT_EQ(list->storage->refCount, 2);
+
+    semiListAppend(&gc, slice, semiValueIntCreate(42));
+    ASSERT_EQ(slice->storage, nullptr);
+    ASSERT_EQ(list->storage->refCount, 1);
+    ASSERT_EQ(slice->size, 4);
+    ASSERT_EQ(AS_INT(&slice->values[0]), 1);
+    ASSERT_EQ(AS_INT(&slice->values[3]), 42);
+    ASSERT_EQ(list->size, 6);
+    ASSERT_EQ(AS_INT(&list->values[4]), 4);
+
+    // The last owner of the buffer takes it back without copying.
+    Value* values = list->values;
+    semiListAppend(&gc, list, semiValueIntCreate(6));
+    ASSERT_EQ(list->storage, nullptr);
+    ASSERT_EQ(list->size, 7);
+    ASSERT_EQ(list->values, values);
+}
+
+TEST_F(ObjectValueListTest, SliceOutlivesParentMutation) {
+    ObjectList* list = createList();
+    for (IntValue i = 0; i < 4; i++) {
+        semiListAppend(&gc, list, semiValueIntCreate(i));
+    }
+
+    ObjectList* slice = semiListSlice(&gc, list, 2, 4);
+    ObjectList* empty = semiListSlice(&gc, list, 4, 4);
+    ASSERT_EQ(list->storage->refCount, 3);
+    ASSERT_EQ(empty->elementKind, LIST_ELEMENT_KIND_EMPTY);
+
+    while (semiListPop(&gc, list)) {
+    }
+    ASSERT_EQ(list->storage, nullptr);
+    ASSERT_EQ(slice->storage->refCount, 2);
+    ASSERT_EQ(AS_INT(&slice->values[0]), 2);
+    ASSERT_EQ(AS_INT(&slice->values[1]), 3);
+}
+
+TEST_F(ObjectValueListTest, SortInts) {
+    ObjectList* list = createList();
+    for (IntValue i = 0; i < 1000; i++) {
+        semiListAppend(&gc, list, semiValueIntCreate((i * 7919) % 1000 - 500));
+    }
+    semiListAppend(&gc, list, semiValueIntCreate(INT64_MIN));
+    semiListAppend(&gc, list, semiValueIntCreate(INT64_MAX));
+
+    ASSERT_EQ(semiListSort(&gc, list, NULL, NULL), 0);
+    ASSERT_EQ(list->size, 1002);
+    ASSERT_EQ(AS_INT(&list->values[0]), INT64_MIN);
+    ASSERT_EQ(AS_INT(&list->values[1001]), INT64_MAX);
+    for (uint32_t i = 1; i < list->size; i++) {
+        ASSERT_LE(AS_INT(&list->values[i - 1]), AS_INT(&list->values[i]));
+    }
+}
+
+TEST_F(ObjectValueListTest, SortFloats) {
+    ObjectList* list = createList();
+    FloatValue values[] = {3.5, -0.25, 100.0, -7.0, 0.0, 2.0};
+    for (FloatValue v : values) {
+        semiListAppend(&gc, list, semiValueFloatCreate(v));
+    }
+
+    ASSERT_EQ(semiListSort(&gc, list, NULL, NULL), 0);
+    FloatValue expected[] = {-7.0, -0.25, 0.0, 2.0, 3.5, 100.0};
+    for (uint32_t i = 0; i < list->size; i++) {
+        ASSERT_DOUBLE_EQ(AS_FLOAT(&list->values[i]), expected[i]);
+    }
+}
+
+TEST_F(ObjectValueListTest, SortStrings) {
+    ObjectList* list    = createList();
+    const char* words[] = {"pear", "b", "apple", "", "banana", "ab"};
+    for (const char* w : words) {
+        semiListAppend(&gc, list, semiValueStringCreate(&gc, w, strlen(w)));
+    }
+
+    ASSERT_EQ(semiListSort(&gc, list, NULL, NULL), 0);
+    const char* expected[] = {"", "ab", "apple", "b", "banana", "pear"};
+    for (uint32_t i = 0; i < list->size; i++) {
+        Value* v = &list->values[i];
+        if (IS_INLINE_STRING(v)) {
+            ASSERT_EQ(std::string(AS_INLINE_STRING(v).c, AS_INLINE_STRING(v).length), expected[i]);
+        } else {
+            ASSERT_EQ(std::string(AS_OBJECT_STRING(v)->str, AS_OBJECT_STRING(v)->length), expected[i]);
+        }
+    }
+}
+
+static ErrorId numericLessThan(void* context, Value* a, Value* b, bool* ret) {
+    (void)context;
+    FloatValue x = IS_INT(a) ? (FloatValue)AS_INT(a) : AS_FLOAT(a);
+    FloatValue y = IS_INT(b) ? (FloatValue)AS_INT(b) : AS_FLOAT(b);
+    *ret         = x < y;
+    return 0;
+}
+
+TEST_F(ObjectValueListTest, SortMixedUsesComparatorAndIsStable) {
+    ObjectList* list = createList();
+    for (IntValue i = 0; i < 40; i++) {
+        if (i % 2 == 0) {
+            semiListAppend(&gc, list, semiValueIntCreate(i % 5));
+        } else {
+            semiListAppend(&gc, list, semiValueFloatCreate((FloatValue)(i % 5)));
+        }
+    }
+    ASSERT_EQ(semiListSort(&gc, list, NULL, NULL), SEMI_ERROR_UNEXPECTED_TYPE);
+
+    // Payload carries the original position so stability can be checked.
+    std::vector<Value> payload;
+    for (uint32_t i = 0; i < list->size; i++) {
+        payload.push_back(semiValueIntCreate(i));
+    }
+    ASSERT_EQ(semiValuesSort(&gc, list->values, payload.data(), list->size, numericLessThan, NULL), 0);
+    for (uint32_t i = 1; i < list->size; i++) {
+        bool less;
+        numericLessThan(NULL, &list->values[i], &list->values[i - 1], &less);
+        ASSERT_FALSE(less);
+        numericLessThan(NULL, &list->values[i - 1], &list->values[i], &less);
+        if (!less) {
+            ASSERT_LT(AS_INT(&payload[i - 1]), AS_INT(&payload[i]));
+        }
+    }
+}
@@ -0,0 +1,103 @@
+// Copyright (c) 2025 Ian Chen
+// SPDX-License-Identifier: MPL-2.0
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+extern "C" {
+#include "../src/gc.h"
+#include "../src/value.h"
+}
+
+#include "test_common.hpp"
+
+class ObjectValueSetTest : public ::testing::Test {
+   protected:
+    GC gc;
+
+    void SetUp() override {
+        semiGCInit(&gc, defaultReallocFn, NULL);
+    }
+
+    void TearDown() override {
+        semiGCCleanup(&gc);
+    }
+
+    ObjectSet* createSet(std::vector<IntValue> keys) {
+        Value setValue = semiValueSetCreate(&gc);
+        ObjectSet* set = AS_SET(&setValue);
+        for (IntValue key : keys) {
+            EXPECT_TRUE(semiSetAdd(&gc, set, semiValueIntCreate(key)));
+        }
+        return set;
+    }
+
+    std::vector<IntValue> keysOf(ObjectSet* set) {
+        std::vector<IntValue> keys;
+        uint32_t cursor = 0;
+        TupleId tid;
+        while ((tid = semiDictNextTupleId(set, &cursor)) >= 0) {
+            keys.push_back(AS_INT(&set->keys[tid].key));
+        }
+        return keys;
+    }
+};
+
+TEST_F(ObjectValueSetTest, AddRemoveWithoutValues) {
+    ObjectSet* set = createSet({3, 1, 3, 2, 1});
+    ASSERT_TRUE(set->keysOnly);
+    ASSERT_EQ(set->values, nullptr);
+    ASSERT_EQ(semiSetLen(set), 3);
+    ASSERT_EQ(keysOf(set), (std::vector<IntValue>{3, 1, 2}));
+
+    ASSERT_TRUE(semiSetRemove(&gc, set, semiValueIntCreate(1)));
+    ASSERT_FALSE(semiSetRemove(&gc, set, semiValueIntCreate(1)));
+    ASSERT_FALSE(semiSetHas(set, semiValueIntCreate(1)));
+    ASSERT_TRUE(semiSetHas(set, semiValueIntCreate(2)));
+
+    for (IntValue i = 100; i < 1100; i++) {
+        ASSERT_TRUE(semiSetAdd(&gc, set, semiValueIntCreate(i)));
+    }
+    for (IntValue i = 100; i < 1090; i++) {
+        ASSERT_TRUE(semiSetRemove(&gc, set, semiValueIntCreate(i)));
+    }
+    ASSERT_EQ(set->values, nullptr);
+    ASSERT_EQ(semiSetLen(set), 12);
+    ASSERT_EQ(keysOf(set), (std::vector<IntValue>{3, 2, 1090, 1091, 1092, 1093, 1094, 1095, 1096, 1097, 1098, 1099}));
+}
+
+TEST_F(ObjectValueSetTest, SetAlgebra) {
+    ObjectSet* a = createSet({1, 2, 3, 4, 5, 6});
+    ObjectSet* b = createSet({6, 4, 8});
+
+    ASSERT_EQ(keysOf(semiSetUnion(&gc, a, b)), (std::vector<IntValue>{1, 2, 3, 4, 5, 6, 8}));
+    ASSERT_EQ(keysOf(semiSetIntersection(&gc, a, b)), (std::vector<IntValue>{6, 4}));
+    ASSERT_EQ(keysOf(semiSetDifference(&gc, a, b)), (std::vector<IntValue>{1, 2, 3, 5}));
+    ASSERT_EQ(keysOf(semiSetDifference(&gc, b, a)), (std::vector<IntValue>{8}));
+
+    // Operands are left untouched.
+    ASSERT_EQ(semiSetLen(a), 6);
+    ASSERT_EQ(semiSetLen(b), 3);
+
+    ObjectSet* empty = createSet({});
+    ASSERT_EQ(semiSetLen(semiSetUnion(&gc, empty, empty)), 0);
+    ASSERT_EQ(keysOf(semiSetUnion(&gc, empty, b)), (std::vector<IntValue>{6, 4, 8}));
+    ASSERT_EQ(semiSetLen(semiSetIntersection(&gc, a, empty)), 0);
+    ASSERT_EQ(keysOf(semiSetDifference(&gc, b, empty)), (std::vector<IntValue>{6, 4, 8}));
+}
+
+TEST_F(ObjectValueSetTest, CloneKeepsDeletedSlotsConsistent) {
+    ObjectSet* a = createSet({1, 2, 3, 4, 5, 6, 7, 8, 9, 10});
+    ASSERT_TRUE(semiSetRemove(&gc, a, semiValueIntCreate(2)));
+    ASSERT_TRUE(semiSetRemove(&gc, a, semiValueIntCreate(9)));
+    ObjectSet* b = createSet({5});
+
+    // `a - b` with a smaller `b` copies the tables of `a` as they are, including deleted entries.
+    ObjectSet* diff = semiSetDifference(&gc, a, b);
+    ASSERT_EQ(keysOf(diff), (std::vector<IntValue>{1, 3, 4, 6, 7, 8, 10}));
+    ASSERT_FALSE(semiSetHas(diff, semiValueIntCreate(2)));
+    ASSERT_TRUE(semiSetAdd(&gc, diff, semiValueIntCreate(2)));
+    ASSERT_TRUE(semiSetHas(diff, semiValueIntCreate(2)));
+    ASSERT_EQ(semiSetLen(diff), 8);
+}
@@ -47,6 +47,7 @@ static inline void enterTestBlock(Compiler* compiler, BlockScope* newBlock) {
     currentFunction->currentBlock = newBlock;
     newBlock->variableStackStart  = currentBlock->variableStackEnd;
     newBlock->variableStackEnd    = currentBlock->variableStackEnd;
+    newBlock->hasUpvalue          = false;
 }
 
 /*
@@ -338,7 +339,7 @@ class CompilerTest : public ::testing::Test {
         compiler.classes           = &vm->classes;
         compiler.globalIdentifiers = &vm->globalIdentifiers;
 
-        VariableListEnsureCapacity(compiler.gc, &compiler.variables, 32);
+        VariableListArenaEnsureCapacity(compiler.gc, &compiler.arena, &compiler.variables, 32);
         compiler.artifactModule = semiVMModuleCreate(compiler.gc, SEMI_REPL_MODULE_ID);
         semiPrimitivesInitBuiltInModuleTypes(compiler.gc, compiler.symbolTable, compiler.artifactModule);
         module = compiler.artifactModule;
@@ -401,9 +402,10 @@ class CompilerTest : public ::testing::Test {
         LocalRegisterId registerId = compiler.currentFunction->nextRegisterId;
         compiler.currentFunction->nextRegisterId++;
 
-        VariableListAppend(compiler.gc,
-                           &compiler.variables,
-                           (VariableDescription){.identifierId = identifierId, .registerId = registerId});
+        VariableListArenaAppend(compiler.gc,
+                                &compiler.arena,
+                                &compiler.variables,
+                                (VariableDescription){.identifierId = identifierId, .registerId = registerId});
         compiler.currentFunction->currentBlock->variableStackEnd = compiler.variables.size;
     }
 
@@ -509,4 +511,15 @@ class CompilerTest : public ::testing::Test {
     }
 };
 
+// A CompilerTest with one optimization of the compiler turned on, e.g.
+// `using CompilerPeepholeTest = OptimizedCompilerTest<&Compiler::enablePeephole>;`.
+template <bool Compiler::* Flag>
+class OptimizedCompilerTest : public CompilerTest {
+   protected:
+    void SetUp() override {
+        CompilerTest::SetUp();
+        compiler.*Flag = true;
+    }
+};
+
 #endif /* SEMI_TEST_COMMON_HPP */
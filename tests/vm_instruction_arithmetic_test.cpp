@@ -599,3 +599,51 @@ arity=0 coarity=0 maxStackSize=3
     ASSERT_EQ(result, SEMI_ERROR_UNEXPECTED_TYPE);
     ASSERT_EQ(vm->error, SEMI_ERROR_UNEXPECTED_TYPE);
 }
+
+TEST_F(VMInstructionArithmeticTest, OpAddStrings) {
+    ErrorId result = InstructionVerifier::BuildAndRunModule(vm, R"(
+[PreDefine:Registers]
+R[1]: String "hello"
+R[2]: String " world"
+R[3]: String "a"
+
+[ModuleInit]
+arity=0 coarity=0 maxStackSize=6
+
+[Instructions]
+0: OP_ADD  A=0x00 B=0x01 C=0x02 kb=F kc=F
+1: OP_ADD  A=0x04 B=0x03 C=0x03 kb=F kc=F
+2: OP_ADD  A=0x05 B=0x01 C=0x04 kb=F kc=F
+3: OP_TRAP A=0x00 B=0x00 C=0x00 kb=F kc=F
+)");
+
+    ASSERT_EQ(result, 0);
+    ASSERT_EQ(vm->values[0].header, VALUE_TYPE_OBJECT_STRING);
+    ASSERT_EQ(AS_OBJECT_STRING(&vm->values[0])->length, 11u);
+    ASSERT_EQ(memcmp(AS_OBJECT_STRING(&vm->values[0])->str, "hello world", 11), 0);
+    ASSERT_EQ(AS_OBJECT_STRING(&vm->values[0])->hash, semiHashString("hello world", 11));
+
+    // Short results stay inline like string literals.
+    ASSERT_EQ(vm->values[4].header, VALUE_TYPE_INLINE_STRING);
+    ASSERT_EQ(AS_INLINE_STRING(&vm->values[4]).length, 2);
+
+    ASSERT_EQ(vm->values[5].header, VALUE_TYPE_OBJECT_STRING);
+    ASSERT_EQ(memcmp(AS_OBJECT_STRING(&vm->values[5])->str, "helloaa", 7), 0);
+}
+
+TEST_F(VMInstructionArithmeticTest, OpAddStringAndNumberIsTypeError) {
+    ErrorId result = InstructionVerifier::BuildAndRunModule(vm, R"(
+[PreDefine:Registers]
+R[1]: String "hello"
+R[2]: Int 1
+
+[ModuleInit]
+arity=0 coarity=0 maxStackSize=3
+
+[Instructions]
+0: OP_ADD  A=0x00 B=0x01 C=0x02 kb=F kc=F
+1: OP_TRAP A=0x00 B=0x00 C=0x00 kb=F kc=F
+)");
+
+    ASSERT_EQ(result, SEMI_ERROR_UNEXPECTED_TYPE);
+}
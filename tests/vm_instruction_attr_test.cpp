@@ -0,0 +1,274 @@
+// Copyright (c) 2025 Ian Chen
+// SPDX-License-Identifier: MPL-2.0
+
+#include <gtest/gtest.h>
+
+#include <cstring>
+
+extern "C" {
+#include "../src/compiler.h"
+#include "../src/value.h"
+#include "../src/vm.h"
+#include "semi/error.h"
+}
+
+#include "test_common.hpp"
+
+class VMInstructionAttrTest : public VMTest {
+   protected:
+    SemiModule* module = nullptr;
+
+    ErrorId RunSource(const char* source) {
+        SemiModuleSource moduleSource = {
+            .source     = source,
+            .length     = (unsigned int)strlen(source),
+            .name       = "test_module",
+            .nameLength = (uint8_t)strlen("test_module"),
+        };
+        module = semiVMCompileModule(vm, &moduleSource);
+        if (module == nullptr) {
+            return vm->error;
+        }
+        return semiRunModule(vm, moduleSource.name, moduleSource.nameLength);
+    }
+
+    Value GetModuleVariable(const char* name) {
+        InternedChar* identifier = semiSymbolTableGet(&vm->symbolTable, name, strlen(name));
+        EXPECT_NE(identifier, nullptr);
+        Value key       = semiValueIntCreate(semiSymbolTableGetId(identifier));
+        TupleId tupleId = semiDictFindTupleId(&module->globals, key, semiHash64Bits(semiSymbolTableGetId(identifier)));
+        EXPECT_GE(tupleId, 0);
+        return module->globals.values[tupleId];
+    }
+};
+
+TEST_F(VMInstructionAttrTest, CreateReadAndWriteFields) {
+    ErrorId result = RunSource(
+        "struct Point { x, y }\n"
+        "p := Point{x: 1, y: 2}\n"
+        "p.x = p.x + p.y * 10\n"
+        "r := p.x");
+    ASSERT_EQ(result, 0);
+
+    Value p = GetModuleVariable("p");
+    ASSERT_TRUE(IS_STRUCT(&p));
+    ASSERT_EQ(AS_STRUCT(&p)->fieldCount, 2);
+
+    Value r = GetModuleVariable("r");
+    ASSERT_TRUE(IS_INT(&r));
+    ASSERT_EQ(AS_INT(&r), 21);
+}
+
+TEST_F(VMInstructionAttrTest, NestedStructs) {
+    ErrorId result = RunSource(
+        "struct Node { value, next }\n"
+        "n := Node{value: 1, next: Node{value: 2, next: 0}}\n"
+        "n.next.value = 40\n"
+        "r := n.value + n.next.value + 1");
+    ASSERT_EQ(result, 0);
+
+    Value r = GetModuleVariable("r");
+    ASSERT_EQ(AS_INT(&r), 42);
+}
+
+TEST_F(VMInstructionAttrTest, CacheMissesOnDifferentStructTypes) {
+    // `o.y` is at slot 1 in `A` and at slot 0 in `B`, so the cache of the access site flips between the two types.
+    ErrorId result = RunSource(
+        "struct A { x, y }\n"
+        "struct B { y }\n"
+        "fn getY(o) {\n"
+        "  return o.y\n"
+        "}\n"
+        "a := A{x: 1, y: 2}\n"
+        "b := B{y: 30}\n"
+        "s := 0\n"
+        "for i in 0..6 {\n"
+        "  s = s + getY(i % 2 == 0 ? a : b)\n"
+        "}");
+    ASSERT_EQ(result, 0);
+
+    Value s = GetModuleVariable("s");
+    ASSERT_EQ(AS_INT(&s), 96);
+}
+
+TEST_F(VMInstructionAttrTest, SeededCacheFallsBackOnOtherTypes) {
+    // The cache of `o.y` is seeded with `A` because `o` is last assigned an `A` at compile time.
+    ErrorId result = RunSource(
+        "struct A { x, y }\n"
+        "struct B { y }\n"
+        "fn f() {\n"
+        "  a := A{x: 1, y: 2}\n"
+        "  b := B{y: 30}\n"
+        "  s := 0\n"
+        "  for i in 0..4 {\n"
+        "    o := a\n"
+        "    if i % 2 == 1 {\n"
+        "      o = b\n"
+        "    }\n"
+        "    s = s + o.y\n"
+        "  }\n"
+        "  return s\n"
+        "}\n"
+        "r := f()");
+    ASSERT_EQ(result, 0);
+
+    Value r = GetModuleVariable("r");
+    ASSERT_EQ(AS_INT(&r), 64);
+}
+
+TEST_F(VMInstructionAttrTest, UnknownAttribute) {
+    ErrorId result = RunSource(
+        "struct A { x }\n"
+        "fn f(o) {\n"
+        "  return o.y\n"
+        "}\n"
+        "r := f(A{x: 1})");
+    ASSERT_EQ(result, SEMI_ERROR_UNKNOWN_ATTRIBUTE);
+
+    // A seeded cache doesn't turn an unknown field into a compile error.
+    result = RunSource(
+        "struct B { y }\n"
+        "s := B{y: 1}.x");
+    ASSERT_EQ(result, SEMI_ERROR_UNKNOWN_ATTRIBUTE);
+}
+
+TEST_F(VMInstructionAttrTest, AttributeOfNonStruct) {
+    ErrorId result = RunSource(
+        "fn f(o) {\n"
+        "  return o.y\n"
+        "}\n"
+        "r := f(3)");
+    ASSERT_EQ(result, SEMI_ERROR_UNEXPECTED_TYPE);
+
+    result = RunSource(
+        "l := List[1]\n"
+        "l.y = 3");
+    ASSERT_EQ(result, SEMI_ERROR_UNEXPECTED_TYPE);
+}
+
+TEST_F(VMInstructionAttrTest, ColumnarListOfStructs) {
+    ErrorId result = RunSource(
+        "struct Point { x, y }\n"
+        "l := Point[Point{x: 1, y: 0.5}, Point{x: 2, y: 1.5}, Point{x: 3, y: 2.5}]\n"
+        "s := 0\n"
+        "for p in l {\n"
+        "  s = s + p.x\n"
+        "}\n"
+        "l[1].x = 20\n"
+        "t := l[1].x + l[1].y");
+    ASSERT_EQ(result, 0);
+
+    Value l = GetModuleVariable("l");
+    ASSERT_TRUE(IS_COLUMNAR_LIST(&l));
+    ObjectColumnarList* list = AS_COLUMNAR_LIST(&l);
+    ASSERT_EQ(list->size, 3u);
+    ASSERT_EQ(list->columns[0].kind, LIST_ELEMENT_KIND_INT);
+    ASSERT_EQ(list->columns[1].kind, LIST_ELEMENT_KIND_FLOAT);
+    ASSERT_EQ(list->columns[0].as.ints[1], 20);
+
+    Value s = GetModuleVariable("s");
+    ASSERT_EQ(AS_INT(&s), 6);
+
+    Value t = GetModuleVariable("t");
+    ASSERT_DOUBLE_EQ(AS_FLOAT(&t), 21.5);
+}
+
+TEST_F(VMInstructionAttrTest, ColumnarListStoresByValue) {
+    ErrorId result = RunSource(
+        "struct Point { x, y }\n"
+        "p := Point{x: 1, y: 2}\n"
+        "l := Point[p, p]\n"
+        "p.x = 10\n"
+        "l[1] = p\n"
+        "v := l[0]\n"
+        "r := l[0].x + l[1].x\n"
+        "same := v == l[0]");
+    ASSERT_EQ(result, 0);
+
+    Value r = GetModuleVariable("r");
+    ASSERT_EQ(AS_INT(&r), 11);
+
+    Value v = GetModuleVariable("v");
+    ASSERT_TRUE(IS_STRUCT_VIEW(&v));
+
+    Value same = GetModuleVariable("same");
+    ASSERT_TRUE(AS_BOOL(&same));
+}
+
+TEST_F(VMInstructionAttrTest, ColumnarListRejectsOtherTypes) {
+    ErrorId result = RunSource(
+        "struct A { x }\n"
+        "struct B { x }\n"
+        "l := A[B{x: 1}]");
+    ASSERT_EQ(result, SEMI_ERROR_UNEXPECTED_TYPE);
+
+    result = RunSource(
+        "struct C { x }\n"
+        "m := C[1]");
+    ASSERT_EQ(result, SEMI_ERROR_UNEXPECTED_TYPE);
+}
+
+TEST_F(VMInstructionAttrTest, ColumnarListContainsRowsByValue) {
+    ErrorId result = RunSource(
+        "struct Point { x, y }\n"
+        "a := Point{x: 1, y: 2}\n"
+        "l := Point[a, Point{x: 3, y: 4.5}]\n"
+        "r1 := a in l\n"
+        "r2 := Point{x: 3, y: 4.5} in l\n"
+        "r3 := Point{x: 3, y: 5} in l\n"
+        "r4 := l[1] in l\n"
+        "r5 := 1 in l");
+    ASSERT_EQ(result, 0);
+
+    const char* expected[][2] = {{"r1", "T"}, {"r2", "T"}, {"r3", "F"}, {"r4", "T"}, {"r5", "F"}};
+    for (auto& e : expected) {
+        Value r = GetModuleVariable(e[0]);
+        ASSERT_TRUE(IS_BOOL(&r)) << e[0];
+        EXPECT_EQ(AS_BOOL(&r), e[1][0] == 'T') << e[0];
+    }
+}
+
+TEST_F(VMInstructionAttrTest, ColumnarListSliceCopiesRows) {
+    ErrorId result = RunSource(
+        "struct Point { x, y }\n"
+        "l := Point[Point{x: 1, y: 0.5}, Point{x: 2, y: 1.5}, Point{x: 3, y: 2.5}]\n"
+        "s := l[1..3]\n"
+        "s[0].x = 20\n"
+        "r := l[1].x + s[0].x + s[1].x");
+    ASSERT_EQ(result, 0);
+
+    Value s = GetModuleVariable("s");
+    ASSERT_TRUE(IS_COLUMNAR_LIST(&s));
+    ObjectColumnarList* slice = AS_COLUMNAR_LIST(&s);
+    ASSERT_EQ(slice->size, 2u);
+    EXPECT_EQ(slice->columns[0].kind, LIST_ELEMENT_KIND_INT);
+    EXPECT_EQ(slice->columns[1].kind, LIST_ELEMENT_KIND_FLOAT);
+    EXPECT_DOUBLE_EQ(slice->columns[1].as.floats[1], 2.5);
+
+    Value r = GetModuleVariable("r");
+    ASSERT_EQ(AS_INT(&r), 25);
+}
+
+TEST_F(VMInstructionAttrTest, ColumnarListExtendAppendsEachElement) {
+    ASSERT_EQ(RunSource("struct Point { x, y }\n"
+                        "p := Point{x: 1, y: 2}\n"
+                        "l := Point[p]"),
+              0);
+    Value l = GetModuleVariable("l");
+    Value p = GetModuleVariable("p");
+    ASSERT_TRUE(IS_COLUMNAR_LIST(&l));
+    MagicMethodsTable* table = semiVMGetMagicMethodsTable(vm, &l);
+
+    Value items = semiValueListCreate(&vm->gc, 2);
+    semiListAppend(&vm->gc, AS_LIST(&items), p);
+    semiListAppend(&vm->gc, AS_LIST(&items), p);
+    ASSERT_EQ(table->collectionMethods->extend(&vm->gc, &l, &items), 0);
+
+    Value deque = semiValueDequeCreate(&vm->gc, 1);
+    semiDequePushBack(&vm->gc, AS_DEQUE(&deque), p);
+    ASSERT_EQ(table->collectionMethods->extend(&vm->gc, &l, &deque), 0);
+    ASSERT_EQ(AS_COLUMNAR_LIST(&l)->size, 4u);
+
+    semiDequePushBack(&vm->gc, AS_DEQUE(&deque), semiValueIntCreate(1));
+    ASSERT_EQ(table->collectionMethods->extend(&vm->gc, &l, &deque), SEMI_ERROR_UNEXPECTED_TYPE);
+}
@@ -117,6 +117,47 @@ struct SetItemTestCase {
     ErrorId expected_error;
 };
 
+TEST_F(VMInstructionCollectionTest, OpGetItemListSlice) {
+    const char* spec = R"(
+[PreDefine:Registers]
+R[4]: Int 10
+R[5]: Int 20
+R[6]: Int 30
+
+[ModuleInit]
+arity=0 coarity=0 maxStackSize=8
+
+[Instructions]
+0: OP_NEW_COLLECTION A=0x01 B=0x06 C=0x03 kb=T kc=F
+1: OP_APPEND_LIST    A=0x01 B=0x04 C=0x03 kb=F kc=F
+2: OP_LOAD_CONSTANT  A=0x02 K=0x0000 i=F s=F
+3: OP_LOAD_CONSTANT  A=0x03 K=0x0001 i=F s=F
+4: OP_GET_ITEM       A=0x02 B=0x01 C=0x02 kb=F kc=F
+5: OP_GET_ITEM       A=0x03 B=0x01 C=0x03 kb=F kc=F
+6: OP_SET_ITEM       A=0x02 B=0x80 C=0xE3 kb=T kc=T
+7: OP_TRAP           A=0x00 K=0x0000 i=F s=F
+
+[Constants]
+K[0]: Range start=-2 end=100 step=1
+K[1]: Range start=0 end=3 step=2
+)";
+
+    ErrorId result = InstructionVerifier::BuildAndRunModule(vm, spec);
+    ASSERT_EQ(result, 0) << "GET_ITEM with a range key should succeed";
+
+    ObjectList* list  = AS_LIST(&vm->values[1]);
+    ObjectList* slice = AS_LIST(&vm->values[2]);
+    ASSERT_EQ(slice->size, 2);
+    EXPECT_EQ(AS_INT(&slice->values[0]), 99);
+    EXPECT_EQ(AS_INT(&slice->values[1]), 30);
+    EXPECT_EQ(AS_INT(&list->values[1]), 20) << "Writing to a slice must not affect its parent";
+
+    ObjectList* stepped = AS_LIST(&vm->values[3]);
+    ASSERT_EQ(stepped->size, 2);
+    EXPECT_EQ(AS_INT(&stepped->values[0]), 10);
+    EXPECT_EQ(AS_INT(&stepped->values[1]), 30);
+}
+
 TEST_F(VMInstructionCollectionTest, OpSetItemDict) {
     // Create a dictionary and set key-value: R[1]["key"] = 42
     ErrorId result = InstructionVerifier::BuildAndRunModule(vm, R"(
@@ -297,6 +297,66 @@ arity=0 coarity=0 maxStackSize=8
     ASSERT_EQ(result, 0) << "VM should complete successfully";
 }
 
+// OP_EXTRA_ARG Tests: K of the next instruction := (J << 16) + K
+TEST_F(VMInstructionGeneralTest, OpExtraArgZeroPrefixCJump) {
+    SemiModule* module;
+    ErrorId result = InstructionVerifier::BuildAndRunModule(vm,
+                                                            R"(
+[PreDefine:Registers]
+R[0]: Bool true
+
+[ModuleInit]
+arity=0 coarity=0 maxStackSize=8
+
+[Instructions]
+0: OP_EXTRA_ARG  J=0x000000 s=F
+1: OP_C_JUMP     A=0x00 K=0x0002 i=T s=T
+2: OP_TRAP       A=0x00 K=0x0063 i=F s=F
+3: OP_TRAP       A=0x00 K=0x0000 i=F s=F
+)",
+                                                            &module);
+
+    ASSERT_EQ(result, 0) << "Jump should be relative to the C_JUMP instruction";
+}
+
+TEST_F(VMInstructionGeneralTest, OpExtraArgWidensCJumpOffset) {
+    SemiModule* module;
+    ErrorId result = InstructionVerifier::BuildAndRunModule(vm,
+                                                            R"(
+[PreDefine:Registers]
+R[0]: Bool true
+
+[ModuleInit]
+arity=0 coarity=0 maxStackSize=8
+
+[Instructions]
+0: OP_EXTRA_ARG  J=0x000001 s=F
+1: OP_C_JUMP     A=0x00 K=0x0002 i=T s=T
+2: OP_TRAP       A=0x00 K=0x0063 i=F s=F
+3: OP_TRAP       A=0x00 K=0x0000 i=F s=F
+)",
+                                                            &module);
+
+    ASSERT_EQ(result, SEMI_ERROR_INVALID_PC) << "Offset 0x10002 should run past the end of the chunk";
+}
+
+TEST_F(VMInstructionGeneralTest, OpExtraArgBeforeUnsupportedInstruction) {
+    SemiModule* module;
+    ErrorId result = InstructionVerifier::BuildAndRunModule(vm,
+                                                            R"(
+[ModuleInit]
+arity=0 coarity=0 maxStackSize=8
+
+[Instructions]
+0: OP_EXTRA_ARG  J=0x000000 s=F
+1: OP_MOVE       A=0x00 B=0x01 C=0x00 kb=F kc=F
+2: OP_TRAP       A=0x00 K=0x0000 i=F s=F
+)",
+                                                            &module);
+
+    ASSERT_EQ(result, SEMI_ERROR_INVALID_INSTRUCTION) << "Only K-type instructions may follow OP_EXTRA_ARG";
+}
+
 TEST_F(VMInstructionGeneralTest, OpNoopBasic) {
     SemiModule* module;
     ErrorId result = InstructionVerifier::BuildAndRunModule(vm,
@@ -451,4 +451,100 @@ arity=0 coarity=0 maxStackSize=8
         vm = semiCreateVM(NULL);
         ASSERT_NE(vm, nullptr) << "Failed to recreate VM for next test case";
     }
-}
\ No newline at end of file
+}
+// OP_ITER_PREPARE / OP_ITER_NEXT Tests
+//
+// The loop sums the items into R[0] and stops with trap 0x99. R[1] is the iterable, R[2] the cursor, R[3] the
+// counter, R[4] the item and R[5] the index.
+static const char* kIterSumSpec = R"(
+[ModuleInit]
+arity=0 coarity=0 maxStackSize=8
+
+[Instructions]
+0: OP_ITER_PREPARE A=0x01 B=0x01 C=0x00 kb=F kc=F
+1: OP_ITER_NEXT    A=0x01 K=0x0003 i=T s=F
+2: OP_ADD          A=0x00 B=0x00 C=0x04 kb=F kc=F
+3: OP_JUMP         J=0x000002 s=F
+4: OP_TRAP         A=0x00 K=0x0099 i=F s=F
+)";
+
+TEST_F(VMInstructionIterTest, OpIterNextList) {
+    Value listValue  = semiValueListCreate(&vm->gc, 4);
+    ObjectList* list = AS_LIST(&listValue);
+    for (int i = 1; i <= 5; i++) {
+        semiListAppend(&vm->gc, list, semiValueIntCreate(i));
+    }
+    vm->values[0] = semiValueIntCreate(0);
+    vm->values[1] = listValue;
+
+    SemiModule* module;
+    ErrorId result = InstructionVerifier::BuildAndRunModule(vm, kIterSumSpec, &module);
+
+    ASSERT_EQ(result, 0x99);
+    ASSERT_EQ(AS_INT(&vm->values[0]), 15);
+    ASSERT_EQ(AS_INT(&vm->values[3]), 5) << "Counter should count every item";
+    ASSERT_EQ(AS_INT(&vm->values[5]), 4) << "Index of the last item";
+}
+
+TEST_F(VMInstructionIterTest, OpIterNextEmptyList) {
+    vm->values[0] = semiValueIntCreate(0);
+    vm->values[1] = semiValueListCreate(&vm->gc, 0);
+
+    SemiModule* module;
+    ErrorId result = InstructionVerifier::BuildAndRunModule(vm, kIterSumSpec, &module);
+
+    ASSERT_EQ(result, 0x99);
+    ASSERT_EQ(AS_INT(&vm->values[0]), 0);
+    ASSERT_EQ(AS_INT(&vm->values[3]), 0);
+}
+
+TEST_F(VMInstructionIterTest, OpIterNextDictSkipsDeletedKeys) {
+    Value dictValue  = semiValueDictCreate(&vm->gc);
+    ObjectDict* dict = AS_DICT(&dictValue);
+    for (int i = 1; i <= 4; i++) {
+        semiDictSet(&vm->gc, dict, semiValueIntCreate(i * 10), semiValueBoolCreate(true));
+    }
+    semiDictDelete(&vm->gc, dict, semiValueIntCreate(20));
+    vm->values[0] = semiValueIntCreate(0);
+    vm->values[1] = dictValue;
+
+    SemiModule* module;
+    ErrorId result = InstructionVerifier::BuildAndRunModule(vm, kIterSumSpec, &module);
+
+    ASSERT_EQ(result, 0x99);
+    ASSERT_EQ(AS_INT(&vm->values[0]), 10 + 30 + 40);
+    ASSERT_EQ(AS_INT(&vm->values[3]), 3);
+    ASSERT_EQ(AS_INT(&vm->values[5]), 2);
+}
+
+TEST_F(VMInstructionIterTest, OpIterNextString) {
+    vm->values[1] = semiValueStringCreate(&vm->gc, "abc", 3);
+
+    SemiModule* module;
+    ErrorId result = InstructionVerifier::BuildAndRunModule(vm,
+                                                            R"(
+[ModuleInit]
+arity=0 coarity=0 maxStackSize=8
+
+[Instructions]
+0: OP_ITER_PREPARE A=0x01 B=0x01 C=0x00 kb=F kc=F
+1: OP_ITER_NEXT    A=0x01 K=0x0002 i=F s=F
+2: OP_JUMP         J=0x000001 s=F
+3: OP_TRAP         A=0x00 K=0x0099 i=F s=F
+)",
+                                                            &module);
+
+    ASSERT_EQ(result, 0x99);
+    ASSERT_EQ(AS_INT(&vm->values[2]), 3) << "Cursor should be at the end of the string";
+    ASSERT_TRUE(IS_INLINE_STRING(&vm->values[4]));
+    ASSERT_EQ(AS_INLINE_STRING(&vm->values[4]).c[0], 'c');
+}
+
+TEST_F(VMInstructionIterTest, OpIterPrepareNonIterable) {
+    vm->values[1] = semiValueIntCreate(42);
+
+    SemiModule* module;
+    ErrorId result = InstructionVerifier::BuildAndRunModule(vm, kIterSumSpec, &module);
+
+    ASSERT_EQ(result, SEMI_ERROR_UNEXPECTED_TYPE);
+}